@@ -0,0 +1,87 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#include "cluster-labels.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace ml
+{
+
+std::vector<int32_t>
+ReorderLabels(const std::vector<int32_t>& labels, uint32_t partitions)
+{
+    std::size_t part = partitions > 0 ? labels.size() / partitions : 0;
+    std::map<int32_t, int32_t> mapping;
+    for (uint32_t i = 0; i < partitions; i++)
+    {
+        // Most common non-negative label, the first seen on ties (Counter.most_common)
+        std::map<int32_t, std::pair<std::size_t, std::size_t>> counts; //!< label -> count, first
+        for (std::size_t s = i * part; s < (i + 1) * part; s++)
+        {
+            if (labels[s] >= 0)
+            {
+                auto [it, inserted] = counts.try_emplace(labels[s], 0, s);
+                it->second.first++;
+            }
+        }
+        int32_t predominant = -1;
+        std::pair<std::size_t, std::size_t> best{0, 0};
+        for (const auto& [label, count] : counts)
+        {
+            if (count.first > best.first ||
+                (count.first == best.first && count.second < best.second))
+            {
+                predominant = label;
+                best = count;
+            }
+        }
+        if (predominant >= 0)
+        {
+            mapping[predominant] = i;
+        }
+    }
+
+    std::vector<int32_t> reordered(labels.size());
+    for (std::size_t s = 0; s < labels.size(); s++)
+    {
+        auto it = mapping.find(labels[s]);
+        reordered[s] = labels[s] >= 0 && it != mapping.end() ? it->second : labels[s];
+    }
+    return reordered;
+}
+
+std::map<int32_t, std::size_t>
+ClusterSizes(const std::vector<int32_t>& labels)
+{
+    std::map<int32_t, std::size_t> sizes;
+    for (int32_t label : labels)
+    {
+        sizes[label]++;
+    }
+    return sizes;
+}
+
+void
+WriteLabels(const std::string& filename,
+            const std::vector<int32_t>& labels,
+            const std::vector<int32_t>& reordered)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Can not open " + filename);
+    }
+    file << "index,label,reordered\n";
+    for (std::size_t s = 0; s < labels.size(); s++)
+    {
+        file << s << "," << labels[s] << "," << (reordered.empty() ? labels[s] : reordered[s])
+             << "\n";
+    }
+}
+
+} // namespace ml
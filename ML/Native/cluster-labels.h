@@ -0,0 +1,49 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef CLUSTER_LABELS_H
+#define CLUSTER_LABELS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief Rename the clusters after the partition of the samples where they predominate
+ *
+ * Same as reorder_labels of the Python scripts: the samples are split in partitions of equal
+ * size (one per scenario) and the predominant non-negative label of partition i becomes label
+ * i. Negative labels (DBSCAN noise) and labels predominant nowhere are kept.
+ *
+ * \param labels cluster label of every sample
+ * \param partitions number of partitions
+ * \return the renamed labels
+ */
+std::vector<int32_t> ReorderLabels(const std::vector<int32_t>& labels, uint32_t partitions);
+
+/**
+ * \param labels cluster label of every sample
+ * \return the number of samples of every label
+ */
+std::map<int32_t, std::size_t> ClusterSizes(const std::vector<int32_t>& labels);
+
+/**
+ * \brief Write the label of every sample to a CSV file (index, label, reordered label)
+ * \param filename output file
+ * \param labels cluster label of every sample
+ * \param reordered reordered labels (empty: same as the labels)
+ */
+void WriteLabels(const std::string& filename,
+                 const std::vector<int32_t>& labels,
+                 const std::vector<int32_t>& reordered);
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,239 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#include "csv-dataset.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace ml
+{
+
+namespace
+{
+/// Columns of the DeviceStats files (no header), named as in the Python scripts
+const std::map<std::string, std::size_t> DEVICE_STATS_COLUMNS = {{"mcs", 5},
+                                                                 {"channelwidth", 6},
+                                                                 {"gi", 7},
+                                                                 {"avgthroughput", 8},
+                                                                 {"avgtxbytes", 9},
+                                                                 {"avgtxpackets", 10},
+                                                                 {"avgrxbytes", 11},
+                                                                 {"avgrxpackets", 12},
+                                                                 {"avgtotaldelay", 13},
+                                                                 {"avgtotaljitter", 14},
+                                                                 {"signal", 15},
+                                                                 {"noise", 16},
+                                                                 {"snr", 17}};
+
+/// Device type column of the DeviceStats files
+constexpr std::size_t DEVICE_STATS_DEVICE_COLUMN = 3;
+
+/**
+ * \param line CSV line
+ * \return the fields of the line, without surrounding blanks
+ */
+std::vector<std::string>
+SplitLine(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::size_t begin = 0;
+    while (true)
+    {
+        std::size_t end = line.find(',', begin);
+        std::string field =
+            line.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        std::size_t first = field.find_first_not_of(" \t\r\"");
+        std::size_t last = field.find_last_not_of(" \t\r\"");
+        fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        if (end == std::string::npos)
+        {
+            return fields;
+        }
+        begin = end + 1;
+    }
+}
+
+/**
+ * \param field CSV field
+ * \param value parsed value
+ * \return whether the field is a number
+ */
+bool
+ParseNumber(const std::string& field, double& value)
+{
+    if (field.empty())
+    {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(field.c_str(), &end);
+    return *end == '\0';
+}
+} // namespace
+
+std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> items;
+    for (const auto& item : SplitLine(list))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Dataset
+LoadCsv(const std::string& filename,
+        const std::vector<std::string>& features,
+        const std::string& device)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Can not open " + filename);
+    }
+    if (features.empty())
+    {
+        throw std::runtime_error("No features selected");
+    }
+
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        throw std::runtime_error(filename + " is empty");
+    }
+    std::vector<std::string> first = SplitLine(line);
+
+    // A header unless the first field is a number (seed of a DeviceStats line)
+    double value;
+    bool header = !ParseNumber(first[0], value);
+    std::vector<std::size_t> columns;
+    std::size_t deviceColumn = std::numeric_limits<std::size_t>::max();
+    for (const auto& feature : features)
+    {
+        if (header)
+        {
+            auto it = std::find(first.begin(), first.end(), feature);
+            if (it == first.end())
+            {
+                throw std::runtime_error("No column " + feature + " in " + filename);
+            }
+            columns.push_back(it - first.begin());
+        }
+        else
+        {
+            auto it = DEVICE_STATS_COLUMNS.find(feature);
+            if (it == DEVICE_STATS_COLUMNS.end())
+            {
+                throw std::runtime_error("Unknown DeviceStats feature " + feature);
+            }
+            columns.push_back(it->second);
+        }
+    }
+    if (!device.empty())
+    {
+        auto it = std::find(first.begin(), first.end(), "device");
+        if (!header)
+        {
+            deviceColumn = DEVICE_STATS_DEVICE_COLUMN;
+        }
+        else if (it != first.end())
+        {
+            deviceColumn = it - first.begin();
+        }
+        else
+        {
+            throw std::runtime_error("No device column in " + filename);
+        }
+    }
+
+    Dataset dataset;
+    dataset.features = features;
+    dataset.stride = (features.size() + SIMD_LANES - 1) / SIMD_LANES * SIMD_LANES;
+    std::size_t lineNumber = 1;
+    for (bool pending = !header; pending || std::getline(file, line); pending = false)
+    {
+        std::vector<std::string> fields = pending ? first : SplitLine(line);
+        lineNumber += pending ? 0 : 1;
+        if (fields.size() == 1 && fields[0].empty())
+        {
+            continue;
+        }
+        if (deviceColumn < fields.size() && fields[deviceColumn] != device)
+        {
+            continue;
+        }
+        dataset.values.resize(dataset.values.size() + dataset.stride, 0);
+        double* row = dataset.Row(dataset.nSamples);
+        for (std::size_t f = 0; f < columns.size(); f++)
+        {
+            if (columns[f] >= fields.size() || !ParseNumber(fields[columns[f]], row[f]))
+            {
+                throw std::runtime_error(filename + ":" + std::to_string(lineNumber) +
+                                         ": no numeric " + features[f]);
+            }
+        }
+        dataset.nSamples++;
+    }
+    return dataset;
+}
+
+void
+MinMaxScale(Dataset& dataset)
+{
+    std::size_t nFeatures = dataset.features.size();
+    for (std::size_t f = 0; f < nFeatures; f++)
+    {
+        double min = std::numeric_limits<double>::infinity();
+        double max = -min;
+        for (std::size_t i = 0; i < dataset.nSamples; i++)
+        {
+            min = std::min(min, dataset.Row(i)[f]);
+            max = std::max(max, dataset.Row(i)[f]);
+        }
+        // Same operations as MinMaxScaler: x * scale + offset
+        double scale = max > min ? 1 / (max - min) : 1;
+        double offset = -min * scale;
+        for (std::size_t i = 0; i < dataset.nSamples; i++)
+        {
+            dataset.Row(i)[f] = dataset.Row(i)[f] * scale + offset;
+        }
+    }
+}
+
+void
+WriteCsv(const Dataset& dataset, const std::string& filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Can not open " + filename);
+    }
+    file.precision(17);
+    for (std::size_t f = 0; f < dataset.features.size(); f++)
+    {
+        file << (f > 0 ? "," : "") << dataset.features[f];
+    }
+    file << "\n";
+    for (std::size_t i = 0; i < dataset.nSamples; i++)
+    {
+        for (std::size_t f = 0; f < dataset.features.size(); f++)
+        {
+            file << (f > 0 ? "," : "") << dataset.Row(i)[f];
+        }
+        file << "\n";
+    }
+}
+
+} // namespace ml
@@ -0,0 +1,82 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef CSV_DATASET_H
+#define CSV_DATASET_H
+
+#include "simd-distance.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief Samples of the selected features, row-major
+ *
+ * Every row is padded with zeros up to a multiple of SIMD_LANES, so that the distance kernels
+ * run without tails; the padding adds nothing to the distances.
+ */
+struct Dataset
+{
+    std::vector<std::string> features; //!< feature names, in column order
+    std::size_t nSamples{0};
+    std::size_t stride{0};      //!< doubles per row (features and padding)
+    std::vector<double> values; //!< nSamples x stride
+
+    const double* Row(std::size_t sample) const
+    {
+        return values.data() + sample * stride;
+    }
+
+    double* Row(std::size_t sample)
+    {
+        return values.data() + sample * stride;
+    }
+};
+
+/**
+ * \brief Load the features of a stats file
+ *
+ * Files with a header (Scenarios-APStats.csv, Scenarios-STAStats.csv) are read by column
+ * name; the headerless DeviceStats files written by the scenarios by position, using the names
+ * of the Python scripts (avgthroughput, avgtxpackets, avgrxpackets, avgtotaldelay,
+ * avgtotaljitter, snr...).
+ *
+ * \param filename CSV file
+ * \param features names of the features to load
+ * \param device only the rows of this device type (AP / STA, "device" column of the files with
+ * a header), empty for every row
+ * \return the dataset (not scaled)
+ */
+Dataset LoadCsv(const std::string& filename,
+                const std::vector<std::string>& features,
+                const std::string& device);
+
+/**
+ * \brief Scale every feature to [0, 1] (MinMaxScaler); constant features become 0
+ * \param dataset dataset to scale
+ */
+void MinMaxScale(Dataset& dataset);
+
+/**
+ * \brief Write the features of a dataset to a CSV file with a header
+ * \param dataset dataset
+ * \param filename output file
+ */
+void WriteCsv(const Dataset& dataset, const std::string& filename);
+
+/**
+ * \param list comma separated list
+ * \return the items of the list
+ */
+std::vector<std::string> SplitList(const std::string& list);
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,448 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#include "dbscan.h"
+
+#include "parallel-for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace ml
+{
+
+namespace
+{
+/// Samples of a block of the parallel queries
+constexpr std::size_t QUERY_BLOCK = 256;
+
+/// Maximum number of samples of a leaf of the tree of micro-cluster seeds
+constexpr std::size_t SEED_LEAF_SIZE = 16;
+
+/// No sample
+constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+/**
+ * \param parent parent of every sample
+ * \param sample sample
+ * \return the root of the set of the sample, halving the path
+ */
+std::size_t
+Find(std::vector<std::atomic<std::size_t>>& parent, std::size_t sample)
+{
+    while (true)
+    {
+        std::size_t up = parent[sample].load(std::memory_order_relaxed);
+        if (up == sample)
+        {
+            return sample;
+        }
+        std::size_t grandparent = parent[up].load(std::memory_order_relaxed);
+        parent[sample].compare_exchange_weak(up, grandparent, std::memory_order_relaxed);
+        sample = grandparent;
+    }
+}
+
+/**
+ * \brief Merge the sets of two samples; the root with the highest position is linked to the
+ * other one, so that concurrent merges never make a cycle
+ * \param parent parent of every sample
+ * \param a first sample
+ * \param b second sample
+ */
+void
+Unite(std::vector<std::atomic<std::size_t>>& parent, std::size_t a, std::size_t b)
+{
+    while (true)
+    {
+        a = Find(parent, a);
+        b = Find(parent, b);
+        if (a == b)
+        {
+            return;
+        }
+        if (a < b)
+        {
+            std::swap(a, b);
+        }
+        std::size_t root = a;
+        if (parent[a].compare_exchange_strong(root, b))
+        {
+            return;
+        }
+    }
+}
+} // namespace
+
+Dbscan::Dbscan(double eps, uint32_t minSamples, unsigned nThreads)
+    : m_eps(eps),
+      m_minSamples(minSamples),
+      m_nThreads(std::max(1U, nThreads))
+{
+    if (eps <= 0 || minSamples == 0)
+    {
+        throw std::runtime_error("eps and minSamples must be positive");
+    }
+}
+
+Dbscan::Result
+Dbscan::Fit(const KdTree& tree) const
+{
+    const Dataset& points = tree.GetPoints();
+    std::size_t n = points.nSamples;
+    std::size_t nNodes = tree.GetNNodes();
+    double eps2 = m_eps * m_eps;
+
+    // Core samples
+    std::vector<uint8_t> core(n);
+    ParallelForDynamic(n, QUERY_BLOCK, m_nThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; p++)
+        {
+            core[p] = tree.CountWithin(points.Row(p), eps2, m_minSamples) >= m_minSamples;
+        }
+    });
+    auto isCore = [&core](std::size_t p) { return core[p] != 0; };
+
+    // First core sample of every node
+    std::vector<std::size_t> nextCore(n + 1, NONE); //!< first core position from p on
+    for (std::size_t p = n; p > 0; p--)
+    {
+        nextCore[p - 1] = core[p - 1] ? p - 1 : nextCore[p];
+    }
+    std::vector<std::size_t> representative(nNodes, NONE);
+    tree.ForEachNode([&](uint32_t node, std::size_t begin, std::size_t end) {
+        representative[node] = nextCore[begin] < end ? nextCore[begin] : NONE;
+        return true;
+    });
+
+    // Clusters: core samples connected through their neighbourhoods, in a union-find
+    std::vector<std::atomic<std::size_t>> parent(n);
+    for (std::size_t p = 0; p < n; p++)
+    {
+        parent[p].store(p, std::memory_order_relaxed);
+    }
+
+    // Micro-clusters: every core sample not grouped yet, in tree order, groups the ungrouped
+    // core samples within eps / 2, which are neighbours of each other (and come after it).
+    // Nodes whose core samples are all grouped are skipped
+    std::vector<std::size_t> group(n, NONE); //!< micro-cluster of every core sample
+    std::vector<std::size_t> seeds;          //!< first core sample of every micro-cluster
+    std::vector<uint8_t> grouped(nNodes);
+    for (uint32_t node = 0; node < nNodes; node++)
+    {
+        grouped[node] = representative[node] == NONE;
+    }
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (!core[p] || group[p] != NONE)
+        {
+            continue;
+        }
+        std::size_t id = seeds.size();
+        seeds.push_back(p);
+        auto take = [&](std::size_t q) {
+            if (core[q] && group[q] == NONE)
+            {
+                group[q] = id;
+                parent[q].store(p, std::memory_order_relaxed);
+            }
+        };
+        auto enter = [&](uint32_t node, bool inside) {
+            if (grouped[node] || !inside)
+            {
+                return !grouped[node];
+            }
+            auto [first, last] = tree.GetRange(node);
+            for (std::size_t q = first; q < last; q++)
+            {
+                take(q);
+            }
+            grouped[node] = 1;
+            return false;
+        };
+        tree.ForEachWithin(points.Row(p), eps2 / 4, enter, take);
+    }
+    grouped.clear();
+    grouped.shrink_to_fit();
+
+    // Micro-clusters of minSamples core samples or more (dense) are linked to the dense ones
+    // within reach through any pair of their core samples within eps: the seeds of such a pair
+    // are within 2 eps, and each sample within 1.5 eps of the other seed
+    std::vector<std::size_t> offsets(seeds.size() + 1, 0); //!< members of every micro-cluster
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (group[p] != NONE)
+        {
+            offsets[group[p] + 1]++;
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::size_t> members(offsets.back());
+    std::vector<std::size_t> filled(offsets.begin(), offsets.end() - 1);
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (group[p] != NONE)
+        {
+            members[filled[group[p]]++] = p;
+        }
+    }
+    filled.clear();
+    filled.shrink_to_fit();
+    auto isDense = [&](std::size_t id) { return offsets[id + 1] - offsets[id] >= m_minSamples; };
+
+    Dataset denseSeeds; //!< seeds of the dense micro-clusters
+    std::vector<std::size_t> dense;
+    denseSeeds.features = points.features;
+    denseSeeds.stride = points.stride;
+    for (std::size_t id = 0; id < seeds.size(); id++)
+    {
+        if (isDense(id))
+        {
+            dense.push_back(id);
+            denseSeeds.values.insert(denseSeeds.values.end(),
+                                     points.Row(seeds[id]),
+                                     points.Row(seeds[id]) + points.stride);
+        }
+    }
+    denseSeeds.nSamples = dense.size();
+    auto linked = [&](std::size_t a, std::size_t b) {
+        const double* seedA = points.Row(seeds[a]);
+        const double* seedB = points.Row(seeds[b]);
+        std::vector<std::size_t> candidates;
+        for (std::size_t m = offsets[b]; m < offsets[b + 1]; m++)
+        {
+            if (SquaredDistance(points.Row(members[m]), seedA, points.stride) <= 2.25 * eps2)
+            {
+                candidates.push_back(members[m]);
+            }
+        }
+        for (std::size_t m = offsets[a]; m < offsets[a + 1] && !candidates.empty(); m++)
+        {
+            const double* row = points.Row(members[m]);
+            if (SquaredDistance(row, seedB, points.stride) > 2.25 * eps2)
+            {
+                continue;
+            }
+            for (std::size_t q : candidates)
+            {
+                if (SquaredDistance(row, points.Row(q), points.stride) <= eps2)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    if (!dense.empty())
+    {
+        KdTree seedTree(std::move(denseSeeds), SEED_LEAF_SIZE);
+        ParallelForDynamic(dense.size(), 1, m_nThreads, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                std::size_t a = dense[i];
+                seedTree.ForEachWithin(points.Row(seeds[a]), 4 * eps2, [&](std::size_t position) {
+                    std::size_t b = dense[seedTree.GetIndex(position)];
+                    if (b > a && Find(parent, seeds[a]) != Find(parent, seeds[b]) &&
+                        linked(a, b))
+                    {
+                        Unite(parent, seeds[a], seeds[b]);
+                    }
+                });
+            }
+        });
+    }
+
+    // Core samples out of the dense micro-clusters: their own neighbourhood. A node is merged
+    // when all its core samples are in the same set, which they stay in: one core neighbour
+    // of a merged node joins it to the set of the sample. The queries mark the nodes merged
+    // as they find them so
+    std::vector<std::atomic<uint8_t>> merged(nNodes);
+    for (auto& flag : merged)
+    {
+        flag.store(0, std::memory_order_relaxed);
+    }
+    auto isMerged = [&](uint32_t node) {
+        if (merged[node].load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+        auto [left, right] = tree.GetChildren(node);
+        bool now = true;
+        if (left == 0)
+        {
+            std::size_t root = Find(parent, representative[node]);
+            auto [begin, end] = tree.GetRange(node);
+            for (std::size_t p = begin; p < end && now; p++)
+            {
+                now = !core[p] || Find(parent, p) == root;
+            }
+        }
+        else
+        {
+            std::size_t first = representative[left];
+            std::size_t second = representative[right];
+            now = (first == NONE || merged[left].load(std::memory_order_relaxed)) &&
+                  (second == NONE || merged[right].load(std::memory_order_relaxed)) &&
+                  (first == NONE || second == NONE || Find(parent, first) == Find(parent, second));
+        }
+        if (now)
+        {
+            merged[node].store(1, std::memory_order_relaxed);
+        }
+        return now;
+    };
+    ParallelForDynamic(n, QUERY_BLOCK, m_nThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; p++)
+        {
+            if (!core[p] || isDense(group[p]))
+            {
+                continue;
+            }
+            // A sample whose parent is a root the set of p had is in the set already
+            const double* row = points.Row(p);
+            std::size_t root = Find(parent, p);
+            auto joined = [&](std::size_t q) {
+                if (parent[q].load(std::memory_order_relaxed) == root)
+                {
+                    return true;
+                }
+                root = Find(parent, p);
+                return Find(parent, q) == root;
+            };
+            auto join = [&](std::size_t q) {
+                Unite(parent, p, q);
+                root = Find(parent, p);
+            };
+            auto enter = [&](uint32_t node, bool inside) {
+                std::size_t sample = representative[node];
+                if (sample == NONE)
+                {
+                    return false;
+                }
+                if (isMerged(node))
+                {
+                    if (!joined(sample) && (inside || tree.AnyWithin(node, row, eps2, isCore)))
+                    {
+                        join(sample);
+                    }
+                    return false;
+                }
+                if (!inside)
+                {
+                    return true;
+                }
+                // Every core sample of the node is a neighbour: the node ends merged
+                auto [first, last] = tree.GetRange(node);
+                for (std::size_t q = first; q < last; q++)
+                {
+                    if (core[q] && !joined(q))
+                    {
+                        join(q);
+                    }
+                }
+                merged[node].store(1, std::memory_order_relaxed);
+                return false;
+            };
+            tree.ForEachWithin(row, eps2, enter, [&](std::size_t q) {
+                if (core[q] && !joined(q))
+                {
+                    join(q);
+                }
+            });
+        }
+    });
+
+    group.clear();
+    group.shrink_to_fit();
+
+    // Number the clusters in the order of their first sample in the dataset
+    Result result;
+    std::vector<std::size_t> first(n, NONE);
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (core[p])
+        {
+            std::size_t root = Find(parent, p);
+            first[root] = std::min(first[root], tree.GetIndex(p));
+            result.nCore++;
+        }
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> roots; //!< first sample, root
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (first[p] != NONE)
+        {
+            roots.emplace_back(first[p], p);
+        }
+    }
+    first.clear();
+    first.shrink_to_fit();
+    std::sort(roots.begin(), roots.end());
+    result.nClusters = roots.size();
+
+    std::vector<int32_t> labels(n, -1); //!< cluster of every position
+    for (std::size_t c = 0; c < roots.size(); c++)
+    {
+        labels[roots[c].second] = c;
+    }
+    for (std::size_t p = 0; p < n; p++)
+    {
+        if (core[p])
+        {
+            labels[p] = labels[Find(parent, p)];
+        }
+    }
+
+    // Border samples: the lowest cluster among their core neighbours
+    ParallelForDynamic(n, QUERY_BLOCK, m_nThreads, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; p++)
+        {
+            if (core[p])
+            {
+                continue;
+            }
+            const double* row = points.Row(p);
+            auto join = [&](std::size_t q) {
+                if (labels[p] < 0 || labels[q] < labels[p])
+                {
+                    labels[p] = labels[q];
+                }
+            };
+            auto enter = [&](uint32_t node, bool inside) {
+                std::size_t sample = representative[node];
+                if (sample == NONE || !merged[node].load(std::memory_order_relaxed))
+                {
+                    return sample != NONE;
+                }
+                if (inside || tree.AnyWithin(node, row, eps2, isCore))
+                {
+                    join(sample);
+                }
+                return false;
+            };
+            tree.ForEachWithin(row, eps2, enter, [&](std::size_t q) {
+                if (core[q])
+                {
+                    join(q);
+                }
+            });
+        }
+    });
+
+    result.labels.resize(n);
+    for (std::size_t p = 0; p < n; p++)
+    {
+        result.labels[tree.GetIndex(p)] = labels[p];
+        result.nNoise += labels[p] < 0;
+    }
+    return result;
+}
+
+} // namespace ml
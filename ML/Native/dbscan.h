@@ -0,0 +1,69 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef DBSCAN_H
+#define DBSCAN_H
+
+#include "kd-tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief DBSCAN with the semantics of scikit-learn DBSCAN
+ *
+ * A sample is a core sample when at least minSamples samples (itself included) lie within eps;
+ * the clusters are the connected groups of core samples, numbered in the order of their first
+ * sample. A border sample takes the lowest cluster among its core neighbours and the rest are
+ * noise (-1), so the labels are those of scikit-learn, which expands the clusters in order.
+ *
+ * No neighbourhood is stored; the k-d tree is queried and the clusters merged in a concurrent
+ * union-find. The core samples (a query stopping at minSamples) are first grouped in
+ * micro-clusters: the core samples within eps / 2 of a seed, all neighbours of each other.
+ * Micro-clusters of minSamples core samples or more are linked to those within 2 eps by a
+ * single pair of core samples within eps, so dense regions cost a query per micro-cluster
+ * instead of one per sample; the other core samples query their own neighbourhood, skipping
+ * the nodes already in their set. Border samples query theirs once more. All but the grouping
+ * run in parallel, and the result does not depend on the number of threads.
+ */
+class Dbscan
+{
+  public:
+    /// Result of a fit
+    struct Result
+    {
+        std::vector<int32_t> labels; //!< cluster of every sample of the original dataset
+        std::size_t nClusters{0};
+        std::size_t nCore{0};  //!< number of core samples
+        std::size_t nNoise{0}; //!< number of noise samples
+    };
+
+    /**
+     * \param eps radius of the neighbourhood
+     * \param minSamples samples in the neighbourhood of a core sample (itself included)
+     * \param nThreads number of threads
+     */
+    Dbscan(double eps, uint32_t minSamples, unsigned nThreads);
+
+    /**
+     * \param tree k-d tree of the samples (scaled)
+     * \return the labels
+     */
+    Result Fit(const KdTree& tree) const;
+
+  private:
+    double m_eps;
+    uint32_t m_minSamples;
+    unsigned m_nThreads;
+};
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,271 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#include "kd-tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace ml
+{
+
+KdTree::KdTree(Dataset dataset, std::size_t leafSize)
+    : m_points(std::move(dataset)),
+      m_index(m_points.nSamples),
+      m_nFeatures(m_points.features.size()),
+      m_leafSize(std::max<std::size_t>(1, leafSize))
+{
+    if (m_points.nSamples == 0)
+    {
+        throw std::runtime_error("No samples");
+    }
+    for (std::size_t p = 0; p < m_index.size(); p++)
+    {
+        m_index[p] = p;
+    }
+    m_nodes.reserve(2 * (m_points.nSamples / m_leafSize + 1));
+    Build(0, m_points.nSamples);
+
+    // Move every row to its position, following the cycles of the permutation
+    std::size_t stride = m_points.stride;
+    std::vector<bool> placed(m_points.nSamples, false);
+    std::vector<double> saved(stride);
+    for (std::size_t start = 0; start < m_points.nSamples; start++)
+    {
+        if (placed[start])
+        {
+            continue;
+        }
+        std::copy_n(m_points.Row(start), stride, saved.begin());
+        for (std::size_t p = start;;)
+        {
+            std::size_t source = m_index[p];
+            placed[p] = true;
+            if (source == start)
+            {
+                std::copy_n(saved.begin(), stride, m_points.Row(p));
+                break;
+            }
+            std::copy_n(m_points.Row(source), stride, m_points.Row(p));
+            p = source;
+        }
+    }
+}
+
+const Dataset&
+KdTree::GetPoints() const
+{
+    return m_points;
+}
+
+std::size_t
+KdTree::GetIndex(std::size_t position) const
+{
+    return m_index[position];
+}
+
+std::pair<uint32_t, uint32_t>
+KdTree::GetChildren(uint32_t node) const
+{
+    return {m_nodes[node].left, m_nodes[node].right};
+}
+
+std::pair<std::size_t, std::size_t>
+KdTree::GetRange(uint32_t node) const
+{
+    return {m_nodes[node].begin, m_nodes[node].end};
+}
+
+std::size_t
+KdTree::GetNNodes() const
+{
+    return m_nodes.size();
+}
+
+uint32_t
+KdTree::Build(std::size_t begin, std::size_t end)
+{
+    uint32_t node = m_nodes.size();
+    m_nodes.push_back({begin, end});
+    m_lower.resize(m_lower.size() + m_nFeatures, std::numeric_limits<double>::infinity());
+    m_upper.resize(m_upper.size() + m_nFeatures, -std::numeric_limits<double>::infinity());
+    double* lower = m_lower.data() + node * m_nFeatures;
+    double* upper = m_upper.data() + node * m_nFeatures;
+    for (std::size_t p = begin; p < end; p++)
+    {
+        const double* row = m_points.Row(m_index[p]);
+        for (std::size_t f = 0; f < m_nFeatures; f++)
+        {
+            lower[f] = std::min(lower[f], row[f]);
+            upper[f] = std::max(upper[f], row[f]);
+        }
+    }
+    if (end - begin <= m_leafSize)
+    {
+        return node;
+    }
+
+    std::size_t widest = 0;
+    for (std::size_t f = 1; f < m_nFeatures; f++)
+    {
+        if (upper[f] - lower[f] > upper[widest] - lower[widest])
+        {
+            widest = f;
+        }
+    }
+    std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element(m_index.begin() + begin,
+                     m_index.begin() + middle,
+                     m_index.begin() + end,
+                     [this, widest](std::size_t a, std::size_t b) {
+                         return m_points.Row(a)[widest] < m_points.Row(b)[widest];
+                     });
+    uint32_t left = Build(begin, middle);
+    uint32_t right = Build(middle, end);
+    m_nodes[node].left = left;
+    m_nodes[node].right = right;
+    return node;
+}
+
+double
+KdTree::MinDistance(uint32_t node, const double* point) const
+{
+    const double* lower = m_lower.data() + node * m_nFeatures;
+    const double* upper = m_upper.data() + node * m_nFeatures;
+    double distance = 0;
+    for (std::size_t f = 0; f < m_nFeatures; f++)
+    {
+        double excess = std::max({lower[f] - point[f], point[f] - upper[f], 0.0});
+        distance += excess * excess;
+    }
+    return distance;
+}
+
+double
+KdTree::MaxDistance(uint32_t node, const double* point) const
+{
+    const double* lower = m_lower.data() + node * m_nFeatures;
+    const double* upper = m_upper.data() + node * m_nFeatures;
+    double distance = 0;
+    for (std::size_t f = 0; f < m_nFeatures; f++)
+    {
+        double farthest = std::max(point[f] - lower[f], upper[f] - point[f]);
+        distance += farthest * farthest;
+    }
+    return distance;
+}
+
+std::size_t
+KdTree::CountWithin(const double* point, double radius2, std::size_t limit) const
+{
+    std::size_t count = 0;
+    std::pair<double, uint32_t> stack[MAX_DEPTH + 1];
+    std::size_t top = 0;
+    stack[top++] = {MinDistance(0, point), 0};
+    while (top > 0)
+    {
+        auto [bound, index] = stack[--top];
+        const Node& node = m_nodes[index];
+        if (bound > radius2)
+        {
+            continue;
+        }
+        if (MaxDistance(index, point) <= radius2)
+        {
+            count += node.end - node.begin;
+        }
+        else if (node.left == 0)
+        {
+            for (std::size_t p = node.begin; p < node.end; p++)
+            {
+                count += SquaredDistance(point, m_points.Row(p), m_points.stride) <= radius2;
+            }
+        }
+        else
+        {
+            // Nearer child on top of the stack, so that the count reaches the limit sooner
+            double left = MinDistance(node.left, point);
+            double right = MinDistance(node.right, point);
+            if (left <= right)
+            {
+                stack[top++] = {right, node.right};
+                stack[top++] = {left, node.left};
+            }
+            else
+            {
+                stack[top++] = {left, node.left};
+                stack[top++] = {right, node.right};
+            }
+        }
+        if (count >= limit)
+        {
+            return limit;
+        }
+    }
+    return count;
+}
+
+std::vector<double>
+KdTree::NearestDistances(const double* point, std::size_t k) const
+{
+    k = std::min(k, m_points.nSamples);
+    std::priority_queue<double> nearest; //!< k smallest squared distances, largest on top
+    std::vector<std::pair<double, uint32_t>> stack = {{MinDistance(0, point), 0}};
+    while (!stack.empty())
+    {
+        auto [bound, index] = stack.back();
+        stack.pop_back();
+        if (nearest.size() == k && bound >= nearest.top())
+        {
+            continue;
+        }
+        const Node& node = m_nodes[index];
+        if (node.left == 0)
+        {
+            for (std::size_t p = node.begin; p < node.end; p++)
+            {
+                double distance = SquaredDistance(point, m_points.Row(p), m_points.stride);
+                if (nearest.size() < k)
+                {
+                    nearest.push(distance);
+                }
+                else if (distance < nearest.top())
+                {
+                    nearest.pop();
+                    nearest.push(distance);
+                }
+            }
+            continue;
+        }
+        // Nearer child on top of the stack, so that it shrinks the bound of the other one
+        double left = MinDistance(node.left, point);
+        double right = MinDistance(node.right, point);
+        if (left <= right)
+        {
+            stack.emplace_back(right, node.right);
+            stack.emplace_back(left, node.left);
+        }
+        else
+        {
+            stack.emplace_back(left, node.left);
+            stack.emplace_back(right, node.right);
+        }
+    }
+
+    std::vector<double> distances(nearest.size());
+    for (std::size_t i = distances.size(); i > 0; i--)
+    {
+        distances[i - 1] = std::sqrt(nearest.top());
+        nearest.pop();
+    }
+    return distances;
+}
+
+} // namespace ml
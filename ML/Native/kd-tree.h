@@ -0,0 +1,274 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "csv-dataset.h"
+#include "simd-distance.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief K-d tree over the samples of a dataset, for the eps-neighbourhood and k-nearest
+ * neighbour queries
+ *
+ * Every node splits its samples at the median of its widest feature and keeps their bounding
+ * box; leaves hold up to leafSize samples. The tree takes the dataset and reorders its rows so
+ * that the samples of a node are contiguous: queries work with positions (rows of GetPoints)
+ * and GetIndex gives the row of a position in the original dataset.
+ */
+class KdTree
+{
+  public:
+    /**
+     * \param dataset samples, reordered by the tree
+     * \param leafSize maximum number of samples of a leaf
+     */
+    KdTree(Dataset dataset, std::size_t leafSize);
+
+    /**
+     * \return the samples, in tree order
+     */
+    const Dataset& GetPoints() const;
+
+    /**
+     * \param position row of GetPoints
+     * \return the row of the sample in the original dataset
+     */
+    std::size_t GetIndex(std::size_t position) const;
+
+    /**
+     * \brief Count the samples within a squared distance, stopping at a limit
+     *
+     * Nodes whose bounding box lies inside the ball are counted without computing distances.
+     *
+     * \param point query point (stride doubles)
+     * \param radius2 squared radius (inclusive)
+     * \param limit count at which to stop
+     * \return the number of samples within the radius (the point itself included), at most
+     * limit
+     */
+    std::size_t CountWithin(const double* point, double radius2, std::size_t limit) const;
+
+    /**
+     * \brief Call visit(position) for every sample within a squared distance
+     *
+     * Every node that meets the ball is first passed to enter(node, inside), inside telling
+     * whether its bounding box lies in the ball; the node is skipped when it returns false.
+     *
+     * \param point query point (stride doubles)
+     * \param radius2 squared radius (inclusive)
+     * \param enter callable enter(node, inside)
+     * \param visit callable visit(position)
+     */
+    template <typename NodeVisitor, typename Visitor>
+    void ForEachWithin(const double* point,
+                       double radius2,
+                       NodeVisitor&& enter,
+                       Visitor&& visit) const;
+
+    /**
+     * \brief Call visit(position) for every sample within a squared distance
+     * \param point query point (stride doubles)
+     * \param radius2 squared radius (inclusive)
+     * \param visit callable visit(position)
+     */
+    template <typename Visitor>
+    void ForEachWithin(const double* point, double radius2, Visitor&& visit) const;
+
+    /**
+     * \brief Call visit(node, begin, end) from the root down, descending while it returns true
+     * \param visit callable visit(node, begin, end), samples [begin, end) in tree order
+     */
+    template <typename Visitor>
+    void ForEachNode(Visitor&& visit) const;
+
+    /**
+     * \param node node
+     * \param point query point (stride doubles)
+     * \param radius2 squared radius (inclusive)
+     * \param accept callable accept(position)
+     * \return whether a sample of the subtree of the node within the radius is accepted
+     */
+    template <typename Predicate>
+    bool AnyWithin(uint32_t node, const double* point, double radius2, Predicate&& accept) const;
+
+    /**
+     * \param node node
+     * \return the children of the node, 0 for a leaf
+     */
+    std::pair<uint32_t, uint32_t> GetChildren(uint32_t node) const;
+
+    /**
+     * \param node node
+     * \return the samples [begin, end) of the node, in tree order
+     */
+    std::pair<std::size_t, std::size_t> GetRange(uint32_t node) const;
+
+    /**
+     * \return the number of nodes
+     */
+    std::size_t GetNNodes() const;
+
+    /**
+     * \param point query point (stride doubles)
+     * \param k number of neighbours
+     * \return the distances to the k nearest samples, ascending (a sample of the tree is its own
+     * nearest neighbour, as kneighbors(X) of scikit-learn)
+     */
+    std::vector<double> NearestDistances(const double* point, std::size_t k) const;
+
+  private:
+    /// Node of the tree; samples [begin, end) in tree order
+    struct Node
+    {
+        std::size_t begin;
+        std::size_t end;
+        uint32_t left{0};  //!< left child, 0 for a leaf (the root is no child)
+        uint32_t right{0}; //!< right child
+    };
+
+    /// Maximum depth of the tree (the median splits halve the samples)
+    static constexpr std::size_t MAX_DEPTH = 64;
+
+    /**
+     * \brief Build the subtree of the samples m_index[begin, end)
+     * \param begin first sample
+     * \param end past the last sample
+     * \return the node
+     */
+    uint32_t Build(std::size_t begin, std::size_t end);
+
+    /**
+     * \param node node
+     * \param point query point
+     * \return the squared distance from the point to the bounding box of the node
+     */
+    double MinDistance(uint32_t node, const double* point) const;
+
+    /**
+     * \param node node
+     * \param point query point
+     * \return the squared distance from the point to the farthest corner of the bounding box
+     */
+    double MaxDistance(uint32_t node, const double* point) const;
+
+    Dataset m_points;                 //!< samples, in tree order
+    std::vector<std::size_t> m_index; //!< original row of every position
+    std::vector<Node> m_nodes;
+    std::vector<double> m_lower; //!< nodes x features, lower corners of the bounding boxes
+    std::vector<double> m_upper; //!< nodes x features, upper corners of the bounding boxes
+    std::size_t m_nFeatures;
+    std::size_t m_leafSize;
+};
+
+template <typename NodeVisitor, typename Visitor>
+void
+KdTree::ForEachWithin(const double* point,
+                      double radius2,
+                      NodeVisitor&& enter,
+                      Visitor&& visit) const
+{
+    uint32_t stack[MAX_DEPTH + 1];
+    std::size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        uint32_t index = stack[--top];
+        const Node& node = m_nodes[index];
+        if (MinDistance(index, point) > radius2)
+        {
+            continue;
+        }
+        if (!enter(index, MaxDistance(index, point) <= radius2))
+        {
+            continue;
+        }
+        if (node.left == 0)
+        {
+            for (std::size_t p = node.begin; p < node.end; p++)
+            {
+                if (SquaredDistance(point, m_points.Row(p), m_points.stride) <= radius2)
+                {
+                    visit(p);
+                }
+            }
+            continue;
+        }
+        stack[top++] = node.right;
+        stack[top++] = node.left;
+    }
+}
+
+template <typename Visitor>
+void
+KdTree::ForEachWithin(const double* point, double radius2, Visitor&& visit) const
+{
+    ForEachWithin(point, radius2, [](uint32_t, bool) { return true; }, visit);
+}
+
+template <typename Visitor>
+void
+KdTree::ForEachNode(Visitor&& visit) const
+{
+    uint32_t stack[MAX_DEPTH + 1];
+    std::size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        uint32_t index = stack[--top];
+        const Node& node = m_nodes[index];
+        if (visit(index, node.begin, node.end) && node.left != 0)
+        {
+            stack[top++] = node.right;
+            stack[top++] = node.left;
+        }
+    }
+}
+
+template <typename Predicate>
+bool
+KdTree::AnyWithin(uint32_t node, const double* point, double radius2, Predicate&& accept) const
+{
+    uint32_t stack[MAX_DEPTH + 1];
+    std::size_t top = 0;
+    stack[top++] = node;
+    while (top > 0)
+    {
+        uint32_t index = stack[--top];
+        const Node& other = m_nodes[index];
+        if (MinDistance(index, point) > radius2)
+        {
+            continue;
+        }
+        if (other.left == 0)
+        {
+            for (std::size_t p = other.begin; p < other.end; p++)
+            {
+                if (SquaredDistance(point, m_points.Row(p), m_points.stride) <= radius2 &&
+                    accept(p))
+                {
+                    return true;
+                }
+            }
+            continue;
+        }
+        stack[top++] = other.right;
+        stack[top++] = other.left;
+    }
+    return false;
+}
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,518 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#include "kmeans.h"
+
+#include "parallel-for.h"
+#include "simd-distance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace ml
+{
+
+KMeans::KMeans(uint32_t nClusters,
+               uint32_t nInit,
+               uint32_t maxIter,
+               double tol,
+               Algorithm algorithm,
+               uint64_t seed,
+               unsigned nThreads)
+    : m_nClusters(nClusters),
+      m_nInit(nInit),
+      m_maxIter(maxIter),
+      m_tol(tol),
+      m_algorithm(algorithm),
+      m_seed(seed),
+      m_nThreads(std::max(1U, nThreads))
+{
+    if (nClusters == 0 || nInit == 0 || maxIter == 0)
+    {
+        throw std::runtime_error("k, nInit and maxIter must be positive");
+    }
+}
+
+KMeans::Algorithm
+KMeans::ParseAlgorithm(const std::string& name)
+{
+    if (name == "lloyd")
+    {
+        return LLOYD;
+    }
+    if (name == "elkan")
+    {
+        return ELKAN;
+    }
+    if (name == "hamerly")
+    {
+        return HAMERLY;
+    }
+    throw std::runtime_error("Invalid algorithm " + name + " (must be lloyd, elkan or hamerly)");
+}
+
+KMeans::Result
+KMeans::Fit(const Dataset& dataset) const
+{
+    if (dataset.nSamples < m_nClusters)
+    {
+        throw std::runtime_error("Fewer samples than clusters");
+    }
+
+    // Tolerance relative to the mean variance of the features
+    double meanVariance = 0;
+    for (std::size_t f = 0; f < dataset.features.size(); f++)
+    {
+        double mean = 0;
+        for (std::size_t i = 0; i < dataset.nSamples; i++)
+        {
+            mean += dataset.Row(i)[f];
+        }
+        mean /= dataset.nSamples;
+        double variance = 0;
+        for (std::size_t i = 0; i < dataset.nSamples; i++)
+        {
+            variance += (dataset.Row(i)[f] - mean) * (dataset.Row(i)[f] - mean);
+        }
+        meanVariance += variance / dataset.nSamples;
+    }
+    double tol = m_tol * meanVariance / dataset.features.size();
+
+    std::mt19937_64 rng(m_seed);
+    Result best;
+    for (uint32_t init = 0; init < m_nInit; init++)
+    {
+        Result result = Run(dataset, Seed(dataset, rng), tol);
+        if (init == 0 || result.inertia < best.inertia)
+        {
+            best = std::move(result);
+        }
+    }
+    return best;
+}
+
+std::vector<double>
+KMeans::Seed(const Dataset& dataset, std::mt19937_64& rng) const
+{
+    std::size_t n = dataset.nSamples;
+    std::size_t stride = dataset.stride;
+    std::vector<double> centers(m_nClusters * stride, 0);
+    uint32_t nTrials = 2 + static_cast<uint32_t>(std::log(m_nClusters));
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    // First center: a sample drawn uniformly
+    std::size_t first = std::uniform_int_distribution<std::size_t>(0, n - 1)(rng);
+    std::copy_n(dataset.Row(first), stride, centers.begin());
+    std::vector<double> closest(n);
+    ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            closest[i] = SquaredDistance(dataset.Row(i), centers.data(), stride);
+        }
+    });
+    double potential = std::accumulate(closest.begin(), closest.end(), 0.0);
+
+    // Next centers: the best of nTrials candidates drawn with probability ~ D^2
+    std::vector<double> cumulative(n);
+    std::vector<std::size_t> candidates(nTrials);
+    std::vector<double> trialDistances(nTrials * n);
+    std::vector<double> partialPotentials(m_nThreads * nTrials);
+    for (uint32_t c = 1; c < m_nClusters; c++)
+    {
+        std::partial_sum(closest.begin(), closest.end(), cumulative.begin());
+        for (auto& candidate : candidates)
+        {
+            double value = uniform(rng) * potential;
+            candidate = std::lower_bound(cumulative.begin(), cumulative.end(), value) -
+                        cumulative.begin();
+            candidate = std::min(candidate, n - 1);
+        }
+        std::fill(partialPotentials.begin(), partialPotentials.end(), 0.0);
+        ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned thread) {
+            for (uint32_t t = 0; t < nTrials; t++)
+            {
+                const double* candidate = dataset.Row(candidates[t]);
+                double* distances = trialDistances.data() + t * n;
+                double sum = 0;
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    distances[i] = std::min(closest[i],
+                                            SquaredDistance(dataset.Row(i), candidate, stride));
+                    sum += distances[i];
+                }
+                partialPotentials[thread * nTrials + t] = sum;
+            }
+        });
+        uint32_t best = 0;
+        double bestPotential = std::numeric_limits<double>::infinity();
+        for (uint32_t t = 0; t < nTrials; t++)
+        {
+            double trialPotential = 0;
+            for (unsigned thread = 0; thread < m_nThreads; thread++)
+            {
+                trialPotential += partialPotentials[thread * nTrials + t];
+            }
+            if (trialPotential < bestPotential)
+            {
+                best = t;
+                bestPotential = trialPotential;
+            }
+        }
+        potential = bestPotential;
+        std::copy_n(trialDistances.begin() + best * n, n, closest.begin());
+        std::copy_n(dataset.Row(candidates[best]), stride, centers.begin() + c * stride);
+    }
+    return centers;
+}
+
+std::vector<double>
+KMeans::UpdateCenters(const Dataset& dataset,
+                      const std::vector<int32_t>& labels,
+                      std::vector<double>& centers) const
+{
+    std::size_t stride = dataset.stride;
+    std::size_t clusterSize = m_nClusters * stride;
+    std::vector<double> partialSums(m_nThreads * clusterSize, 0);
+    std::vector<std::size_t> partialCounts(m_nThreads * m_nClusters, 0);
+    auto accumulateSamples = [&](std::size_t begin, std::size_t end, unsigned thread) {
+        double* sums = partialSums.data() + thread * clusterSize;
+        std::size_t* counts = partialCounts.data() + thread * m_nClusters;
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const double* row = dataset.Row(i);
+            double* sum = sums + labels[i] * stride;
+            for (std::size_t f = 0; f < stride; f++)
+            {
+                sum[f] += row[f];
+            }
+            counts[labels[i]]++;
+        }
+    };
+    ParallelFor(dataset.nSamples, m_nThreads, accumulateSamples);
+    std::vector<double> sums(clusterSize, 0);
+    std::vector<std::size_t> counts(m_nClusters, 0);
+    for (unsigned thread = 0; thread < m_nThreads; thread++)
+    {
+        for (std::size_t v = 0; v < clusterSize; v++)
+        {
+            sums[v] += partialSums[thread * clusterSize + v];
+        }
+        for (uint32_t c = 0; c < m_nClusters; c++)
+        {
+            counts[c] += partialCounts[thread * m_nClusters + c];
+        }
+    }
+
+    // Empty clusters: moved to the samples farthest from their centers (labels kept)
+    std::vector<uint32_t> empty;
+    for (uint32_t c = 0; c < m_nClusters; c++)
+    {
+        if (counts[c] == 0)
+        {
+            empty.push_back(c);
+        }
+    }
+    if (!empty.empty())
+    {
+        std::vector<std::size_t> order(dataset.nSamples);
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<double> distances(dataset.nSamples);
+        for (std::size_t i = 0; i < dataset.nSamples; i++)
+        {
+            distances[i] = SquaredDistance(dataset.Row(i), &centers[labels[i] * stride], stride);
+        }
+        std::partial_sort(order.begin(),
+                          order.begin() + empty.size(),
+                          order.end(),
+                          [&](std::size_t a, std::size_t b) {
+                              return distances[a] > distances[b] ||
+                                     (distances[a] == distances[b] && a < b);
+                          });
+        for (std::size_t e = 0; e < empty.size(); e++)
+        {
+            const double* row = dataset.Row(order[e]);
+            int32_t old = labels[order[e]];
+            for (std::size_t f = 0; f < stride; f++)
+            {
+                sums[old * stride + f] -= row[f];
+                sums[empty[e] * stride + f] = row[f];
+            }
+            counts[old]--;
+            counts[empty[e]] = 1;
+        }
+    }
+
+    std::vector<double> shifts(m_nClusters, 0);
+    for (uint32_t c = 0; c < m_nClusters; c++)
+    {
+        double* center = &centers[c * stride];
+        std::vector<double> previous(center, center + stride);
+        for (std::size_t f = 0; f < stride && counts[c] > 0; f++)
+        {
+            center[f] = sums[c * stride + f] / counts[c];
+        }
+        shifts[c] = std::sqrt(SquaredDistance(center, previous.data(), stride));
+    }
+    return shifts;
+}
+
+double
+KMeans::Inertia(const Dataset& dataset,
+                const std::vector<int32_t>& labels,
+                const std::vector<double>& centers) const
+{
+    std::vector<double> partial(m_nThreads, 0);
+    std::size_t stride = dataset.stride;
+    ParallelFor(dataset.nSamples, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned t) {
+        double sum = 0;
+        for (std::size_t i = begin; i < end; i++)
+        {
+            sum += SquaredDistance(dataset.Row(i), &centers[labels[i] * stride], stride);
+        }
+        partial[t] = sum;
+    });
+    return std::accumulate(partial.begin(), partial.end(), 0.0);
+}
+
+KMeans::Result
+KMeans::Run(const Dataset& dataset, std::vector<double> centers, double tol) const
+{
+    std::size_t n = dataset.nSamples;
+    std::size_t stride = dataset.stride;
+    uint32_t k = m_nClusters;
+    auto distance = [&](std::size_t i, uint32_t c) {
+        return SquaredDistance(dataset.Row(i), &centers[c * stride], stride);
+    };
+
+    Result result;
+    result.labels.assign(n, -1);
+    std::vector<int32_t>& labels = result.labels;
+    // Bounds (Euclidean distances): upper to the own center, lower to the others
+    std::vector<double> upper(m_algorithm == LLOYD ? 0 : n);
+    std::vector<double> lower(m_algorithm == ELKAN ? n * k : (m_algorithm == HAMERLY ? n : 0), 0);
+    std::vector<double> halfDistances(k * k); //!< half distances between the centers
+    std::vector<double> nextHalfDistance(k);  //!< half distance to the closest other center
+    std::vector<std::size_t> partialChanges(m_nThreads);
+    bool strict = false;
+
+    uint32_t iter = 0;
+    for (; iter < m_maxIter; iter++)
+    {
+        if (m_algorithm != LLOYD)
+        {
+            for (uint32_t a = 0; a < k; a++)
+            {
+                nextHalfDistance[a] = std::numeric_limits<double>::infinity();
+                for (uint32_t b = 0; b < k; b++)
+                {
+                    double half = std::sqrt(SquaredDistance(&centers[a * stride],
+                                                            &centers[b * stride],
+                                                            stride)) /
+                                  2;
+                    halfDistances[a * k + b] = half;
+                    nextHalfDistance[a] = b != a ? std::min(nextHalfDistance[a], half)
+                                                 : nextHalfDistance[a];
+                }
+            }
+        }
+
+        // Assignment: every distance in the first iteration and with Lloyd, pruned afterwards
+        ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned thread) {
+            std::size_t changes = 0;
+            for (std::size_t i = begin; i < end; i++)
+            {
+                int32_t label = labels[i];
+                if (m_algorithm == LLOYD || iter == 0)
+                {
+                    uint32_t best = 0;
+                    double bestDistance = distance(i, 0);
+                    double secondDistance = std::numeric_limits<double>::infinity();
+                    if (m_algorithm == ELKAN)
+                    {
+                        lower[i * k] = std::sqrt(bestDistance);
+                    }
+                    for (uint32_t c = 1; c < k; c++)
+                    {
+                        double d = distance(i, c);
+                        if (d < bestDistance)
+                        {
+                            secondDistance = bestDistance;
+                            best = c;
+                            bestDistance = d;
+                        }
+                        else
+                        {
+                            secondDistance = std::min(secondDistance, d);
+                        }
+                        if (m_algorithm == ELKAN)
+                        {
+                            lower[i * k + c] = std::sqrt(d);
+                        }
+                    }
+                    if (m_algorithm == HAMERLY)
+                    {
+                        lower[i] = std::sqrt(secondDistance);
+                    }
+                    if (m_algorithm != LLOYD)
+                    {
+                        upper[i] = std::sqrt(bestDistance);
+                    }
+                    label = best;
+                }
+                else if (m_algorithm == ELKAN)
+                {
+                    double u = upper[i];
+                    bool tight = false;
+                    double* l = &lower[i * k];
+                    if (u <= nextHalfDistance[label])
+                    {
+                        continue;
+                    }
+                    for (uint32_t c = 0; c < k; c++)
+                    {
+                        if (static_cast<int32_t>(c) == label || u <= l[c] ||
+                            u <= halfDistances[label * k + c])
+                        {
+                            continue;
+                        }
+                        if (!tight)
+                        {
+                            u = std::sqrt(distance(i, label));
+                            l[label] = u;
+                            tight = true;
+                            if (u <= l[c] || u <= halfDistances[label * k + c])
+                            {
+                                continue;
+                            }
+                        }
+                        double d = std::sqrt(distance(i, c));
+                        l[c] = d;
+                        if (d < u)
+                        {
+                            label = c;
+                            u = d;
+                        }
+                    }
+                    upper[i] = u;
+                }
+                else
+                {
+                    double bound = std::max(nextHalfDistance[label], lower[i]);
+                    if (upper[i] <= bound)
+                    {
+                        continue;
+                    }
+                    upper[i] = std::sqrt(distance(i, label));
+                    if (upper[i] <= bound)
+                    {
+                        continue;
+                    }
+                    double bestDistance = std::numeric_limits<double>::infinity();
+                    double secondDistance = bestDistance;
+                    for (uint32_t c = 0; c < k; c++)
+                    {
+                        double d = distance(i, c);
+                        if (d < bestDistance)
+                        {
+                            secondDistance = bestDistance;
+                            label = c;
+                            bestDistance = d;
+                        }
+                        else
+                        {
+                            secondDistance = std::min(secondDistance, d);
+                        }
+                    }
+                    upper[i] = std::sqrt(bestDistance);
+                    lower[i] = std::sqrt(secondDistance);
+                }
+                changes += label != labels[i];
+                labels[i] = label;
+            }
+            partialChanges[thread] = changes;
+        });
+        std::size_t changes = std::accumulate(partialChanges.begin(), partialChanges.end(), 0UL);
+
+        std::vector<double> shifts = UpdateCenters(dataset, labels, centers);
+        if (m_algorithm == ELKAN)
+        {
+            ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    upper[i] += shifts[labels[i]];
+                    for (uint32_t c = 0; c < k; c++)
+                    {
+                        lower[i * k + c] = std::max(lower[i * k + c] - shifts[c], 0.0);
+                    }
+                }
+            });
+        }
+        else if (m_algorithm == HAMERLY)
+        {
+            // Largest shift of the other centers: the second largest for the center that moved most
+            uint32_t largest = std::max_element(shifts.begin(), shifts.end()) - shifts.begin();
+            double second = 0;
+            for (uint32_t c = 0; c < k; c++)
+            {
+                second = c != largest ? std::max(second, shifts[c]) : second;
+            }
+            ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned) {
+                for (std::size_t i = begin; i < end; i++)
+                {
+                    upper[i] += shifts[labels[i]];
+                    bool isLargest = static_cast<uint32_t>(labels[i]) == largest;
+                    lower[i] -= isLargest ? second : shifts[largest];
+                }
+            });
+        }
+
+        if (changes == 0)
+        {
+            strict = true;
+            break;
+        }
+        double shiftSquared = 0;
+        for (double shift : shifts)
+        {
+            shiftSquared += shift * shift;
+        }
+        if (shiftSquared <= tol)
+        {
+            break;
+        }
+    }
+    result.nIter = std::min(iter + 1, m_maxIter);
+
+    // Without strict convergence, the labels of the last centers
+    if (!strict)
+    {
+        ParallelFor(n, m_nThreads, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                int32_t best = 0;
+                double bestDistance = distance(i, 0);
+                for (uint32_t c = 1; c < k; c++)
+                {
+                    double d = distance(i, c);
+                    if (d < bestDistance)
+                    {
+                        best = c;
+                        bestDistance = d;
+                    }
+                }
+                labels[i] = best;
+            }
+        });
+    }
+    result.inertia = Inertia(dataset, labels, centers);
+    result.centers = std::move(centers);
+    return result;
+}
+
+} // namespace ml
@@ -0,0 +1,131 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef KMEANS_H
+#define KMEANS_H
+
+#include "csv-dataset.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief K-means with the semantics of scikit-learn KMeans
+ *
+ * Every one of the nInit runs starts from a greedy k-means++ seeding (2 + ln(k) candidates
+ * per center) and iterates until the labels do not change, the squared center shift falls
+ * below tol times the mean variance of the features, or maxIter; a run that did not converge
+ * strictly relabels the samples with its last centers. Empty clusters are moved to the samples
+ * farthest from their centers. The run with the lowest inertia is kept.
+ *
+ * The assignment step is Lloyd (every distance), Elkan (a lower bound per sample and center)
+ * or Hamerly (one lower bound per sample); the bounds skip the distances that can not change a
+ * label, so the three give the same labels. The samples are split among the threads in fixed
+ * chunks, and the partial sums reduced in order, so a seed gives the same result every run.
+ */
+class KMeans
+{
+  public:
+    /// Assignment step
+    enum Algorithm
+    {
+        LLOYD,
+        ELKAN,
+        HAMERLY
+    };
+
+    /// Result of a fit
+    struct Result
+    {
+        std::vector<int32_t> labels;
+        std::vector<double> centers; //!< nClusters x stride
+        double inertia{0};           //!< sum of squared distances to the centers
+        uint32_t nIter{0};           //!< iterations of the kept run
+    };
+
+    /**
+     * \param nClusters number of clusters
+     * \param nInit number of runs with different seedings
+     * \param maxIter maximum number of iterations of a run
+     * \param tol relative tolerance of the center shift
+     * \param algorithm assignment step
+     * \param seed seed of the k-means++ seedings
+     * \param nThreads number of threads
+     */
+    KMeans(uint32_t nClusters,
+           uint32_t nInit,
+           uint32_t maxIter,
+           double tol,
+           Algorithm algorithm,
+           uint64_t seed,
+           unsigned nThreads);
+
+    /**
+     * \param dataset samples (scaled)
+     * \return the result of the run with the lowest inertia
+     */
+    Result Fit(const Dataset& dataset) const;
+
+    /**
+     * \param name lloyd, elkan or hamerly
+     * \return the algorithm
+     */
+    static Algorithm ParseAlgorithm(const std::string& name);
+
+  private:
+    /**
+     * \param dataset samples
+     * \param rng random number generator
+     * \return the k-means++ centers
+     */
+    std::vector<double> Seed(const Dataset& dataset, std::mt19937_64& rng) const;
+
+    /**
+     * \param dataset samples
+     * \param centers initial centers
+     * \param tol absolute tolerance of the squared center shift
+     * \return the result of the run
+     */
+    Result Run(const Dataset& dataset, std::vector<double> centers, double tol) const;
+
+    /**
+     * \brief Move the centers to the mean of their samples
+     * \param dataset samples
+     * \param labels label of every sample
+     * \param centers centers, updated
+     * \return the shift (distance) of every center
+     */
+    std::vector<double> UpdateCenters(const Dataset& dataset,
+                                      const std::vector<int32_t>& labels,
+                                      std::vector<double>& centers) const;
+
+    /**
+     * \param dataset samples
+     * \param labels label of every sample
+     * \param centers centers
+     * \return the inertia
+     */
+    double Inertia(const Dataset& dataset,
+                   const std::vector<int32_t>& labels,
+                   const std::vector<double>& centers) const;
+
+    uint32_t m_nClusters;
+    uint32_t m_nInit;
+    uint32_t m_maxIter;
+    double m_tol;
+    Algorithm m_algorithm;
+    uint64_t m_seed;
+    unsigned m_nThreads;
+};
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,190 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+// DBSCAN on the stats files, as DBSCAN_AP.py / DBSCAN_STA.py, without pandas and scikit-learn
+// and without storing the neighbourhoods. DBSCAN_STA.py clusters the scaled features (eps
+// 0.121); DBSCAN_AP.py clusters the features as read (eps 0.115, --scale=false).
+//
+// Build:
+//   g++ -O3 -march=native -std=c++17 -pthread -o native-dbscan native-dbscan.cc dbscan.cc
+//       kd-tree.cc csv-dataset.cc cluster-labels.cc
+//
+// Examples:
+//   ./native-dbscan --input=Scenarios-APStats.csv --eps=0.115 --minSamples=7 --scale=false
+//   ./native-dbscan --input=Scenarios-STAStats.csv --eps=0.121 --minSamples=7
+//       --kdistance=Scenarios-STAStats-EPS.csv --labels=Scenarios-STAStats-DBSCAN.csv
+//       --partitions=4
+
+#include "cluster-labels.h"
+#include "csv-dataset.h"
+#include "dbscan.h"
+#include "kd-tree.h"
+#include "parallel-for.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace ml;
+
+namespace
+{
+/// Samples of a block of the parallel k-distance queries
+constexpr std::size_t QUERY_BLOCK = 256;
+
+/**
+ * \brief Parse the --name=value arguments
+ * \param argc number of arguments
+ * \param argv arguments
+ * \param values default values, overwritten by the arguments
+ */
+void
+ParseArguments(int argc, char* argv[], std::map<std::string, std::string>& values)
+{
+    for (int a = 1; a < argc; a++)
+    {
+        std::string argument = argv[a];
+        std::size_t equal = argument.find('=');
+        std::string name = argument.substr(2, equal == std::string::npos ? equal : equal - 2);
+        if (argument.rfind("--", 0) != 0 || values.find(name) == values.end())
+        {
+            std::cerr << "Usage: " << argv[0];
+            for (const auto& [option, value] : values)
+            {
+                std::cerr << " [--" << option << "=" << value << "]";
+            }
+            std::cerr << std::endl;
+            throw std::runtime_error("Invalid argument " + argument);
+        }
+        values[name] = equal == std::string::npos ? "true" : argument.substr(equal + 1);
+    }
+}
+
+/**
+ * \brief Write the sorted distance of every sample to its k-th neighbour (the EPS graphic)
+ * \param tree k-d tree of the samples
+ * \param k neighbour (the sample itself is the 0th, as distances[:, k] of the scripts)
+ * \param nThreads number of threads
+ * \param filename output file
+ */
+void
+WriteKDistance(const KdTree& tree, std::size_t k, unsigned nThreads, const std::string& filename)
+{
+    const Dataset& points = tree.GetPoints();
+    if (k >= points.nSamples)
+    {
+        throw std::runtime_error("kneighbor must be lower than the number of samples");
+    }
+    std::vector<double> distances(points.nSamples);
+    auto query = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t p = begin; p < end; p++)
+        {
+            distances[p] = tree.NearestDistances(points.Row(p), k + 1)[k];
+        }
+    };
+    ParallelForDynamic(points.nSamples, QUERY_BLOCK, nThreads, query);
+    std::sort(distances.begin(), distances.end());
+
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("Can not open " + filename);
+    }
+    file.precision(17);
+    file << "index,distance\n";
+    for (std::size_t i = 0; i < distances.size(); i++)
+    {
+        file << i << "," << distances[i] << "\n";
+    }
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::map<std::string, std::string> options = {
+        {"input", "Scenarios-APStats.csv"},
+        {"device", ""},
+        {"features", "avgthroughput,avgrxpackets,snr,avgtotaljitter,avgtotaldelay,avgtxpackets"},
+        {"scale", "true"},
+        {"eps", "0.115"},
+        {"minSamples", "7"},
+        {"leafSize", "30"},
+        {"threads", std::to_string(std::max(1U, std::thread::hardware_concurrency()))},
+        {"kdistance", ""},
+        {"kneighbor", "1"},
+        {"partitions", "0"},
+        {"labels", ""},
+        {"scaled", ""}};
+
+    try
+    {
+        ParseArguments(argc, argv, options);
+        Dataset dataset =
+            LoadCsv(options["input"], SplitList(options["features"]), options["device"]);
+        if (options["scale"] != "false" && options["scale"] != "0")
+        {
+            MinMaxScale(dataset);
+        }
+        std::cout << "Samples: " << dataset.nSamples << ", features: " << dataset.features.size()
+                  << ", kernel: " << SIMD_KERNEL << ", threads: " << options["threads"]
+                  << std::endl;
+        if (!options["scaled"].empty())
+        {
+            WriteCsv(dataset, options["scaled"]);
+        }
+        unsigned threads = std::stoul(options["threads"]);
+
+        auto start = std::chrono::steady_clock::now();
+        KdTree tree(std::move(dataset), std::stoul(options["leafSize"]));
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout.precision(8);
+        std::cout << "Tree: " << elapsed.count() << " s" << std::endl;
+
+        // EPS parameter analysis: distance to the k-th neighbour
+        if (!options["kdistance"].empty())
+        {
+            WriteKDistance(tree, std::stoul(options["kneighbor"]), threads, options["kdistance"]);
+        }
+
+        Dbscan dbscan(std::stod(options["eps"]), std::stoul(options["minSamples"]), threads);
+        start = std::chrono::steady_clock::now();
+        Dbscan::Result result = dbscan.Fit(tree);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Clusters: " << result.nClusters << ", core samples: " << result.nCore
+                  << ", noise: " << result.nNoise << ", fit: " << elapsed.count() << " s"
+                  << std::endl;
+
+        std::vector<int32_t> reordered;
+        uint32_t partitions = std::stoul(options["partitions"]);
+        if (partitions > 0)
+        {
+            reordered = ReorderLabels(result.labels, partitions);
+        }
+        std::cout << "Cluster sizes:" << std::endl;
+        for (const auto& [label, size] :
+             ClusterSizes(reordered.empty() ? result.labels : reordered))
+        {
+            std::cout << "  " << label << ": " << size << std::endl;
+        }
+        if (!options["labels"].empty())
+        {
+            WriteLabels(options["labels"], result.labels, reordered);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
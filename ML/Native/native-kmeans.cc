@@ -0,0 +1,153 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+// K-means on the stats files, as KMEANS_AP.py / KMEANS_STA.py (MinMax scaling, k-means++,
+// nInit runs, best inertia) without pandas and scikit-learn.
+//
+// Build:
+//   g++ -O3 -march=native -std=c++17 -pthread -o native-kmeans native-kmeans.cc kmeans.cc
+//       csv-dataset.cc cluster-labels.cc
+//
+// Examples:
+//   ./native-kmeans --input=Scenarios-APStats.csv --k=4 --nInit=100 --maxIter=100
+//   ./native-kmeans --input=Scenario3-DeviceStats.csv --device=STA --k=4 --nInit=10
+//       --labels=Scenario3-KMeans-Labels.csv --partitions=4
+
+#include "cluster-labels.h"
+#include "csv-dataset.h"
+#include "kmeans.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace ml;
+
+namespace
+{
+/**
+ * \brief Parse the --name=value arguments
+ * \param argc number of arguments
+ * \param argv arguments
+ * \param values default values, overwritten by the arguments
+ */
+void
+ParseArguments(int argc, char* argv[], std::map<std::string, std::string>& values)
+{
+    for (int a = 1; a < argc; a++)
+    {
+        std::string argument = argv[a];
+        std::size_t equal = argument.find('=');
+        std::string name = argument.substr(2, equal == std::string::npos ? equal : equal - 2);
+        if (argument.rfind("--", 0) != 0 || values.find(name) == values.end())
+        {
+            std::cerr << "Usage: " << argv[0];
+            for (const auto& [option, value] : values)
+            {
+                std::cerr << " [--" << option << "=" << value << "]";
+            }
+            std::cerr << std::endl;
+            throw std::runtime_error("Invalid argument " + argument);
+        }
+        values[name] = equal == std::string::npos ? "true" : argument.substr(equal + 1);
+    }
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    std::map<std::string, std::string> options = {
+        {"input", "Scenarios-APStats.csv"},
+        {"device", ""},
+        {"features", "avgthroughput,avgrxpackets,snr,avgtotaljitter,avgtotaldelay,avgtxpackets"},
+        {"k", "4"},
+        {"nInit", "100"},
+        {"maxIter", "100"},
+        {"tol", "1e-4"},
+        {"algorithm", "elkan"},
+        {"seed", "1"},
+        {"threads", std::to_string(std::max(1U, std::thread::hardware_concurrency()))},
+        {"elbow", "0"},
+        {"partitions", "0"},
+        {"labels", ""},
+        {"scaled", ""}};
+
+    try
+    {
+        ParseArguments(argc, argv, options);
+        Dataset dataset =
+            LoadCsv(options["input"], SplitList(options["features"]), options["device"]);
+        MinMaxScale(dataset);
+        std::cout << "Samples: " << dataset.nSamples << ", features: " << dataset.features.size()
+                  << ", kernel: " << SIMD_KERNEL << ", threads: " << options["threads"]
+                  << std::endl;
+        if (!options["scaled"].empty())
+        {
+            WriteCsv(dataset, options["scaled"]);
+        }
+
+        uint32_t nInit = std::stoul(options["nInit"]);
+        uint32_t maxIter = std::stoul(options["maxIter"]);
+        double tol = std::stod(options["tol"]);
+        KMeans::Algorithm algorithm = KMeans::ParseAlgorithm(options["algorithm"]);
+        uint64_t seed = std::stoull(options["seed"]);
+        unsigned threads = std::stoul(options["threads"]);
+
+        // K parameter analysis: score (-inertia) of every k, as the elbow curve
+        for (uint32_t k = 1; k <= std::stoul(options["elbow"]); k++)
+        {
+            KMeans kmeans(k, nInit, maxIter, tol, algorithm, seed, threads);
+            std::cout << "k=" << k << " score " << -kmeans.Fit(dataset).inertia << std::endl;
+        }
+
+        KMeans kmeans(std::stoul(options["k"]), nInit, maxIter, tol, algorithm, seed, threads);
+        auto start = std::chrono::steady_clock::now();
+        KMeans::Result result = kmeans.Fit(dataset);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout.precision(8);
+        std::cout << "Inertia: " << result.inertia << ", iterations: " << result.nIter
+                  << ", fit: " << elapsed.count() << " s" << std::endl;
+        std::cout << "Centroids:" << std::endl;
+        for (uint32_t c = 0; c < result.centers.size() / dataset.stride; c++)
+        {
+            std::cout << " ";
+            for (std::size_t f = 0; f < dataset.features.size(); f++)
+            {
+                std::cout << " " << result.centers[c * dataset.stride + f];
+            }
+            std::cout << std::endl;
+        }
+
+        std::vector<int32_t> reordered;
+        uint32_t partitions = std::stoul(options["partitions"]);
+        if (partitions > 0)
+        {
+            reordered = ReorderLabels(result.labels, partitions);
+        }
+        std::cout << "Cluster sizes:" << std::endl;
+        for (const auto& [label, size] :
+             ClusterSizes(reordered.empty() ? result.labels : reordered))
+        {
+            std::cout << "  " << label << ": " << size << std::endl;
+        }
+        if (!options["labels"].empty())
+        {
+            WriteLabels(options["labels"], result.labels, reordered);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
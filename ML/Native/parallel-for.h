@@ -0,0 +1,79 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ml
+{
+
+/**
+ * \brief Split [0, n) in contiguous chunks, one per thread
+ *
+ * The chunks are fixed by n and nThreads, so per-thread partial results reduced in thread
+ * order give the same result on every run.
+ *
+ * \param n number of items
+ * \param nThreads number of threads (the caller runs the last chunk)
+ * \param body callable body(begin, end, thread)
+ */
+template <typename Body>
+void
+ParallelFor(std::size_t n, unsigned nThreads, Body&& body)
+{
+    nThreads = std::max(1U, std::min<unsigned>(nThreads, n));
+    if (nThreads == 1)
+    {
+        body(std::size_t{0}, n, 0U);
+        return;
+    }
+    std::size_t chunk = (n + nThreads - 1) / nThreads;
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads - 1);
+    for (unsigned t = 0; t + 1 < nThreads; t++)
+    {
+        threads.emplace_back(body, t * chunk, std::min(n, (t + 1) * chunk), t);
+    }
+    body(std::min(n, (nThreads - 1) * chunk), n, nThreads - 1);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * \brief Split [0, n) in blocks that the threads take as they become free
+ *
+ * For items of uneven cost. The blocks a thread runs change from run to run, so the body must
+ * give the same result whatever thread runs a block.
+ *
+ * \param n number of items
+ * \param block number of items of a block
+ * \param nThreads number of threads
+ * \param body callable body(begin, end)
+ */
+template <typename Body>
+void
+ParallelForDynamic(std::size_t n, std::size_t block, unsigned nThreads, Body&& body)
+{
+    std::atomic<std::size_t> next{0};
+    ParallelFor(nThreads, nThreads, [&](std::size_t, std::size_t, unsigned) {
+        for (std::size_t begin = next.fetch_add(block); begin < n; begin = next.fetch_add(block))
+        {
+            body(begin, std::min(n, begin + block));
+        }
+    });
+}
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,74 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+// Copyright (c) 2022, scikit-learn developers
+// Distributed under the BSD 3-Clause License.
+// See https://scikit-learn.org/stable/licence.html for more information.
+
+#ifndef SIMD_DISTANCE_H
+#define SIMD_DISTANCE_H
+
+#include <cstddef>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ml
+{
+
+/// Rows are padded to a multiple of this number of doubles (a 512-bit register)
+constexpr std::size_t SIMD_LANES = 8;
+
+/// Name of the distance kernel compiled in
+#if defined(__AVX512F__)
+constexpr const char* SIMD_KERNEL = "AVX-512";
+#elif defined(__AVX2__)
+constexpr const char* SIMD_KERNEL = "AVX2";
+#else
+constexpr const char* SIMD_KERNEL = "scalar";
+#endif
+
+/**
+ * \param a first row
+ * \param b second row
+ * \param stride doubles per row (multiple of SIMD_LANES)
+ * \return the squared Euclidean distance between the rows
+ */
+inline double
+SquaredDistance(const double* a, const double* b, std::size_t stride)
+{
+#if defined(__AVX512F__)
+    __m512d sum = _mm512_setzero_pd();
+    for (std::size_t i = 0; i < stride; i += 8)
+    {
+        __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+        sum = _mm512_fmadd_pd(diff, diff, sum);
+    }
+    return _mm512_reduce_add_pd(sum);
+#elif defined(__AVX2__)
+    __m256d sum = _mm256_setzero_pd();
+    for (std::size_t i = 0; i < stride; i += 4)
+    {
+        __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+#if defined(__FMA__)
+        sum = _mm256_fmadd_pd(diff, diff, sum);
+#else
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(diff, diff));
+#endif
+    }
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#else
+    double sum = 0;
+    for (std::size_t i = 0; i < stride; i++)
+    {
+        double diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+#endif
+}
+
+} // namespace ml
+
+#endif
@@ -0,0 +1,346 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ampdu-stats.h"
+
+#include <ns3/abort.h>
+#include <ns3/he-configuration.h>
+#include <ns3/log.h>
+#include <ns3/qos-utils.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-psdu.h>
+#include <ns3/wifi-tx-timer.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AmpduStats");
+
+NS_OBJECT_ENSURE_REGISTERED(AmpduStats);
+
+namespace
+{
+/**
+ * \param value a value
+ * \param nBins number of bins
+ * \return the log2 bin of the value: 0 for 0 and 1, 1 for 2-3, 2 for 4-7... (last bin open)
+ */
+uint32_t
+GetLog2Bin(uint64_t value, uint32_t nBins)
+{
+    uint32_t bin = 0;
+    while (value > 1 && bin < nBins - 1)
+    {
+        value >>= 1;
+        bin++;
+    }
+    return bin;
+}
+} // namespace
+
+AmpduStats::AmpduStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AmpduStats::~AmpduStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+AmpduStats::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::AmpduStats").SetParent<Object>().AddConstructor<AmpduStats>();
+    return tid;
+}
+
+void
+AmpduStats::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_links.clear();
+    m_settings.clear();
+    m_inFlight.clear();
+    m_psdus.clear();
+    Object::DoDispose();
+}
+
+void
+AmpduStats::AddBss(const std::string& label,
+                   const NetDeviceContainer& apDevices,
+                   const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            Ptr<WifiMac> mac = device->GetMac();
+            uint32_t index = m_devices.size();
+            m_devices.push_back({label, isAp});
+            if (isAp && m_settings.find(label) == m_settings.end())
+            {
+                Ptr<HeConfiguration> heConfiguration = device->GetHeConfiguration();
+                m_settings[label] = {
+                    static_cast<uint16_t>(heConfiguration ? heConfiguration->GetMpduBufferSize()
+                                                          : 64),
+                    mac->GetMaxAmpduSize(AC_BE)};
+            }
+
+            for (uint8_t phyId = 0; phyId < device->GetNPhys(); phyId++)
+            {
+                Ptr<WifiPhy> phy = device->GetPhy(phyId);
+                phy->TraceConnectWithoutContext(
+                    "PhyTxPsduBegin",
+                    MakeCallback(&AmpduStats::NotifyTx, this).Bind(index, phy));
+            }
+            mac->TraceConnectWithoutContext("AckedMpdu",
+                                            MakeCallback(&AmpduStats::NotifyAcked, this));
+            mac->TraceConnectWithoutContext("NAckedMpdu",
+                                            MakeCallback(&AmpduStats::NotifyNAcked, this));
+            mac->TraceConnectWithoutContext("DroppedMpdu",
+                                            MakeCallback(&AmpduStats::NotifyDropped, this));
+            mac->TraceConnectWithoutContext("PsduResponseTimeout",
+                                            MakeCallback(&AmpduStats::NotifyPsduTimeout, this));
+            mac->TraceConnectWithoutContext(
+                "PsduMapResponseTimeout",
+                MakeCallback(&AmpduStats::NotifyPsduMapTimeout, this));
+        }
+    }
+}
+
+void
+AmpduStats::SetWindow(Time start, Time end)
+{
+    m_start = start;
+    m_end = end;
+}
+
+void
+AmpduStats::NotifyTx(uint32_t deviceIndex,
+                     Ptr<WifiPhy> phy,
+                     WifiConstPsduMap psduMap,
+                     WifiTxVector txVector,
+                     double txPowerW)
+{
+    Time now = Simulator::Now();
+    if (now < m_start || now > m_end)
+    {
+        return;
+    }
+    const Device& tx = m_devices[deviceIndex];
+    Direction& direction = m_links[{tx.bss, phy->GetFrequency()}][tx.isAp ? 0 : 1];
+    Time duration = WifiPhy::CalculateTxDuration(psduMap, txVector, phy->GetPhyBand());
+
+    // Every PSDU of a MU PPDU is an A-MPDU of its own, lasting the whole PPDU
+    for (const auto& [staId, psdu] : psduMap)
+    {
+        if (!psdu->GetHeader(0).IsQosData())
+        {
+            continue;
+        }
+        direction.psdus++;
+        direction.mpdus += psdu->GetNMpdus();
+        direction.durationSum += duration.GetSeconds();
+        direction.length[GetLog2Bin(psdu->GetNMpdus(), N_LENGTH_BINS)]++;
+        direction.duration[GetLog2Bin(duration.GetMicroSeconds(), N_DURATION_BINS)]++;
+
+        uint64_t psduId = m_nextPsdu++;
+        m_psdus[psduId] = {&direction, static_cast<uint16_t>(psdu->GetNMpdus()), 0, 0};
+        for (const auto& mpdu : *psdu)
+        {
+            // A retransmitted MPDU failed in its previous PSDU
+            const WifiMpdu* original = PeekPointer(mpdu->GetOriginal());
+            Resolve(original, false);
+            m_inFlight[original] = psduId;
+        }
+    }
+}
+
+void
+AmpduStats::Resolve(const WifiMpdu* mpdu, bool acked)
+{
+    auto it = m_inFlight.find(mpdu);
+    if (it == m_inFlight.end())
+    {
+        return;
+    }
+    auto psduIt = m_psdus.find(it->second);
+    m_inFlight.erase(it);
+    Psdu& psdu = psduIt->second;
+    if (acked)
+    {
+        psdu.acked++;
+        psdu.direction->ackedMpdus++;
+        psdu.direction->ackedBytes += mpdu->GetSize();
+    }
+    else
+    {
+        psdu.direction->failedMpdus++;
+    }
+    if (++psdu.resolved < psdu.nMpdus)
+    {
+        return;
+    }
+    if (psdu.nMpdus > 1)
+    {
+        psdu.direction->ratio[psdu.acked * (N_RATIO_BINS - 1) / psdu.nMpdus]++;
+    }
+    m_psdus.erase(psduIt);
+}
+
+void
+AmpduStats::ResolveFailed(Ptr<const WifiPsdu> psdu)
+{
+    for (const auto& mpdu : *psdu)
+    {
+        Resolve(PeekPointer(mpdu->GetOriginal()), false);
+    }
+}
+
+void
+AmpduStats::NotifyAcked(Ptr<const WifiMpdu> mpdu)
+{
+    Resolve(PeekPointer(mpdu), true);
+}
+
+void
+AmpduStats::NotifyNAcked(Ptr<const WifiMpdu> mpdu)
+{
+    Resolve(PeekPointer(mpdu), false);
+}
+
+void
+AmpduStats::NotifyDropped(WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu)
+{
+    Resolve(PeekPointer(mpdu), false);
+}
+
+void
+AmpduStats::NotifyPsduTimeout(uint8_t reason,
+                              Ptr<const WifiPsdu> psdu,
+                              const WifiTxVector& txVector)
+{
+    if (reason == WifiTxTimer::WAIT_BLOCK_ACK || reason == WifiTxTimer::WAIT_NORMAL_ACK)
+    {
+        ResolveFailed(psdu);
+    }
+}
+
+void
+AmpduStats::NotifyPsduMapTimeout(uint8_t reason,
+                                 WifiPsduMap* psduMap,
+                                 const std::set<Mac48Address>* missingStations,
+                                 std::size_t nTotalStations)
+{
+    // DL MU PPDU: the PSDUs of the stations whose response is missing
+    for (const auto& [staId, psdu] : *psduMap)
+    {
+        if (missingStations->count(psdu->GetAddr1()))
+        {
+            ResolveFailed(psdu);
+        }
+    }
+}
+
+double
+AmpduStats::GetThroughput(uint64_t bytes) const
+{
+    Time window = std::min(m_end, Simulator::Now()) - m_start;
+    return window.IsStrictlyPositive() ? bytes * 8.0 / window.GetSeconds() / 1e6 : 0;
+}
+
+void
+AmpduStats::WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, BSS, link frequency (MHz), direction (DL/UL), MPDU buffer size, max A-MPDU size
+    // (bytes), PSDUs, MPDUs, mean A-MPDU length (MPDUs), mean PPDU duration (us), acknowledged
+    // MPDUs, failed MPDUs, MPDU success ratio, acknowledged throughput (Mbps)
+    for (const auto& [key, link] : m_links)
+    {
+        auto settings = m_settings.find(key.first);
+        for (uint8_t dir = 0; dir < 2; dir++)
+        {
+            const Direction& direction = link[dir];
+            if (direction.psdus == 0)
+            {
+                continue;
+            }
+            uint64_t resolved = direction.ackedMpdus + direction.failedMpdus;
+            file << seedNumber << "," << runNumber << "," << key.first << "," << key.second << ","
+                 << (dir == 0 ? "DL" : "UL") << ","
+                 << (settings != m_settings.end() ? settings->second.mpduBufferSize : 0) << ","
+                 << (settings != m_settings.end() ? settings->second.maxAmpduSize : 0) << ","
+                 << direction.psdus << "," << direction.mpdus << ","
+                 << static_cast<double>(direction.mpdus) / direction.psdus << ","
+                 << 1e6 * direction.durationSum / direction.psdus << "," << direction.ackedMpdus
+                 << "," << direction.failedMpdus << ","
+                 << (resolved > 0 ? static_cast<double>(direction.ackedMpdus) / resolved : 0)
+                 << "," << GetThroughput(direction.ackedBytes) << "\n";
+        }
+    }
+}
+
+void
+AmpduStats::WriteHistogramCsv(const std::string& filename,
+                              uint32_t seedNumber,
+                              uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, BSS, link frequency (MHz), direction (DL/UL), histogram (Length in MPDUs /
+    // Duration in us / BaRatio), lower bin edge, PSDUs
+    for (const auto& [key, link] : m_links)
+    {
+        for (uint8_t dir = 0; dir < 2; dir++)
+        {
+            const Direction& direction = link[dir];
+            std::string prefix = std::to_string(seedNumber) + "," + std::to_string(runNumber) +
+                                 "," + key.first + "," + std::to_string(key.second) + "," +
+                                 (dir == 0 ? "DL" : "UL");
+            for (uint8_t bin = 0; bin < N_LENGTH_BINS; bin++)
+            {
+                if (direction.length[bin] > 0)
+                {
+                    file << prefix << ",Length," << (1 << bin) << "," << direction.length[bin]
+                         << "\n";
+                }
+            }
+            for (uint8_t bin = 0; bin < N_DURATION_BINS; bin++)
+            {
+                if (direction.duration[bin] > 0)
+                {
+                    file << prefix << ",Duration," << (bin == 0 ? 0 : 1 << bin) << ","
+                         << direction.duration[bin] << "\n";
+                }
+            }
+            for (uint8_t bin = 0; bin < N_RATIO_BINS; bin++)
+            {
+                if (direction.ratio[bin] > 0)
+                {
+                    file << prefix << ",BaRatio," << bin / 10.0 << "," << direction.ratio[bin]
+                         << "\n";
+                }
+            }
+        }
+    }
+}
+
+}
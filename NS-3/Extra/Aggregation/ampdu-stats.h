@@ -0,0 +1,182 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef AMPDU_STATS_H
+#define AMPDU_STATS_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-ppdu.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class WifiMpdu;
+class WifiPhy;
+class WifiPsdu;
+
+/**
+ * \ingroup helper
+ * \brief Aggregation and Block Ack efficiency of every link of the BSSs
+ *
+ * Every PHY of the registered devices is traced, so that the links of an MLD are accounted
+ * separately (a link is told apart by its operating frequency), in the downlink (sent by the
+ * AP) and the uplink. Every QoS data PSDU sent within the measurement window adds its number of
+ * MPDUs and its PPDU duration to log2 histograms. Its MPDUs are then followed until they are
+ * acknowledged, not acknowledged, retransmitted, dropped or their response times out; once all
+ * of them are resolved, the fraction acknowledged (the success ratio of the Block Ack bitmap)
+ * of an A-MPDU goes to a histogram of deciles. The MPDU buffer size and maximum A-MPDU size of
+ * the AP are written with every link, to tune them against the acknowledged throughput.
+ */
+class AmpduStats : public Object
+{
+  public:
+    /// A-MPDU length bins: 1, 2-3, 4-7... MPDUs (last bin open)
+    static constexpr uint8_t N_LENGTH_BINS = 11;
+    /// PPDU duration bins: < 2 us, 2-3 us, 4-7 us... (last bin open)
+    static constexpr uint8_t N_DURATION_BINS = 14;
+    /// Block Ack success ratio bins: [0, 0.1), [0.1, 0.2)... and 1
+    static constexpr uint8_t N_RATIO_BINS = 11;
+
+    AmpduStats();
+    ~AmpduStats() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Trace every link of the devices of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Set the measurement window
+     * \param start first accounted transmission
+     * \param end last accounted transmission
+     */
+    void SetWindow(Time start, Time end);
+
+    /**
+     * \brief Append a line per BSS, link and direction to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+    /**
+     * \brief Append the non-empty histogram bins to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteHistogramCsv(const std::string& filename,
+                           uint32_t seedNumber,
+                           uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// BSS label and operating frequency (MHz) of a link
+    using LinkKey = std::pair<std::string, uint16_t>;
+
+    /// Counters and histograms of a direction of a link
+    struct Direction
+    {
+        uint64_t psdus{0};
+        uint64_t mpdus{0};
+        double durationSum{0}; //!< seconds
+        uint64_t ackedMpdus{0};
+        uint64_t failedMpdus{0};
+        uint64_t ackedBytes{0};
+        std::array<uint64_t, N_LENGTH_BINS> length{};
+        std::array<uint64_t, N_DURATION_BINS> duration{};
+        std::array<uint64_t, N_RATIO_BINS> ratio{};
+    };
+
+    /// Downlink (index 0) and uplink (index 1) of a link
+    using Link = std::array<Direction, 2>;
+
+    /// Aggregation settings of the AP of a BSS
+    struct Settings
+    {
+        uint16_t mpduBufferSize;
+        uint32_t maxAmpduSize; //!< bytes (AC_BE)
+    };
+
+    /// Traced device
+    struct Device
+    {
+        std::string bss;
+        bool isAp;
+    };
+
+    /// PSDU whose MPDUs are not resolved yet
+    struct Psdu
+    {
+        Direction* direction;
+        uint16_t nMpdus;
+        uint16_t acked;
+        uint16_t resolved;
+    };
+
+    void NotifyTx(uint32_t deviceIndex,
+                  Ptr<WifiPhy> phy,
+                  WifiConstPsduMap psduMap,
+                  WifiTxVector txVector,
+                  double txPowerW);
+    void NotifyAcked(Ptr<const WifiMpdu> mpdu);
+    void NotifyNAcked(Ptr<const WifiMpdu> mpdu);
+    void NotifyDropped(WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu);
+    void NotifyPsduTimeout(uint8_t reason,
+                           Ptr<const WifiPsdu> psdu,
+                           const WifiTxVector& txVector);
+    void NotifyPsduMapTimeout(uint8_t reason,
+                              WifiPsduMap* psduMap,
+                              const std::set<Mac48Address>* missingStations,
+                              std::size_t nTotalStations);
+
+    /**
+     * \brief Account the outcome of an MPDU in flight, if followed
+     * \param mpdu original MPDU (not an alias)
+     * \param acked whether the MPDU was acknowledged
+     */
+    void Resolve(const WifiMpdu* mpdu, bool acked);
+
+    /**
+     * \brief Account every MPDU of a PSDU without response as failed
+     * \param psdu PSDU
+     */
+    void ResolveFailed(Ptr<const WifiPsdu> psdu);
+
+    double GetThroughput(uint64_t bytes) const;
+
+    std::vector<Device> m_devices;
+    std::map<LinkKey, Link> m_links;
+    std::map<std::string, Settings> m_settings;
+    std::unordered_map<const WifiMpdu*, uint64_t> m_inFlight; //!< MPDU -> PSDU
+    std::unordered_map<uint64_t, Psdu> m_psdus;
+    uint64_t m_nextPsdu{0};
+    Time m_start;
+    Time m_end{Time::Max()};
+};
+
+};
+#endif
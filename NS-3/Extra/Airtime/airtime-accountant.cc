@@ -0,0 +1,257 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "airtime-accountant.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy-state-helper.h>
+#include <ns3/wifi-phy.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AirtimeAccountant");
+
+NS_OBJECT_ENSURE_REGISTERED(AirtimeAccountant);
+
+AirtimeAccountant::AirtimeAccountant()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AirtimeAccountant::~AirtimeAccountant()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+AirtimeAccountant::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::AirtimeAccountant")
+                            .SetParent<Object>()
+                            .AddConstructor<AirtimeAccountant>()
+                            .AddAttribute("Interval",
+                                          "Time between the samples of the time series",
+                                          TimeValue(MilliSeconds(100)),
+                                          MakeTimeAccessor(&AirtimeAccountant::m_interval),
+                                          MakeTimeChecker());
+    return tid;
+}
+
+void
+AirtimeAccountant::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_phys.clear();
+    m_nodeIndex.clear();
+    m_airtime.clear();
+    if (m_csv.is_open())
+    {
+        m_csv.close();
+    }
+    Object::DoDispose();
+}
+
+void
+AirtimeAccountant::AddBss(const std::string& label,
+                          const NetDeviceContainer& apDevices,
+                          const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    uint32_t bss = m_bssLabels.size();
+    m_bssLabels.push_back(label);
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            uint32_t index = m_devices.size();
+            m_devices.push_back({bss, isAp});
+            m_nodeIndex[device->GetNode()->GetId()] = index;
+            m_airtime.resize(m_airtime.size() + N_COUNTERS, 0);
+
+            for (uint8_t phyId = 0; phyId < device->GetNPhys(); phyId++)
+            {
+                Ptr<WifiPhy> phy = device->GetPhy(phyId);
+                phy->GetState()->TraceConnectWithoutContext(
+                    "State",
+                    MakeCallback(&AirtimeAccountant::NotifyState, this).Bind(m_phys.size()));
+                m_phys.push_back({index, phy, Time()});
+            }
+        }
+    }
+}
+
+void
+AirtimeAccountant::SetWindow(Time start, Time end)
+{
+    m_start = start;
+    m_end = end;
+    Simulator::Schedule(end - Simulator::Now(), &AirtimeAccountant::AccountOpenStates, this, end);
+}
+
+void
+AirtimeAccountant::EnableTimeSeries(const std::string& filename,
+                                    uint32_t seedNumber,
+                                    uint32_t runNumber)
+{
+    NS_LOG_FUNCTION(this << filename);
+    NS_ABORT_MSG_IF(!m_interval.IsStrictlyPositive(), "The airtime samples need an interval");
+    m_csv.open(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!m_csv.is_open(), "Can not open " << filename);
+    m_seedNumber = seedNumber;
+    m_runNumber = runNumber;
+    m_lastSample.assign(m_bssLabels.size(), std::vector<int64_t>(N_BSS_COUNTERS, 0));
+    Simulator::Schedule(m_start + m_interval - Simulator::Now(), &AirtimeAccountant::Sample, this);
+}
+
+void
+AirtimeAccountant::NotifyState(uint32_t phyIndex, Time start, Time duration, WifiPhyState state)
+{
+    Account(phyIndex, start, start + duration, state);
+}
+
+void
+AirtimeAccountant::Account(uint32_t phyIndex, Time start, Time end, WifiPhyState state)
+{
+    Counter counter;
+    switch (state)
+    {
+    case WifiPhyState::TX:
+        counter = TX_COUNTER;
+        break;
+    case WifiPhyState::RX:
+        counter = RX_COUNTER;
+        break;
+    case WifiPhyState::CCA_BUSY:
+        counter = CCA_BUSY_COUNTER;
+        break;
+    case WifiPhyState::IDLE:
+        counter = IDLE_COUNTER;
+        break;
+    default:
+        return;
+    }
+    // Part of the state period within the measurement window not accounted yet (an open period
+    // may have been accounted up to a sample)
+    Phy& phy = m_phys[phyIndex];
+    Time begin = std::max({start, m_start, phy.accountedUntil});
+    end = std::min(end, m_end);
+    if (end > begin)
+    {
+        m_airtime[phy.device * N_COUNTERS + counter] += (end - begin).GetNanoSeconds();
+        phy.accountedUntil = end;
+    }
+}
+
+void
+AirtimeAccountant::AccountOpenStates(Time until)
+{
+    for (uint32_t i = 0; i < m_phys.size(); i++)
+    {
+        // The current state started at the end of the last notified period
+        Account(i, m_phys[i].accountedUntil, until, m_phys[i].phy->GetState()->GetState());
+    }
+}
+
+std::vector<int64_t>
+AirtimeAccountant::GetBssCounters(uint32_t bss) const
+{
+    std::vector<int64_t> counters(N_BSS_COUNTERS, 0);
+    for (uint32_t i = 0; i < m_devices.size(); i++)
+    {
+        if (m_devices[i].bss != bss)
+        {
+            continue;
+        }
+        const int64_t* airtime = &m_airtime[i * N_COUNTERS];
+        counters[BSS_AIRTIME] += airtime[TX_COUNTER];
+        if (m_devices[i].isAp)
+        {
+            counters[AP_TX] += airtime[TX_COUNTER];
+            counters[AP_RX] += airtime[RX_COUNTER];
+            counters[AP_CCA_BUSY] += airtime[CCA_BUSY_COUNTER];
+            counters[AP_IDLE] += airtime[IDLE_COUNTER];
+        }
+    }
+    return counters;
+}
+
+void
+AirtimeAccountant::Sample()
+{
+    AccountOpenStates(Simulator::Now());
+    double interval = m_interval.GetNanoSeconds();
+    for (uint32_t bss = 0; bss < m_bssLabels.size(); bss++)
+    {
+        std::vector<int64_t> counters = GetBssCounters(bss);
+        std::vector<int64_t>& last = m_lastSample[bss];
+        // seed, run, time (s), BSS, BSS airtime, AP RX, AP CCA busy, channel busy (AP not idle)
+        // (fractions of the interval)
+        m_csv << m_seedNumber << "," << m_runNumber << "," << Simulator::Now().GetSeconds()
+              << "," << m_bssLabels[bss] << ","
+              << (counters[BSS_AIRTIME] - last[BSS_AIRTIME]) / interval << ","
+              << (counters[AP_RX] - last[AP_RX]) / interval << ","
+              << (counters[AP_CCA_BUSY] - last[AP_CCA_BUSY]) / interval << ","
+              << (counters[AP_TX] + counters[AP_RX] + counters[AP_CCA_BUSY] - last[AP_TX] -
+                  last[AP_RX] - last[AP_CCA_BUSY]) /
+                     interval
+              << "\n";
+        last = counters;
+    }
+    if (Simulator::Now() + m_interval <= m_end)
+    {
+        Simulator::Schedule(m_interval, &AirtimeAccountant::Sample, this);
+    }
+}
+
+AirtimeAccountant::Occupancy
+AirtimeAccountant::GetDeviceOccupancy(uint32_t nodeId) const
+{
+    Occupancy occupancy;
+    auto it = m_nodeIndex.find(nodeId);
+    double window = (std::min(m_end, Simulator::Now()) - m_start).GetNanoSeconds();
+    if (it == m_nodeIndex.end() || window <= 0)
+    {
+        return occupancy;
+    }
+    const int64_t* counters = &m_airtime[it->second * N_COUNTERS];
+    occupancy.tx = counters[TX_COUNTER] / window;
+    occupancy.rx = counters[RX_COUNTER] / window;
+    occupancy.ccaBusy = counters[CCA_BUSY_COUNTER] / window;
+    occupancy.idle = counters[IDLE_COUNTER] / window;
+    occupancy.busy = occupancy.tx + occupancy.rx + occupancy.ccaBusy;
+    return occupancy;
+}
+
+AirtimeAccountant::Occupancy
+AirtimeAccountant::GetBssOccupancy(uint32_t nodeId) const
+{
+    Occupancy occupancy;
+    auto it = m_nodeIndex.find(nodeId);
+    double window = (std::min(m_end, Simulator::Now()) - m_start).GetNanoSeconds();
+    if (it == m_nodeIndex.end() || window <= 0)
+    {
+        return occupancy;
+    }
+    std::vector<int64_t> counters = GetBssCounters(m_devices[it->second].bss);
+    occupancy.tx = counters[BSS_AIRTIME] / window;
+    occupancy.rx = counters[AP_RX] / window;
+    occupancy.ccaBusy = counters[AP_CCA_BUSY] / window;
+    occupancy.idle = counters[AP_IDLE] / window;
+    occupancy.busy = (counters[AP_TX] + counters[AP_RX] + counters[AP_CCA_BUSY]) / window;
+    return occupancy;
+}
+
+}
@@ -0,0 +1,166 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef AIRTIME_ACCOUNTANT_H
+#define AIRTIME_ACCOUNTANT_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-phy-state.h>
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class WifiPhy;
+
+/**
+ * \ingroup helper
+ * \brief Airtime and channel occupancy of every device and BSS
+ *
+ * The PHY state periods (TX, RX, CCA busy, idle) of the registered devices are added, within
+ * the measurement window, to four flat counters per device (every PHY of a multi-link device
+ * adds to the same counters). The airtime of a BSS is the TX time of all its devices; its
+ * channel occupancy is the time the PHY of its AP is not idle (TX, RX or CCA busy), so that a
+ * frame of a STA of the BSS is only counted once.
+ *
+ * A state period is accounted when it ends; the periods still open at every sample and at the
+ * end of the window are accounted up to that time. The time series samples every Interval, per
+ * BSS, the counters accumulated since the previous sample.
+ */
+class AirtimeAccountant : public Object
+{
+  public:
+    AirtimeAccountant();
+    ~AirtimeAccountant() override;
+    static TypeId GetTypeId();
+
+    /// Fractions of the measurement window in every PHY state
+    struct Occupancy
+    {
+        double tx{0};
+        double rx{0};
+        double ccaBusy{0};
+        double idle{0};
+        double busy{0}; //!< not idle: TX, RX or CCA busy (of the AP for a BSS)
+    };
+
+    /**
+     * \brief Account the PHY states of the devices of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Set the measurement window
+     * \param start start of the accounting
+     * \param end end of the accounting
+     */
+    void SetWindow(Time start, Time end);
+
+    /**
+     * \brief Sample the occupancy of every BSS every Interval of the window to a CSV file
+     * \param filename output file (appended)
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void EnableTimeSeries(const std::string& filename, uint32_t seedNumber, uint32_t runNumber);
+
+    /**
+     * \param nodeId node of the device
+     * \return the occupancy of the device
+     */
+    Occupancy GetDeviceOccupancy(uint32_t nodeId) const;
+
+    /**
+     * \param nodeId node of a device of the BSS
+     * \return the occupancy of the BSS: airtime of all its devices (tx) and PHY states of the AP
+     *         (rx, ccaBusy, idle, busy)
+     */
+    Occupancy GetBssOccupancy(uint32_t nodeId) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Counters of every device, in this order
+    enum Counter
+    {
+        TX_COUNTER = 0,
+        RX_COUNTER,
+        CCA_BUSY_COUNTER,
+        IDLE_COUNTER,
+        N_COUNTERS
+    };
+
+    /// Counters of a BSS, in this order
+    enum BssCounter
+    {
+        BSS_AIRTIME = 0, //!< TX of every device
+        AP_TX,
+        AP_RX,
+        AP_CCA_BUSY,
+        AP_IDLE,
+        N_BSS_COUNTERS
+    };
+
+    /// Accounted device
+    struct Device
+    {
+        uint32_t bss;
+        bool isAp;
+    };
+
+    /// Accounted PHY
+    struct Phy
+    {
+        uint32_t device;
+        Ptr<WifiPhy> phy;
+        Time accountedUntil; //!< end of the last accounted state period
+    };
+
+    void NotifyState(uint32_t phyIndex, Time start, Time duration, WifiPhyState state);
+    void Account(uint32_t phyIndex, Time start, Time end, WifiPhyState state);
+
+    /**
+     * \brief Account the state periods still open
+     * \param until end of the accounting
+     */
+    void AccountOpenStates(Time until);
+    void Sample();
+
+    /**
+     * \param bss BSS index
+     * \return the BssCounter counters of the BSS (ns)
+     */
+    std::vector<int64_t> GetBssCounters(uint32_t bss) const;
+
+    Time m_interval;
+
+    std::vector<std::string> m_bssLabels;
+    std::vector<Device> m_devices;
+    std::vector<Phy> m_phys;
+    std::unordered_map<uint32_t, uint32_t> m_nodeIndex; //!< node ID -> device index
+    std::vector<int64_t> m_airtime; //!< N_COUNTERS counters per device (ns)
+    Time m_start;
+    Time m_end{Time::Max()};
+
+    std::vector<std::vector<int64_t>> m_lastSample; //!< BSS counters at the previous sample
+    std::ofstream m_csv;
+    uint32_t m_seedNumber{0};
+    uint32_t m_runNumber{0};
+};
+
+};
+#endif
@@ -0,0 +1,433 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "multi-wall-propagation-loss-model.h"
+
+#include <ns3/abort.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultiWallPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(MultiWallPropagationLossModel);
+
+namespace
+{
+// Sign of the turn a -> b -> c
+double
+Orientation(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+} // namespace
+
+TypeId
+MultiWallPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultiWallPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<MultiWallPropagationLossModel>()
+            .AddAttribute("WallLoss",
+                          "Penetration loss of the walls added without a loss (dB)",
+                          DoubleValue(5.0),
+                          MakeDoubleAccessor(&MultiWallPropagationLossModel::m_wallLoss),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("FloorLoss",
+                          "Penetration loss of the floors added without a loss (dB)",
+                          DoubleValue(18.3),
+                          MakeDoubleAccessor(&MultiWallPropagationLossModel::m_floorLoss),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("FloorFactorB",
+                          "Empirical parameter b of the floor loss: n floors of loss Lf add "
+                          "Lf * n^((n + 2) / (n + 1) - b)",
+                          DoubleValue(0.46),
+                          MakeDoubleAccessor(&MultiWallPropagationLossModel::m_floorFactorB),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("CellSize",
+                          "Side of the cells of the uniform grid indexing the walls (m)",
+                          DoubleValue(2.0),
+                          MakeDoubleAccessor(&MultiWallPropagationLossModel::m_cellSize),
+                          MakeDoubleChecker<double>(0.1))
+            .AddAttribute("CacheLinks",
+                          "Reuse the loss of a link while neither end moves",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&MultiWallPropagationLossModel::m_cacheLinks),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+MultiWallPropagationLossModel::MultiWallPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MultiWallPropagationLossModel::~MultiWallPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultiWallPropagationLossModel::AddWall(const Vector& start, const Vector& end)
+{
+    AddWall(start, end, m_wallLoss);
+}
+
+void
+MultiWallPropagationLossModel::AddWall(const Vector& start, const Vector& end, double loss)
+{
+    NS_LOG_FUNCTION(this << start << end << loss);
+    m_walls.push_back({start.x, start.y, end.x, end.y, loss});
+    m_gridDirty = true;
+    m_cache.clear();
+}
+
+void
+MultiWallPropagationLossModel::AddFloor(double height)
+{
+    AddFloor(height, m_floorLoss);
+}
+
+void
+MultiWallPropagationLossModel::AddFloor(double height, double loss)
+{
+    NS_LOG_FUNCTION(this << height << loss);
+    m_floors.emplace_back(height, loss);
+    std::sort(m_floors.begin(), m_floors.end());
+    m_cache.clear();
+}
+
+void
+MultiWallPropagationLossModel::LoadBuilding(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ifstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open building description " << filename);
+
+    std::string line;
+    uint64_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+        if (type == "wall")
+        {
+            double x1;
+            double y1;
+            double x2;
+            double y2;
+            double loss;
+            NS_ABORT_MSG_IF(!(iss >> x1 >> y1 >> x2 >> y2),
+                            "Malformed wall in " << filename << ":" << lineNumber);
+            if (!(iss >> loss))
+            {
+                loss = m_wallLoss;
+            }
+            AddWall(Vector(x1, y1, 0), Vector(x2, y2, 0), loss);
+        }
+        else if (type == "floor")
+        {
+            double z;
+            double loss;
+            NS_ABORT_MSG_IF(!(iss >> z), "Malformed floor in " << filename << ":" << lineNumber);
+            if (!(iss >> loss))
+            {
+                loss = m_floorLoss;
+            }
+            AddFloor(z, loss);
+        }
+        else
+        {
+            NS_ABORT_MSG("Unknown building element '" << type << "' in " << filename << ":"
+                                                      << lineNumber);
+        }
+    }
+}
+
+uint32_t
+MultiWallPropagationLossModel::GetNWalls() const
+{
+    return m_walls.size();
+}
+
+uint32_t
+MultiWallPropagationLossModel::GetNFloors() const
+{
+    return m_floors.size();
+}
+
+uint64_t
+MultiWallPropagationLossModel::GetCacheHits() const
+{
+    return m_cacheHits;
+}
+
+uint64_t
+MultiWallPropagationLossModel::GetCacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+void
+MultiWallPropagationLossModel::BuildGrid() const
+{
+    NS_LOG_FUNCTION(this);
+    m_gridDirty = false;
+    m_cells.clear();
+    m_wallStamp.assign(m_walls.size(), 0);
+    m_stamp = 0;
+    if (m_walls.empty())
+    {
+        m_nx = 0;
+        m_ny = 0;
+        return;
+    }
+
+    double xMax = std::numeric_limits<double>::lowest();
+    double yMax = std::numeric_limits<double>::lowest();
+    m_xMin = std::numeric_limits<double>::max();
+    m_yMin = std::numeric_limits<double>::max();
+    for (const auto& wall : m_walls)
+    {
+        m_xMin = std::min({m_xMin, wall.x1, wall.x2});
+        m_yMin = std::min({m_yMin, wall.y1, wall.y2});
+        xMax = std::max({xMax, wall.x1, wall.x2});
+        yMax = std::max({yMax, wall.y1, wall.y2});
+    }
+    m_nx = static_cast<uint32_t>((xMax - m_xMin) / m_cellSize) + 1;
+    m_ny = static_cast<uint32_t>((yMax - m_yMin) / m_cellSize) + 1;
+    m_cells.resize(m_nx * m_ny);
+
+    for (uint32_t i = 0; i < m_walls.size(); i++)
+    {
+        const Wall& wall = m_walls[i];
+        TraverseGrid(wall.x1, wall.y1, wall.x2, wall.y2, [this, i](uint32_t cell) {
+            m_cells[cell].push_back(i);
+        });
+    }
+    NS_LOG_INFO(m_walls.size() << " walls in a " << m_nx << "x" << m_ny << " grid");
+}
+
+template <typename F>
+void
+MultiWallPropagationLossModel::TraverseGrid(double x0,
+                                            double y0,
+                                            double x1,
+                                            double y1,
+                                            F visit) const
+{
+    // Clip the segment to the grid (Liang-Barsky): no wall outside it
+    double xMax = m_xMin + m_nx * m_cellSize;
+    double yMax = m_yMin + m_ny * m_cellSize;
+    double dx = x1 - x0;
+    double dy = y1 - y0;
+    double tEnter = 0;
+    double tExit = 1;
+    for (const auto& [p, q] : {std::make_pair(-dx, x0 - m_xMin),
+                               std::make_pair(dx, xMax - x0),
+                               std::make_pair(-dy, y0 - m_yMin),
+                               std::make_pair(dy, yMax - y0)})
+    {
+        if (p == 0)
+        {
+            if (q < 0)
+            {
+                return;
+            }
+            continue;
+        }
+        double t = q / p;
+        if (p < 0)
+        {
+            tEnter = std::max(tEnter, t);
+        }
+        else
+        {
+            tExit = std::min(tExit, t);
+        }
+    }
+    if (tEnter > tExit)
+    {
+        return;
+    }
+
+    // Walk the cells crossed by the clipped segment (Amanatides-Woo)
+    double sx = x0 + tEnter * dx;
+    double sy = y0 + tEnter * dy;
+    auto cellOf = [this](double v, double vMin, uint32_t n) {
+        return std::min<int64_t>(std::max<int64_t>((v - vMin) / m_cellSize, 0), n - 1);
+    };
+    int64_t ix = cellOf(sx, m_xMin, m_nx);
+    int64_t iy = cellOf(sy, m_yMin, m_ny);
+    int64_t endIx = cellOf(x0 + tExit * dx, m_xMin, m_nx);
+    int64_t endIy = cellOf(y0 + tExit * dy, m_yMin, m_ny);
+
+    int64_t stepX = dx > 0 ? 1 : -1;
+    int64_t stepY = dy > 0 ? 1 : -1;
+    double inf = std::numeric_limits<double>::infinity();
+    double tMaxX = dx != 0 ? (m_xMin + (ix + (dx > 0)) * m_cellSize - sx) / dx : inf;
+    double tMaxY = dy != 0 ? (m_yMin + (iy + (dy > 0)) * m_cellSize - sy) / dy : inf;
+    double tDeltaX = dx != 0 ? m_cellSize / std::abs(dx) : inf;
+    double tDeltaY = dy != 0 ? m_cellSize / std::abs(dy) : inf;
+
+    for (uint32_t steps = 0; steps <= m_nx + m_ny; steps++)
+    {
+        visit(iy * m_nx + ix);
+        if (ix == endIx && iy == endIy)
+        {
+            return;
+        }
+        if (tMaxX < tMaxY)
+        {
+            ix += stepX;
+            tMaxX += tDeltaX;
+        }
+        else
+        {
+            iy += stepY;
+            tMaxY += tDeltaY;
+        }
+        if (ix < 0 || iy < 0 || ix >= m_nx || iy >= m_ny)
+        {
+            return;
+        }
+    }
+}
+
+double
+MultiWallPropagationLossModel::GetWallLoss(const Vector& a, const Vector& b) const
+{
+    if (m_gridDirty)
+    {
+        BuildGrid();
+    }
+    if (m_walls.empty())
+    {
+        return 0;
+    }
+
+    // A wall spanning several cells is tested once per link
+    if (++m_stamp == 0)
+    {
+        std::fill(m_wallStamp.begin(), m_wallStamp.end(), 0);
+        m_stamp = 1;
+    }
+    double loss = 0;
+    TraverseGrid(a.x, a.y, b.x, b.y, [&](uint32_t cell) {
+        for (uint32_t i : m_cells[cell])
+        {
+            if (m_wallStamp[i] == m_stamp)
+            {
+                continue;
+            }
+            m_wallStamp[i] = m_stamp;
+            const Wall& wall = m_walls[i];
+            double o1 = Orientation(a.x, a.y, b.x, b.y, wall.x1, wall.y1);
+            double o2 = Orientation(a.x, a.y, b.x, b.y, wall.x2, wall.y2);
+            double o3 = Orientation(wall.x1, wall.y1, wall.x2, wall.y2, a.x, a.y);
+            double o4 = Orientation(wall.x1, wall.y1, wall.x2, wall.y2, b.x, b.y);
+            // Crossed, unless the link runs along the wall
+            if (o1 * o2 <= 0 && o3 * o4 <= 0 && !(o1 == 0 && o2 == 0))
+            {
+                loss += wall.loss;
+            }
+        }
+    });
+    return loss;
+}
+
+double
+MultiWallPropagationLossModel::GetFloorLoss(double za, double zb) const
+{
+    double zMin = std::min(za, zb);
+    double zMax = std::max(za, zb);
+    double loss = 0;
+    uint32_t n = 0;
+    for (const auto& [height, floorLoss] : m_floors)
+    {
+        if (height > zMin && height < zMax)
+        {
+            loss += floorLoss;
+            n++;
+        }
+    }
+    if (n == 0)
+    {
+        return 0;
+    }
+    return loss * std::pow(n, (n + 2.0) / (n + 1.0) - m_floorFactorB - 1);
+}
+
+double
+MultiWallPropagationLossModel::CalcPenetrationLoss(const Vector& a, const Vector& b) const
+{
+    return GetWallLoss(a, b) + GetFloorLoss(a.z, b.z);
+}
+
+double
+MultiWallPropagationLossModel::GetPenetrationLoss(Ptr<MobilityModel> a,
+                                                  Ptr<MobilityModel> b) const
+{
+    Vector positionA = a->GetPosition();
+    Vector positionB = b->GetPosition();
+    if (!m_cacheLinks)
+    {
+        return CalcPenetrationLoss(positionA, positionB);
+    }
+
+    // The loss is symmetric: one entry per pair of ends
+    if (PeekPointer(b) < PeekPointer(a))
+    {
+        std::swap(a, b);
+        std::swap(positionA, positionB);
+    }
+    auto [it, inserted] = m_cache.try_emplace({PeekPointer(a), PeekPointer(b)});
+    Link& link = it->second;
+    if (!inserted && link.a == positionA && link.b == positionB)
+    {
+        m_cacheHits++;
+        return link.loss;
+    }
+    m_cacheMisses++;
+    link.a = positionA;
+    link.b = positionB;
+    link.loss = CalcPenetrationLoss(positionA, positionB);
+    return link.loss;
+}
+
+double
+MultiWallPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                             Ptr<MobilityModel> a,
+                                             Ptr<MobilityModel> b) const
+{
+    return txPowerDbm - GetPenetrationLoss(a, b);
+}
+
+int64_t
+MultiWallPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    return 0;
+}
+
+}
@@ -0,0 +1,162 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef MULTI_WALL_PROPAGATION_LOSS_MODEL_H
+#define MULTI_WALL_PROPAGATION_LOSS_MODEL_H
+
+#include <ns3/propagation-loss-model.h>
+#include <ns3/vector.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ * \brief Wall and floor penetration loss of an indoor building (COST 231 multi-wall model)
+ *
+ * The building is a set of walls, vertical segments from floor to ceiling, and of floors,
+ * horizontal slabs at a given height. The loss of a link is the loss of every wall crossed by
+ * its horizontal projection plus the loss of the floors between both ends:
+ *
+ *   L = sum_walls Lw + (sum_floors Lf) * n^((n + 2) / (n + 1) - b - 1)
+ *
+ * with n the number of floors crossed, so that n floors of loss Lf add Lf * n^((n+2)/(n+1)-b).
+ * Only the penetration loss is added: the model is chained after a distance loss model.
+ *
+ * The walls are indexed in a uniform grid of CellSize cells and only the walls of the cells
+ * crossed by the link are tested. The loss of every link is cached and reused while neither
+ * end moves.
+ */
+class MultiWallPropagationLossModel : public PropagationLossModel
+{
+  public:
+    static TypeId GetTypeId();
+    MultiWallPropagationLossModel();
+    ~MultiWallPropagationLossModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    MultiWallPropagationLossModel(const MultiWallPropagationLossModel&) = delete;
+    MultiWallPropagationLossModel& operator=(const MultiWallPropagationLossModel&) = delete;
+
+    /**
+     * \brief Add a wall of WallLoss
+     * \param start one end of the wall (z ignored)
+     * \param end other end of the wall (z ignored)
+     */
+    void AddWall(const Vector& start, const Vector& end);
+
+    /**
+     * \brief Add a wall
+     * \param start one end of the wall (z ignored)
+     * \param end other end of the wall (z ignored)
+     * \param loss penetration loss (dB)
+     */
+    void AddWall(const Vector& start, const Vector& end, double loss);
+
+    /**
+     * \brief Add a floor slab of FloorLoss
+     * \param height height of the slab (m)
+     */
+    void AddFloor(double height);
+
+    /**
+     * \brief Add a floor slab
+     * \param height height of the slab (m)
+     * \param loss penetration loss (dB)
+     */
+    void AddFloor(double height, double loss);
+
+    /**
+     * \brief Add the walls and floors of a building description
+     *
+     * One element per line ('#' comments): "wall,x1,y1,x2,y2[,loss]" or "floor,z[,loss]".
+     *
+     * \param filename building description file
+     */
+    void LoadBuilding(const std::string& filename);
+
+    uint32_t GetNWalls() const;
+    uint32_t GetNFloors() const;
+
+    /**
+     * \param a one end of the link
+     * \param b other end of the link
+     * \return the wall and floor penetration loss of the link (dB)
+     */
+    double GetPenetrationLoss(Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+    uint64_t GetCacheHits() const;
+    uint64_t GetCacheMisses() const;
+
+  private:
+    /// Wall (horizontal projection)
+    struct Wall
+    {
+        double x1;
+        double y1;
+        double x2;
+        double y2;
+        double loss;
+    };
+
+    /// Cached loss of a link
+    struct Link
+    {
+        Vector a;
+        Vector b;
+        double loss;
+    };
+
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    void BuildGrid() const;
+
+    /**
+     * \brief Visit the grid cells crossed by a segment
+     * \param visit called with the index of every cell crossed
+     */
+    template <typename F>
+    void TraverseGrid(double x0, double y0, double x1, double y1, F visit) const;
+
+    double GetWallLoss(const Vector& a, const Vector& b) const;
+    double GetFloorLoss(double za, double zb) const;
+    double CalcPenetrationLoss(const Vector& a, const Vector& b) const;
+
+    double m_wallLoss;
+    double m_floorLoss;
+    double m_floorFactorB;
+    double m_cellSize;
+    bool m_cacheLinks;
+
+    std::vector<Wall> m_walls;
+    std::vector<std::pair<double, double>> m_floors; //!< (height, loss), sorted by height
+
+    // Uniform grid of the walls, built on the first query after a change
+    mutable bool m_gridDirty{true};
+    mutable double m_xMin{0};
+    mutable double m_yMin{0};
+    mutable uint32_t m_nx{0};
+    mutable uint32_t m_ny{0};
+    mutable std::vector<std::vector<uint32_t>> m_cells;
+    mutable std::vector<uint32_t> m_wallStamp; //!< last query that tested each wall
+    mutable uint32_t m_stamp{0};
+
+    mutable std::map<std::pair<const MobilityModel*, const MobilityModel*>, Link> m_cache;
+    mutable uint64_t m_cacheHits{0};
+    mutable uint64_t m_cacheMisses{0};
+};
+
+};
+#endif
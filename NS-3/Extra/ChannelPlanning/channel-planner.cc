@@ -0,0 +1,481 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "channel-planner.h"
+
+#include <ns3/abort.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/pointer.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ChannelPlanner");
+
+NS_OBJECT_ENSURE_REGISTERED(ChannelPlanner);
+
+namespace
+{
+double
+DbmToMw(double dBm)
+{
+    return std::pow(10.0, dBm / 10.0);
+}
+} // namespace
+
+ChannelPlanner::ChannelPlanner()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ChannelPlanner::~ChannelPlanner()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+ChannelPlanner::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ChannelPlanner")
+            .SetParent<Object>()
+            .AddConstructor<ChannelPlanner>()
+            .AddAttribute("LossModel",
+                          "Propagation loss model used to predict the AP-AP and AP-STA powers",
+                          PointerValue(),
+                          MakePointerAccessor(&ChannelPlanner::m_lossModel),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("TxPower",
+                          "AP transmission power (dBm)",
+                          DoubleValue(21.0),
+                          MakeDoubleAccessor(&ChannelPlanner::m_txPower),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("CcaThreshold",
+                          "Power above which two overlapping BSSs share the medium (dBm)",
+                          DoubleValue(-82.0),
+                          MakeDoubleAccessor(&ChannelPlanner::m_ccaThreshold),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("CellRadius",
+                          "Distance of the reference STA used to predict the signal (m)",
+                          DoubleValue(5.0),
+                          MakeDoubleAccessor(&ChannelPlanner::m_cellRadius),
+                          MakeDoubleChecker<double>(0.1))
+            .AddAttribute("NoiseFigure",
+                          "Receiver noise figure (dB)",
+                          DoubleValue(7.0),
+                          MakeDoubleAccessor(&ChannelPlanner::m_noiseFigure),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxIterations",
+                          "Maximum number of local search rounds",
+                          UintegerValue(20),
+                          MakeUintegerAccessor(&ChannelPlanner::m_maxIterations),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+void
+ChannelPlanner::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_bss.clear();
+    m_lossModel = nullptr;
+    Object::DoDispose();
+}
+
+uint32_t
+ChannelPlanner::AddBss(const std::string& label, Ptr<Node> apNode, Channel currentChannel)
+{
+    NS_LOG_FUNCTION(this << label << apNode);
+    Bss bss;
+    bss.label = label;
+    bss.apNode = apNode;
+    bss.initial = currentChannel;
+    bss.planned = currentChannel;
+    m_bss.push_back(bss);
+    return m_bss.size() - 1;
+}
+
+std::vector<ChannelPlanner::Channel>
+ChannelPlanner::GetCandidates(uint16_t width) const
+{
+    std::vector<uint16_t> numbers;
+    if (m_frequency == 6)
+    {
+        uint16_t first = width == 20 ? 1 : width == 40 ? 3 : width == 80 ? 7 : 15;
+        for (uint16_t number = first; number <= 233; number += width / 5)
+        {
+            numbers.push_back(number);
+        }
+    }
+    else if (m_frequency == 5)
+    {
+        switch (width)
+        {
+        case 20:
+            numbers = {36,  40,  44,  48,  52,  56,  60,  64,  100, 104, 108, 112, 116,
+                       120, 124, 128, 132, 136, 140, 144, 149, 153, 157, 161, 165};
+            break;
+        case 40:
+            numbers = {38, 46, 54, 62, 102, 110, 118, 126, 134, 142, 151, 159};
+            break;
+        case 80:
+            numbers = {42, 58, 106, 122, 138, 155};
+            break;
+        case 160:
+            numbers = {50, 114};
+            break;
+        }
+    }
+    else if (m_frequency == 2.4 && width == 20)
+    {
+        numbers = {1, 6, 11};
+    }
+
+    std::vector<Channel> candidates;
+    for (auto number : numbers)
+    {
+        candidates.push_back({number, width});
+    }
+    return candidates;
+}
+
+double
+ChannelPlanner::GetCenterFrequency(uint16_t number) const
+{
+    if (m_frequency == 6)
+    {
+        return 5950 + 5 * number;
+    }
+    else if (m_frequency == 5)
+    {
+        return 5000 + 5 * number;
+    }
+    return 2407 + 5 * number;
+}
+
+double
+ChannelPlanner::GetOverlap(const Channel& a, const Channel& b) const
+{
+    double aLow = GetCenterFrequency(a.number) - a.width / 2.0;
+    double bLow = GetCenterFrequency(b.number) - b.width / 2.0;
+    double common = std::min(aLow + a.width, bLow + b.width) - std::max(aLow, bLow);
+    return std::max(0.0, common) / a.width;
+}
+
+void
+ChannelPlanner::ComputeRxPowers()
+{
+    NS_ABORT_MSG_IF(!m_lossModel, "The channel planner needs a propagation loss model");
+    uint32_t n = m_bss.size();
+    m_rxPower.assign(n, std::vector<double>(n, -std::numeric_limits<double>::infinity()));
+    m_signal.assign(n, 0);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<MobilityModel> apMobility = m_bss[i].apNode->GetObject<MobilityModel>();
+        NS_ABORT_MSG_IF(!apMobility, "Mobility must be installed before the channel planning");
+
+        Ptr<ConstantPositionMobilityModel> edge = CreateObject<ConstantPositionMobilityModel>();
+        edge->SetPosition(apMobility->GetPosition() + Vector(m_cellRadius, 0, 0));
+        m_signal[i] = m_lossModel->CalcRxPower(m_txPower, apMobility, edge);
+
+        for (uint32_t j = 0; j < n; j++)
+        {
+            if (i != j)
+            {
+                m_rxPower[i][j] = m_lossModel->CalcRxPower(
+                    m_txPower,
+                    m_bss[j].apNode->GetObject<MobilityModel>(),
+                    apMobility);
+            }
+        }
+    }
+}
+
+double
+ChannelPlanner::GetBssThroughput(uint32_t i, const std::vector<Channel>& plan) const
+{
+    double interference = 0;
+    double contenders = 0;
+    for (uint32_t j = 0; j < plan.size(); j++)
+    {
+        if (i == j)
+        {
+            continue;
+        }
+        double overlap = GetOverlap(plan[i], plan[j]);
+        if (overlap <= 0)
+        {
+            continue;
+        }
+        if (m_rxPower[i][j] >= m_ccaThreshold)
+        {
+            contenders += overlap;
+        }
+        else
+        {
+            interference += overlap * DbmToMw(m_rxPower[i][j]);
+        }
+    }
+
+    double noise = DbmToMw(-174 + 10 * std::log10(plan[i].width * 1e6) + m_noiseFigure);
+    double sinr = DbmToMw(m_signal[i]) / (noise + interference);
+    return plan[i].width * std::log2(1 + sinr) / (1 + contenders);
+}
+
+double
+ChannelPlanner::GetThroughput(const std::vector<Channel>& plan) const
+{
+    double throughput = 0;
+    for (uint32_t i = 0; i < plan.size(); i++)
+    {
+        throughput += GetBssThroughput(i, plan);
+    }
+    return throughput;
+}
+
+void
+ChannelPlanner::Colour(const std::vector<Channel>& colours, std::vector<Channel>& plan)
+{
+    // DSATUR: most constrained AP first (distinct neighbour colours, then degree)
+    uint32_t n = m_bss.size();
+    std::vector<bool> coloured(n, false);
+    std::vector<std::vector<uint32_t>> neighbours(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t j = 0; j < n; j++)
+        {
+            if (i != j && std::max(m_rxPower[i][j], m_rxPower[j][i]) >= m_ccaThreshold)
+            {
+                neighbours[i].push_back(j);
+            }
+        }
+    }
+
+    for (uint32_t step = 0; step < n; step++)
+    {
+        uint32_t next = n;
+        uint32_t bestSaturation = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (coloured[i])
+            {
+                continue;
+            }
+            std::set<uint32_t> used;
+            for (auto j : neighbours[i])
+            {
+                if (coloured[j])
+                {
+                    used.insert(m_bss[j].colour);
+                }
+            }
+            if (next == n || used.size() > bestSaturation ||
+                (used.size() == bestSaturation && neighbours[i].size() > neighbours[next].size()))
+            {
+                next = i;
+                bestSaturation = used.size();
+            }
+        }
+
+        // Smallest free colour, or the one heard with the lowest power if none is free
+        uint32_t bestColour = 0;
+        double bestCost = std::numeric_limits<double>::infinity();
+        for (uint32_t colour = 0; colour < colours.size(); colour++)
+        {
+            double cost = 0;
+            for (auto j : neighbours[next])
+            {
+                if (coloured[j] && m_bss[j].colour == colour)
+                {
+                    cost += DbmToMw(m_rxPower[next][j]);
+                }
+            }
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestColour = colour;
+            }
+            if (cost == 0)
+            {
+                break;
+            }
+        }
+        m_bss[next].colour = bestColour;
+        plan[next] = colours[bestColour];
+        coloured[next] = true;
+    }
+}
+
+void
+ChannelPlanner::LocalSearch(const std::vector<Channel>& candidates, std::vector<Channel>& plan)
+{
+    double current = GetThroughput(plan);
+    for (uint32_t iteration = 0; iteration < m_maxIterations; iteration++)
+    {
+        bool improved = false;
+        for (uint32_t i = 0; i < plan.size(); i++)
+        {
+            Channel best = plan[i];
+            for (const auto& candidate : candidates)
+            {
+                plan[i] = candidate;
+                double throughput = GetThroughput(plan);
+                if (throughput > current * (1 + 1e-9))
+                {
+                    current = throughput;
+                    best = candidate;
+                    improved = true;
+                }
+            }
+            plan[i] = best;
+        }
+        if (!improved)
+        {
+            break;
+        }
+    }
+}
+
+void
+ChannelPlanner::Plan(double frequency, uint16_t maxWidth)
+{
+    NS_LOG_FUNCTION(this << frequency << maxWidth);
+    m_frequency = frequency;
+    if (m_bss.empty())
+    {
+        return;
+    }
+    ComputeRxPowers();
+
+    std::vector<Channel> initial;
+    for (const auto& bss : m_bss)
+    {
+        initial.push_back(bss.initial);
+    }
+    m_initialThroughput = GetThroughput(initial);
+
+    std::vector<Channel> colours = GetCandidates(maxWidth);
+    NS_ABORT_MSG_IF(colours.empty(),
+                    "No channel of " << maxWidth << " MHz in the " << frequency << " GHz band");
+    std::vector<Channel> candidates;
+    for (uint16_t width = 20; width <= maxWidth; width *= 2)
+    {
+        auto widthCandidates = GetCandidates(width);
+        candidates.insert(candidates.end(), widthCandidates.begin(), widthCandidates.end());
+    }
+
+    std::vector<Channel> plan(m_bss.size());
+    Colour(colours, plan);
+    LocalSearch(candidates, plan);
+
+    m_plannedThroughput = GetThroughput(plan);
+    for (uint32_t i = 0; i < m_bss.size(); i++)
+    {
+        m_bss[i].planned = plan[i];
+        std::cout << "Channel plan: BSS " << m_bss[i].label << " -> "
+                  << GetChannelSettings(i) << std::endl;
+    }
+    std::cout << "Channel plan: predicted throughput " << m_initialThroughput << " -> "
+              << m_plannedThroughput << " Mbps" << std::endl;
+}
+
+ChannelPlanner::Channel
+ChannelPlanner::GetChannel(uint32_t bssIndex) const
+{
+    NS_ABORT_MSG_IF(bssIndex >= m_bss.size(), "No BSS " << bssIndex);
+    return m_bss[bssIndex].planned;
+}
+
+std::string
+ChannelPlanner::GetChannelSettings(uint32_t bssIndex) const
+{
+    Channel channel = GetChannel(bssIndex);
+    std::ostringstream oss;
+    oss << "{" << channel.number << ", " << channel.width;
+    if (m_frequency == 6)
+    {
+        oss << ", BAND_6GHZ, 0}";
+    }
+    else if (m_frequency == 5)
+    {
+        oss << ", BAND_5GHZ, 0}";
+    }
+    else
+    {
+        oss << ", BAND_2_4GHZ, 0}";
+    }
+    return oss.str();
+}
+
+void
+ChannelPlanner::Apply(uint32_t bssIndex, const NetDeviceContainer& devices) const
+{
+    NS_LOG_FUNCTION(this << bssIndex);
+    std::string channelSettings = GetChannelSettings(bssIndex);
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+        NS_ASSERT(device);
+        device->GetPhy()->SetAttribute("ChannelSettings", StringValue(channelSettings));
+    }
+}
+
+double
+ChannelPlanner::GetPredictedThroughput() const
+{
+    return m_plannedThroughput;
+}
+
+double
+ChannelPlanner::GetInitialPredictedThroughput() const
+{
+    return m_initialThroughput;
+}
+
+void
+ChannelPlanner::WriteCsv(const std::string& filename,
+                         uint32_t seedNumber,
+                         uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    std::vector<Channel> initial;
+    std::vector<Channel> planned;
+    for (const auto& bss : m_bss)
+    {
+        initial.push_back(bss.initial);
+        planned.push_back(bss.planned);
+    }
+
+    // seed, run, BSS, x, y, initial channel, initial width, channel, width, predicted Mbps
+    // (initial plan), predicted Mbps (planned)
+    for (uint32_t i = 0; i < m_bss.size(); i++)
+    {
+        Vector position = m_bss[i].apNode->GetObject<MobilityModel>()->GetPosition();
+        file << seedNumber << "," << runNumber << "," << m_bss[i].label << "," << position.x
+             << "," << position.y << "," << m_bss[i].initial.number << ","
+             << m_bss[i].initial.width << "," << m_bss[i].planned.number << ","
+             << m_bss[i].planned.width << "," << GetBssThroughput(i, initial) << ","
+             << GetBssThroughput(i, planned) << "\n";
+    }
+}
+
+}
@@ -0,0 +1,129 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef CHANNEL_PLANNER_H
+#define CHANNEL_PLANNER_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/node.h>
+#include <ns3/object.h>
+#include <ns3/propagation-loss-model.h>
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup helper
+ * \brief Automatic channel planning of a set of BSSs
+ *
+ * The planner builds the AP interference graph from the AP positions and a propagation loss
+ * model (an edge joins two APs that hear each other above the CCA threshold), colours it with
+ * DSATUR using the non-overlapping channels of the widest allowed width and then runs a local
+ * search over every (primary channel, width) pair to maximise the predicted aggregate
+ * throughput:
+ *
+ *   sum_i  width_i * log2(1 + S_i / (N_i + I_i)) / (1 + C_i)
+ *
+ * where S_i is the signal at CellRadius from the AP, I_i the overlapping interference heard
+ * below the CCA threshold and C_i the overlapping contenders heard above it (both weighted by
+ * the fraction of spectrum in common).
+ */
+class ChannelPlanner : public Object
+{
+  public:
+    /// Channel of a BSS
+    struct Channel
+    {
+        uint16_t number{0};
+        uint16_t width{0};
+    };
+
+    ChannelPlanner();
+    ~ChannelPlanner() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Add a BSS to plan
+     * \param label label of the BSS
+     * \param apNode AP of the BSS (with a mobility model)
+     * \param currentChannel channel the BSS would use without planning
+     * \return the index of the BSS
+     */
+    uint32_t AddBss(const std::string& label, Ptr<Node> apNode, Channel currentChannel);
+
+    /**
+     * \brief Compute the plan
+     * \param frequency band (2.4, 5 or 6 GHz)
+     * \param maxWidth widest channel width allowed (MHz)
+     */
+    void Plan(double frequency, uint16_t maxWidth);
+
+    Channel GetChannel(uint32_t bssIndex) const;
+
+    /**
+     * \return the ChannelSettings attribute value of the planned channel of a BSS
+     */
+    std::string GetChannelSettings(uint32_t bssIndex) const;
+
+    /**
+     * \brief Move the devices of a BSS to its planned channel (before the simulation starts)
+     * \param bssIndex the BSS
+     * \param devices AP and STA devices of the BSS
+     */
+    void Apply(uint32_t bssIndex, const NetDeviceContainer& devices) const;
+
+    double GetPredictedThroughput() const;
+    double GetInitialPredictedThroughput() const;
+
+    /**
+     * \brief Append the plan to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// BSS to plan
+    struct Bss
+    {
+        std::string label;
+        Ptr<Node> apNode;
+        Channel initial;
+        Channel planned;
+        uint32_t colour{0};
+    };
+
+    std::vector<Channel> GetCandidates(uint16_t width) const;
+    double GetCenterFrequency(uint16_t number) const;
+    double GetOverlap(const Channel& a, const Channel& b) const;
+    double GetBssThroughput(uint32_t i, const std::vector<Channel>& plan) const;
+    double GetThroughput(const std::vector<Channel>& plan) const;
+    void ComputeRxPowers();
+    void Colour(const std::vector<Channel>& colours, std::vector<Channel>& plan);
+    void LocalSearch(const std::vector<Channel>& candidates, std::vector<Channel>& plan);
+
+    Ptr<PropagationLossModel> m_lossModel;
+    double m_txPower;
+    double m_ccaThreshold;
+    double m_cellRadius;
+    double m_noiseFigure;
+    uint32_t m_maxIterations;
+
+    double m_frequency{5};
+    std::vector<Bss> m_bss;
+    std::vector<std::vector<double>> m_rxPower; //!< [i][j]: power of AP j at AP i (dBm)
+    std::vector<double> m_signal;               //!< signal at the cell edge (dBm)
+    double m_initialThroughput{0};
+    double m_plannedThroughput{0};
+};
+
+};
+#endif
@@ -0,0 +1,354 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "scenario-checkpoint.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/simulator.h>
+#include <ns3/sta-wifi-mac.h>
+#include <ns3/wifi-net-device.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ScenarioCheckpoint");
+
+namespace
+{
+/// Number of TIDs checked for BA agreements
+const uint8_t N_TIDS = 8;
+
+/// Wi-Fi MAC of the first Wi-Fi device of a node (nullptr if none)
+Ptr<WifiMac>
+GetWifiMac(Ptr<Node> node)
+{
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(node->GetDevice(i));
+        if (device)
+        {
+            return device->GetMac();
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+ScenarioCheckpoint::ScenarioCheckpoint()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+ScenarioCheckpoint::~ScenarioCheckpoint()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+ScenarioCheckpoint::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::ScenarioCheckpoint")
+                            .SetParent<Object>()
+                            .AddConstructor<ScenarioCheckpoint>();
+    return tid;
+}
+
+void
+ScenarioCheckpoint::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_networks.clear();
+    Object::DoDispose();
+}
+
+void
+ScenarioCheckpoint::AddNetwork(const std::string& label,
+                               const NodeContainer& apNodes,
+                               const NodeContainer& staNodes)
+{
+    NS_LOG_FUNCTION(this << label);
+    m_networks.push_back({label, apNodes, staNodes});
+}
+
+double
+ScenarioCheckpoint::Replay(const std::string& key, double drawn)
+{
+    NS_LOG_FUNCTION(this << key << drawn);
+    double value = drawn;
+    if (m_loaded)
+    {
+        auto it = m_loadedValues.find(key);
+        NS_ABORT_MSG_IF(it == m_loadedValues.end(),
+                        "Checkpoint has no value for " << key
+                                                       << " (different scenario parameters?)");
+        value = it->second;
+    }
+    m_values.emplace_back(key, value);
+    return value;
+}
+
+void
+ScenarioCheckpoint::SetSeedRun(uint32_t seedNumber, uint32_t runNumber)
+{
+    m_seedNumber = seedNumber;
+    m_runNumber = runNumber;
+}
+
+uint32_t
+ScenarioCheckpoint::GetSeed() const
+{
+    return m_seedNumber;
+}
+
+uint32_t
+ScenarioCheckpoint::GetRun() const
+{
+    return m_runNumber;
+}
+
+bool
+ScenarioCheckpoint::IsLoaded() const
+{
+    return m_loaded;
+}
+
+Time
+ScenarioCheckpoint::GetSaveTime() const
+{
+    return m_saveTime;
+}
+
+std::string
+ScenarioCheckpoint::Key(const std::string& label, const std::string& role, uint32_t index)
+{
+    return label + "/" + role + "/" + std::to_string(index);
+}
+
+ScenarioCheckpoint::NodeState
+ScenarioCheckpoint::Capture(Ptr<Node> node, Ptr<Node> apNode, bool isSta) const
+{
+    NodeState state;
+    Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
+    if (mobility)
+    {
+        state.position = mobility->GetPosition();
+    }
+    if (!isSta || !apNode)
+    {
+        return state;
+    }
+
+    Ptr<StaWifiMac> staMac = DynamicCast<StaWifiMac>(GetWifiMac(node));
+    Ptr<WifiMac> apMac = GetWifiMac(apNode);
+    if (!staMac || !apMac)
+    {
+        return state;
+    }
+
+    state.associated = staMac->IsAssociated();
+    if (state.associated)
+    {
+        state.bssid = staMac->GetBssid(0);
+    }
+    for (uint8_t tid = 0; tid < N_TIDS; tid++)
+    {
+        if (staMac->GetBaAgreementEstablishedAsOriginator(apMac->GetAddress(), tid))
+        {
+            state.baUl |= (1 << tid);
+        }
+        if (apMac->GetBaAgreementEstablishedAsOriginator(staMac->GetAddress(), tid))
+        {
+            state.baDl |= (1 << tid);
+        }
+    }
+    return state;
+}
+
+void
+ScenarioCheckpoint::ScheduleSave(Time saveTime, const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << saveTime << filename);
+    m_saveTime = saveTime;
+    Simulator::Schedule(saveTime, &ScenarioCheckpoint::Save, this, filename);
+}
+
+void
+ScenarioCheckpoint::Save(std::string filename) const
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ofstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open checkpoint file " << filename);
+    file << std::setprecision(17);
+
+    file << "# ScenarioCheckpoint v1\n";
+    file << "time " << Simulator::Now().GetSeconds() << "\n";
+    file << "seed " << m_seedNumber << "\n";
+    file << "run " << m_runNumber << "\n";
+    for (const auto& [key, value] : m_values)
+    {
+        file << "value " << key << " " << value << "\n";
+    }
+
+    // node <label> <role> <index> <x> <y> <z> <associated> <bssid> <baUl> <baDl>
+    for (const auto& network : m_networks)
+    {
+        Ptr<Node> apNode = network.apNodes.GetN() > 0 ? network.apNodes.Get(0) : nullptr;
+        for (uint32_t i = 0; i < network.apNodes.GetN(); i++)
+        {
+            NodeState state = Capture(network.apNodes.Get(i), nullptr, false);
+            file << "node " << network.label << " ap " << i << " " << state.position.x << " "
+                 << state.position.y << " " << state.position.z << " 0 " << state.bssid
+                 << " 0 0\n";
+        }
+        for (uint32_t i = 0; i < network.staNodes.GetN(); i++)
+        {
+            NodeState state = Capture(network.staNodes.Get(i), apNode, true);
+            file << "node " << network.label << " sta " << i << " " << state.position.x << " "
+                 << state.position.y << " " << state.position.z << " " << state.associated
+                 << " " << state.bssid << " " << +state.baUl << " " << +state.baDl << "\n";
+        }
+    }
+    file.close();
+
+    std::cout << "Checkpoint saved at " << Simulator::Now().GetSeconds() << " s in " << filename
+              << std::endl;
+}
+
+void
+ScenarioCheckpoint::Load(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ifstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open checkpoint file " << filename);
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string type;
+        iss >> type;
+        if (type == "time")
+        {
+            double saveTime;
+            iss >> saveTime;
+            m_saveTime = Seconds(saveTime);
+        }
+        else if (type == "seed")
+        {
+            iss >> m_seedNumber;
+        }
+        else if (type == "run")
+        {
+            iss >> m_runNumber;
+        }
+        else if (type == "value")
+        {
+            std::string key;
+            double value;
+            iss >> key >> value;
+            m_loadedValues[key] = value;
+        }
+        else if (type == "node")
+        {
+            std::string label;
+            std::string role;
+            std::string bssid;
+            uint32_t index;
+            uint32_t baUl;
+            uint32_t baDl;
+            NodeState state;
+            iss >> label >> role >> index >> state.position.x >> state.position.y >>
+                state.position.z >> state.associated >> bssid >> baUl >> baDl;
+            state.bssid = Mac48Address(bssid.c_str());
+            state.baUl = baUl;
+            state.baDl = baDl;
+            m_loadedNodes[Key(label, role, index)] = state;
+        }
+        NS_ABORT_MSG_IF(iss.fail(), "Malformed checkpoint line: " << line);
+    }
+    m_loaded = true;
+}
+
+void
+ScenarioCheckpoint::RestorePositions()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!m_loaded, "No checkpoint loaded");
+    for (const auto& network : m_networks)
+    {
+        for (const auto& [role, nodes] :
+             {std::make_pair(std::string("ap"), network.apNodes),
+              std::make_pair(std::string("sta"), network.staNodes)})
+        {
+            for (uint32_t i = 0; i < nodes.GetN(); i++)
+            {
+                auto it = m_loadedNodes.find(Key(network.label, role, i));
+                NS_ABORT_MSG_IF(it == m_loadedNodes.end(),
+                                "Checkpoint has no node " << Key(network.label, role, i));
+                Ptr<MobilityModel> mobility = nodes.Get(i)->GetObject<MobilityModel>();
+                NS_ABORT_MSG_IF(!mobility, "Mobility must be installed before the restore");
+                mobility->SetPosition(it->second.position);
+            }
+        }
+    }
+}
+
+void
+ScenarioCheckpoint::ScheduleCheck(Time checkTime)
+{
+    NS_LOG_FUNCTION(this << checkTime);
+    Simulator::Schedule(checkTime, &ScenarioCheckpoint::Check, this);
+}
+
+void
+ScenarioCheckpoint::Check() const
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t nStations = 0;
+    uint32_t nAssocMismatch = 0;
+    uint32_t nBaMismatch = 0;
+    for (const auto& network : m_networks)
+    {
+        Ptr<Node> apNode = network.apNodes.GetN() > 0 ? network.apNodes.Get(0) : nullptr;
+        for (uint32_t i = 0; i < network.staNodes.GetN(); i++)
+        {
+            auto it = m_loadedNodes.find(Key(network.label, "sta", i));
+            if (it == m_loadedNodes.end())
+            {
+                continue;
+            }
+            NodeState state = Capture(network.staNodes.Get(i), apNode, true);
+            nStations++;
+            if (state.associated != it->second.associated ||
+                (state.associated && state.bssid != it->second.bssid))
+            {
+                nAssocMismatch++;
+            }
+            // Only the agreements of the checkpoint are required to be in place
+            if ((state.baUl & it->second.baUl) != it->second.baUl ||
+                (state.baDl & it->second.baDl) != it->second.baDl)
+            {
+                nBaMismatch++;
+            }
+        }
+    }
+
+    std::cout << "Checkpoint restore at " << Simulator::Now().GetSeconds() << " s: " << nStations
+              << " STAs, " << nAssocMismatch << " association and " << nBaMismatch
+              << " BA agreement mismatches" << std::endl;
+}
+
+}
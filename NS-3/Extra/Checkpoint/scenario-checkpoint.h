@@ -0,0 +1,132 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef SCENARIO_CHECKPOINT_H
+#define SCENARIO_CHECKPOINT_H
+
+#include <ns3/mac48-address.h>
+#include <ns3/node-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/vector.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup helper
+ * \brief Snapshot/restore of the warmed-up state of a scenario
+ *
+ * A checkpoint stores, at a given simulation time, everything a variant run needs to skip
+ * the set-up and warm-up of a previous run: seed and run numbers, the random draws of the
+ * topology (node counts, room sizes...), the position of every node and the association and
+ * block ack state of every STA.
+ *
+ * ns-3 can not serialise its event list nor the internal state of the MAC and of the RNG
+ * streams, so the restore is a fast reconstruction: the topology draws and positions are
+ * replayed exactly, while associations, ARP caches and BA agreements are rebuilt by the fast
+ * start mechanisms before the applications start. CheckRestoredState compares the rebuilt
+ * state with the saved one.
+ */
+class ScenarioCheckpoint : public Object
+{
+  public:
+    ScenarioCheckpoint();
+    ~ScenarioCheckpoint() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Register the nodes of a BSS
+     * \param label label of the BSS (A, B...)
+     * \param apNodes AP of the BSS
+     * \param staNodes STAs of the BSS
+     */
+    void AddNetwork(const std::string& label,
+                    const NodeContainer& apNodes,
+                    const NodeContainer& staNodes);
+
+    /**
+     * \brief Record a random draw of the scenario, or replay it from a loaded checkpoint
+     * \param key name of the draw
+     * \param drawn value drawn by the current run
+     * \return the saved value if a checkpoint is loaded, the drawn value otherwise
+     *
+     * The draw must be performed anyway, so that the RNG streams are consumed as in the
+     * original run.
+     */
+    double Replay(const std::string& key, double drawn);
+
+    void SetSeedRun(uint32_t seedNumber, uint32_t runNumber);
+    uint32_t GetSeed() const;
+    uint32_t GetRun() const;
+
+    /**
+     * \brief Save the state of the registered networks
+     * \param saveTime simulation time of the snapshot
+     * \param filename checkpoint file
+     */
+    void ScheduleSave(Time saveTime, const std::string& filename);
+
+    /**
+     * \brief Load a checkpoint file
+     * \param filename checkpoint file
+     */
+    void Load(const std::string& filename);
+    bool IsLoaded() const;
+    Time GetSaveTime() const;
+
+    /**
+     * \brief Move the registered nodes to their saved positions
+     */
+    void RestorePositions();
+
+    /**
+     * \brief Compare the rebuilt association and BA state with the saved one
+     * \param checkTime simulation time of the check (before the applications start)
+     */
+    void ScheduleCheck(Time checkTime);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// State of a node in the checkpoint
+    struct NodeState
+    {
+        Vector position;
+        bool associated{false};
+        Mac48Address bssid;
+        uint8_t baUl{0}; //!< TIDs with a BA agreement STA -> AP (bitmap)
+        uint8_t baDl{0}; //!< TIDs with a BA agreement AP -> STA (bitmap)
+    };
+
+    /// Registered BSS
+    struct Network
+    {
+        std::string label;
+        NodeContainer apNodes;
+        NodeContainer staNodes;
+    };
+
+    NodeState Capture(Ptr<Node> node, Ptr<Node> apNode, bool isSta) const;
+    void Save(std::string filename) const;
+    void Check() const;
+    static std::string Key(const std::string& label, const std::string& role, uint32_t index);
+
+    std::vector<Network> m_networks;
+    std::vector<std::pair<std::string, double>> m_values; //!< draws in order of appearance
+    std::map<std::string, double> m_loadedValues;
+    std::map<std::string, NodeState> m_loadedNodes;
+    uint32_t m_seedNumber{1};
+    uint32_t m_runNumber{1};
+    Time m_saveTime{Seconds(0)};
+    bool m_loaded{false};
+};
+
+};
+#endif
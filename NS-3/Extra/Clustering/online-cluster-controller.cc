@@ -0,0 +1,438 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "online-cluster-controller.h"
+
+#include <ns3/abort.h>
+#include <ns3/ampdu-subframe-header.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/qos-multi-user-scheduler.h>
+#include <ns3/qos-txop.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-remote-station-manager.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("OnlineClusterController");
+
+NS_OBJECT_ENSURE_REGISTERED(OnlineClusterController);
+
+OnlineClusterController::OnlineClusterController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+OnlineClusterController::~OnlineClusterController()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+OnlineClusterController::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::OnlineClusterController")
+            .SetParent<Object>()
+            .AddConstructor<OnlineClusterController>()
+            .AddAttribute("Interval",
+                          "Time between clustering steps",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&OnlineClusterController::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("K",
+                          "Number of clusters",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&OnlineClusterController::m_k),
+                          MakeUintegerChecker<uint32_t>(2))
+            .AddAttribute("Decay",
+                          "Forgetting factor of the samples of a centroid",
+                          DoubleValue(0.9),
+                          MakeDoubleAccessor(&OnlineClusterController::m_decay),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("EdcaAction",
+                          "Set the CWmin of the STAs from the rank of their cluster (applied "
+                          "again after every beacon of the AP)",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&OnlineClusterController::m_edcaAction),
+                          MakeBooleanChecker())
+            .AddAttribute("OfdmaAction",
+                          "Set the urgency weight of the STAs in the Qos OFDMA scheduler",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&OnlineClusterController::m_ofdmaAction),
+                          MakeBooleanChecker())
+            .AddAttribute("PowerAction",
+                          "Raise the TX power level of the STAs of the worst cluster",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&OnlineClusterController::m_powerAction),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+void
+OnlineClusterController::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_stas.clear();
+    m_staIndex.clear();
+    if (m_csv.is_open())
+    {
+        m_csv.close();
+    }
+    Object::DoDispose();
+}
+
+void
+OnlineClusterController::AddBss(const std::string& label,
+                                const NetDeviceContainer& apDevices,
+                                const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    if (apDevices.GetN() == 0)
+    {
+        return;
+    }
+    Ptr<WifiNetDevice> ap = DynamicCast<WifiNetDevice>(apDevices.Get(0));
+    NS_ASSERT(ap);
+    ap->GetMac()->TraceConnectWithoutContext(
+        "AckedMpdu",
+        MakeCallback(&OnlineClusterController::NotifyAcked, this));
+
+    for (uint32_t i = 0; i < staDevices.GetN(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(staDevices.Get(i));
+        NS_ASSERT(device);
+        Sta sta;
+        sta.device = device;
+        sta.ap = ap;
+        sta.bss = label;
+        sta.initialPowerLevel = device->GetRemoteStationManager()->GetDefaultTxPowerLevel();
+
+        uint32_t index = m_stas.size();
+        m_staIndex[device->GetMac()->GetAddress()] = index;
+        m_stas.push_back(sta);
+
+        device->GetMac()->TraceConnectWithoutContext(
+            "MacRx",
+            MakeCallback(&OnlineClusterController::NotifyMacRx, this).Bind(index));
+        device->GetMac()->TraceConnectWithoutContext(
+            "AckedMpdu",
+            MakeCallback(&OnlineClusterController::NotifyAcked, this));
+        device->GetPhy()->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeCallback(&OnlineClusterController::NotifyRx, this).Bind(index));
+        device->GetMac()->TraceConnectWithoutContext(
+            "BeaconArrival",
+            MakeCallback(&OnlineClusterController::NotifyBeacon, this).Bind(index));
+    }
+}
+
+void
+OnlineClusterController::EnableCsv(const std::string& filename,
+                                   uint32_t seedNumber,
+                                   uint32_t runNumber)
+{
+    m_csv.open(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!m_csv.is_open(), "Can not open " << filename);
+    m_seedNumber = seedNumber;
+    m_runNumber = runNumber;
+}
+
+void
+OnlineClusterController::Start(Time measureStart, Time controlStart, Time measureEnd)
+{
+    NS_LOG_FUNCTION(this << measureStart << controlStart << measureEnd);
+    NS_ABORT_MSG_IF(measureStart >= controlStart || controlStart >= measureEnd,
+                    "The cluster control must start within the measurement window");
+    m_measureStart = measureStart;
+    m_controlStart = controlStart;
+    m_measureEnd = measureEnd;
+    Simulator::Schedule(measureStart + m_interval, &OnlineClusterController::Update, this);
+}
+
+void
+OnlineClusterController::NotifyMacRx(uint32_t staIndex, Ptr<const Packet> packet)
+{
+    Sta& sta = m_stas[staIndex];
+    sta.rxBytes += packet->GetSize();
+    sta.rxPackets++;
+
+    Time now = Simulator::Now();
+    if (now >= m_measureStart && now <= m_measureEnd)
+    {
+        m_rxBytes[now < m_controlStart ? 0 : 1] += packet->GetSize();
+    }
+}
+
+void
+OnlineClusterController::NotifyRx(uint32_t staIndex,
+                                  Ptr<const Packet> packet,
+                                  uint16_t channelFreqMhz,
+                                  WifiTxVector txVector,
+                                  MpduInfo aMpdu,
+                                  SignalNoiseDbm signalNoise,
+                                  uint16_t staId)
+{
+    // HE data frames are (S-)MPDUs: the sniffer gets every subframe with its delimiter
+    Ptr<const Packet> mpdu = packet;
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        Ptr<Packet> subframe = packet->Copy();
+        AmpduSubframeHeader delimiter;
+        subframe->RemoveHeader(delimiter);
+        mpdu = subframe;
+    }
+    WifiMacHeader header;
+    Sta& sta = m_stas[staIndex];
+    if (mpdu->PeekHeader(header) == 0 || header.GetAddr2() != sta.ap->GetMac()->GetAddress())
+    {
+        return;
+    }
+    sta.snrSum += signalNoise.signal - signalNoise.noise;
+    sta.snrSamples++;
+}
+
+void
+OnlineClusterController::NotifyAcked(Ptr<const WifiMpdu> mpdu)
+{
+    // Downlink MPDUs are accounted for their receiver, uplink ones for their transmitter
+    auto it = m_staIndex.find(mpdu->GetHeader().GetAddr1());
+    if (it == m_staIndex.end())
+    {
+        it = m_staIndex.find(mpdu->GetHeader().GetAddr2());
+    }
+    if (it == m_staIndex.end())
+    {
+        return;
+    }
+    double delay = (Simulator::Now() - mpdu->GetTimestamp()).GetSeconds() * 1000;
+    AddDelay(m_stas[it->second], delay);
+
+    Time now = Simulator::Now();
+    if (now >= m_measureStart && now <= m_measureEnd)
+    {
+        m_delaySum[now < m_controlStart ? 0 : 1] += delay;
+        m_delayCount[now < m_controlStart ? 0 : 1]++;
+    }
+}
+
+void
+OnlineClusterController::NotifyBeacon(uint32_t staIndex, Time arrival)
+{
+    // The STA takes the EDCA parameters of the beacon after this trace: apply the CWmin of the
+    // cluster once the beacon is processed
+    if (m_stas[staIndex].cwMin > 0)
+    {
+        Simulator::ScheduleNow(&OnlineClusterController::ApplyCwMin, this, staIndex);
+    }
+}
+
+void
+OnlineClusterController::ApplyCwMin(uint32_t staIndex)
+{
+    const Sta& sta = m_stas[staIndex];
+    sta.device->GetMac()->GetQosTxop(AC_BE)->SetMinCw(sta.cwMin);
+}
+
+void
+OnlineClusterController::AddDelay(Sta& sta, double delay)
+{
+    if (sta.lastDelay >= 0)
+    {
+        sta.jitterSum += std::abs(delay - sta.lastDelay);
+    }
+    sta.lastDelay = delay;
+    sta.delaySum += delay;
+    sta.delaySamples++;
+}
+
+OnlineClusterController::Features
+OnlineClusterController::Standardise(const Features& features)
+{
+    // Running mean and variance of every feature (Welford)
+    m_nSamples++;
+    Features standardised;
+    for (uint32_t f = 0; f < N_FEATURES; f++)
+    {
+        double delta = features[f] - m_mean[f];
+        m_mean[f] += delta / m_nSamples;
+        m_m2[f] += delta * (features[f] - m_mean[f]);
+        double sd = (m_nSamples > 1) ? std::sqrt(m_m2[f] / (m_nSamples - 1)) : 0;
+        standardised[f] = (sd > 0) ? (features[f] - m_mean[f]) / sd : 0;
+    }
+    return standardised;
+}
+
+uint32_t
+OnlineClusterController::Cluster(const Features& sample)
+{
+    uint32_t nearest = 0;
+    double nearestDistance = std::numeric_limits<double>::infinity();
+    for (uint32_t c = 0; c < m_centroids.size(); c++)
+    {
+        double distance = 0;
+        for (uint32_t f = 0; f < N_FEATURES; f++)
+        {
+            distance += (sample[f] - m_centroids[c][f]) * (sample[f] - m_centroids[c][f]);
+        }
+        if (distance < nearestDistance)
+        {
+            nearestDistance = distance;
+            nearest = c;
+        }
+    }
+
+    // The first K distinct samples seed the centroids
+    if (m_centroids.size() < m_k && nearestDistance > 1e-9)
+    {
+        m_centroids.push_back(sample);
+        m_weights.push_back(1);
+        return m_centroids.size() - 1;
+    }
+
+    // Sequential k-means step with forgetting
+    m_weights[nearest] = m_decay * m_weights[nearest] + 1;
+    for (uint32_t f = 0; f < N_FEATURES; f++)
+    {
+        m_centroids[nearest][f] += (sample[f] - m_centroids[nearest][f]) / m_weights[nearest];
+    }
+    return nearest;
+}
+
+std::vector<uint32_t>
+OnlineClusterController::RankClusters() const
+{
+    // Quality of a centroid: throughput + SNR - delay - jitter (standardised units)
+    std::vector<uint32_t> order(m_centroids.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto quality = [this](uint32_t c) {
+        const Features& centroid = m_centroids[c];
+        return centroid[0] + centroid[2] - centroid[3] - centroid[4];
+    };
+    std::sort(order.begin(), order.end(), [&quality](uint32_t a, uint32_t b) {
+        return quality(a) < quality(b);
+    });
+
+    std::vector<uint32_t> rank(m_centroids.size());
+    for (uint32_t r = 0; r < order.size(); r++)
+    {
+        rank[order[r]] = r;
+    }
+    return rank;
+}
+
+void
+OnlineClusterController::Apply(Sta& sta, uint32_t rank)
+{
+    Mac48Address address = sta.device->GetMac()->GetAddress();
+    if (m_edcaAction)
+    {
+        sta.cwMin = std::min<uint32_t>(15, (4 << std::min<uint32_t>(rank, 3)) - 1);
+        ApplyCwMin(m_staIndex.at(address));
+    }
+    if (m_ofdmaAction)
+    {
+        Ptr<QosMultiUserScheduler> scheduler =
+            sta.ap->GetMac()->GetObject<QosMultiUserScheduler>();
+        NS_ABORT_MSG_IF(!scheduler, "The OFDMA action needs the Qos MU scheduler");
+        scheduler->SetUrgencyWeight(address, m_k - rank);
+    }
+    if (m_powerAction)
+    {
+        uint8_t level = (rank == 0) ? sta.device->GetPhy()->GetNTxPower() - 1
+                                    : sta.initialPowerLevel;
+        sta.device->GetRemoteStationManager()->SetDefaultTxPowerLevel(level);
+    }
+}
+
+void
+OnlineClusterController::Update()
+{
+    NS_LOG_FUNCTION(this);
+    double interval = m_interval.GetSeconds();
+
+    for (auto& sta : m_stas)
+    {
+        if (sta.snrSamples > 0)
+        {
+            sta.lastSnr = sta.snrSum / sta.snrSamples;
+        }
+        Features features = {
+            sta.rxBytes * 8.0 / interval / 1e6,
+            static_cast<double>(sta.rxPackets),
+            sta.lastSnr,
+            (sta.delaySamples > 0) ? sta.delaySum / sta.delaySamples : 0,
+            (sta.delaySamples > 1) ? sta.jitterSum / (sta.delaySamples - 1) : 0,
+        };
+        sta.cluster = Cluster(Standardise(features));
+
+        if (m_csv.is_open())
+        {
+            // seed, run, time, BSS, node, cluster, throughput (Mbps), rx packets, SNR (dB),
+            // delay (ms), jitter (ms)
+            m_csv << m_seedNumber << "," << m_runNumber << "," << Simulator::Now().GetSeconds()
+                  << "," << sta.bss << "," << sta.device->GetNode()->GetId() << ","
+                  << sta.cluster;
+            for (double feature : features)
+            {
+                m_csv << "," << feature;
+            }
+            m_csv << "\n";
+        }
+
+        sta.rxBytes = 0;
+        sta.rxPackets = 0;
+        sta.snrSum = 0;
+        sta.snrSamples = 0;
+        sta.delaySum = 0;
+        sta.jitterSum = 0;
+        sta.delaySamples = 0;
+        sta.lastDelay = -1;
+    }
+
+    if (Simulator::Now() >= m_controlStart && m_centroids.size() == m_k)
+    {
+        std::vector<uint32_t> rank = RankClusters();
+        for (auto& sta : m_stas)
+        {
+            Apply(sta, rank[sta.cluster]);
+        }
+    }
+
+    if (Simulator::Now() + m_interval < m_measureEnd)
+    {
+        Simulator::Schedule(m_interval, &OnlineClusterController::Update, this);
+    }
+}
+
+void
+OnlineClusterController::Report() const
+{
+    double before = m_rxBytes[0] * 8.0 / (m_controlStart - m_measureStart).GetSeconds() / 1e6;
+    double after = m_rxBytes[1] * 8.0 / (m_measureEnd - m_controlStart).GetSeconds() / 1e6;
+    double delayBefore = (m_delayCount[0] > 0) ? m_delaySum[0] / m_delayCount[0] : 0;
+    double delayAfter = (m_delayCount[1] > 0) ? m_delaySum[1] / m_delayCount[1] : 0;
+    std::cout << "Cluster control: STA MAC throughput " << before << " Mbps before, " << after
+              << " Mbps after; MAC delay " << delayBefore << " ms before, " << delayAfter
+              << " ms after" << std::endl;
+}
+
+}
@@ -0,0 +1,162 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef ONLINE_CLUSTER_CONTROLLER_H
+#define ONLINE_CLUSTER_CONTROLLER_H
+
+#include <ns3/mac48-address.h>
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-phy-common.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <array>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class WifiMpdu;
+class WifiNetDevice;
+
+/**
+ * \ingroup helper
+ * \brief In-simulation clustering of the STAs with a QoS action per cluster
+ *
+ * Every Interval, a feature vector is built for every STA from the last interval: MAC
+ * throughput and received packets, SNR of the frames from its AP, mean MAC delay (enqueue to
+ * acknowledgment, both directions) and its jitter. The features are standardised with their
+ * running mean and variance and clustered with sequential k-means (every sample moves its
+ * nearest centroid, with a forgetting factor so that the clusters follow the STAs).
+ *
+ * The clusters are ranked by the quality of their centroid (throughput + SNR - delay - jitter).
+ * From the control start on, every STA gets the action of the rank of its cluster, the worst
+ * cluster getting the strongest one:
+ *
+ * - Edca: CWmin of the BE queue of the STA (3 for the worst cluster, 7, 15...). The EDCA
+ *   Parameter Set of the AP is BSS-wide and a STA takes it again from every beacon, so the
+ *   CWmin of the cluster is applied again right after every beacon of the AP;
+ * - Ofdma: urgency weight in the QosMultiUserScheduler of the AP (K for the worst cluster,
+ *   K-1... 1 for the best one);
+ * - Power: highest TX power level for the worst cluster, initial level for the others.
+ */
+class OnlineClusterController : public Object
+{
+  public:
+    /// Features of a STA
+    static constexpr uint32_t N_FEATURES = 5;
+    using Features = std::array<double, N_FEATURES>;
+
+    OnlineClusterController();
+    ~OnlineClusterController() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Cluster the STAs of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Start the periodic clustering
+     * \param measureStart first clustering step and start of the accounting
+     * \param controlStart first step applying the cluster actions
+     * \param measureEnd end of the accounting
+     */
+    void Start(Time measureStart, Time controlStart, Time measureEnd);
+
+    /**
+     * \brief Log the cluster of every STA at every step to a CSV file
+     * \param filename output file (appended)
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void EnableCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber);
+
+    /**
+     * \brief Print the throughput and MAC delay of the STAs before and after the control
+     */
+    void Report() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Clustered STA
+    struct Sta
+    {
+        Ptr<WifiNetDevice> device;
+        Ptr<WifiNetDevice> ap;
+        std::string bss;
+        uint8_t initialPowerLevel;
+        uint32_t cwMin{0}; //!< BE CWmin of the cluster (0 while not controlled)
+        // Counters of the current interval
+        uint64_t rxBytes{0};
+        uint32_t rxPackets{0};
+        double snrSum{0};
+        uint32_t snrSamples{0};
+        double delaySum{0};
+        double jitterSum{0};
+        uint32_t delaySamples{0};
+        double lastDelay{-1};
+        double lastSnr{0};
+        uint32_t cluster{0};
+    };
+
+    void NotifyMacRx(uint32_t staIndex, Ptr<const Packet> packet);
+    void NotifyRx(uint32_t staIndex,
+                  Ptr<const Packet> packet,
+                  uint16_t channelFreqMhz,
+                  WifiTxVector txVector,
+                  MpduInfo aMpdu,
+                  SignalNoiseDbm signalNoise,
+                  uint16_t staId);
+    void NotifyAcked(Ptr<const WifiMpdu> mpdu);
+    void NotifyBeacon(uint32_t staIndex, Time arrival);
+    void ApplyCwMin(uint32_t staIndex);
+    void AddDelay(Sta& sta, double delay);
+    void Update();
+    Features Standardise(const Features& features);
+    uint32_t Cluster(const Features& sample);
+    std::vector<uint32_t> RankClusters() const;
+    void Apply(Sta& sta, uint32_t rank);
+
+    Time m_interval;
+    uint32_t m_k;
+    double m_decay;
+    bool m_edcaAction;
+    bool m_ofdmaAction;
+    bool m_powerAction;
+
+    std::vector<Sta> m_stas;
+    std::map<Mac48Address, uint32_t> m_staIndex;
+    std::vector<Features> m_centroids;
+    std::vector<double> m_weights; //!< decayed sample count per centroid
+    Features m_mean{};
+    Features m_m2{};
+    uint64_t m_nSamples{0};
+
+    Time m_measureStart;
+    Time m_controlStart;
+    Time m_measureEnd;
+    std::array<uint64_t, 2> m_rxBytes{};    //!< before / after the control start
+    std::array<double, 2> m_delaySum{};     //!< before / after the control start
+    std::array<uint64_t, 2> m_delayCount{}; //!< before / after the control start
+    std::ofstream m_csv;
+    uint32_t m_seedNumber{0};
+    uint32_t m_runNumber{0};
+};
+
+};
+#endif
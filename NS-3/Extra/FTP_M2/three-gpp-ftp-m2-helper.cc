@@ -70,7 +70,9 @@ ThreeGppFtpM2Helper::DoConfigureFtpClients()
     for (uint32_t i = 0; i < m_serversIps->GetN(); i++)
     {
         Ipv4Address ipAddress = m_serversIps->GetAddress(i, 0);
-        AddressValue remoteAddress(InetSocketAddress(ipAddress, m_port));
+        InetSocketAddress remote(ipAddress, m_port);
+        remote.SetTos(m_tos);
+        AddressValue remoteAddress(remote);
         ftpHelper.SetAttribute("Remote", remoteAddress);
         m_clientApps->Add(ftpHelper.Install(*m_clientNodes));
     }
@@ -134,6 +136,13 @@ ThreeGppFtpM2Helper::Configure(uint16_t port,
     m_startJitter->SetAttribute("Max", DoubleValue(0.100));
 }
 
+void
+ThreeGppFtpM2Helper::SetTos(uint8_t tos)
+{
+    NS_LOG_FUNCTION(this << +tos);
+    m_tos = tos;
+}
+
 void
 ThreeGppFtpM2Helper::Start()
 {
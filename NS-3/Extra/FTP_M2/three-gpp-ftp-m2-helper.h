@@ -46,6 +46,11 @@ class ThreeGppFtpM2Helper : public Object
                    double ftpMu,
                    double ftpSigma,
                    double dataRate);
+    /**
+     * \brief Set the type of service of the FTP packets (0 by default)
+     * \param tos type of service, to be called before Start
+     */
+    void SetTos(uint8_t tos);
     void Start();
 
   private:
@@ -57,6 +62,7 @@ class ThreeGppFtpM2Helper : public Object
     Ptr<ExponentialRandomVariable> m_ftpArrivals;
     Ptr<UniformRandomVariable> m_startJitter;
     uint16_t m_port{0};
+    uint8_t m_tos{0};
     Time m_clientStartTime{Seconds(0)};
     Time m_clientStopTime{Seconds(0)};
     double m_ftpLambda{0.0};
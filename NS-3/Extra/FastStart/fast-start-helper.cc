@@ -0,0 +1,205 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "fast-start-helper.h"
+
+#include <ns3/boolean.h>
+#include <ns3/config.h>
+#include <ns3/inet-socket-address.h>
+#include <ns3/ipv4.h>
+#include <ns3/log.h>
+#include <ns3/nstime.h>
+#include <ns3/packet.h>
+#include <ns3/simulator.h>
+#include <ns3/sta-wifi-mac.h>
+#include <ns3/udp-socket-factory.h>
+#include <ns3/wifi-net-device.h>
+
+#include <iostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FastStartHelper");
+
+FastStartHelper::FastStartHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FastStartHelper::~FastStartHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+FastStartHelper::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FastStartHelper")
+                            .SetParent<Object>()
+                            .AddConstructor<FastStartHelper>();
+    return tid;
+}
+
+void
+FastStartHelper::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& socket : m_sockets)
+    {
+        socket->Close();
+    }
+    m_sockets.clear();
+    Object::DoDispose();
+}
+
+void
+FastStartHelper::ConfigureDefaults()
+{
+    // Probe right away instead of waiting for a beacon (up to one beacon interval)
+    Config::SetDefault("ns3::StaWifiMac::ActiveProbing", BooleanValue(true));
+    Config::SetDefault("ns3::StaWifiMac::ProbeRequestTimeout", TimeValue(MilliSeconds(10)));
+    Config::SetDefault("ns3::StaWifiMac::AssocRequestTimeout", TimeValue(MilliSeconds(10)));
+}
+
+void
+FastStartHelper::Install(const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t i = 0; i < staDevices.GetN(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(staDevices.Get(i));
+        NS_ASSERT(device);
+        Ptr<StaWifiMac> mac = DynamicCast<StaWifiMac>(device->GetMac());
+        NS_ABORT_MSG_IF(!mac, "Fast start can only track STA devices");
+
+        uint32_t staIndex = m_assocTime.size();
+        m_assocTime.push_back(Time::Max());
+        mac->TraceConnectWithoutContext(
+            "Assoc",
+            MakeCallback(&FastStartHelper::NotifyAssoc, this).Bind(staIndex));
+    }
+}
+
+void
+FastStartHelper::NotifyAssoc(uint32_t staIndex, Mac48Address bssid)
+{
+    NS_LOG_FUNCTION(this << staIndex << bssid);
+    if (m_assocTime[staIndex] != Time::Max())
+    {
+        // Re-association: only the first one is relevant for the start-up phase
+        return;
+    }
+    m_assocTime[staIndex] = Simulator::Now();
+    m_lastAssociation = Simulator::Now();
+    m_nAssociated++;
+}
+
+void
+FastStartHelper::PrimeBlockAck(const NodeContainer& apNodes,
+                               const NodeContainer& staNodes,
+                               const std::vector<uint8_t>& tosValues,
+                               Time primeTime)
+{
+    NS_LOG_FUNCTION(this << primeTime);
+    if (apNodes.GetN() == 0 || staNodes.GetN() == 0)
+    {
+        return;
+    }
+    Ptr<Node> apNode = apNodes.Get(0);
+
+    // Sink sockets on the discard port, so that priming datagrams trigger no ICMP
+    BindDiscardSocket(apNode);
+    for (uint32_t i = 0; i < staNodes.GetN(); i++)
+    {
+        BindDiscardSocket(staNodes.Get(i));
+    }
+
+    Simulator::Schedule(primeTime,
+                        &FastStartHelper::SendPrimingDatagrams,
+                        this,
+                        apNode,
+                        staNodes,
+                        tosValues);
+}
+
+void
+FastStartHelper::BindDiscardSocket(Ptr<Node> node)
+{
+    Ptr<Socket> socket = Socket::CreateSocket(node, UdpSocketFactory::GetTypeId());
+    socket->Bind(InetSocketAddress(Ipv4Address::GetAny(), m_discardPort));
+    m_sockets.push_back(socket);
+}
+
+void
+FastStartHelper::SendPrimingDatagrams(Ptr<Node> apNode,
+                                      NodeContainer staNodes,
+                                      std::vector<uint8_t> tosValues)
+{
+    NS_LOG_FUNCTION(this << apNode);
+    // One datagram per direction and access category starts the ADDBA handshakes
+    for (uint32_t i = 0; i < staNodes.GetN(); i++)
+    {
+        for (uint8_t tos : tosValues)
+        {
+            SendDatagram(apNode, staNodes.Get(i), tos);
+            SendDatagram(staNodes.Get(i), apNode, tos);
+        }
+    }
+}
+
+void
+FastStartHelper::SendDatagram(Ptr<Node> from, Ptr<Node> to, uint8_t tos)
+{
+    Ipv4Address destination = to->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal();
+
+    Ptr<Socket> socket = Socket::CreateSocket(from, UdpSocketFactory::GetTypeId());
+    socket->Bind();
+    socket->SetIpTos(tos);
+    socket->SendTo(Create<Packet>(m_primeSize), 0, InetSocketAddress(destination, m_discardPort));
+    m_sockets.push_back(socket);
+}
+
+uint32_t
+FastStartHelper::GetNStations() const
+{
+    return m_assocTime.size();
+}
+
+uint32_t
+FastStartHelper::GetNAssociated() const
+{
+    return m_nAssociated;
+}
+
+Time
+FastStartHelper::GetLastAssociationTime() const
+{
+    return m_lastAssociation;
+}
+
+void
+FastStartHelper::Report(Time appStartTime) const
+{
+    uint32_t lateStations = 0;
+    for (const auto& assocTime : m_assocTime)
+    {
+        if (assocTime > appStartTime)
+        {
+            lateStations++;
+        }
+    }
+
+    std::cout << "Fast start: " << m_nAssociated << "/" << GetNStations()
+              << " STAs associated, last association at " << m_lastAssociation.GetSeconds()
+              << " s" << std::endl;
+    if (lateStations > 0)
+    {
+        std::cout << "Fast start: " << lateStations << " STAs were not associated at "
+                  << appStartTime.GetSeconds() << " s (application start)" << std::endl;
+    }
+}
+
+}
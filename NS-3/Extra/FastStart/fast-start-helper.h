@@ -0,0 +1,96 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef FAST_START_HELPER_H
+#define FAST_START_HELPER_H
+
+#include <ns3/mac48-address.h>
+#include <ns3/net-device-container.h>
+#include <ns3/node-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/socket.h>
+
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup helper
+ * \brief Helper for a pre-associated (fast start) set up of the Wi-Fi networks
+ *
+ * ns-3 does not allow installing a StaWifiMac in the associated state, so the helper
+ * makes the association phase as short and deterministic as possible instead:
+ * STAs probe actively as soon as they start (no waiting for beacons), the management
+ * timeouts are shortened and the association of every STA is tracked, so that the
+ * applications can start right after the whole set of STAs is associated.
+ *
+ * Optionally, one datagram per access category is exchanged with every STA before the
+ * applications start, so that block ack agreements are already established when the
+ * measured traffic begins.
+ */
+class FastStartHelper : public Object
+{
+  public:
+    FastStartHelper();
+    ~FastStartHelper() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Set the StaWifiMac defaults for an immediate association
+     *
+     * Must be called before the Wi-Fi devices are installed.
+     */
+    static void ConfigureDefaults();
+
+    /**
+     * \brief Track the association of the STAs of a BSS
+     * \param staDevices the STA devices of the BSS
+     */
+    void Install(const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Establish block ack agreements before the applications start
+     * \param apNodes the AP of the BSS (nothing is done for an empty container)
+     * \param staNodes the STAs of the BSS
+     * \param tosValues one ToS per access category to prime
+     * \param primeTime time at which the priming datagrams are sent
+     */
+    void PrimeBlockAck(const NodeContainer& apNodes,
+                       const NodeContainer& staNodes,
+                       const std::vector<uint8_t>& tosValues,
+                       Time primeTime);
+
+    uint32_t GetNStations() const;
+    uint32_t GetNAssociated() const;
+    Time GetLastAssociationTime() const;
+
+    /**
+     * \brief Print the association summary
+     * \param appStartTime start time of the applications
+     */
+    void Report(Time appStartTime) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void NotifyAssoc(uint32_t staIndex, Mac48Address bssid);
+    void SendPrimingDatagrams(Ptr<Node> apNode,
+                              NodeContainer staNodes,
+                              std::vector<uint8_t> tosValues);
+    void SendDatagram(Ptr<Node> from, Ptr<Node> to, uint8_t tos);
+    void BindDiscardSocket(Ptr<Node> node);
+
+    static const uint16_t m_discardPort{9};
+    static const uint32_t m_primeSize{64};
+    std::vector<Time> m_assocTime;
+    uint32_t m_nAssociated{0};
+    Time m_lastAssociation{Seconds(0)};
+    std::vector<Ptr<Socket>> m_sockets;
+};
+
+};
+#endif
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# Function to build the grid and hexagonal deployments of scenario 5 and time their setup
+run_benchmark() {
+    # Change directory to the ns-3 installation directory
+    cd /home/user/Documents/ns3/ns-3-dev
+
+    # Execute the ns-3 scenario with the incremented parameter
+    ./ns3 run "scenario5.cc --layout=Grid --nAps=$3 --nStaMean=10 --setupOnly=true --seedNumber=$1 --runNumber=$2"
+    ./ns3 run "scenario5.cc --layout=Hex --nAps=$3 --nStaMean=10 --setupOnly=true --seedNumber=$1 --runNumber=$2"
+}
+
+# Initialize the parameter value
+runNumber=1
+seedNumber=123
+max_executions=3
+
+# Enterprise and stadium scales: 100 to 500 APs
+while [ $runNumber -le $max_executions ]; do
+    for nAps in 100 200 300 400 500; do
+        run_benchmark $seedNumber $runNumber $nAps
+    done
+    ((runNumber++))
+done
+
+# Average setup time per layout and size
+# Columns: Seed, Run, Layout, APs, STAs, Nodes, Mobility, Wifi, Channel plan, Internet,
+# Applications, Total setup, Wall-clock run time
+awk -F, '{ key = $3 " " $4; setup[key] += $12; wifi[key] += $8; sta[key] += $5; n[key]++ }
+     END { for (k in n) printf "%s APs (%.0f STAs): setup %.2f s (wifi %.2f s)\n", k, sta[k] / n[k], setup[k] / n[k], wifi[k] / n[k] }' \
+    /home/user/Documents/ns3/ns-3-dev/Scenario5-Setup.csv | sort -k1,1 -k2,2n
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Function to execute scenario 3 at full load with and without the MAC queue statistics
+run_benchmark() {
+    # Change directory to the ns-3 installation directory
+    cd /home/user/Documents/ns3/ns-3-dev
+
+    # Execute the ns-3 scenario with the incremented parameter
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=50 --nStaB=50 --nStaC=50 --nStaD=50 --nStaE=50 --dataRate=100000000 --tracing=false --frequency=5 --macStats=false --seedNumber=$1 --runNumber=$2"
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=50 --nStaB=50 --nStaC=50 --nStaD=50 --nStaE=50 --dataRate=100000000 --tracing=false --frequency=5 --macStats=true --seedNumber=$1 --runNumber=$2"
+}
+
+# Initialize the parameter value
+runNumber=1
+seedNumber=123
+max_executions=5
+
+# Same seed and run for both configurations
+while [ $runNumber -le $max_executions ]; do
+    run_benchmark $seedNumber $runNumber
+    ((runNumber++))
+done
+
+# Average wall-clock time per configuration and overhead of the statistics (target below 5 %;
+# not measured yet, this script has not been run)
+# Columns: Seed, Run, Packet pool, Wall-clock (s), VoD packets, Allocations, Recycled, Allocation rate,
+# PHY model, MAC stats
+awk -F, 'NF >= 10 { wall[$10] += $4; n[$10]++ }
+     END { if (n[0] && n[1]) printf "MAC stats off: %.2f s, on: %.2f s, overhead %.1f %%\n", wall[0] / n[0], wall[1] / n[1], 100 * (wall[1] / n[1] - wall[0] / n[0]) / (wall[0] / n[0]) }' \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-Benchmark.csv
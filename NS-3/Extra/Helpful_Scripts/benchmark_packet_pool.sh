@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Function to execute scenario 3 at full load with and without packet pool
+run_benchmark() {
+    # Change directory to the ns-3 installation directory
+    cd /home/user/Documents/ns3/ns-3-dev
+
+    # Execute the ns-3 scenario with the incremented parameter
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=50 --nStaB=50 --nStaC=50 --nStaD=50 --nStaE=50 --dataRate=100000000 --tracing=false --frequency=5 --usePacketPool=false --seedNumber=$1 --runNumber=$2"
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=50 --nStaB=50 --nStaC=50 --nStaD=50 --nStaE=50 --dataRate=100000000 --tracing=false --frequency=5 --usePacketPool=true --seedNumber=$1 --runNumber=$2"
+}
+
+# Initialize the parameter value
+runNumber=1
+seedNumber=123
+max_executions=5
+
+# Same seed and run for both configurations
+while [ $runNumber -le $max_executions ]; do
+    run_benchmark $seedNumber $runNumber
+    ((runNumber++))
+done
+
+# Average wall-clock time and allocation rate per configuration
+# Columns: Seed, Run, Packet pool, Wall-clock (s), VoD packets, Allocations, Recycled, Allocation rate
+awk -F, '{ wall[$3] += $4; rate[$3] += $8; n[$3]++ }
+     END { for (p in n) printf "Packet pool=%s: wall-clock %.2f s, %.0f allocations/s\n", p, wall[p] / n[p], rate[p] / n[p] }' \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-Benchmark.csv
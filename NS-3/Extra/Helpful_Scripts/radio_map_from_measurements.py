@@ -0,0 +1,79 @@
+############################################################################################
+# Radio map from measured data (tx_x,tx_y,rx_x,rx_y,gain_dB), in the binary format
+# memory-mapped by ns3::RadioMapPropagationLossModel (see
+# NS-3/Extra/RadioMap/radio-map-propagation-loss-model.h)
+#
+# Every transmitter position is a source of the map; the gain of every cell is the inverse
+# distance weighting of the measurements of that source (power 2, up to 8 nearest points).
+#
+# Usage: python3 radio_map_from_measurements.py measurements.csv map.rmp cellSize
+############################################################################################
+#LIBRARIES #################################################################################
+############################################################################################
+import csv
+import math
+import struct
+import sys
+from collections import defaultdict
+
+############################################################################################
+# EXTRA FUNCTIONS ##########################################################################
+############################################################################################
+def readMeasurements(fileName):
+    measurements = defaultdict(list)
+    with open(fileName, newline='') as measurementFile:
+        for row in csv.reader(measurementFile):
+            if not row or row[0].startswith('#'):
+                continue
+            try:
+                txX, txY, rxX, rxY, gain = map(float, row[0:5])
+            except ValueError:
+                continue  # Header row
+            measurements[(txX, txY)].append((rxX, rxY, gain))
+    return measurements
+
+def interpolateGain(points, x, y, nNearest=8):
+    nearest = sorted(points, key=lambda point: (point[0] - x) ** 2 + (point[1] - y) ** 2)
+    weightSum = 0
+    gainSum = 0
+    for rxX, rxY, gain in nearest[:nNearest]:
+        distance = math.hypot(rxX - x, rxY - y)
+        if distance < 1e-9:
+            return gain
+        weightSum += 1 / distance ** 2
+        gainSum += gain / distance ** 2
+    return gainSum / weightSum
+
+def writeRadioMap(measurements, cellSize, fileName):
+    points = [point for sourcePoints in measurements.values() for point in sourcePoints]
+    xMin = min(point[0] for point in points)
+    yMin = min(point[1] for point in points)
+    nx = max(math.ceil((max(point[0] for point in points) - xMin) / cellSize), 1)
+    ny = max(math.ceil((max(point[1] for point in points) - yMin) / cellSize), 1)
+    sources = list(measurements)
+    with open(fileName, 'wb') as mapFile:
+        mapFile.write(b'NS3RMP1\0')
+        mapFile.write(struct.pack('=QQQ', len(sources), nx, ny))
+        mapFile.write(struct.pack('=ddd', xMin, yMin, cellSize))
+        mapFile.write(struct.pack('=%dd' % len(sources), *[source[0] for source in sources]))
+        mapFile.write(struct.pack('=%dd' % len(sources), *[source[1] for source in sources]))
+        for source in sources:
+            gains = [interpolateGain(measurements[source],
+                                     xMin + (i + 0.5) * cellSize,
+                                     yMin + (j + 0.5) * cellSize)
+                     for j in range(ny) for i in range(nx)]
+            mapFile.write(struct.pack('=%df' % len(gains), *gains))
+    return nx, ny
+
+############################################################################################
+# MAIN #####################################################################################
+############################################################################################
+if len(sys.argv) != 4:
+    sys.exit('Usage: python3 radio_map_from_measurements.py <measurements.csv> <map.rmp> '
+             '<cellSize>')
+
+mapMeasurements = readMeasurements(sys.argv[1])
+if not mapMeasurements:
+    sys.exit('No measurements in %s' % sys.argv[1])
+mapNx, mapNy = writeRadioMap(mapMeasurements, float(sys.argv[3]), sys.argv[2])
+print('%d sources, %dx%d cells' % (len(mapMeasurements), mapNx, mapNy))
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Function to execute scenario 3 with the given Block Ack buffer and A-MPDU size
+run_sweep() {
+    # Change directory to the ns-3 installation directory
+    cd /home/user/Documents/ns3/ns-3-dev
+
+    # Execute the ns-3 scenario with the aggregation settings
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=20 --nStaB=20 --nStaC=20 --nStaD=20 --nStaE=20 --tracing=false --frequency=5 --ampduStats=true --useExtendedBlockAck=$1 --maxAmpduSize=$2 --seedNumber=$3 --runNumber=$4"
+}
+
+# Initialize the parameter value
+seedNumber=123
+max_executions=3
+
+# Same seeds and runs for every combination of the settings
+for useExtendedBlockAck in false true; do
+    for maxAmpduSize in 65535 1048575 8388607; do
+        runNumber=1
+        while [ $runNumber -le $max_executions ]; do
+            run_sweep $useExtendedBlockAck $maxAmpduSize $seedNumber $runNumber
+            ((runNumber++))
+        done
+    done
+done
+
+# Mean A-MPDU length, MPDU success ratio and acknowledged throughput (summed over the links) per
+# setting and direction
+# Columns: Seed, Run, BSS, Frequency, Direction, MPDU buffer size, Max A-MPDU size, PSDUs, MPDUs,
+# Mean length, Mean duration, Acked MPDUs, Failed MPDUs, Success ratio, Acked throughput
+awk -F, '{ key = $6 "," $7 "," $5; psdus[key] += $8; mpdus[key] += $9; acked[key] += $12; failed[key] += $13; tput[key] += $15; if (!((key, $1, $2) in seen)) { seen[key, $1, $2]; runs[key]++ } }
+     END { for (k in psdus) { split(k, f, ","); printf "Buffer %s, max A-MPDU %s B, %s: %.1f MPDUs per A-MPDU, success %.3f, %.1f Mbps\n", f[1], f[2], f[3], mpdus[k] / psdus[k], acked[k] / (acked[k] + failed[k]), tput[k] / runs[k] } }' \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-Ampdu.csv
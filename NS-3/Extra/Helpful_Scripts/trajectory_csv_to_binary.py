@@ -0,0 +1,51 @@
+############################################################################################
+# Conversion of a CSV mobility trace (node,time,x,y,z) into the binary trajectory format
+# memory-mapped by ns3::TrajectoryTrace (see NS-3/Extra/Trajectory/trajectory-trace.h)
+#
+# Usage: python3 trajectory_csv_to_binary.py trace.csv trace.trj
+############################################################################################
+#LIBRARIES #################################################################################
+############################################################################################
+import csv
+import struct
+import sys
+from collections import defaultdict
+
+############################################################################################
+# EXTRA FUNCTIONS ##########################################################################
+############################################################################################
+def readTrace(fileName):
+    tracks = defaultdict(list)
+    with open(fileName, newline='') as traceFile:
+        for row in csv.reader(traceFile):
+            if not row or row[0].startswith('#'):
+                continue
+            try:
+                node, time, x, y, z = int(row[0]), *map(float, row[1:5])
+            except ValueError:
+                continue  # Header row
+            tracks[node].append((time, x, y, z))
+    # Tracks numbered by ascending node identifier, waypoints sorted by time
+    return [sorted(tracks[node], key=lambda waypoint: waypoint[0]) for node in sorted(tracks)]
+
+def writeBinary(tracks, fileName):
+    offsets = [0]
+    for track in tracks:
+        offsets.append(offsets[-1] + len(track))
+    with open(fileName, 'wb') as binaryFile:
+        binaryFile.write(b'NS3TRJ1\0')
+        binaryFile.write(struct.pack('=QQ', len(tracks), offsets[-1]))
+        binaryFile.write(struct.pack('=%dQ' % len(offsets), *offsets))
+        for component in range(4):
+            values = [waypoint[component] for track in tracks for waypoint in track]
+            binaryFile.write(struct.pack('=%dd' % len(values), *values))
+
+############################################################################################
+# MAIN #####################################################################################
+############################################################################################
+if len(sys.argv) != 3:
+    sys.exit('Usage: python3 trajectory_csv_to_binary.py <trace.csv> <trace.trj>')
+
+traceTracks = readTrace(sys.argv[1])
+writeBinary(traceTracks, sys.argv[2])
+print('%d tracks, %d waypoints' % (len(traceTracks), sum(len(track) for track in traceTracks)))
@@ -0,0 +1,76 @@
+############################################################################################
+# Validation of the Abstract PHY of scenario 3 against the detailed (Spectrum) PHY: per-flow
+# throughput, delay and loss of the same seeds and runs, and wall-clock speed-up
+#
+# Usage: python3 validate_phy_abstraction.py Scenario3-FlowStats-Spectrum.csv
+#                Scenario3-FlowStats-Abstract.csv Scenario3-Benchmark.csv
+############################################################################################
+#LIBRARIES #################################################################################
+############################################################################################
+# Numeric data management libraries
+import pandas as pd
+import numpy as np
+
+# Data plotting
+import matplotlib.pyplot as plt
+
+import sys
+
+############################################################################################
+# EXTRA FUNCTIONS ##########################################################################
+############################################################################################
+FLOW_COLUMNS = ["seed", "run", "network", "direction", "flowid", "sourceip", "sourceport",
+                "destinationip", "destinationport", "protocol", "txpackets", "txbytes",
+                "txoffered", "rxpackets", "rxbytes", "throughput", "meandelay", "lastdelay",
+                "meanjitter"]
+FLOW_KEY = ["seed", "run", "sourceip", "sourceport", "destinationip", "destinationport",
+            "protocol"]
+BENCHMARK_COLUMNS = ["seed", "run", "packetpool", "wallclock", "vodpackets", "allocations",
+                     "recycled", "allocationrate", "phymodel", "macstats"]
+
+def readFlows(fileName):
+    flows = pd.read_csv(fileName, header=None, names=FLOW_COLUMNS)
+    flows["loss"] = 1 - flows["rxpackets"] / flows["txpackets"].clip(lower=1)
+    return flows
+
+def plotComparison(axes, flows, metric, label):
+    spectrum = flows[metric + "_spectrum"]
+    abstract = flows[metric + "_abstract"]
+    limits = [min(spectrum.min(), abstract.min()), max(spectrum.max(), abstract.max())]
+    axes.scatter(spectrum, abstract, s=12)
+    axes.plot(limits, limits, color='black', linewidth=1)
+    axes.set_xlabel(label + ' (Spectrum)', fontsize=14)
+    axes.set_ylabel(label + ' (Abstract)', fontsize=14)
+    print('%s: mean absolute error %.4g, mean relative error %.2f %%' %
+          (label, np.mean(np.abs(abstract - spectrum)),
+           100 * np.mean(np.abs(abstract - spectrum) / spectrum.abs().clip(lower=1e-9))))
+
+############################################################################################
+# MAIN #####################################################################################
+############################################################################################
+if len(sys.argv) != 4:
+    sys.exit('Usage: python3 validate_phy_abstraction.py <flows-spectrum.csv> '
+             '<flows-abstract.csv> <benchmark.csv>')
+
+# Flows of the same seed and run matched by their 5-tuple
+matchedFlows = readFlows(sys.argv[1]).merge(readFlows(sys.argv[2]), on=FLOW_KEY,
+                                            suffixes=("_spectrum", "_abstract"))
+print('%d matched flows' % len(matchedFlows))
+
+plt.rcParams['figure.figsize'] = (18, 6)
+figure, axes = plt.subplots(1, 3)
+plotComparison(axes[0], matchedFlows, "throughput", "Throughput (Mbit/s)")
+plotComparison(axes[1], matchedFlows, "meandelay", "Mean delay")
+plotComparison(axes[2], matchedFlows, "loss", "Packet loss ratio")
+figure.suptitle('Abstract PHY vs Spectrum PHY, per flow')
+figure.tight_layout()
+figure.savefig('PhyAbstraction-Validation.png')
+
+# Wall-clock speed-up over the runs of both PHY models without the MAC queue statistics (rows
+# written before the macstats column have it empty)
+benchmark = pd.read_csv(sys.argv[3], header=None, names=BENCHMARK_COLUMNS)
+benchmark = benchmark[benchmark["macstats"].fillna(0) == 0]
+wallClock = benchmark.groupby("phymodel")["wallclock"].mean()
+print(wallClock.to_string())
+if "Spectrum" in wallClock and "Abstract" in wallClock:
+    print('Speed-up: %.2fx' % (wallClock["Spectrum"] / wallClock["Abstract"]))
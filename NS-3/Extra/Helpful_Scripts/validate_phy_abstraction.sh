@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Directory of the plotting script (the runs change to the ns-3 directory)
+scriptDir="$(cd "$(dirname "$0")" && pwd)"
+
+# Function to execute scenario 3 with the detailed and the abstract PHY
+run_validation() {
+    # Change directory to the ns-3 installation directory
+    cd /home/user/Documents/ns3/ns-3-dev
+
+    # Execute the ns-3 scenario with the given PHY model
+    ./ns3 run "scenario3.cc --mcs=7 --channelWidth=80 --nNetwork=5 --nStaA=20 --nStaB=20 --nStaC=20 --nStaD=20 --nStaE=20 --tracing=false --frequency=5 --phyModel=$1 --seedNumber=$2 --runNumber=$3"
+}
+
+# Initialize the parameter value
+seedNumber=123
+max_executions=5
+
+# Same seeds and runs for both PHY models, flow statistics kept apart
+for phyModel in Spectrum Abstract; do
+    runNumber=1
+    while [ $runNumber -le $max_executions ]; do
+        run_validation $phyModel $seedNumber $runNumber
+        ((runNumber++))
+    done
+    mv /home/user/Documents/ns3/ns-3-dev/Scenario3-FlowStats.csv /home/user/Documents/ns3/ns-3-dev/Scenario3-FlowStats-$phyModel.csv
+done
+
+# Per-flow comparison plots (PhyAbstraction-Validation.png) and wall-clock speed-up
+python3 "$scriptDir/validate_phy_abstraction.py" \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-FlowStats-Spectrum.csv \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-FlowStats-Abstract.csv \
+    /home/user/Documents/ns3/ns-3-dev/Scenario3-Benchmark.csv
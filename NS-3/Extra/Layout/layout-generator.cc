@@ -0,0 +1,328 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "layout-generator.h"
+
+#include <ns3/abort.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <ns3/list-position-allocator.h>
+#include <ns3/log.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LayoutGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(LayoutGenerator);
+
+LayoutGenerator::LayoutGenerator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LayoutGenerator::~LayoutGenerator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+LayoutGenerator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LayoutGenerator")
+            .SetParent<Object>()
+            .AddConstructor<LayoutGenerator>()
+            .AddAttribute("Layout",
+                          "AP placement",
+                          EnumValue(LayoutGenerator::GRID),
+                          MakeEnumAccessor(&LayoutGenerator::m_type),
+                          MakeEnumChecker(LayoutGenerator::GRID,
+                                          "Grid",
+                                          LayoutGenerator::HEX,
+                                          "Hex",
+                                          LayoutGenerator::FLOOR_PLAN,
+                                          "FloorPlan"))
+            .AddAttribute("NAps",
+                          "Number of APs (FloorPlan: 0 takes every AP of the file)",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&LayoutGenerator::m_nAps),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Spacing",
+                          "Distance between neighbouring APs of the grid and hexagonal layouts "
+                          "(m)",
+                          DoubleValue(20.0),
+                          MakeDoubleAccessor(&LayoutGenerator::m_spacing),
+                          MakeDoubleChecker<double>(1.0))
+            .AddAttribute("Columns",
+                          "APs per row of the grid and hexagonal layouts (0: square layout)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&LayoutGenerator::m_columns),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FloorPlan",
+                          "CSV file with the AP coordinates of the FloorPlan layout",
+                          StringValue(""),
+                          MakeStringAccessor(&LayoutGenerator::m_floorPlan),
+                          MakeStringChecker())
+            .AddAttribute("ApHeight",
+                          "AP height when not given by the floor plan (m)",
+                          DoubleValue(2.5),
+                          MakeDoubleAccessor(&LayoutGenerator::m_apHeight),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+void
+LayoutGenerator::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_cells.clear();
+    Object::DoDispose();
+}
+
+void
+LayoutGenerator::Generate()
+{
+    NS_LOG_FUNCTION(this);
+    m_cells.clear();
+    switch (m_type)
+    {
+    case GRID:
+        GenerateGrid();
+        break;
+    case HEX:
+        GenerateHex();
+        break;
+    case FLOOR_PLAN:
+        LoadFloorPlan();
+        break;
+    }
+    NS_ABORT_MSG_IF(m_cells.empty(), "The layout has no AP");
+    NS_LOG_INFO("Layout of " << m_cells.size() << " APs");
+}
+
+void
+LayoutGenerator::GenerateGrid()
+{
+    NS_ABORT_MSG_IF(m_nAps == 0, "The grid layout needs at least one AP");
+    uint32_t columns =
+        m_columns > 0 ? m_columns : static_cast<uint32_t>(std::ceil(std::sqrt(m_nAps)));
+    m_cells.reserve(m_nAps);
+    for (uint32_t i = 0; i < m_nAps; i++)
+    {
+        uint32_t row = i / columns;
+        uint32_t column = i % columns;
+        Cell cell;
+        cell.ap = Vector((column + 0.5) * m_spacing, (row + 0.5) * m_spacing, m_apHeight);
+        cell.region = Rectangle(column * m_spacing,
+                                (column + 1) * m_spacing,
+                                row * m_spacing,
+                                (row + 1) * m_spacing);
+        m_cells.push_back(cell);
+    }
+}
+
+void
+LayoutGenerator::GenerateHex()
+{
+    NS_ABORT_MSG_IF(m_nAps == 0, "The hexagonal layout needs at least one AP");
+    uint32_t columns =
+        m_columns > 0 ? m_columns : static_cast<uint32_t>(std::ceil(std::sqrt(m_nAps)));
+    // Pointy-top hexagons: circumradius s / sqrt(3), rows 1.5 circumradius apart
+    double radius = m_spacing / std::sqrt(3.0);
+    m_cells.reserve(m_nAps);
+    for (uint32_t i = 0; i < m_nAps; i++)
+    {
+        uint32_t row = i / columns;
+        uint32_t column = i % columns;
+        double x = (column + 0.5 + 0.5 * (row % 2)) * m_spacing;
+        double y = radius + 1.5 * radius * row;
+        Cell cell;
+        cell.ap = Vector(x, y, m_apHeight);
+        cell.region = Rectangle(x - m_spacing / 2, x + m_spacing / 2, y - radius, y + radius);
+        m_cells.push_back(cell);
+    }
+}
+
+void
+LayoutGenerator::LoadFloorPlan()
+{
+    std::ifstream file(m_floorPlan);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open floor plan " << m_floorPlan);
+
+    std::string line;
+    uint64_t lineNumber = 0;
+    while (std::getline(file, line) && (m_nAps == 0 || m_cells.size() < m_nAps))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        double x;
+        double y;
+        double z;
+        if (!(iss >> x >> y))
+        {
+            // Header row
+            NS_ABORT_MSG_IF(lineNumber > 1, "Malformed floor plan row " << lineNumber);
+            continue;
+        }
+        if (!(iss >> z))
+        {
+            z = m_apHeight;
+        }
+        Cell cell;
+        cell.ap = Vector(x, y, z);
+        m_cells.push_back(cell);
+    }
+    NS_ABORT_MSG_IF(m_nAps > 0 && m_cells.size() < m_nAps,
+                    "The floor plan has " << m_cells.size() << " APs, " << m_nAps
+                                          << " requested");
+
+    // Square region of side the distance to the nearest AP (Spacing for a single AP)
+    for (auto& cell : m_cells)
+    {
+        double nearest = std::numeric_limits<double>::max();
+        for (const auto& other : m_cells)
+        {
+            double distance = std::hypot(cell.ap.x - other.ap.x, cell.ap.y - other.ap.y);
+            if (&other != &cell && distance > 0)
+            {
+                nearest = std::min(nearest, distance);
+            }
+        }
+        double half = (nearest < std::numeric_limits<double>::max() ? nearest : m_spacing) / 2;
+        cell.region =
+            Rectangle(cell.ap.x - half, cell.ap.x + half, cell.ap.y - half, cell.ap.y + half);
+    }
+}
+
+uint32_t
+LayoutGenerator::GetN() const
+{
+    return m_cells.size();
+}
+
+const LayoutGenerator::Cell&
+LayoutGenerator::GetCell(uint32_t index) const
+{
+    NS_ABORT_MSG_IF(index >= m_cells.size(), "No cell " << index << " in the layout");
+    return m_cells[index];
+}
+
+Rectangle
+LayoutGenerator::GetArea() const
+{
+    Rectangle area(std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::lowest(),
+                   std::numeric_limits<double>::max(),
+                   std::numeric_limits<double>::lowest());
+    for (const auto& cell : m_cells)
+    {
+        area.xMin = std::min(area.xMin, cell.region.xMin);
+        area.xMax = std::max(area.xMax, cell.region.xMax);
+        area.yMin = std::min(area.yMin, cell.region.yMin);
+        area.yMax = std::max(area.yMax, cell.region.yMax);
+    }
+    return area;
+}
+
+void
+LayoutGenerator::InstallAps(NodeContainer apNodes) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(apNodes.GetN() != m_cells.size(),
+                    apNodes.GetN() << " AP nodes for a layout of " << m_cells.size() << " APs");
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    for (const auto& cell : m_cells)
+    {
+        positionAlloc->Add(cell.ap);
+    }
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(apNodes);
+}
+
+void
+LayoutGenerator::ConfigureStaMobility(MobilityHelper& mobility,
+                                      uint32_t index,
+                                      const std::string& staMobilityModel,
+                                      double z) const
+{
+    const Rectangle& region = GetCell(index).region;
+    std::ostringstream x;
+    x << "ns3::UniformRandomVariable[Min=" << region.xMin << "|Max=" << region.xMax << "]";
+    std::ostringstream y;
+    y << "ns3::UniformRandomVariable[Min=" << region.yMin << "|Max=" << region.yMax << "]";
+    mobility.SetPositionAllocator("ns3::RandomRectanglePositionAllocator",
+                                  "X",
+                                  StringValue(x.str()),
+                                  "Y",
+                                  StringValue(y.str()),
+                                  "Z",
+                                  DoubleValue(z));
+    mobility.SetMobilityModel(staMobilityModel,
+                              "Mode",
+                              StringValue("Time"),
+                              "Time",
+                              StringValue("3s"),
+                              "Speed",
+                              StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
+                              "Bounds",
+                              RectangleValue(region));
+}
+
+std::vector<uint32_t>
+LayoutGenerator::AssignChannelGroups(uint32_t nGroups) const
+{
+    NS_ABORT_MSG_IF(nGroups == 0, "At least one channel group is needed");
+    std::vector<uint32_t> groups(m_cells.size());
+    std::vector<double> interference(nGroups);
+    for (uint32_t i = 0; i < m_cells.size(); i++)
+    {
+        std::fill(interference.begin(), interference.end(), 0.0);
+        for (uint32_t j = 0; j < i; j++)
+        {
+            double dx = m_cells[i].ap.x - m_cells[j].ap.x;
+            double dy = m_cells[i].ap.y - m_cells[j].ap.y;
+            interference[groups[j]] += 1 / std::max(dx * dx + dy * dy, 1.0);
+        }
+        groups[i] = std::min_element(interference.begin(), interference.end()) -
+                    interference.begin();
+    }
+    return groups;
+}
+
+void
+LayoutGenerator::WriteCsv(const std::string& filename,
+                          uint32_t seedNumber,
+                          uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, AP, x, y, z, STA region xMin, xMax, yMin, yMax
+    for (uint32_t i = 0; i < m_cells.size(); i++)
+    {
+        const Cell& cell = m_cells[i];
+        file << seedNumber << "," << runNumber << "," << i << "," << cell.ap.x << ","
+             << cell.ap.y << "," << cell.ap.z << "," << cell.region.xMin << ","
+             << cell.region.xMax << "," << cell.region.yMin << "," << cell.region.yMax << "\n";
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef LAYOUT_GENERATOR_H
+#define LAYOUT_GENERATOR_H
+
+#include <ns3/mobility-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/object.h>
+#include <ns3/rectangle.h>
+#include <ns3/vector.h>
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Placement of the APs of a large deployment and of the STA region of each cell
+ *
+ * The APs are placed on:
+ *
+ * - Grid: a square grid, Spacing metres apart, Columns per row (0: as square as possible);
+ * - Hex: hexagonal cells, Spacing metres between neighbouring APs (odd rows shifted by half);
+ * - FloorPlan: the coordinates of a CSV file, one "x,y[,z]" AP per line ('#' comments).
+ *
+ * The STA region of a cell is the rectangle around its AP bounding the cell: the grid square,
+ * the box of the hexagon, or a square of side the distance to the nearest AP of the floor plan.
+ * The STAs are dropped uniformly in the region and their random walk is bounded by it.
+ */
+class LayoutGenerator : public Object
+{
+  public:
+    LayoutGenerator();
+    ~LayoutGenerator() override;
+    static TypeId GetTypeId();
+
+    /// AP placement
+    enum Type
+    {
+        GRID,
+        HEX,
+        FLOOR_PLAN
+    };
+
+    /// Cell of the layout
+    struct Cell
+    {
+        Vector ap;        //!< AP position
+        Rectangle region; //!< STA region
+    };
+
+    /**
+     * \brief Place the APs and size the cells from the attributes
+     */
+    void Generate();
+
+    uint32_t GetN() const;
+    const Cell& GetCell(uint32_t index) const;
+
+    /**
+     * \return the rectangle enclosing every STA region
+     */
+    Rectangle GetArea() const;
+
+    /**
+     * \brief Place the APs of the layout, AP i on cell i
+     * \param apNodes one AP per cell
+     */
+    void InstallAps(NodeContainer apNodes) const;
+
+    /**
+     * \brief Set the STA position allocator and mobility model of a cell on a mobility helper
+     * \param mobility helper the STAs are installed with
+     * \param index the cell
+     * \param staMobilityModel STA mobility model type (with a Bounds attribute)
+     * \param z STA height (m)
+     */
+    void ConfigureStaMobility(MobilityHelper& mobility,
+                              uint32_t index,
+                              const std::string& staMobilityModel,
+                              double z) const;
+
+    /**
+     * \brief Assign a channel group to every cell, far from the cells already assigned to it
+     *
+     * Each cell, in order, takes the group with the least interference (sum of 1/d^2) from the
+     * cells already assigned to it.
+     *
+     * \param nGroups number of channel groups (reuse factor)
+     * \return the channel group of every cell
+     */
+    std::vector<uint32_t> AssignChannelGroups(uint32_t nGroups) const;
+
+    /**
+     * \brief Append the layout to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void GenerateGrid();
+    void GenerateHex();
+    void LoadFloorPlan();
+
+    Type m_type;
+    uint32_t m_nAps;
+    double m_spacing;
+    uint32_t m_columns;
+    std::string m_floorPlan;
+    double m_apHeight;
+
+    std::vector<Cell> m_cells;
+};
+
+};
+#endif
@@ -0,0 +1,336 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "mac-queue-stats.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/qos-txop.h>
+#include <ns3/qos-utils.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mac-queue.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-psdu.h>
+#include <ns3/wifi-tx-timer.h>
+
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MacQueueStats");
+
+NS_OBJECT_ENSURE_REGISTERED(MacQueueStats);
+
+namespace
+{
+/// Labels of the access categories, in AcIndex order
+const char* const AC_LABELS[MacQueueStats::N_ACS] = {"BE", "BK", "VI", "VO"};
+
+/**
+ * \param value a value
+ * \param nBins number of bins
+ * \return the log2 bin of the value: 0 for 0 and 1, 1 for 2-3, 2 for 4-7... (last bin open)
+ */
+uint32_t
+GetLog2Bin(uint64_t value, uint32_t nBins)
+{
+    uint32_t bin = 0;
+    while (value > 1 && bin < nBins - 1)
+    {
+        value >>= 1;
+        bin++;
+    }
+    return bin;
+}
+} // namespace
+
+MacQueueStats::MacQueueStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MacQueueStats::~MacQueueStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+MacQueueStats::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MacQueueStats")
+                            .SetParent<Object>()
+                            .AddConstructor<MacQueueStats>()
+                            .AddAttribute("SampleInterval",
+                                          "Time between the samples of the queue lengths",
+                                          TimeValue(MilliSeconds(10)),
+                                          MakeTimeAccessor(&MacQueueStats::m_sampleInterval),
+                                          MakeTimeChecker());
+    return tid;
+}
+
+void
+MacQueueStats::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    Object::DoDispose();
+}
+
+void
+MacQueueStats::AddBss(const std::string& label,
+                      const NetDeviceContainer& apDevices,
+                      const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            Ptr<WifiMac> mac = device->GetMac();
+            uint32_t index = m_devices.size();
+            m_devices.push_back({label, device->GetNode()->GetId(), isAp, mac, {}});
+
+            for (uint8_t ac = 0; ac < N_ACS; ac++)
+            {
+                mac->GetQosTxop(static_cast<AcIndex>(ac))
+                    ->GetWifiMacQueue()
+                    ->TraceConnectWithoutContext(
+                        "Enqueue",
+                        MakeCallback(&MacQueueStats::NotifyEnqueue, this).Bind(index));
+            }
+            mac->TraceConnectWithoutContext(
+                "AckedMpdu",
+                MakeCallback(&MacQueueStats::NotifyAcked, this).Bind(index));
+            mac->TraceConnectWithoutContext(
+                "NAckedMpdu",
+                MakeCallback(&MacQueueStats::NotifyNAcked, this).Bind(index));
+            mac->TraceConnectWithoutContext(
+                "DroppedMpdu",
+                MakeCallback(&MacQueueStats::NotifyDropped, this).Bind(index));
+            mac->TraceConnectWithoutContext(
+                "PsduResponseTimeout",
+                MakeCallback(&MacQueueStats::NotifyPsduTimeout, this).Bind(index));
+            mac->TraceConnectWithoutContext(
+                "PsduMapResponseTimeout",
+                MakeCallback(&MacQueueStats::NotifyPsduMapTimeout, this).Bind(index));
+        }
+    }
+}
+
+void
+MacQueueStats::Start(Time start, Time end)
+{
+    NS_LOG_FUNCTION(this << start << end);
+    NS_ABORT_MSG_IF(!m_sampleInterval.IsStrictlyPositive(),
+                    "The queue length samples need an interval");
+    m_start = start;
+    m_end = end;
+    Simulator::Schedule(start - Simulator::Now(), &MacQueueStats::Sample, this);
+}
+
+uint8_t
+MacQueueStats::GetAc(Ptr<const WifiMpdu> mpdu)
+{
+    const WifiMacHeader& hdr = mpdu->GetHeader();
+    return hdr.IsQosData() ? QosUtilsMapTidToAc(hdr.GetQosTid()) : N_ACS;
+}
+
+bool
+MacQueueStats::InWindow() const
+{
+    Time now = Simulator::Now();
+    return now >= m_start && now <= m_end;
+}
+
+void
+MacQueueStats::NotifyEnqueue(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu)
+{
+    uint8_t ac = GetAc(mpdu);
+    if (ac < N_ACS && InWindow())
+    {
+        m_devices[deviceIndex].acs[ac].enqueued++;
+    }
+}
+
+void
+MacQueueStats::NotifyAcked(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu)
+{
+    uint8_t ac = GetAc(mpdu);
+    if (ac >= N_ACS || !InWindow())
+    {
+        return;
+    }
+    AcCounters& counters = m_devices[deviceIndex].acs[ac];
+    Time sojourn = Simulator::Now() - mpdu->GetTimestamp();
+    counters.acked++;
+    counters.sojournSum += sojourn.GetSeconds();
+    counters.sojourn[GetLog2Bin(sojourn.GetMicroSeconds(), N_SOJOURN_BINS)]++;
+}
+
+void
+MacQueueStats::NotifyNAcked(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu)
+{
+    uint8_t ac = GetAc(mpdu);
+    if (ac < N_ACS && InWindow())
+    {
+        m_devices[deviceIndex].acs[ac].nacked++;
+    }
+}
+
+void
+MacQueueStats::NotifyDropped(uint32_t deviceIndex,
+                             WifiMacDropReason reason,
+                             Ptr<const WifiMpdu> mpdu)
+{
+    uint8_t ac = GetAc(mpdu);
+    if (ac < N_ACS && reason <= WIFI_MAC_DROP_QOS_OLD_PACKET && InWindow())
+    {
+        m_devices[deviceIndex].acs[ac].dropped[reason]++;
+    }
+}
+
+void
+MacQueueStats::CountBlockAckTimeout(Device& device, Ptr<const WifiPsdu> psdu)
+{
+    for (uint8_t tid : psdu->GetTids())
+    {
+        device.acs[QosUtilsMapTidToAc(tid)].blockAckTimeouts++;
+    }
+}
+
+void
+MacQueueStats::NotifyPsduTimeout(uint32_t deviceIndex,
+                                 uint8_t reason,
+                                 Ptr<const WifiPsdu> psdu,
+                                 const WifiTxVector& txVector)
+{
+    if (reason == WifiTxTimer::WAIT_BLOCK_ACK && InWindow())
+    {
+        CountBlockAckTimeout(m_devices[deviceIndex], psdu);
+    }
+}
+
+void
+MacQueueStats::NotifyPsduMapTimeout(uint32_t deviceIndex,
+                                    uint8_t reason,
+                                    WifiPsduMap* psduMap,
+                                    const std::set<Mac48Address>* missingStations,
+                                    std::size_t nTotalStations)
+{
+    if (!InWindow())
+    {
+        return;
+    }
+    // DL MU PPDU: the PSDUs of the stations whose Block Ack is missing
+    for (const auto& [staId, psdu] : *psduMap)
+    {
+        if (missingStations->count(psdu->GetAddr1()))
+        {
+            CountBlockAckTimeout(m_devices[deviceIndex], psdu);
+        }
+    }
+}
+
+void
+MacQueueStats::Sample()
+{
+    for (auto& device : m_devices)
+    {
+        for (uint8_t ac = 0; ac < N_ACS; ac++)
+        {
+            uint32_t length =
+                device.mac->GetQosTxop(static_cast<AcIndex>(ac))->GetWifiMacQueue()->GetNPackets();
+            device.acs[ac].length[length == 0 ? 0 : GetLog2Bin(length, N_LENGTH_BINS - 1) + 1]++;
+        }
+    }
+    if (Simulator::Now() + m_sampleInterval <= m_end)
+    {
+        Simulator::Schedule(m_sampleInterval, &MacQueueStats::Sample, this);
+    }
+}
+
+void
+MacQueueStats::WriteCsv(const std::string& filename,
+                        uint32_t seedNumber,
+                        uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, BSS, node, AP/STA, AC, enqueued, acknowledged, not acknowledged, dropped
+    // (queue full), expired, dropped (retry limit), dropped (old packet), Block Ack timeouts,
+    // mean sojourn time (ms), mean queue length (MPDUs)
+    for (const auto& device : m_devices)
+    {
+        for (uint8_t ac = 0; ac < N_ACS; ac++)
+        {
+            const AcCounters& counters = device.acs[ac];
+            uint64_t samples = 0;
+            double lengthSum = 0;
+            for (uint8_t bin = 0; bin < N_LENGTH_BINS; bin++)
+            {
+                // Bin 0 is an empty queue, bin b holds 2^(b-1) to 2^b - 1 MPDUs (midpoint)
+                samples += counters.length[bin];
+                lengthSum += counters.length[bin] * (bin == 0 ? 0 : 1.5 * (1 << (bin - 1)) - 0.5);
+            }
+            file << seedNumber << "," << runNumber << "," << device.bss << "," << device.nodeId
+                 << "," << (device.isAp ? "AP" : "STA") << "," << AC_LABELS[ac] << ","
+                 << counters.enqueued << "," << counters.acked << "," << counters.nacked;
+            for (uint64_t dropped : counters.dropped)
+            {
+                file << "," << dropped;
+            }
+            file << "," << counters.blockAckTimeouts << ","
+                 << (counters.acked > 0 ? 1000 * counters.sojournSum / counters.acked : 0) << ","
+                 << (samples > 0 ? lengthSum / samples : 0) << "\n";
+        }
+    }
+}
+
+void
+MacQueueStats::WriteHistogramCsv(const std::string& filename,
+                                 uint32_t seedNumber,
+                                 uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, BSS, node, AC, histogram (QueueLength in MPDUs / Sojourn in us), lower bin
+    // edge, samples
+    for (const auto& device : m_devices)
+    {
+        for (uint8_t ac = 0; ac < N_ACS; ac++)
+        {
+            const AcCounters& counters = device.acs[ac];
+            for (uint8_t bin = 0; bin < N_LENGTH_BINS; bin++)
+            {
+                if (counters.length[bin] > 0)
+                {
+                    file << seedNumber << "," << runNumber << "," << device.bss << ","
+                         << device.nodeId << "," << AC_LABELS[ac] << ",QueueLength,"
+                         << (bin == 0 ? 0 : 1 << (bin - 1)) << "," << counters.length[bin]
+                         << "\n";
+                }
+            }
+            for (uint8_t bin = 0; bin < N_SOJOURN_BINS; bin++)
+            {
+                if (counters.sojourn[bin] > 0)
+                {
+                    file << seedNumber << "," << runNumber << "," << device.bss << ","
+                         << device.nodeId << "," << AC_LABELS[ac] << ",Sojourn,"
+                         << (bin == 0 ? 0 : 1 << bin) << "," << counters.sojourn[bin] << "\n";
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,152 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef MAC_QUEUE_STATS_H
+#define MAC_QUEUE_STATS_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-ppdu.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class WifiMpdu;
+class WifiPsdu;
+
+/**
+ * \ingroup helper
+ * \brief Queue occupancy, sojourn time, retries and drops of every device and access category
+ *
+ * Within the measurement window, the QoS data MPDUs of the registered devices are counted per
+ * access category when enqueued, acknowledged, not acknowledged (each one is retransmitted or
+ * dropped) and dropped (per WifiMacDropReason), together with the Block Ack responses that
+ * timed out. The sojourn time of an acknowledged MPDU (enqueue to acknowledgment) and the
+ * queue length, sampled every SampleInterval, fill log2 histograms. Every counter lives in
+ * fixed-size arrays per device: the traces only index and increment.
+ */
+class MacQueueStats : public Object
+{
+  public:
+    /// Access categories accounted (AC_BE, AC_BK, AC_VI, AC_VO)
+    static constexpr uint8_t N_ACS = 4;
+    /// Queue length bins: 0, 1, 2-3, 4-7... (last bin open)
+    static constexpr uint8_t N_LENGTH_BINS = 12;
+    /// Sojourn time bins: < 2 us, 2-3 us, 4-7 us... (last bin open)
+    static constexpr uint8_t N_SOJOURN_BINS = 20;
+
+    MacQueueStats();
+    ~MacQueueStats() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Trace the devices of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Set the measurement window and sample the queue lengths every SampleInterval
+     * \param start first accounted event
+     * \param end last accounted event
+     */
+    void Start(Time start, Time end);
+
+    /**
+     * \brief Append a line per device and access category with the counters to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+    /**
+     * \brief Append the non-empty histogram bins to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteHistogramCsv(const std::string& filename,
+                           uint32_t seedNumber,
+                           uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Counters of an access category of a device
+    struct AcCounters
+    {
+        uint64_t enqueued{0};
+        uint64_t acked{0};
+        uint64_t nacked{0};
+        std::array<uint64_t, WIFI_MAC_DROP_QOS_OLD_PACKET + 1> dropped{}; //!< per drop reason
+        uint64_t blockAckTimeouts{0};
+        double sojournSum{0}; //!< seconds
+        std::array<uint64_t, N_LENGTH_BINS> length{};
+        std::array<uint64_t, N_SOJOURN_BINS> sojourn{};
+    };
+
+    /// Traced device
+    struct Device
+    {
+        std::string bss;
+        uint32_t nodeId;
+        bool isAp;
+        Ptr<WifiMac> mac;
+        std::array<AcCounters, N_ACS> acs;
+    };
+
+    /**
+     * \param mpdu an MPDU
+     * \return the access category of a QoS data MPDU, N_ACS otherwise
+     */
+    static uint8_t GetAc(Ptr<const WifiMpdu> mpdu);
+
+    bool InWindow() const;
+    void NotifyEnqueue(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu);
+    void NotifyAcked(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu);
+    void NotifyNAcked(uint32_t deviceIndex, Ptr<const WifiMpdu> mpdu);
+    void NotifyDropped(uint32_t deviceIndex, WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu);
+    void NotifyPsduTimeout(uint32_t deviceIndex,
+                           uint8_t reason,
+                           Ptr<const WifiPsdu> psdu,
+                           const WifiTxVector& txVector);
+    void NotifyPsduMapTimeout(uint32_t deviceIndex,
+                              uint8_t reason,
+                              WifiPsduMap* psduMap,
+                              const std::set<Mac48Address>* missingStations,
+                              std::size_t nTotalStations);
+
+    /**
+     * \brief Count the Block Ack timeout of the access categories of a PSDU
+     * \param device transmitting device
+     * \param psdu PSDU without its Block Ack
+     */
+    void CountBlockAckTimeout(Device& device, Ptr<const WifiPsdu> psdu);
+
+    void Sample();
+
+    Time m_sampleInterval;
+
+    std::vector<Device> m_devices;
+    Time m_start;
+    Time m_end{Time::Max()};
+};
+
+};
+#endif
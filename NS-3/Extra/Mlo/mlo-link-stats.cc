@@ -0,0 +1,220 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "mlo-link-stats.h"
+
+#include <ns3/abort.h>
+#include <ns3/ampdu-subframe-header.h>
+#include <ns3/log.h>
+#include <ns3/packet.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy-state-helper.h>
+#include <ns3/wifi-phy.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MloLinkStats");
+
+NS_OBJECT_ENSURE_REGISTERED(MloLinkStats);
+
+MloLinkStats::MloLinkStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MloLinkStats::~MloLinkStats()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+MloLinkStats::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MloLinkStats").SetParent<Object>().AddConstructor<MloLinkStats>();
+    return tid;
+}
+
+void
+MloLinkStats::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_links.clear();
+    Object::DoDispose();
+}
+
+void
+MloLinkStats::AddBss(const std::string& label,
+                     const NetDeviceContainer& apDevices,
+                     const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            uint32_t index = m_devices.size();
+            m_devices.push_back({device, label, isAp});
+
+            for (uint8_t phyId = 0; phyId < device->GetNPhys(); phyId++)
+            {
+                Ptr<WifiPhy> phy = device->GetPhy(phyId);
+                phy->TraceConnectWithoutContext(
+                    "MonitorSnifferRx",
+                    MakeCallback(&MloLinkStats::NotifyRx, this).Bind(index));
+                if (isAp)
+                {
+                    phy->GetState()->TraceConnectWithoutContext(
+                        "State",
+                        MakeCallback(&MloLinkStats::NotifyState, this).Bind(label, phy));
+                }
+            }
+        }
+    }
+}
+
+void
+MloLinkStats::SetWindow(Time start, Time end)
+{
+    m_start = start;
+    m_end = end;
+}
+
+void
+MloLinkStats::NotifyRx(uint32_t deviceIndex,
+                       Ptr<const Packet> packet,
+                       uint16_t channelFreqMhz,
+                       WifiTxVector txVector,
+                       MpduInfo aMpdu,
+                       SignalNoiseDbm signalNoise,
+                       uint16_t staId)
+{
+    Time now = Simulator::Now();
+    if (now < m_start || now > m_end)
+    {
+        return;
+    }
+    // HE and EHT data frames are (S-)MPDUs: the sniffer gets every subframe with its delimiter
+    // and padding
+    Ptr<const Packet> mpdu = packet;
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        Ptr<Packet> subframe = packet->Copy();
+        AmpduSubframeHeader delimiter;
+        subframe->RemoveHeader(delimiter);
+        subframe->RemoveAtEnd(subframe->GetSize() - delimiter.GetLength());
+        mpdu = subframe;
+    }
+    WifiMacHeader hdr;
+    mpdu->PeekHeader(hdr);
+    if (!hdr.IsQosData())
+    {
+        return;
+    }
+    // Only the MPDUs addressed to the device (any of its link addresses)
+    const Device& rx = m_devices[deviceIndex];
+    Ptr<WifiMac> mac = rx.device->GetMac();
+    if (hdr.GetAddr1() != mac->GetAddress() && !mac->GetLinkIdByAddress(hdr.GetAddr1()))
+    {
+        return;
+    }
+
+    Link& link = m_links[{rx.bss, channelFreqMhz}];
+    if (rx.isAp)
+    {
+        link.ulBytes += mpdu->GetSize();
+        link.ulMpdus++;
+    }
+    else
+    {
+        link.dlBytes += mpdu->GetSize();
+        link.dlMpdus++;
+    }
+    link.snrSum += signalNoise.signal - signalNoise.noise;
+    link.snrSamples++;
+}
+
+void
+MloLinkStats::NotifyState(std::string bss,
+                          Ptr<WifiPhy> phy,
+                          Time start,
+                          Time duration,
+                          WifiPhyState state)
+{
+    if (state == WifiPhyState::IDLE || state == WifiPhyState::SLEEP ||
+        state == WifiPhyState::OFF || state == WifiPhyState::SWITCHING)
+    {
+        return;
+    }
+    // Part of the state period within the measurement window
+    Time begin = std::max(start, m_start);
+    Time end = std::min(start + duration, m_end);
+    if (end > begin)
+    {
+        m_links[{bss, phy->GetFrequency()}].apBusy += end - begin;
+    }
+}
+
+double
+MloLinkStats::GetThroughput(uint64_t bytes) const
+{
+    Time window = std::min(m_end, Simulator::Now()) - m_start;
+    return window.IsStrictlyPositive() ? bytes * 8.0 / window.GetSeconds() / 1e6 : 0;
+}
+
+void
+MloLinkStats::Report() const
+{
+    Time window = std::min(m_end, Simulator::Now()) - m_start;
+    std::cout << "Per-link KPIs:" << std::endl;
+    for (const auto& [key, link] : m_links)
+    {
+        std::cout << "  BSS " << key.first << " " << key.second << " MHz: DL "
+                  << GetThroughput(link.dlBytes) << " Mbps, UL " << GetThroughput(link.ulBytes)
+                  << " Mbps, AP busy " << std::fixed << std::setprecision(1)
+                  << (window.IsStrictlyPositive()
+                          ? 100 * link.apBusy.GetSeconds() / window.GetSeconds()
+                          : 0.0)
+                  << " %" << std::defaultfloat << std::endl;
+    }
+}
+
+void
+MloLinkStats::WriteCsv(const std::string& filename,
+                       uint32_t seedNumber,
+                       uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    Time window = std::min(m_end, Simulator::Now()) - m_start;
+    // seed, run, BSS, link frequency (MHz), DL throughput (Mbps), UL throughput (Mbps),
+    // DL MPDUs, UL MPDUs, mean SNR (dB), AP busy fraction
+    for (const auto& [key, link] : m_links)
+    {
+        file << seedNumber << "," << runNumber << "," << key.first << "," << key.second << ","
+             << GetThroughput(link.dlBytes) << "," << GetThroughput(link.ulBytes) << ","
+             << link.dlMpdus << "," << link.ulMpdus << ","
+             << (link.snrSamples > 0 ? link.snrSum / link.snrSamples : 0) << ","
+             << (window.IsStrictlyPositive() ? link.apBusy.GetSeconds() / window.GetSeconds()
+                                             : 0.0)
+             << "\n";
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef MLO_LINK_STATS_H
+#define MLO_LINK_STATS_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-phy-common.h>
+#include <ns3/wifi-phy-state.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class WifiNetDevice;
+class WifiPhy;
+
+/**
+ * \ingroup helper
+ * \brief KPIs of every link of the BSSs, for single-link and multi-link devices
+ *
+ * Every PHY of the registered devices is traced, so that the affiliated links of an MLD are
+ * accounted separately (a link is told apart by its operating frequency). Within the
+ * measurement window, the QoS data MPDUs received by the APs (uplink) and STAs (downlink) add
+ * their MAC bytes and SNR to their link, and the PHY states of the AP give the busy fraction
+ * of the channel of every link.
+ */
+class MloLinkStats : public Object
+{
+  public:
+    MloLinkStats();
+    ~MloLinkStats() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Trace every link of the devices of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Set the measurement window
+     * \param start first accounted reception
+     * \param end last accounted reception
+     */
+    void SetWindow(Time start, Time end);
+
+    /**
+     * \brief Print the throughput and channel occupancy of every link
+     */
+    void Report() const;
+
+    /**
+     * \brief Append a line per BSS and link to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// BSS label and operating frequency (MHz) of a link
+    using LinkKey = std::pair<std::string, uint16_t>;
+
+    /// Counters of a link
+    struct Link
+    {
+        uint64_t dlBytes{0};
+        uint64_t ulBytes{0};
+        uint64_t dlMpdus{0};
+        uint64_t ulMpdus{0};
+        double snrSum{0};
+        uint64_t snrSamples{0};
+        Time apBusy{0}; //!< time the AP PHY of the link is not idle
+    };
+
+    /// Traced device
+    struct Device
+    {
+        Ptr<WifiNetDevice> device;
+        std::string bss;
+        bool isAp;
+    };
+
+    void NotifyRx(uint32_t deviceIndex,
+                  Ptr<const Packet> packet,
+                  uint16_t channelFreqMhz,
+                  WifiTxVector txVector,
+                  MpduInfo aMpdu,
+                  SignalNoiseDbm signalNoise,
+                  uint16_t staId);
+    void NotifyState(std::string bss,
+                     Ptr<WifiPhy> phy,
+                     Time start,
+                     Time duration,
+                     WifiPhyState state);
+    double GetThroughput(uint64_t bytes) const;
+
+    std::vector<Device> m_devices;
+    std::map<LinkKey, Link> m_links;
+    Time m_start;
+    Time m_end{Time::Max()};
+};
+
+};
+#endif
@@ -0,0 +1,201 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "adaptive-obss-pd-algorithm.h"
+
+#include <ns3/double.h>
+#include <ns3/he-configuration.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/sta-wifi-mac.h>
+#include <ns3/uinteger.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AdaptiveObssPdAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED(AdaptiveObssPdAlgorithm);
+
+AdaptiveObssPdAlgorithm::AdaptiveObssPdAlgorithm()
+    : m_obssRssi(std::numeric_limits<double>::quiet_NaN()),
+      m_per(std::numeric_limits<double>::quiet_NaN())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+AdaptiveObssPdAlgorithm::~AdaptiveObssPdAlgorithm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+AdaptiveObssPdAlgorithm::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AdaptiveObssPdAlgorithm")
+            .SetParent<ObssPdAlgorithm>()
+            .SetGroupName("Wifi")
+            .AddConstructor<AdaptiveObssPdAlgorithm>()
+            .AddAttribute("Interval",
+                          "Time between threshold updates",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&AdaptiveObssPdAlgorithm::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("Alpha",
+                          "Weight of a new sample in the averaged OBSS RSSI and PER",
+                          DoubleValue(0.2),
+                          MakeDoubleAccessor(&AdaptiveObssPdAlgorithm::m_alpha),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("PerHigh",
+                          "PER above which the threshold is lowered",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&AdaptiveObssPdAlgorithm::m_perHigh),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("PerLow",
+                          "PER below which the threshold follows the OBSS RSSI",
+                          DoubleValue(0.02),
+                          MakeDoubleAccessor(&AdaptiveObssPdAlgorithm::m_perLow),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("Step",
+                          "Threshold change per update (dB)",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&AdaptiveObssPdAlgorithm::m_step),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Margin",
+                          "Distance between the threshold and the average OBSS RSSI (dB)",
+                          DoubleValue(3.0),
+                          MakeDoubleAccessor(&AdaptiveObssPdAlgorithm::m_margin),
+                          MakeDoubleChecker<double>(0.0))
+            .AddTraceSource("Threshold",
+                            "The OBSS-PD threshold has been updated",
+                            MakeTraceSourceAccessor(&AdaptiveObssPdAlgorithm::m_thresholdTrace),
+                            "ns3::AdaptiveObssPdAlgorithm::ThresholdTracedCallback");
+    return tid;
+}
+
+void
+AdaptiveObssPdAlgorithm::ConnectWifiNetDevice(const Ptr<WifiNetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    auto hePhy = DynamicCast<HePhy>(device->GetPhy()->GetPhyEntity(WIFI_MOD_CLASS_HE));
+    NS_ASSERT(hePhy);
+    hePhy->SetEndOfHeSigACallback(MakeCallback(&AdaptiveObssPdAlgorithm::ReceiveHeSigA, this));
+
+    device->GetMac()->TraceConnectWithoutContext(
+        "AckedMpdu",
+        MakeCallback(&AdaptiveObssPdAlgorithm::NotifyAcked, this));
+    device->GetMac()->TraceConnectWithoutContext(
+        "NAckedMpdu",
+        MakeCallback(&AdaptiveObssPdAlgorithm::NotifyNAcked, this));
+
+    ObssPdAlgorithm::ConnectWifiNetDevice(device);
+}
+
+void
+AdaptiveObssPdAlgorithm::DoInitialize()
+{
+    NS_LOG_FUNCTION(this);
+    m_updateEvent = Simulator::Schedule(m_interval, &AdaptiveObssPdAlgorithm::Update, this);
+    ObssPdAlgorithm::DoInitialize();
+}
+
+void
+AdaptiveObssPdAlgorithm::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_updateEvent.Cancel();
+    ObssPdAlgorithm::DoDispose();
+}
+
+void
+AdaptiveObssPdAlgorithm::ReceiveHeSigA(HeSigAParameters params)
+{
+    NS_LOG_FUNCTION(this << +params.bssColor << WToDbm(params.rssiW));
+
+    Ptr<StaWifiMac> mac = m_device->GetMac()->GetObject<StaWifiMac>();
+    if (mac && !mac->IsAssociated())
+    {
+        NS_LOG_DEBUG("This is not an associated STA: skip OBSS_PD SR");
+        return;
+    }
+
+    Ptr<HeConfiguration> heConfiguration = m_device->GetHeConfiguration();
+    NS_ASSERT(heConfiguration);
+    UintegerValue bssColorAttribute;
+    heConfiguration->GetAttribute("BssColor", bssColorAttribute);
+    uint8_t bssColor = bssColorAttribute.Get();
+
+    if (bssColor == 0 || params.bssColor == 0 || bssColor == params.bssColor)
+    {
+        return; // Unknown color or intra-BSS frame
+    }
+
+    double rssi = WToDbm(params.rssiW);
+    m_obssRssi = std::isnan(m_obssRssi) ? rssi : m_obssRssi + m_alpha * (rssi - m_obssRssi);
+    if (rssi < m_obssPdLevel)
+    {
+        NS_LOG_DEBUG("OBSS frame at " << rssi << " dBm below the threshold of " << m_obssPdLevel
+                                      << " dBm: reset PHY to IDLE");
+        ResetPhy(params);
+    }
+}
+
+void
+AdaptiveObssPdAlgorithm::NotifyAcked(Ptr<const WifiMpdu> mpdu)
+{
+    m_nAcked++;
+}
+
+void
+AdaptiveObssPdAlgorithm::NotifyNAcked(Ptr<const WifiMpdu> mpdu)
+{
+    m_nFailed++;
+}
+
+void
+AdaptiveObssPdAlgorithm::Update()
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t nTx = m_nAcked + m_nFailed;
+    if (nTx > 0)
+    {
+        double per = static_cast<double>(m_nFailed) / nTx;
+        m_per = std::isnan(m_per) ? per : m_per + m_alpha * (per - m_per);
+    }
+    m_nAcked = 0;
+    m_nFailed = 0;
+
+    double level = m_obssPdLevel;
+    if (!std::isnan(m_per) && m_per > m_perHigh)
+    {
+        level -= m_step;
+    }
+    else if (!std::isnan(m_obssRssi) && (std::isnan(m_per) || m_per < m_perLow))
+    {
+        double target = m_obssRssi + m_margin;
+        level = (level < target) ? std::min(level + m_step, target)
+                                 : std::max(level - m_step, target);
+    }
+    level = std::clamp(level, m_obssPdLevelMin, m_obssPdLevelMax);
+
+    if (level != m_obssPdLevel)
+    {
+        NS_LOG_DEBUG("OBSS-PD threshold " << m_obssPdLevel << " -> " << level << " dBm");
+        m_obssPdLevel = level;
+    }
+    m_thresholdTrace(m_obssPdLevel, m_obssRssi, m_per);
+
+    m_updateEvent = Simulator::Schedule(m_interval, &AdaptiveObssPdAlgorithm::Update, this);
+}
+
+}
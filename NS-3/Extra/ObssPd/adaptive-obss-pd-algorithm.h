@@ -0,0 +1,80 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef ADAPTIVE_OBSS_PD_ALGORITHM_H
+#define ADAPTIVE_OBSS_PD_ALGORITHM_H
+
+#include <ns3/event-id.h>
+#include <ns3/he-phy.h>
+#include <ns3/nstime.h>
+#include <ns3/obss-pd-algorithm.h>
+#include <ns3/traced-callback.h>
+
+namespace ns3
+{
+
+class WifiMpdu;
+
+/**
+ * \ingroup wifi
+ * \brief OBSS-PD algorithm with a threshold tuned online from the measured interference
+ *
+ * Frames from another BSS color are handled as in ConstantObssPdAlgorithm, but their RSSI is
+ * also averaged (EWMA). Every Interval, the packet error rate of the MPDUs sent by the device
+ * (acked vs. not acked) decides the next threshold:
+ *
+ * - PER above PerHigh: the threshold goes down one Step (fewer OBSS frames are ignored);
+ * - PER below PerLow: the threshold moves one Step towards the average OBSS RSSI plus Margin,
+ *   the lowest value that still ignores most of the OBSS frames.
+ *
+ * The threshold is kept within [ObssPdLevelMin, ObssPdLevelMax]. The transmit power
+ * restriction follows from it as in the base class (TxPowerRef - (threshold - ObssPdLevelMin)),
+ * so a lower threshold also means a looser restriction.
+ */
+class AdaptiveObssPdAlgorithm : public ObssPdAlgorithm
+{
+  public:
+    AdaptiveObssPdAlgorithm();
+    ~AdaptiveObssPdAlgorithm() override;
+    static TypeId GetTypeId();
+
+    void ConnectWifiNetDevice(const Ptr<WifiNetDevice> device) override;
+    void ReceiveHeSigA(HeSigAParameters params) override;
+
+    /**
+     * TracedCallback signature for the threshold updates
+     * \param obssPdLevel new OBSS-PD threshold (dBm)
+     * \param obssRssi average RSSI of the OBSS frames (dBm, NaN if none was received)
+     * \param per average packet error rate of the transmitted MPDUs
+     */
+    typedef void (*ThresholdTracedCallback)(double obssPdLevel, double obssRssi, double per);
+
+  protected:
+    void DoInitialize() override;
+    void DoDispose() override;
+
+  private:
+    void NotifyAcked(Ptr<const WifiMpdu> mpdu);
+    void NotifyNAcked(Ptr<const WifiMpdu> mpdu);
+    void Update();
+
+    Time m_interval;
+    double m_alpha;
+    double m_perHigh;
+    double m_perLow;
+    double m_step;
+    double m_margin;
+
+    double m_obssRssi; //!< EWMA of the OBSS RSSI (dBm, NaN until the first OBSS frame)
+    double m_per;      //!< EWMA of the PER (NaN until the first MPDU)
+    uint32_t m_nAcked{0};
+    uint32_t m_nFailed{0};
+    EventId m_updateEvent;
+
+    TracedCallback<double, double, double> m_thresholdTrace;
+};
+
+};
+#endif
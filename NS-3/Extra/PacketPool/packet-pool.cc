@@ -0,0 +1,122 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "packet-pool.h"
+
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PacketPool");
+
+NS_OBJECT_ENSURE_REGISTERED(PacketPool);
+
+TypeId
+PacketPool::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PacketPool")
+            .SetParent<Object>()
+            .AddConstructor<PacketPool>()
+            .AddAttribute("PacketSize",
+                          "Size in bytes of the payloads handed out by the pool",
+                          UintegerValue(1448),
+                          MakeUintegerAccessor(&PacketPool::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Capacity",
+                          "Maximum number of payloads kept for recycling",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&PacketPool::m_capacity),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+PacketPool::PacketPool()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PacketPool::~PacketPool()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PacketPool::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_slots.clear();
+    m_template = nullptr;
+    Object::DoDispose();
+}
+
+Ptr<Packet>
+PacketPool::Allocate()
+{
+    if (!m_template)
+    {
+        m_template = Create<Packet>(m_packetSize);
+    }
+    m_nAllocated++;
+    // The copy shares the template buffer and metadata, so no payload is allocated
+    return m_template->Copy();
+}
+
+Ptr<Packet>
+PacketPool::Acquire()
+{
+    NS_LOG_FUNCTION(this);
+    m_nAcquired++;
+
+    // A slot only referenced by the pool has been released by the socket and the
+    // application, so it can be handed out again after stripping its tags
+    for (std::size_t n = 0; n < m_slots.size(); n++)
+    {
+        Ptr<Packet>& slot = m_slots[m_nextSlot];
+        m_nextSlot = (m_nextSlot + 1) % m_slots.size();
+        if (slot->GetReferenceCount() == 1 && slot->GetSize() == m_packetSize)
+        {
+            slot->RemoveAllPacketTags();
+            slot->RemoveAllByteTags();
+            m_nRecycled++;
+            return slot;
+        }
+    }
+
+    Ptr<Packet> packet = Allocate();
+    if (m_slots.size() < m_capacity)
+    {
+        m_slots.push_back(packet);
+    }
+    return packet;
+}
+
+uint32_t
+PacketPool::GetPacketSize() const
+{
+    return m_packetSize;
+}
+
+uint64_t
+PacketPool::GetNAcquired() const
+{
+    return m_nAcquired;
+}
+
+uint64_t
+PacketPool::GetNAllocated() const
+{
+    return m_nAllocated;
+}
+
+uint64_t
+PacketPool::GetNRecycled() const
+{
+    return m_nRecycled;
+}
+
+} // namespace ns3
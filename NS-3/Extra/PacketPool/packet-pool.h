@@ -0,0 +1,64 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <ns3/object.h>
+#include <ns3/packet.h>
+
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup network
+ * \brief Per-simulation pool of fixed-size, zero-filled application payloads
+ *
+ * Traffic generators working at full load (e.g. VoD flows at 100 Mbit/s) spend most
+ * of their time creating and destroying Packet objects of the very same size. The
+ * pool keeps a template payload and a set of recycled Packet objects: a slot can be
+ * handed out again as soon as the socket has taken its own copy and nobody else holds
+ * a reference, so the steady state runs without new Packet, Buffer or metadata
+ * allocations for the payload.
+ *
+ * Packets handed out by the pool share the template UID. The pool is meant to be used
+ * by the scenario generators only, where no trace relies on application packet UIDs.
+ */
+class PacketPool : public Object
+{
+  public:
+    PacketPool();
+    ~PacketPool() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Get a payload of GetPacketSize() bytes, recycled whenever possible
+     * \return a zero-filled packet without tags
+     */
+    Ptr<Packet> Acquire();
+
+    uint32_t GetPacketSize() const;
+    uint64_t GetNAcquired() const;
+    uint64_t GetNAllocated() const;
+    uint64_t GetNRecycled() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Ptr<Packet> Allocate();
+    uint32_t m_packetSize{1448};
+    uint32_t m_capacity{64};
+    Ptr<Packet> m_template;
+    std::vector<Ptr<Packet>> m_slots;
+    std::size_t m_nextSlot{0};
+    uint64_t m_nAcquired{0};
+    uint64_t m_nAllocated{0};
+    uint64_t m_nRecycled{0};
+};
+
+} // namespace ns3
+#endif
@@ -0,0 +1,63 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "pooled-on-off-application.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/pointer.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PooledOnOffApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(PooledOnOffApplication);
+
+TypeId
+PooledOnOffApplication::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::PooledOnOffApplication")
+                            .SetParent<OnOffApplication>()
+                            .AddConstructor<PooledOnOffApplication>()
+                            .AddAttribute("Pool",
+                                          "The PacketPool providing the payloads",
+                                          PointerValue(),
+                                          MakePointerAccessor(&PooledOnOffApplication::m_pool),
+                                          MakePointerChecker<PacketPool>());
+    return tid;
+}
+
+PooledOnOffApplication::PooledOnOffApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PooledOnOffApplication::~PooledOnOffApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PooledOnOffApplication::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_pool = nullptr;
+    OnOffApplication::DoDispose();
+}
+
+Ptr<Packet>
+PooledOnOffApplication::CreatePayload(uint32_t size)
+{
+    if (!m_pool)
+    {
+        return OnOffApplication::CreatePayload(size);
+    }
+    NS_ABORT_MSG_IF(m_pool->GetPacketSize() != size,
+                    "PacketPool payload size does not match the application PacketSize");
+    return m_pool->Acquire();
+}
+
+} // namespace ns3
@@ -0,0 +1,47 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef POOLED_ON_OFF_APPLICATION_H
+#define POOLED_ON_OFF_APPLICATION_H
+
+#include "packet-pool.h"
+
+#include <ns3/onoff-application.h>
+#include <ns3/ptr.h>
+
+namespace ns3
+{
+/**
+ * \ingroup applications
+ * \brief OnOffApplication taking its payloads from a PacketPool
+ *
+ * The on/off behaviour, attributes and traces are those of OnOffApplication; only the
+ * payload of every new packet is obtained from the shared PacketPool instead of being
+ * created from scratch. If no pool is set, payloads are created as in OnOffApplication.
+ *
+ * Requires the CreatePayload hook of onoff-application-payload.patch in the ns-3 tree.
+ */
+class PooledOnOffApplication : public OnOffApplication
+{
+  public:
+    PooledOnOffApplication();
+    ~PooledOnOffApplication() override;
+    static TypeId GetTypeId();
+
+  protected:
+    void DoDispose() override;
+
+    /**
+     * \param size payload size in bytes (PacketSize)
+     * \return a recycled payload of the pool, or a new one if no pool is set
+     */
+    Ptr<Packet> CreatePayload(uint32_t size) override;
+
+  private:
+    Ptr<PacketPool> m_pool;
+};
+
+} // namespace ns3
+#endif
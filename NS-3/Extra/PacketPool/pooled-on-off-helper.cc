@@ -0,0 +1,56 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "pooled-on-off-helper.h"
+
+#include "pooled-on-off-application.h"
+
+#include <ns3/node.h>
+#include <ns3/pointer.h>
+#include <ns3/string.h>
+
+namespace ns3
+{
+
+PooledOnOffHelper::PooledOnOffHelper(std::string protocol, Address address, Ptr<PacketPool> pool)
+{
+    m_factory.SetTypeId("ns3::PooledOnOffApplication");
+    m_factory.Set("Protocol", StringValue(protocol));
+    m_factory.Set("Remote", AddressValue(address));
+    m_factory.Set("Pool", PointerValue(pool));
+}
+
+void
+PooledOnOffHelper::SetAttribute(std::string name, const AttributeValue& value)
+{
+    m_factory.Set(name, value);
+}
+
+ApplicationContainer
+PooledOnOffHelper::Install(Ptr<Node> node) const
+{
+    return ApplicationContainer(InstallPriv(node));
+}
+
+ApplicationContainer
+PooledOnOffHelper::Install(NodeContainer c) const
+{
+    ApplicationContainer apps;
+    for (auto i = c.Begin(); i != c.End(); ++i)
+    {
+        apps.Add(InstallPriv(*i));
+    }
+    return apps;
+}
+
+Ptr<Application>
+PooledOnOffHelper::InstallPriv(Ptr<Node> node) const
+{
+    Ptr<Application> app = m_factory.Create<Application>();
+    node->AddApplication(app);
+    return app;
+}
+
+} // namespace ns3
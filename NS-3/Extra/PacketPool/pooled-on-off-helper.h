@@ -0,0 +1,41 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef POOLED_ON_OFF_HELPER_H
+#define POOLED_ON_OFF_HELPER_H
+
+#include "packet-pool.h"
+
+#include <ns3/address.h>
+#include <ns3/application-container.h>
+#include <ns3/attribute.h>
+#include <ns3/node-container.h>
+#include <ns3/object-factory.h>
+
+#include <string>
+
+namespace ns3
+{
+/**
+ * \ingroup helper
+ * \brief Helper to install PooledOnOffApplication sources sharing one PacketPool
+ *
+ * Drop-in replacement of OnOffHelper for the scenario generators.
+ */
+class PooledOnOffHelper
+{
+  public:
+    PooledOnOffHelper(std::string protocol, Address address, Ptr<PacketPool> pool);
+    void SetAttribute(std::string name, const AttributeValue& value);
+    ApplicationContainer Install(NodeContainer c) const;
+    ApplicationContainer Install(Ptr<Node> node) const;
+
+  private:
+    Ptr<Application> InstallPriv(Ptr<Node> node) const;
+    ObjectFactory m_factory;
+};
+
+} // namespace ns3
+#endif
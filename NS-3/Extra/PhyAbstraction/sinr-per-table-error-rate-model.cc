@@ -0,0 +1,241 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "sinr-per-table-error-rate-model.h"
+
+#include <ns3/abort.h>
+#include <ns3/he-phy.h>
+#include <ns3/log.h>
+#include <ns3/pointer.h>
+#include <ns3/string.h>
+#include <ns3/table-based-error-rate-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/wifi-tx-vector.h>
+#include <ns3/wifi-utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SinrPerTableErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED(SinrPerTableErrorRateModel);
+
+namespace
+{
+/**
+ * \brief Read a table file
+ * \param filename table file
+ * \return the tables of the file
+ */
+std::shared_ptr<const SinrPerTableErrorRateModel::Tables>
+ReadTables(const std::string& filename)
+{
+    std::ifstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open SINR-PER tables " << filename);
+
+    auto tables = std::make_shared<SinrPerTableErrorRateModel::Tables>();
+    std::string line;
+    uint64_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        uint32_t mcs;
+        uint32_t width;
+        uint32_t nss;
+        double sinr;
+        double per;
+        NS_ABORT_MSG_IF(!(iss >> mcs >> width >> nss >> sinr >> per),
+                        "Malformed SINR-PER point in " << filename << ":" << lineNumber);
+        SinrPerTableErrorRateModel::Tables::key_type key(mcs, width, nss);
+        (*tables)[key].emplace_back(sinr, per);
+    }
+    NS_ABORT_MSG_IF(tables->empty(), "Empty SINR-PER tables " << filename);
+    for (auto& [key, curve] : *tables)
+    {
+        std::sort(curve.begin(), curve.end());
+    }
+    return tables;
+}
+} // namespace
+
+TypeId
+SinrPerTableErrorRateModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SinrPerTableErrorRateModel")
+            .SetParent<ErrorRateModel>()
+            .SetGroupName("Wifi")
+            .AddConstructor<SinrPerTableErrorRateModel>()
+            .AddAttribute("TableFile",
+                          "SINR-PER table file (mcs,width,nss,sinr_db,per)",
+                          StringValue(""),
+                          MakeStringAccessor(&SinrPerTableErrorRateModel::SetTableFile,
+                                             &SinrPerTableErrorRateModel::GetTableFile),
+                          MakeStringChecker())
+            .AddAttribute("FrameSize",
+                          "Frame size of the tabulated PER (bytes)",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&SinrPerTableErrorRateModel::m_frameSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Fallback",
+                          "Error rate model of the fields and modes without a table (a "
+                          "TableBasedErrorRateModel if not set)",
+                          PointerValue(),
+                          MakePointerAccessor(&SinrPerTableErrorRateModel::m_fallback),
+                          MakePointerChecker<ErrorRateModel>());
+    return tid;
+}
+
+SinrPerTableErrorRateModel::SinrPerTableErrorRateModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SinrPerTableErrorRateModel::~SinrPerTableErrorRateModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SinrPerTableErrorRateModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_tables = nullptr;
+    m_fallback = nullptr;
+    ErrorRateModel::DoDispose();
+}
+
+void
+SinrPerTableErrorRateModel::SetTableFile(std::string filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_tableFile = filename;
+    m_tables = nullptr;
+    if (filename.empty())
+    {
+        return;
+    }
+    // Every PHY of a scenario has a model of its own: the file is read once
+    static std::map<std::string, std::shared_ptr<const Tables>> loadedTables;
+    auto it = loadedTables.find(filename);
+    if (it == loadedTables.end())
+    {
+        it = loadedTables.emplace(filename, ReadTables(filename)).first;
+        NS_LOG_INFO("SINR-PER tables " << filename << ": " << it->second->size() << " curves");
+    }
+    m_tables = it->second;
+}
+
+std::string
+SinrPerTableErrorRateModel::GetTableFile() const
+{
+    return m_tableFile;
+}
+
+void
+SinrPerTableErrorRateModel::Generate(Ptr<ErrorRateModel> model,
+                                     uint32_t frameSize,
+                                     double sinrMin,
+                                     double sinrMax,
+                                     double sinrStep,
+                                     const std::string& filename)
+{
+    NS_LOG_FUNCTION(model << frameSize << sinrMin << sinrMax << sinrStep << filename);
+    NS_ABORT_MSG_IF(sinrStep <= 0 || sinrMax < sinrMin, "Invalid SINR range of the tables");
+    std::ofstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+    // Enough digits for the PER close to 1 to keep the success of shorter chunks
+    file << std::setprecision(12) << "# mcs,width,nss,sinr_db,per (" << frameSize
+         << " byte frames)\n";
+    for (uint8_t mcs = 0; mcs <= 11; mcs++)
+    {
+        WifiMode mode = HePhy::GetHeMcs(mcs);
+        for (uint16_t width : {20, 40, 80, 160})
+        {
+            for (uint8_t nss = 1; nss <= 4; nss++)
+            {
+                WifiTxVector txVector(mode, 0, WIFI_PREAMBLE_HE_SU, 800, nss, nss, 0, width, true);
+                for (double sinr = sinrMin; sinr <= sinrMax + sinrStep / 2; sinr += sinrStep)
+                {
+                    double success = model->GetChunkSuccessRate(mode,
+                                                                txVector,
+                                                                DbToRatio(sinr),
+                                                                8 * frameSize,
+                                                                nss);
+                    file << +mcs << "," << width << "," << +nss << "," << sinr << ","
+                         << 1 - success << "\n";
+                }
+            }
+        }
+    }
+    NS_ABORT_MSG_IF(!file.good(), "Can not write " << filename);
+}
+
+double
+SinrPerTableErrorRateModel::Interpolate(const std::vector<std::pair<double, double>>& curve,
+                                        double sinrDb)
+{
+    auto upper = std::lower_bound(curve.begin(),
+                                  curve.end(),
+                                  sinrDb,
+                                  [](const std::pair<double, double>& point, double value) {
+                                      return point.first < value;
+                                  });
+    if (upper == curve.begin())
+    {
+        return upper->second;
+    }
+    if (upper == curve.end())
+    {
+        return curve.back().second;
+    }
+    auto lower = std::prev(upper);
+    double weight = (sinrDb - lower->first) / (upper->first - lower->first);
+    return lower->second + weight * (upper->second - lower->second);
+}
+
+double
+SinrPerTableErrorRateModel::DoGetChunkSuccessRate(WifiMode mode,
+                                                  const WifiTxVector& txVector,
+                                                  double snr,
+                                                  uint64_t nbits,
+                                                  uint8_t numRxAntennas,
+                                                  WifiPpduField field,
+                                                  uint16_t staId) const
+{
+    if (m_tables && field == WIFI_PPDU_FIELD_DATA &&
+        mode.GetModulationClass() == WIFI_MOD_CLASS_HE)
+    {
+        auto it = m_tables->find(
+            {mode.GetMcsValue(), txVector.GetChannelWidth(), txVector.GetNss(staId)});
+        if (it != m_tables->end())
+        {
+            double per = std::clamp(Interpolate(it->second, RatioToDb(snr)), 0.0, 1.0);
+            return std::pow(1 - per, static_cast<double>(nbits) / (8 * m_frameSize));
+        }
+        NS_LOG_DEBUG("No SINR-PER table of MCS " << +mode.GetMcsValue() << ", "
+                                                 << txVector.GetChannelWidth() << " MHz, "
+                                                 << +txVector.GetNss(staId) << " streams");
+    }
+    if (!m_fallback)
+    {
+        m_fallback = CreateObject<TableBasedErrorRateModel>();
+    }
+    return m_fallback->GetChunkSuccessRate(mode, txVector, snr, nbits, numRxAntennas, field, staId);
+}
+
+}
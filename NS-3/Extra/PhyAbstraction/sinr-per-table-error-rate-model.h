@@ -0,0 +1,100 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef SINR_PER_TABLE_ERROR_RATE_MODEL_H
+#define SINR_PER_TABLE_ERROR_RATE_MODEL_H
+
+#include <ns3/error-rate-model.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup wifi
+ * \brief Error rate from precomputed SINR-PER tables (link-to-system mapping)
+ *
+ * The success of an HE data field is looked up in a table of packet error rate versus SINR
+ * per (MCS, channel width, spatial streams), linearly interpolated in dB. The tables give the
+ * PER of a FrameSize frame and chunks of other sizes scale it as (1 - PER)^(bits / frame bits).
+ * The other fields and modulations (preambles, non-HT control frames) and the entries missing
+ * from the tables use the Fallback model.
+ *
+ * The table file is CSV ('#' comments), one point per line: "mcs,width,nss,sinr_db,per". Every
+ * file is read once and shared by all the models that use it. Generate builds the tables of a
+ * detailed error rate model.
+ */
+class SinrPerTableErrorRateModel : public ErrorRateModel
+{
+  public:
+    static TypeId GetTypeId();
+    SinrPerTableErrorRateModel();
+    ~SinrPerTableErrorRateModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    SinrPerTableErrorRateModel(const SinrPerTableErrorRateModel&) = delete;
+    SinrPerTableErrorRateModel& operator=(const SinrPerTableErrorRateModel&) = delete;
+
+    /// PER versus SINR (dB) of every (MCS, channel width, spatial streams), SINR ascending
+    using Tables =
+        std::map<std::tuple<uint8_t, uint16_t, uint8_t>, std::vector<std::pair<double, double>>>;
+
+    /**
+     * \brief Build the tables of an error rate model for the HE MCSs (0-11), the 20-160 MHz
+     * channel widths and 1-4 spatial streams
+     * \param model detailed error rate model
+     * \param frameSize frame size of the PER (bytes)
+     * \param sinrMin lowest SINR (dB)
+     * \param sinrMax highest SINR (dB)
+     * \param sinrStep SINR step (dB)
+     * \param filename output file
+     */
+    static void Generate(Ptr<ErrorRateModel> model,
+                         uint32_t frameSize,
+                         double sinrMin,
+                         double sinrMax,
+                         double sinrStep,
+                         const std::string& filename);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    double DoGetChunkSuccessRate(WifiMode mode,
+                                 const WifiTxVector& txVector,
+                                 double snr,
+                                 uint64_t nbits,
+                                 uint8_t numRxAntennas,
+                                 WifiPpduField field,
+                                 uint16_t staId) const override;
+
+    /**
+     * \brief Use the tables of a file
+     * \param filename table file (read on its first use)
+     */
+    void SetTableFile(std::string filename);
+    std::string GetTableFile() const;
+
+    /**
+     * \param curve PER versus SINR (dB)
+     * \param sinrDb SINR (dB)
+     * \return the PER interpolated at the SINR (clamped to the ends of the curve)
+     */
+    static double Interpolate(const std::vector<std::pair<double, double>>& curve, double sinrDb);
+
+    std::string m_tableFile;
+    std::shared_ptr<const Tables> m_tables;
+    uint32_t m_frameSize;
+    mutable Ptr<ErrorRateModel> m_fallback;
+};
+
+};
+#endif
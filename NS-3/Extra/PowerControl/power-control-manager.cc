@@ -0,0 +1,309 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "power-control-manager.h"
+
+#include <ns3/abort.h>
+#include <ns3/ampdu-subframe-header.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-remote-station-manager.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PowerControlManager");
+
+NS_OBJECT_ENSURE_REGISTERED(PowerControlManager);
+
+namespace
+{
+uint64_t
+AddressKey(Mac48Address address)
+{
+    uint8_t buffer[6];
+    address.CopyTo(buffer);
+    uint64_t key = 0;
+    for (auto byte : buffer)
+    {
+        key = (key << 8) | byte;
+    }
+    return key;
+}
+} // namespace
+
+PowerControlManager::PowerControlManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PowerControlManager::~PowerControlManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+PowerControlManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PowerControlManager")
+            .SetParent<Object>()
+            .AddConstructor<PowerControlManager>()
+            .AddAttribute("Interval",
+                          "Time between power adjustments",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&PowerControlManager::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("TargetRssi",
+                          "RSSI the weakest peer of every device should get (dBm)",
+                          DoubleValue(-65.0),
+                          MakeDoubleAccessor(&PowerControlManager::m_targetRssi),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Margin",
+                          "Fading margin added to the target RSSI (dB)",
+                          DoubleValue(3.0),
+                          MakeDoubleAccessor(&PowerControlManager::m_margin),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Alpha",
+                          "Weight of a new sample in the smoothed path loss",
+                          DoubleValue(0.2),
+                          MakeDoubleAccessor(&PowerControlManager::m_alpha),
+                          MakeDoubleChecker<double>(0.0, 1.0));
+    return tid;
+}
+
+void
+PowerControlManager::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_deviceIndex.clear();
+    if (m_csv.is_open())
+    {
+        m_csv.close();
+    }
+    Object::DoDispose();
+}
+
+void
+PowerControlManager::AddBss(const NetDeviceContainer& apDevices,
+                            const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this);
+    uint32_t bss = m_devices.empty() ? 0 : m_devices.back().bss + 1;
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            Device entry;
+            entry.device = device;
+            entry.address = device->GetMac()->GetAddress();
+            entry.bss = bss;
+            entry.isAp = isAp;
+            entry.level = device->GetRemoteStationManager()->GetDefaultTxPowerLevel();
+
+            uint32_t index = m_devices.size();
+            m_deviceIndex[AddressKey(entry.address)] = index;
+            m_devices.push_back(entry);
+
+            device->GetPhy()->TraceConnectWithoutContext(
+                "MonitorSnifferRx",
+                MakeCallback(&PowerControlManager::NotifyRx, this).Bind(index));
+            device->GetMac()->TraceConnectWithoutContext(
+                "MacRx",
+                MakeCallback(&PowerControlManager::NotifyMacRx, this));
+        }
+    }
+}
+
+void
+PowerControlManager::EnableCsv(const std::string& filename,
+                               uint32_t seedNumber,
+                               uint32_t runNumber)
+{
+    m_csv.open(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!m_csv.is_open(), "Can not open " << filename);
+    m_seedNumber = seedNumber;
+    m_runNumber = runNumber;
+}
+
+void
+PowerControlManager::Start(Time measureStart, Time controlStart, Time measureEnd)
+{
+    NS_LOG_FUNCTION(this << measureStart << controlStart << measureEnd);
+    NS_ABORT_MSG_IF(measureStart >= controlStart || controlStart >= measureEnd,
+                    "The power control must start within the measurement window");
+    m_measureStart = measureStart;
+    m_controlStart = controlStart;
+    m_measureEnd = measureEnd;
+    Simulator::Schedule(controlStart, &PowerControlManager::Update, this);
+}
+
+double
+PowerControlManager::GetTxPowerDbm(const Device& device, uint8_t level) const
+{
+    Ptr<WifiPhy> phy = device.device->GetPhy();
+    if (phy->GetNTxPower() <= 1)
+    {
+        return phy->GetTxPowerStart();
+    }
+    return phy->GetTxPowerStart() +
+           level * (phy->GetTxPowerEnd() - phy->GetTxPowerStart()) / (phy->GetNTxPower() - 1);
+}
+
+double
+PowerControlManager::GetTxPowerDbm(const Device& device) const
+{
+    return GetTxPowerDbm(device, device.level);
+}
+
+void
+PowerControlManager::NotifyRx(uint32_t rxIndex,
+                              Ptr<const Packet> packet,
+                              uint16_t channelFreqMhz,
+                              WifiTxVector txVector,
+                              MpduInfo aMpdu,
+                              SignalNoiseDbm signalNoise,
+                              uint16_t staId)
+{
+    // HE data frames are (S-)MPDUs: the sniffer gets every subframe with its delimiter
+    Ptr<const Packet> mpdu = packet;
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        Ptr<Packet> subframe = packet->Copy();
+        AmpduSubframeHeader delimiter;
+        subframe->RemoveHeader(delimiter);
+        mpdu = subframe;
+    }
+    WifiMacHeader header;
+    if (mpdu->PeekHeader(header) == 0 || !header.IsData())
+    {
+        return;
+    }
+    auto it = m_deviceIndex.find(AddressKey(header.GetAddr2()));
+    if (it == m_deviceIndex.end())
+    {
+        return;
+    }
+    Device& rx = m_devices[rxIndex];
+    const Device& tx = m_devices[it->second];
+    if (tx.bss != rx.bss)
+    {
+        return;
+    }
+
+    // Path loss from the power level actually used for the frame
+    double pathLoss = GetTxPowerDbm(tx, txVector.GetTxPowerLevel()) - signalNoise.signal;
+    auto sample = rx.pathLoss.find(it->second);
+    if (sample == rx.pathLoss.end())
+    {
+        rx.pathLoss[it->second] = pathLoss;
+    }
+    else
+    {
+        sample->second += m_alpha * (pathLoss - sample->second);
+    }
+}
+
+void
+PowerControlManager::NotifyMacRx(Ptr<const Packet> packet)
+{
+    Time now = Simulator::Now();
+    if (now >= m_measureStart && now < m_controlStart)
+    {
+        m_rxBytesBefore += packet->GetSize();
+    }
+    else if (now >= m_controlStart && now <= m_measureEnd)
+    {
+        m_rxBytesAfter += packet->GetSize();
+    }
+}
+
+void
+PowerControlManager::Update()
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t i = 0; i < m_devices.size(); i++)
+    {
+        Device& device = m_devices[i];
+        // Weakest peer: the largest path loss measured in either direction
+        double worstPathLoss = -std::numeric_limits<double>::infinity();
+        for (const auto& [peer, pathLoss] : device.pathLoss)
+        {
+            worstPathLoss = std::max(worstPathLoss, pathLoss);
+        }
+        for (uint32_t j = 0; j < m_devices.size(); j++)
+        {
+            auto it = m_devices[j].pathLoss.find(i);
+            if (m_devices[j].bss == device.bss && it != m_devices[j].pathLoss.end())
+            {
+                worstPathLoss = std::max(worstPathLoss, it->second);
+            }
+        }
+        if (std::isinf(worstPathLoss))
+        {
+            continue; // No peer heard yet: keep the current level
+        }
+
+        Ptr<WifiPhy> phy = device.device->GetPhy();
+        uint8_t nLevels = phy->GetNTxPower();
+        double required = m_targetRssi + m_margin + worstPathLoss;
+        uint8_t level = nLevels - 1;
+        for (uint8_t candidate = 0; candidate < nLevels; candidate++)
+        {
+            if (GetTxPowerDbm(device, candidate) >= required)
+            {
+                level = candidate;
+                break;
+            }
+        }
+
+        if (level != device.level)
+        {
+            device.level = level;
+            device.device->GetRemoteStationManager()->SetDefaultTxPowerLevel(level);
+        }
+        if (m_csv.is_open())
+        {
+            // seed, run, time, node, BSS, AP/STA, level, power (dBm), worst path loss (dB)
+            m_csv << m_seedNumber << "," << m_runNumber << "," << Simulator::Now().GetSeconds()
+                  << "," << device.device->GetNode()->GetId() << "," << device.bss << ","
+                  << (device.isAp ? "AP" : "STA") << "," << +level << ","
+                  << GetTxPowerDbm(device) << "," << worstPathLoss << "\n";
+        }
+    }
+    m_nUpdates++;
+
+    if (Simulator::Now() + m_interval < m_measureEnd)
+    {
+        Simulator::Schedule(m_interval, &PowerControlManager::Update, this);
+    }
+}
+
+void
+PowerControlManager::Report() const
+{
+    double before = m_rxBytesBefore * 8.0 / (m_controlStart - m_measureStart).GetSeconds() / 1e6;
+    double after = m_rxBytesAfter * 8.0 / (m_measureEnd - m_controlStart).GetSeconds() / 1e6;
+    std::cout << "Power control: " << m_nUpdates << " adjustments, aggregate MAC throughput "
+              << before << " Mbps before, " << after << " Mbps after" << std::endl;
+}
+
+}
@@ -0,0 +1,119 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef POWER_CONTROL_MANAGER_H
+#define POWER_CONTROL_MANAGER_H
+
+#include <ns3/mac48-address.h>
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-phy-common.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class WifiNetDevice;
+
+/**
+ * \ingroup helper
+ * \brief RSSI-driven transmit power control of the APs and STAs of a set of BSSs
+ *
+ * Every device sniffs the frames of its own BSS and keeps a smoothed path loss estimate to
+ * each peer (transmit power of the peer minus the measured RSSI). Every Interval, each device
+ * gets the lowest power level that keeps its weakest peer (the farthest STA for an AP, the AP
+ * for a STA) at TargetRssi + Margin, through the DefaultTxPowerLevel of its remote station
+ * manager. The bytes received by the devices before and after the first adjustment are
+ * accounted, to report the throughput before and after the power control.
+ */
+class PowerControlManager : public Object
+{
+  public:
+    PowerControlManager();
+    ~PowerControlManager() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Put the devices of a BSS under power control
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const NetDeviceContainer& apDevices, const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Start the periodic adjustments
+     * \param measureStart start of the throughput accounting
+     * \param controlStart time of the first adjustment
+     * \param measureEnd end of the throughput accounting
+     */
+    void Start(Time measureStart, Time controlStart, Time measureEnd);
+
+    /**
+     * \brief Log every adjustment to a CSV file
+     * \param filename output file (appended)
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void EnableCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber);
+
+    /**
+     * \brief Print the throughput before and after the power control
+     */
+    void Report() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Device under power control
+    struct Device
+    {
+        Ptr<WifiNetDevice> device;
+        Mac48Address address;
+        uint32_t bss;
+        bool isAp;
+        uint8_t level;
+        std::unordered_map<uint32_t, double> pathLoss; //!< peer device index -> smoothed dB
+    };
+
+    void NotifyRx(uint32_t rxIndex,
+                  Ptr<const Packet> packet,
+                  uint16_t channelFreqMhz,
+                  WifiTxVector txVector,
+                  MpduInfo aMpdu,
+                  SignalNoiseDbm signalNoise,
+                  uint16_t staId);
+    void NotifyMacRx(Ptr<const Packet> packet);
+    void Update();
+    double GetTxPowerDbm(const Device& device) const;
+    double GetTxPowerDbm(const Device& device, uint8_t level) const;
+
+    Time m_interval;
+    double m_targetRssi;
+    double m_margin;
+    double m_alpha;
+
+    std::vector<Device> m_devices;
+    std::unordered_map<uint64_t, uint32_t> m_deviceIndex; //!< MAC address -> device index
+    Time m_measureStart;
+    Time m_controlStart;
+    Time m_measureEnd;
+    uint64_t m_rxBytesBefore{0};
+    uint64_t m_rxBytesAfter{0};
+    uint32_t m_nUpdates{0};
+    std::ofstream m_csv;
+    uint32_t m_seedNumber{0};
+    uint32_t m_runNumber{0};
+};
+
+};
+#endif
@@ -0,0 +1,554 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "qos-multi-user-scheduler.h"
+
+#include <ns3/ap-wifi-mac.h>
+#include <ns3/boolean.h>
+#include <ns3/he-configuration.h>
+#include <ns3/he-frame-exchange-manager.h>
+#include <ns3/he-phy.h>
+#include <ns3/log.h>
+#include <ns3/mpdu-aggregator.h>
+#include <ns3/qos-txop.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/wifi-mac-queue-container.h>
+#include <ns3/wifi-mac-queue.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-psdu.h>
+#include <ns3/wifi-remote-station-manager.h>
+
+#include <algorithm>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QosMultiUserScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(QosMultiUserScheduler);
+
+TypeId
+QosMultiUserScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::QosMultiUserScheduler")
+            .SetParent<MultiUserScheduler>()
+            .SetGroupName("Wifi")
+            .AddConstructor<QosMultiUserScheduler>()
+            .AddAttribute("NStations",
+                          "The maximum number of stations served by a DL MU PPDU or solicited "
+                          "by a Trigger Frame",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&QosMultiUserScheduler::m_nStations),
+                          MakeUintegerChecker<uint8_t>(1, 74))
+            .AddAttribute("EnableUlOfdma",
+                          "If enabled, send Basic Trigger Frames to the most urgent STAs that "
+                          "reported buffered frames",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&QosMultiUserScheduler::m_enableUlOfdma),
+                          MakeBooleanChecker())
+            .AddAttribute("EnableBsrp",
+                          "If enabled, send a BSRP Trigger Frame before every Basic Trigger Frame",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&QosMultiUserScheduler::m_enableBsrp),
+                          MakeBooleanChecker())
+            .AddAttribute("UlPsduSize",
+                          "The maximum size in bytes of the PSDUs solicited by a Basic Trigger "
+                          "Frame",
+                          UintegerValue(500),
+                          MakeUintegerAccessor(&QosMultiUserScheduler::m_ulPsduSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("VoLatencyBudget",
+                          "Latency budget of the AC_VO frames",
+                          TimeValue(MilliSeconds(10)),
+                          MakeTimeAccessor(&QosMultiUserScheduler::m_voBudget),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("ViLatencyBudget",
+                          "Latency budget of the AC_VI frames",
+                          TimeValue(MilliSeconds(50)),
+                          MakeTimeAccessor(&QosMultiUserScheduler::m_viBudget),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("BeLatencyBudget",
+                          "Latency budget of the AC_BE frames",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&QosMultiUserScheduler::m_beBudget),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("BkLatencyBudget",
+                          "Latency budget of the AC_BK frames",
+                          TimeValue(MilliSeconds(300)),
+                          MakeTimeAccessor(&QosMultiUserScheduler::m_bkBudget),
+                          MakeTimeChecker(NanoSeconds(1)));
+    return tid;
+}
+
+QosMultiUserScheduler::QosMultiUserScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+QosMultiUserScheduler::~QosMultiUserScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QosMultiUserScheduler::DoInitialize()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_apMac);
+    m_apMac->TraceConnectWithoutContext(
+        "AssociatedSta",
+        MakeCallback(&QosMultiUserScheduler::NotifyStationAssociated, this));
+    m_apMac->TraceConnectWithoutContext(
+        "DeAssociatedSta",
+        MakeCallback(&QosMultiUserScheduler::NotifyStationDeassociated, this));
+    MultiUserScheduler::DoInitialize();
+}
+
+void
+QosMultiUserScheduler::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_stations.clear();
+    m_staBudget.clear();
+    m_staWeight.clear();
+    m_lastUlService.clear();
+    m_candidates.clear();
+    m_txParams.Clear();
+    m_apMac->TraceDisconnectWithoutContext(
+        "AssociatedSta",
+        MakeCallback(&QosMultiUserScheduler::NotifyStationAssociated, this));
+    m_apMac->TraceDisconnectWithoutContext(
+        "DeAssociatedSta",
+        MakeCallback(&QosMultiUserScheduler::NotifyStationDeassociated, this));
+    MultiUserScheduler::DoDispose();
+}
+
+void
+QosMultiUserScheduler::SetLatencyBudget(Mac48Address address, Time budget)
+{
+    NS_LOG_FUNCTION(this << address << budget);
+    auto it = m_staBudget.find(address);
+    if (it == m_staBudget.end() || budget < it->second)
+    {
+        m_staBudget[address] = budget;
+    }
+}
+
+void
+QosMultiUserScheduler::SetUrgencyWeight(Mac48Address address, double weight)
+{
+    NS_LOG_FUNCTION(this << address << weight);
+    m_staWeight[address] = weight;
+}
+
+Time
+QosMultiUserScheduler::GetLatencyBudget(Mac48Address address, AcIndex ac) const
+{
+    Time budget;
+    switch (ac)
+    {
+    case AC_VO:
+        budget = m_voBudget;
+        break;
+    case AC_VI:
+        budget = m_viBudget;
+        break;
+    case AC_BK:
+        budget = m_bkBudget;
+        break;
+    default:
+        budget = m_beBudget;
+        break;
+    }
+    auto it = m_staBudget.find(address);
+    return (it != m_staBudget.end()) ? std::min(budget, it->second) : budget;
+}
+
+void
+QosMultiUserScheduler::NotifyStationAssociated(uint16_t aid, Mac48Address address)
+{
+    NS_LOG_FUNCTION(this << aid << address);
+    if (GetWifiRemoteStationManager(m_linkId)->GetHeSupported(address))
+    {
+        m_stations.push_back({aid, address});
+        m_lastUlService[address] = Simulator::Now();
+    }
+}
+
+void
+QosMultiUserScheduler::NotifyStationDeassociated(uint16_t aid, Mac48Address address)
+{
+    NS_LOG_FUNCTION(this << aid << address);
+    m_stations.remove_if([aid](const StaInfo& sta) { return sta.aid == aid; });
+    m_lastUlService.erase(address);
+}
+
+MultiUserScheduler::TxFormat
+QosMultiUserScheduler::SelectTxFormat()
+{
+    NS_LOG_FUNCTION(this);
+    // UL MU after a DL MU PPDU (BSRP first, if enabled), after a BSRP or with no DL frame
+    if (m_enableUlOfdma && m_enableBsrp && GetLastTxFormat(m_linkId) == DL_MU_TX)
+    {
+        if (TrySendingTriggerFrame(TriggerFrameType::BSRP_TRIGGER) == UL_MU_TX)
+        {
+            return UL_MU_TX;
+        }
+    }
+    else if (m_enableUlOfdma && (GetLastTxFormat(m_linkId) == DL_MU_TX ||
+                                 m_trigger.GetType() == TriggerFrameType::BSRP_TRIGGER ||
+                                 !m_edca->PeekNextMpdu(m_linkId)))
+    {
+        if (TrySendingTriggerFrame(TriggerFrameType::BASIC_TRIGGER) == UL_MU_TX)
+        {
+            return UL_MU_TX;
+        }
+    }
+    return TrySendingDlMuPpdu();
+}
+
+std::vector<QosMultiUserScheduler::Candidate>
+QosMultiUserScheduler::RankUlStations(bool reportedOnly) const
+{
+    NS_LOG_FUNCTION(this << reportedOnly);
+    Time now = Simulator::Now();
+    std::vector<Candidate> ranked;
+    for (const auto& sta : m_stations)
+    {
+        // Buffer status reported for the TIDs with a block ack agreement, in decreasing priority
+        AcIndex ac = AC_BE;
+        bool reported = false;
+        uint32_t backlog = 0;
+        for (uint8_t tid : {7, 6, 5, 4, 3, 0, 2, 1})
+        {
+            uint8_t queueSize = m_apMac->GetBufferStatus(tid, sta.address);
+            if (queueSize == 0 || queueSize == 255 ||
+                !m_apMac->GetBaAgreementEstablishedAsRecipient(sta.address, tid))
+            {
+                continue; // nothing buffered or unspecified (255)
+            }
+            if (!reported)
+            {
+                ac = QosUtilsMapTidToAc(tid);
+                reported = true;
+            }
+            backlog += queueSize * 256;
+        }
+        if (reportedOnly && !reported)
+        {
+            continue;
+        }
+        auto last = m_lastUlService.find(sta.address);
+        Time waiting = now - ((last != m_lastUlService.end()) ? last->second : Time());
+        double urgency = waiting.GetSeconds() / GetLatencyBudget(sta.address, ac).GetSeconds();
+        auto weight = m_staWeight.find(sta.address);
+        if (weight != m_staWeight.end())
+        {
+            urgency *= weight->second;
+        }
+        ranked.push_back({sta, nullptr, urgency, backlog, ac});
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const Candidate& a, const Candidate& b) {
+        return (a.urgency != b.urgency) ? a.urgency > b.urgency : a.backlog > b.backlog;
+    });
+    return ranked;
+}
+
+MultiUserScheduler::TxFormat
+QosMultiUserScheduler::TrySendingTriggerFrame(TriggerFrameType type)
+{
+    NS_LOG_FUNCTION(this);
+    bool basic = (type == TriggerFrameType::BASIC_TRIGGER);
+    std::vector<Candidate> ranked = RankUlStations(basic);
+    if (ranked.empty())
+    {
+        return SU_TX;
+    }
+
+    Ptr<HeConfiguration> heConfiguration = m_apMac->GetHeConfiguration();
+    NS_ASSERT(heConfiguration);
+
+    // Equal-sized RUs for the most urgent STAs
+    std::size_t count = std::min<std::size_t>(m_nStations, ranked.size());
+    std::size_t nCentral26TonesRus;
+    HeRu::RuType ruType =
+        HeRu::GetEqualSizedRusForStations(m_allowedWidth, count, nCentral26TonesRus);
+    std::vector<HeRu::RuSpec> ruSet = HeRu::GetRusOfType(m_allowedWidth, ruType);
+
+    WifiTxVector txVector;
+    txVector.SetPreambleType(WIFI_PREAMBLE_HE_TB);
+    txVector.SetChannelWidth(m_allowedWidth);
+    txVector.SetGuardInterval(heConfiguration->GetGuardInterval().GetNanoSeconds());
+    txVector.SetBssColor(heConfiguration->GetBssColor());
+
+    m_candidates.assign(ranked.begin(), ranked.begin() + count);
+    uint32_t maxBacklog = 0;
+    for (std::size_t i = 0; i < m_candidates.size(); i++)
+    {
+        // The UL MCS is the one the AP would use to send data to the STA
+        WifiMacHeader hdr(WIFI_MAC_QOSDATA);
+        hdr.SetAddr1(m_candidates[i].sta.address);
+        hdr.SetAddr2(m_apMac->GetAddress());
+        WifiTxVector suTxVector =
+            GetWifiRemoteStationManager(m_linkId)->GetDataTxVector(hdr, m_allowedWidth);
+        txVector.SetHeMuUserInfo(m_candidates[i].sta.aid,
+                                 {ruSet.at(i), suTxVector.GetMode().GetMcsValue(),
+                                  suTxVector.GetNss()});
+        maxBacklog = std::max(maxBacklog, m_candidates[i].backlog);
+        NS_LOG_DEBUG("Candidate STA " << m_candidates[i].sta.address << " urgency "
+                                      << m_candidates[i].urgency << " backlog "
+                                      << m_candidates[i].backlog);
+    }
+
+    m_trigger = CtrlTriggerHeader(type, txVector);
+    txVector.SetGuardInterval(m_trigger.GetGuardInterval());
+    if (basic)
+    {
+        // Every STA may send the frames of the AC that made it urgent
+        for (auto& userInfo : m_trigger)
+        {
+            auto candidate =
+                std::find_if(m_candidates.begin(),
+                             m_candidates.end(),
+                             [&userInfo](const Candidate& c) {
+                                 return c.sta.aid == userInfo.GetAid12();
+                             });
+            NS_ASSERT(candidate != m_candidates.end());
+            userInfo.SetBasicTriggerDepUserInfo(0, 0, candidate->ac);
+        }
+    }
+
+    // Duration of the solicited HE TB PPDU: QoS Null frames (BSRP) or the largest backlog
+    Ptr<WifiPhy> phy = m_apMac->GetWifiPhy(m_linkId);
+    uint32_t psduSize =
+        basic ? std::min(maxBacklog, m_ulPsduSize) : GetMaxSizeOfQosNullAmpdu(m_trigger);
+    Time ulDuration;
+    for (const auto& userInfo : txVector.GetHeMuUserInfoMap())
+    {
+        ulDuration = Max(ulDuration,
+                         WifiPhy::CalculateTxDuration(psduSize,
+                                                      txVector,
+                                                      phy->GetPhyBand(),
+                                                      userInfo.first));
+    }
+    uint16_t ulLength;
+    std::tie(ulLength, ulDuration) = HePhy::ConvertHeTbPpduDurationToLSigLength(
+        ulDuration,
+        m_trigger.GetHeTbTxVector(m_trigger.begin()->GetAid12()),
+        phy->GetPhyBand());
+    m_trigger.SetUlLength(ulLength);
+
+    Ptr<WifiMpdu> item = GetTriggerFrame(m_trigger, m_linkId);
+    m_triggerMacHdr = item->GetHeader();
+
+    m_txParams.Clear();
+    m_txParams.m_txVector =
+        GetWifiRemoteStationManager(m_linkId)->GetRtsTxVector(m_triggerMacHdr.GetAddr1(),
+                                                              m_allowedWidth);
+    if (!m_heFem->TryAddMpdu(item, m_txParams, m_availableTime))
+    {
+        NS_LOG_DEBUG("The Trigger Frame does not fit in the TXOP");
+        m_candidates.clear();
+        return SU_TX;
+    }
+    if (m_availableTime != Time::Min())
+    {
+        // TryAddMpdu only accounts for the Trigger Frame: add the solicited HE TB PPDU
+        Time tfDuration =
+            WifiPhy::CalculateTxDuration(item->GetSize(), m_txParams.m_txVector, phy->GetPhyBand());
+        if (tfDuration + phy->GetSifs() + ulDuration > m_availableTime)
+        {
+            NS_LOG_DEBUG("The HE TB PPDU does not fit in the TXOP");
+            m_candidates.clear();
+            return SU_TX;
+        }
+    }
+    return UL_MU_TX;
+}
+
+MultiUserScheduler::TxFormat
+QosMultiUserScheduler::TrySendingDlMuPpdu()
+{
+    NS_LOG_FUNCTION(this);
+    AcIndex primaryAc = m_edca->GetAccessCategory();
+    if (m_stations.empty())
+    {
+        return SU_TX;
+    }
+
+    Ptr<HeConfiguration> heConfiguration = m_apMac->GetHeConfiguration();
+    NS_ASSERT(heConfiguration);
+
+    // Rank every STA with queued frames of the primary AC by urgency
+    Time now = Simulator::Now();
+    std::vector<Candidate> ranked;
+    for (const auto& sta : m_stations)
+    {
+        for (uint8_t tid : {wifiAcList.at(primaryAc).GetHighTid(),
+                            wifiAcList.at(primaryAc).GetLowTid()})
+        {
+            if (!m_apMac->GetBaAgreementEstablishedAsOriginator(sta.address, tid))
+            {
+                continue; // DL MU PPDUs need a block ack agreement
+            }
+            Ptr<WifiMpdu> mpdu = m_edca->PeekNextMpdu(m_linkId, tid, sta.address);
+            if (!mpdu)
+            {
+                continue;
+            }
+            double urgency = (now - mpdu->GetTimestamp()).GetSeconds() /
+                             GetLatencyBudget(sta.address, primaryAc).GetSeconds();
+            auto weight = m_staWeight.find(sta.address);
+            if (weight != m_staWeight.end())
+            {
+                urgency *= weight->second;
+            }
+            uint32_t backlog = m_edca->GetWifiMacQueue()->GetNBytes(
+                WifiMacQueueContainer::GetQueueId(mpdu));
+            ranked.push_back({sta, mpdu, urgency, backlog, primaryAc});
+            break;
+        }
+    }
+    if (ranked.empty())
+    {
+        return SU_TX;
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const Candidate& a, const Candidate& b) {
+        return (a.urgency != b.urgency) ? a.urgency > b.urgency : a.backlog > b.backlog;
+    });
+
+    std::size_t count = std::min<std::size_t>(m_nStations, ranked.size());
+    std::size_t nCentral26TonesRus;
+    HeRu::RuType ruType =
+        HeRu::GetEqualSizedRusForStations(m_allowedWidth, count, nCentral26TonesRus);
+
+    m_txParams.Clear();
+    m_txParams.m_txVector.SetPreambleType(WIFI_PREAMBLE_HE_MU);
+    m_txParams.m_txVector.SetChannelWidth(m_allowedWidth);
+    m_txParams.m_txVector.SetGuardInterval(heConfiguration->GetGuardInterval().GetNanoSeconds());
+    m_txParams.m_txVector.SetBssColor(heConfiguration->GetBssColor());
+
+    // Most urgent STAs whose first MPDU fits in the TXOP
+    m_candidates.clear();
+    for (const auto& candidate : ranked)
+    {
+        if (m_candidates.size() == count)
+        {
+            break;
+        }
+        WifiTxVector suTxVector =
+            GetWifiRemoteStationManager(m_linkId)->GetDataTxVector(candidate.mpdu->GetHeader(),
+                                                                   m_allowedWidth);
+        WifiTxVector txVectorCopy = m_txParams.m_txVector;
+        m_txParams.m_txVector.SetHeMuUserInfo(
+            candidate.sta.aid,
+            {{ruType, 1, true}, suTxVector.GetMode().GetMcsValue(), suTxVector.GetNss()});
+
+        if (!m_heFem->TryAddMpdu(candidate.mpdu, m_txParams, m_availableTime))
+        {
+            NS_LOG_DEBUG("Adding STA " << candidate.sta.address << " exceeds the TXOP");
+            m_txParams.m_txVector = txVectorCopy;
+            continue;
+        }
+        NS_LOG_DEBUG("Candidate STA " << candidate.sta.address << " urgency "
+                                      << candidate.urgency << " backlog " << candidate.backlog);
+        m_candidates.push_back(candidate);
+    }
+
+    if (m_candidates.empty())
+    {
+        return SU_TX;
+    }
+    return DL_MU_TX;
+}
+
+MultiUserScheduler::DlMuInfo
+QosMultiUserScheduler::ComputeDlMuInfo()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_candidates.empty())
+    {
+        return DlMuInfo();
+    }
+
+    // Equal-sized RUs for the selected STAs, in order of urgency (the least urgent ones are left
+    // for the next PPDU if there are fewer RUs)
+    std::size_t nRusAssigned = m_candidates.size();
+    std::size_t nCentral26TonesRus;
+    HeRu::RuType ruType =
+        HeRu::GetEqualSizedRusForStations(m_allowedWidth, nRusAssigned, nCentral26TonesRus);
+    if (nRusAssigned < m_candidates.size())
+    {
+        for (auto it = m_candidates.begin() + nRusAssigned; it != m_candidates.end(); it++)
+        {
+            m_txParams.m_txVector.GetHeMuUserInfoMap().erase(it->sta.aid);
+        }
+        m_candidates.erase(m_candidates.begin() + nRusAssigned, m_candidates.end());
+    }
+    std::vector<HeRu::RuSpec> ruSet = HeRu::GetRusOfType(m_allowedWidth, ruType);
+    auto ruIt = ruSet.begin();
+
+    DlMuInfo dlMuInfo;
+    std::swap(dlMuInfo.txParams.m_txVector, m_txParams.m_txVector);
+    for (const auto& candidate : m_candidates)
+    {
+        NS_ASSERT(ruIt != ruSet.end());
+        const HeMuUserInfo& userInfo = dlMuInfo.txParams.m_txVector.GetHeMuUserInfo(
+            candidate.sta.aid);
+        dlMuInfo.txParams.m_txVector.SetHeMuUserInfo(candidate.sta.aid,
+                                                     {*ruIt++, userInfo.mcs, userInfo.nss});
+    }
+
+    for (const auto& candidate : m_candidates)
+    {
+        NS_ASSERT(candidate.mpdu->IsQueued());
+        Ptr<WifiMpdu> item = m_edca->GetNextMpdu(m_linkId,
+                                                 candidate.mpdu,
+                                                 dlMuInfo.txParams,
+                                                 m_availableTime,
+                                                 m_initialFrame);
+        if (!item)
+        {
+            // The frame does not fit anymore: leave its RU empty
+            dlMuInfo.txParams.m_txVector.GetHeMuUserInfoMap().erase(candidate.sta.aid);
+            continue;
+        }
+        std::vector<Ptr<WifiMpdu>> mpduList =
+            m_heFem->GetMpduAggregator()->GetNextAmpdu(item, dlMuInfo.txParams, m_availableTime);
+        if (mpduList.size() > 1)
+        {
+            dlMuInfo.psduMap[candidate.sta.aid] = Create<WifiPsdu>(std::move(mpduList));
+        }
+        else
+        {
+            dlMuInfo.psduMap[candidate.sta.aid] = Create<WifiPsdu>(item, true);
+        }
+    }
+
+    m_txParams.Clear();
+    m_candidates.clear();
+    return dlMuInfo;
+}
+
+MultiUserScheduler::UlMuInfo
+QosMultiUserScheduler::ComputeUlMuInfo()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_trigger.GetType() == TriggerFrameType::BASIC_TRIGGER)
+    {
+        for (const auto& candidate : m_candidates)
+        {
+            m_lastUlService[candidate.sta.address] = Simulator::Now();
+        }
+    }
+    m_candidates.clear();
+    return UlMuInfo{m_trigger, m_triggerMacHdr, std::move(m_txParams)};
+}
+
+}
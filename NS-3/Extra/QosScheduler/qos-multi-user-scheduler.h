@@ -0,0 +1,117 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef QOS_MULTI_USER_SCHEDULER_H
+#define QOS_MULTI_USER_SCHEDULER_H
+
+#include <ns3/ctrl-headers.h>
+#include <ns3/mac48-address.h>
+#include <ns3/multi-user-scheduler.h>
+#include <ns3/nstime.h>
+#include <ns3/qos-utils.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/wifi-tx-parameters.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+class WifiMpdu;
+
+/**
+ * \ingroup wifi
+ * \brief OFDMA scheduler driven by the latency budget of every STA
+ *
+ * Every time the AP gets a TXOP, the associated STAs with queued frames of the primary AC are
+ * ranked by urgency: the head-of-line delay of their first MPDU over their latency budget (the
+ * budget of the AC, or a tighter one set per STA for delay-sensitive flows), scaled by an
+ * optional per-STA weight. Ties go to the largest backlog of the AC. The NStations most urgent
+ * STAs that fit in the TXOP share the PPDU in equal-sized RUs.
+ *
+ * With EnableUlOfdma, a Basic Trigger Frame follows every DL MU PPDU (or is sent when the AP
+ * has no DL frame): the STAs that reported buffered frames are ranked by the time since their
+ * last UL MU transmission over the latency budget of the highest-priority AC they reported, with
+ * the same weights and ties going to the largest reported backlog. With EnableBsrp, a BSRP
+ * Trigger Frame ranked the same way (AC_BE budget for the STAs that reported nothing) solicits
+ * the buffer status reports before the Basic Trigger Frame.
+ */
+class QosMultiUserScheduler : public MultiUserScheduler
+{
+  public:
+    static TypeId GetTypeId();
+    QosMultiUserScheduler();
+    ~QosMultiUserScheduler() override;
+
+    /**
+     * \brief Set a latency budget for the DL and UL frames of a STA
+     * \param address MAC address of the STA
+     * \param budget latency budget (the tightest of the budgets set for the STA is kept)
+     */
+    void SetLatencyBudget(Mac48Address address, Time budget);
+
+    /**
+     * \brief Set the weight of the urgency of a STA
+     * \param address MAC address of the STA
+     * \param weight factor applied to the urgency of the STA (1 by default)
+     */
+    void SetUrgencyWeight(Mac48Address address, double weight);
+
+  protected:
+    void DoDispose() override;
+    void DoInitialize() override;
+
+  private:
+    /// Associated STA
+    struct StaInfo
+    {
+        uint16_t aid;
+        Mac48Address address;
+    };
+
+    /// STA that can be served in the DL MU PPDU or solicited by the Trigger Frame
+    struct Candidate
+    {
+        StaInfo sta;
+        Ptr<WifiMpdu> mpdu; //!< first MPDU to send (DL only)
+        double urgency;     //!< head-of-line delay (DL) or time since served (UL) over budget
+        uint32_t backlog;   //!< bytes queued for (DL) or reported by (UL) the STA
+        AcIndex ac;         //!< AC whose latency budget gives the urgency
+    };
+
+    TxFormat SelectTxFormat() override;
+    DlMuInfo ComputeDlMuInfo() override;
+    UlMuInfo ComputeUlMuInfo() override;
+
+    TxFormat TrySendingDlMuPpdu();
+    TxFormat TrySendingTriggerFrame(TriggerFrameType type);
+    std::vector<Candidate> RankUlStations(bool reportedOnly) const;
+    Time GetLatencyBudget(Mac48Address address, AcIndex ac) const;
+    void NotifyStationAssociated(uint16_t aid, Mac48Address address);
+    void NotifyStationDeassociated(uint16_t aid, Mac48Address address);
+
+    uint8_t m_nStations;
+    bool m_enableUlOfdma;
+    bool m_enableBsrp;
+    uint32_t m_ulPsduSize;
+    Time m_voBudget;
+    Time m_viBudget;
+    Time m_beBudget;
+    Time m_bkBudget;
+
+    std::list<StaInfo> m_stations;
+    std::map<Mac48Address, Time> m_staBudget;     //!< Latency budget per STA
+    std::map<Mac48Address, double> m_staWeight;   //!< Urgency weight per STA
+    std::map<Mac48Address, Time> m_lastUlService; //!< Last Basic Trigger Frame per STA
+    std::vector<Candidate> m_candidates;
+    WifiTxParameters m_txParams;
+    CtrlTriggerHeader m_trigger;
+    WifiMacHeader m_triggerMacHdr;
+};
+
+};
+#endif
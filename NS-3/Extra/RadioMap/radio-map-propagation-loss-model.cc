@@ -0,0 +1,354 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "radio-map-propagation-loss-model.h"
+
+#include <ns3/abort.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/pointer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RadioMapPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(RadioMapPropagationLossModel);
+
+namespace
+{
+/// Magic string of the radio map format
+const char RADIO_MAP_MAGIC[8] = {'N', 'S', '3', 'R', 'M', 'P', '1', '\0'};
+
+/// Size of the fixed part of the header: magic, nSources, nx, ny, xMin, yMin, cellSize
+const size_t RADIO_MAP_HEADER_SIZE =
+    sizeof(RADIO_MAP_MAGIC) + 3 * sizeof(uint64_t) + 3 * sizeof(double);
+} // namespace
+
+TypeId
+RadioMapPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::RadioMapPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<RadioMapPropagationLossModel>()
+            .AddAttribute("Fallback",
+                          "Propagation loss model of the links the radio map does not cover",
+                          PointerValue(),
+                          MakePointerAccessor(&RadioMapPropagationLossModel::m_fallback),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("SourceTolerance",
+                          "Distance within which a link end is taken as a source of a source "
+                          "map (m)",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&RadioMapPropagationLossModel::m_sourceTolerance),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("MinCells",
+                          "Horizontal length (in cells) below which a link uses the Fallback "
+                          "model",
+                          DoubleValue(2.0),
+                          MakeDoubleAccessor(&RadioMapPropagationLossModel::m_minCells),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+RadioMapPropagationLossModel::RadioMapPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RadioMapPropagationLossModel::~RadioMapPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+    Unmap();
+}
+
+void
+RadioMapPropagationLossModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_fallback = nullptr;
+    Unmap();
+    PropagationLossModel::DoDispose();
+}
+
+void
+RadioMapPropagationLossModel::Unmap()
+{
+    if (m_map)
+    {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+        m_sourceX = nullptr;
+        m_sourceY = nullptr;
+        m_gain = nullptr;
+    }
+}
+
+void
+RadioMapPropagationLossModel::Load(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    Unmap();
+    int fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "Can not open radio map " << filename);
+    struct stat fileStat;
+    NS_ABORT_MSG_IF(fstat(fd, &fileStat) != 0, "Can not stat radio map " << filename);
+    m_mapSize = fileStat.st_size;
+
+    NS_ABORT_MSG_IF(m_mapSize < RADIO_MAP_HEADER_SIZE, "Truncated radio map " << filename);
+    m_map = mmap(nullptr, m_mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(m_map == MAP_FAILED, "Can not map radio map " << filename);
+
+    const char* data = static_cast<const char*>(m_map);
+    NS_ABORT_MSG_IF(std::memcmp(data, RADIO_MAP_MAGIC, sizeof(RADIO_MAP_MAGIC)) != 0,
+                    "Not a radio map: " << filename);
+    const char* field = data + sizeof(RADIO_MAP_MAGIC);
+    for (uint64_t* value : {&m_nSources, &m_nx, &m_ny})
+    {
+        std::memcpy(value, field, sizeof(uint64_t));
+        field += sizeof(uint64_t);
+    }
+    for (double* value : {&m_xMin, &m_yMin, &m_cellSize})
+    {
+        std::memcpy(value, field, sizeof(double));
+        field += sizeof(double);
+    }
+    NS_ABORT_MSG_IF(m_nx == 0 || m_ny == 0 || m_cellSize <= 0, "Empty radio map " << filename);
+
+    uint64_t nCells = m_nx * m_ny;
+    uint64_t nRows = m_nSources > 0 ? m_nSources : nCells;
+    const size_t expectedSize = RADIO_MAP_HEADER_SIZE + 2 * m_nSources * sizeof(double) +
+                                nRows * nCells * sizeof(float);
+    NS_ABORT_MSG_IF(m_mapSize < expectedSize, "Truncated radio map " << filename);
+
+    // The header is a multiple of 8 bytes, so the arrays are aligned in the mapping
+    m_sourceX = reinterpret_cast<const double*>(data + RADIO_MAP_HEADER_SIZE);
+    m_sourceY = m_sourceX + m_nSources;
+    m_gain = reinterpret_cast<const float*>(m_sourceY + m_nSources);
+    NS_LOG_INFO("Radio map " << filename << ": " << m_nx << "x" << m_ny << " cells of "
+                             << m_cellSize << " m, "
+                             << (m_nSources > 0 ? std::to_string(m_nSources) + " sources"
+                                                : std::string("cell pairs")));
+}
+
+void
+RadioMapPropagationLossModel::Generate(Ptr<PropagationLossModel> model,
+                                       const Rectangle& area,
+                                       double cellSize,
+                                       double txHeight,
+                                       double rxHeight,
+                                       const std::vector<Vector>& sources,
+                                       const std::string& filename)
+{
+    NS_LOG_FUNCTION(model << area << cellSize << filename);
+    NS_ABORT_MSG_IF(cellSize <= 0, "The radio map cells need a positive size");
+    uint64_t nx = std::max<uint64_t>(std::ceil((area.xMax - area.xMin) / cellSize), 1);
+    uint64_t ny = std::max<uint64_t>(std::ceil((area.yMax - area.yMin) / cellSize), 1);
+    uint64_t nCells = nx * ny;
+    uint64_t nSources = sources.size();
+
+    std::ofstream file(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+    file.write(RADIO_MAP_MAGIC, sizeof(RADIO_MAP_MAGIC));
+    for (uint64_t value : {nSources, nx, ny})
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    for (double value : {area.xMin, area.yMin, cellSize})
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    for (const auto& source : sources)
+    {
+        file.write(reinterpret_cast<const char*>(&source.x), sizeof(double));
+    }
+    for (const auto& source : sources)
+    {
+        file.write(reinterpret_cast<const char*>(&source.y), sizeof(double));
+    }
+
+    auto cellCentre = [&](uint64_t cell, double z) {
+        return Vector(area.xMin + (cell % nx + 0.5) * cellSize,
+                      area.yMin + (cell / nx + 0.5) * cellSize,
+                      z);
+    };
+    Ptr<ConstantPositionMobilityModel> tx = CreateObject<ConstantPositionMobilityModel>();
+    Ptr<ConstantPositionMobilityModel> rx = CreateObject<ConstantPositionMobilityModel>();
+    std::vector<float> row(nCells);
+    for (uint64_t r = 0; r < (nSources > 0 ? nSources : nCells); r++)
+    {
+        tx->SetPosition(nSources > 0 ? Vector(sources[r].x, sources[r].y, txHeight)
+                                     : cellCentre(r, txHeight));
+        for (uint64_t cell = 0; cell < nCells; cell++)
+        {
+            rx->SetPosition(cellCentre(cell, rxHeight));
+            row[cell] = model->CalcRxPower(0, tx, rx);
+        }
+        file.write(reinterpret_cast<const char*>(row.data()), nCells * sizeof(float));
+    }
+    NS_ABORT_MSG_IF(!file.good(), "Can not write " << filename);
+}
+
+uint64_t
+RadioMapPropagationLossModel::GetNLookups() const
+{
+    return m_lookups;
+}
+
+uint64_t
+RadioMapPropagationLossModel::GetNFallbacks() const
+{
+    return m_fallbacks;
+}
+
+Rectangle
+RadioMapPropagationLossModel::GetArea() const
+{
+    return Rectangle(m_xMin, m_xMin + m_nx * m_cellSize, m_yMin, m_yMin + m_ny * m_cellSize);
+}
+
+int64_t
+RadioMapPropagationLossModel::GetSource(const Vector& position) const
+{
+    int64_t source = -1;
+    double nearest = m_sourceTolerance;
+    for (uint64_t i = 0; i < m_nSources; i++)
+    {
+        double distance = std::hypot(position.x - m_sourceX[i], position.y - m_sourceY[i]);
+        if (distance <= nearest)
+        {
+            nearest = distance;
+            source = i;
+        }
+    }
+    return source;
+}
+
+bool
+RadioMapPropagationLossModel::GetCellWeights(const Vector& position,
+                                             std::array<uint64_t, 4>& cells,
+                                             std::array<double, 4>& weights) const
+{
+    double fx = (position.x - m_xMin) / m_cellSize;
+    double fy = (position.y - m_yMin) / m_cellSize;
+    if (fx < 0 || fy < 0 || fx > m_nx || fy > m_ny)
+    {
+        return false;
+    }
+    // Bilinear between the centres of the four nearest cells (clamped at the border)
+    fx = std::clamp(fx - 0.5, 0.0, m_nx - 1.0);
+    fy = std::clamp(fy - 0.5, 0.0, m_ny - 1.0);
+    uint64_t i0 = std::min<uint64_t>(fx, m_nx - 1);
+    uint64_t j0 = std::min<uint64_t>(fy, m_ny - 1);
+    uint64_t i1 = std::min(i0 + 1, m_nx - 1);
+    uint64_t j1 = std::min(j0 + 1, m_ny - 1);
+    double tx = fx - i0;
+    double ty = fy - j0;
+    cells = {j0 * m_nx + i0, j0 * m_nx + i1, j1 * m_nx + i0, j1 * m_nx + i1};
+    weights = {(1 - tx) * (1 - ty), tx * (1 - ty), (1 - tx) * ty, tx * ty};
+    return true;
+}
+
+bool
+RadioMapPropagationLossModel::Interpolate(uint64_t row, const Vector& position, double& gain) const
+{
+    std::array<uint64_t, 4> cells;
+    std::array<double, 4> weights;
+    if (!GetCellWeights(position, cells, weights))
+    {
+        return false;
+    }
+    const float* map = m_gain + row * m_nx * m_ny;
+    gain = 0;
+    for (uint32_t k = 0; k < 4; k++)
+    {
+        gain += weights[k] * map[cells[k]];
+    }
+    return true;
+}
+
+bool
+RadioMapPropagationLossModel::Lookup(const Vector& from, const Vector& to, double& gain) const
+{
+    if (m_nSources > 0)
+    {
+        int64_t source = GetSource(from);
+        return source >= 0 && Interpolate(source, to, gain);
+    }
+    // Cell-pair map: the rows of the four cells around the source end, each interpolated at
+    // the other end
+    std::array<uint64_t, 4> rows;
+    std::array<double, 4> weights;
+    if (!GetCellWeights(from, rows, weights))
+    {
+        return false;
+    }
+    gain = 0;
+    for (uint32_t k = 0; k < 4; k++)
+    {
+        double rowGain;
+        if (!Interpolate(rows[k], to, rowGain))
+        {
+            return false;
+        }
+        gain += weights[k] * rowGain;
+    }
+    return true;
+}
+
+double
+RadioMapPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                            Ptr<MobilityModel> a,
+                                            Ptr<MobilityModel> b) const
+{
+    NS_ABORT_MSG_IF(!m_map, "No radio map loaded");
+    m_lookups++;
+    Vector positionA = a->GetPosition();
+    Vector positionB = b->GetPosition();
+    if (std::hypot(positionA.x - positionB.x, positionA.y - positionB.y) >=
+        m_minCells * m_cellSize)
+    {
+        double gainAb;
+        double gainBa;
+        bool ab = Lookup(positionA, positionB, gainAb);
+        bool ba = Lookup(positionB, positionA, gainBa);
+        if (ab && ba)
+        {
+            return txPowerDbm + (gainAb + gainBa) / 2;
+        }
+        if (ab || ba)
+        {
+            return txPowerDbm + (ab ? gainAb : gainBa);
+        }
+    }
+
+    m_fallbacks++;
+    NS_ABORT_MSG_IF(!m_fallback,
+                    "Link " << positionA << " - " << positionB
+                            << " out of the radio map and no fallback model");
+    return m_fallback->CalcRxPower(txPowerDbm, a, b);
+}
+
+int64_t
+RadioMapPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    return 0;
+}
+
+}
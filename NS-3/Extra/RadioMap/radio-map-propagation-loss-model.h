@@ -0,0 +1,162 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef RADIO_MAP_PROPAGATION_LOSS_MODEL_H
+#define RADIO_MAP_PROPAGATION_LOSS_MODEL_H
+
+#include <ns3/propagation-loss-model.h>
+#include <ns3/rectangle.h>
+#include <ns3/vector.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class MobilityModel;
+
+/**
+ * \ingroup propagation
+ * \brief Propagation gain looked up in a precomputed radio map
+ *
+ * The radio map gives the gain (dB) from a set of sources to the centre of every cell of a
+ * uniform grid. It is either a cell-pair map, where every cell is a source, or a source map,
+ * with the gain of a few fixed transmitters (the APs) to every cell. The gain of a link is
+ * interpolated at both ends: bilinearly between the four cells around each end of a cell-pair
+ * map, or, in a source map, bilinearly at one end in the map of the other end, a source within
+ * SourceTolerance. Both directions are looked up and averaged, so that the gain is reciprocal.
+ * The links the map does not cover (outside the grid, or between two ends that are not
+ * sources) and the links shorter than MinCells cells, where the grid is too coarse, use the
+ * Fallback model.
+ *
+ * The map is memory-mapped and used in place (no copy):
+ * \code
+ * char     magic[8];         // "NS3RMP1\0"
+ * uint64_t nSources;         // 0: cell-pair map
+ * uint64_t nx;
+ * uint64_t ny;
+ * double   xMin;
+ * double   yMin;
+ * double   cellSize;         // cell (i, j) centred at xMin + (i + 0.5) cellSize, ...
+ * double   sourceX[nSources];
+ * double   sourceY[nSources];
+ * float    gain[nRows][nx * ny] // nRows = nSources, or nx * ny for a cell-pair map
+ * \endcode
+ * in host byte order, cells numbered j * nx + i. Generate builds a map from any propagation
+ * loss model; Helpful_Scripts/radio_map_from_measurements.py builds one from measured data.
+ */
+class RadioMapPropagationLossModel : public PropagationLossModel
+{
+  public:
+    static TypeId GetTypeId();
+    RadioMapPropagationLossModel();
+    ~RadioMapPropagationLossModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    RadioMapPropagationLossModel(const RadioMapPropagationLossModel&) = delete;
+    RadioMapPropagationLossModel& operator=(const RadioMapPropagationLossModel&) = delete;
+
+    /**
+     * \brief Map a radio map file
+     * \param filename radio map file
+     */
+    void Load(const std::string& filename);
+
+    /**
+     * \brief Build a radio map from a propagation loss model
+     * \param model propagation loss model
+     * \param area area covered by the grid
+     * \param cellSize side of the cells (m)
+     * \param txHeight height of the sources (m)
+     * \param rxHeight height of the cell centres (m)
+     * \param sources sources of a source map (empty: cell-pair map)
+     * \param filename output file
+     */
+    static void Generate(Ptr<PropagationLossModel> model,
+                         const Rectangle& area,
+                         double cellSize,
+                         double txHeight,
+                         double rxHeight,
+                         const std::vector<Vector>& sources,
+                         const std::string& filename);
+
+    uint64_t GetNLookups() const;
+    uint64_t GetNFallbacks() const;
+
+    /**
+     * \return the area covered by the grid of the loaded map
+     */
+    Rectangle GetArea() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    void Unmap();
+
+    /**
+     * \param position position of a link end
+     * \return the source of a source map at that position, or -1 if there is none
+     */
+    int64_t GetSource(const Vector& position) const;
+
+    /**
+     * \brief Bilinear weights of the centres of the four cells around a position
+     * \param position position
+     * \param cells the four cells (clamped at the border of the grid)
+     * \param weights their weights
+     * \return whether the position is within the grid
+     */
+    bool GetCellWeights(const Vector& position,
+                        std::array<uint64_t, 4>& cells,
+                        std::array<double, 4>& weights) const;
+
+    /**
+     * \brief Interpolate a row of the map
+     * \param row row of the map
+     * \param position position of the other end
+     * \param gain interpolated gain (dB)
+     * \return whether the position is within the grid
+     */
+    bool Interpolate(uint64_t row, const Vector& position, double& gain) const;
+
+    /**
+     * \brief Gain from one end of a link to the other
+     * \param from position of the source end
+     * \param to position of the other end
+     * \param gain interpolated gain (dB)
+     * \return whether the map covers the link in this direction
+     */
+    bool Lookup(const Vector& from, const Vector& to, double& gain) const;
+
+    Ptr<PropagationLossModel> m_fallback;
+    double m_sourceTolerance;
+    double m_minCells;
+
+    void* m_map{nullptr};
+    size_t m_mapSize{0};
+    uint64_t m_nSources{0};
+    uint64_t m_nx{0};
+    uint64_t m_ny{0};
+    double m_xMin{0};
+    double m_yMin{0};
+    double m_cellSize{1};
+    const double* m_sourceX{nullptr};
+    const double* m_sourceY{nullptr};
+    const float* m_gain{nullptr};
+
+    mutable uint64_t m_lookups{0};
+    mutable uint64_t m_fallbacks{0};
+};
+
+};
+#endif
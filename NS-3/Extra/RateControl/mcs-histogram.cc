@@ -0,0 +1,168 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "mcs-histogram.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/simulator.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-psdu.h>
+
+#include <fstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("McsHistogram");
+
+NS_OBJECT_ENSURE_REGISTERED(McsHistogram);
+
+namespace
+{
+uint64_t
+AddressKey(Mac48Address address)
+{
+    uint8_t buffer[6];
+    address.CopyTo(buffer);
+    uint64_t key = 0;
+    for (auto byte : buffer)
+    {
+        key = (key << 8) | byte;
+    }
+    return key;
+}
+} // namespace
+
+McsHistogram::McsHistogram()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+McsHistogram::~McsHistogram()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+McsHistogram::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::McsHistogram").SetParent<Object>().AddConstructor<McsHistogram>();
+    return tid;
+}
+
+void
+McsHistogram::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_devices.clear();
+    m_deviceIndex.clear();
+    Object::DoDispose();
+}
+
+void
+McsHistogram::AddBss(const std::string& label,
+                     const NetDeviceContainer& apDevices,
+                     const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    for (const auto& [devices, isAp] :
+         {std::make_pair(apDevices, true), std::make_pair(staDevices, false)})
+    {
+        for (uint32_t i = 0; i < devices.GetN(); i++)
+        {
+            Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+            NS_ASSERT(device);
+            Device entry;
+            entry.bss = label;
+            entry.nodeId = device->GetNode()->GetId();
+            entry.isAp = isAp;
+
+            uint32_t index = m_devices.size();
+            m_deviceIndex[AddressKey(device->GetMac()->GetAddress())] = index;
+            m_devices.push_back(entry);
+
+            device->GetPhy()->TraceConnectWithoutContext(
+                "PhyTxPsduBegin",
+                MakeCallback(&McsHistogram::NotifyTx, this).Bind(index));
+        }
+    }
+}
+
+void
+McsHistogram::SetWindow(Time start, Time end)
+{
+    m_start = start;
+    m_end = end;
+}
+
+void
+McsHistogram::NotifyTx(uint32_t txIndex,
+                       WifiConstPsduMap psduMap,
+                       WifiTxVector txVector,
+                       double txPowerW)
+{
+    Time now = Simulator::Now();
+    if (now < m_start || now > m_end)
+    {
+        return;
+    }
+    for (const auto& [staId, psdu] : psduMap)
+    {
+        if (!psdu->GetHeader(0).IsQosData())
+        {
+            continue;
+        }
+        WifiMode mode = txVector.GetMode(staId);
+        if (mode.GetModulationClass() < WIFI_MOD_CLASS_HT || mode.GetMcsValue() > MAX_MCS)
+        {
+            continue;
+        }
+        Device& tx = m_devices[txIndex];
+        if (!tx.isAp)
+        {
+            tx.ul[mode.GetMcsValue()]++;
+            continue;
+        }
+        auto it = m_deviceIndex.find(AddressKey(psdu->GetAddr1()));
+        if (it != m_deviceIndex.end() && !m_devices[it->second].isAp)
+        {
+            m_devices[it->second].dl[mode.GetMcsValue()]++;
+        }
+    }
+}
+
+void
+McsHistogram::WriteCsv(const std::string& filename,
+                       uint32_t seedNumber,
+                       uint32_t runNumber) const
+{
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    // seed, run, BSS, STA node, direction (DL/UL), MCS, data PSDUs
+    for (const auto& device : m_devices)
+    {
+        for (uint8_t mcs = 0; mcs <= MAX_MCS && !device.isAp; mcs++)
+        {
+            if (device.dl[mcs] > 0)
+            {
+                file << seedNumber << "," << runNumber << "," << device.bss << ","
+                     << device.nodeId << ",DL," << +mcs << "," << device.dl[mcs] << "\n";
+            }
+            if (device.ul[mcs] > 0)
+            {
+                file << seedNumber << "," << runNumber << "," << device.bss << ","
+                     << device.nodeId << ",UL," << +mcs << "," << device.ul[mcs] << "\n";
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef MCS_HISTOGRAM_H
+#define MCS_HISTOGRAM_H
+
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-ppdu.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup helper
+ * \brief Histogram of the MCS selected for the data frames of every STA
+ *
+ * The PSDUs sent by the APs and STAs of the registered BSSs are traced at the PHY. Every QoS
+ * data PSDU sent within the measurement window counts once for its STA (the receiver in the
+ * downlink, the transmitter in the uplink) and MCS, whatever the rate control in use.
+ */
+class McsHistogram : public Object
+{
+  public:
+    /// Highest MCS index accounted
+    static constexpr uint8_t MAX_MCS = 15;
+
+    McsHistogram();
+    ~McsHistogram() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Trace the devices of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Set the measurement window
+     * \param start first accounted transmission
+     * \param end last accounted transmission
+     */
+    void SetWindow(Time start, Time end);
+
+    /**
+     * \brief Append the non-empty bins to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Traced device
+    struct Device
+    {
+        std::string bss;
+        uint32_t nodeId;
+        bool isAp;
+        std::array<uint64_t, MAX_MCS + 1> dl{}; //!< PSDUs received per MCS (STAs only)
+        std::array<uint64_t, MAX_MCS + 1> ul{}; //!< PSDUs sent per MCS (STAs only)
+    };
+
+    void NotifyTx(uint32_t txIndex,
+                  WifiConstPsduMap psduMap,
+                  WifiTxVector txVector,
+                  double txPowerW);
+
+    std::vector<Device> m_devices;
+    std::unordered_map<uint64_t, uint32_t> m_deviceIndex; //!< MAC address -> device index
+    Time m_start;
+    Time m_end{Time::Max()};
+};
+
+};
+#endif
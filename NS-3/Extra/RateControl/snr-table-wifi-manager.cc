@@ -0,0 +1,282 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "snr-table-wifi-manager.h"
+
+#include <ns3/abort.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/string.h>
+#include <ns3/wifi-phy.h>
+#include <ns3/wifi-utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SnrTableWifiManager");
+
+NS_OBJECT_ENSURE_REGISTERED(SnrTableWifiManager);
+
+/// Peer of a SnrTableWifiManager
+struct SnrTableWifiRemoteStation : public WifiRemoteStation
+{
+    double m_snrDb{0};       //!< Smoothed SNR estimate, scaled to 20 MHz (dB)
+    bool m_snrValid{false};  //!< An SNR sample has been received
+    bool m_feedback{false};  //!< The estimate comes from the data SNR fed back by the peer
+    uint8_t m_lastMcs{0xff}; //!< MCS of the last data frame (for logging)
+};
+
+SnrTableWifiManager::SnrTableWifiManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SnrTableWifiManager::~SnrTableWifiManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+SnrTableWifiManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SnrTableWifiManager")
+            .SetParent<WifiRemoteStationManager>()
+            .SetGroupName("Wifi")
+            .AddConstructor<SnrTableWifiManager>()
+            .AddAttribute("SnrTable",
+                          "Minimum SNR (dB) of HE MCS 0, 1... at 20 MHz with one spatial stream",
+                          StringValue("2,5,9,11,15,18,20,25,29,31,34,37"),
+                          MakeStringAccessor(&SnrTableWifiManager::SetSnrTable,
+                                             &SnrTableWifiManager::GetSnrTable),
+                          MakeStringChecker())
+            .AddAttribute("Margin",
+                          "Margin between the SNR estimate and the tabulated SNR (dB)",
+                          DoubleValue(2.0),
+                          MakeDoubleAccessor(&SnrTableWifiManager::m_margin),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("Alpha",
+                          "Weight of a new sample in the SNR estimate",
+                          DoubleValue(0.3),
+                          MakeDoubleAccessor(&SnrTableWifiManager::m_alpha),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("FailurePenalty",
+                          "Decrease of the SNR estimate after a failed transmission (dB)",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&SnrTableWifiManager::m_failurePenalty),
+                          MakeDoubleChecker<double>(0.0));
+    return tid;
+}
+
+void
+SnrTableWifiManager::SetSnrTable(std::string table)
+{
+    m_snrTable.clear();
+    std::istringstream iss(table);
+    std::string value;
+    while (std::getline(iss, value, ','))
+    {
+        m_snrTable.push_back(std::stod(value));
+    }
+    NS_ABORT_MSG_IF(m_snrTable.empty(), "Empty SNR table");
+}
+
+std::string
+SnrTableWifiManager::GetSnrTable() const
+{
+    std::ostringstream oss;
+    for (size_t i = 0; i < m_snrTable.size(); i++)
+    {
+        oss << (i > 0 ? "," : "") << m_snrTable[i];
+    }
+    return oss.str();
+}
+
+WifiRemoteStation*
+SnrTableWifiManager::DoCreateStation() const
+{
+    NS_LOG_FUNCTION(this);
+    return new SnrTableWifiRemoteStation();
+}
+
+void
+SnrTableWifiManager::UpdateSnr(WifiRemoteStation* st, double snr, uint16_t channelWidth)
+{
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    // The noise of the sample spans its channel width: the same power over 20 MHz gets a
+    // higher SNR, so that samples of any width can be averaged and compared with the table
+    double snrDb = RatioToDb(snr) + 10 * std::log10(channelWidth / 20.0);
+    if (!station->m_snrValid)
+    {
+        station->m_snrDb = snrDb;
+        station->m_snrValid = true;
+    }
+    else
+    {
+        station->m_snrDb += m_alpha * (snrDb - station->m_snrDb);
+    }
+}
+
+void
+SnrTableWifiManager::DoReportRxOk(WifiRemoteStation* st, double rxSnr, WifiMode txMode)
+{
+    NS_LOG_FUNCTION(this << st << rxSnr << txMode);
+    // Uplink SNR only stands in for the downlink one until the peer feeds the latter back
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    if (!station->m_feedback)
+    {
+        UpdateSnr(st, rxSnr, std::min(GetChannelWidth(station), GetPhy()->GetChannelWidth()));
+    }
+}
+
+void
+SnrTableWifiManager::DoReportRtsFailed(WifiRemoteStation* st)
+{
+    NS_LOG_FUNCTION(this << st);
+}
+
+void
+SnrTableWifiManager::DoReportDataFailed(WifiRemoteStation* st)
+{
+    NS_LOG_FUNCTION(this << st);
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    station->m_snrDb -= m_failurePenalty;
+}
+
+void
+SnrTableWifiManager::DoReportRtsOk(WifiRemoteStation* st,
+                                   double ctsSnr,
+                                   WifiMode ctsMode,
+                                   double rtsSnr)
+{
+    NS_LOG_FUNCTION(this << st << ctsSnr << ctsMode << rtsSnr);
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    station->m_feedback = true;
+    // RTS frames are sent in 20 MHz (non-HT duplicate beyond)
+    UpdateSnr(st, rtsSnr, GetPhy()->GetChannelWidth() >= 40 ? 20 : GetPhy()->GetChannelWidth());
+}
+
+void
+SnrTableWifiManager::DoReportDataOk(WifiRemoteStation* st,
+                                    double ackSnr,
+                                    WifiMode ackMode,
+                                    double dataSnr,
+                                    uint16_t dataChannelWidth,
+                                    uint8_t dataNss)
+{
+    NS_LOG_FUNCTION(this << st << ackSnr << ackMode << dataSnr << dataChannelWidth << +dataNss);
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    station->m_feedback = true;
+    UpdateSnr(st, dataSnr, dataChannelWidth);
+}
+
+void
+SnrTableWifiManager::DoReportFinalRtsFailed(WifiRemoteStation* st)
+{
+    NS_LOG_FUNCTION(this << st);
+}
+
+void
+SnrTableWifiManager::DoReportFinalDataFailed(WifiRemoteStation* st)
+{
+    NS_LOG_FUNCTION(this << st);
+}
+
+WifiTxVector
+SnrTableWifiManager::DoGetDataTxVector(WifiRemoteStation* st, uint16_t allowedWidth)
+{
+    NS_LOG_FUNCTION(this << st << allowedWidth);
+    auto station = static_cast<SnrTableWifiRemoteStation*>(st);
+    uint16_t channelWidth = std::min(GetChannelWidth(station), allowedWidth);
+    uint16_t guardInterval = GetGuardInterval(station);
+
+    // Lowest mode until the peer is known to be HE and an SNR sample is available
+    WifiMode bestMode = GetSupported(station, 0);
+    uint8_t bestNss = 1;
+    if (GetHeSupported(station) && station->m_snrValid)
+    {
+        uint8_t maxNss =
+            std::min(GetMaxNumberOfTransmitStreams(), GetNumberOfSupportedStreams(station));
+        // The estimate is scaled to 20 MHz: a wider channel spreads the power over more noise
+        double widthDb = 10 * std::log10(channelWidth / 20.0);
+        uint64_t bestRate = 0;
+        for (uint8_t i = 0; i < GetNMcsSupported(station); i++)
+        {
+            WifiMode mode = GetMcsSupported(station, i);
+            if (mode.GetModulationClass() != WIFI_MOD_CLASS_HE ||
+                mode.GetMcsValue() >= m_snrTable.size())
+            {
+                continue;
+            }
+            for (uint8_t nss = 1; nss <= maxNss; nss++)
+            {
+                double required = m_snrTable[mode.GetMcsValue()] + widthDb + 10 * std::log10(nss);
+                if (!mode.IsAllowed(channelWidth, nss) ||
+                    required > station->m_snrDb - m_margin)
+                {
+                    continue;
+                }
+                uint64_t rate = mode.GetDataRate(channelWidth, guardInterval, nss);
+                if (rate > bestRate)
+                {
+                    bestRate = rate;
+                    bestMode = mode;
+                    bestNss = nss;
+                }
+            }
+        }
+        if (bestRate == 0)
+        {
+            bestMode = GetMcsSupported(station, 0); // Below the table: most robust HE MCS
+        }
+    }
+
+    if (bestMode.GetModulationClass() >= WIFI_MOD_CLASS_HT &&
+        bestMode.GetMcsValue() != station->m_lastMcs)
+    {
+        NS_LOG_DEBUG("Station " << station->m_state->m_address << " SNR " << station->m_snrDb
+                                << " dB: MCS " << +bestMode.GetMcsValue() << ", " << +bestNss
+                                << " streams");
+        station->m_lastMcs = bestMode.GetMcsValue();
+    }
+
+    return WifiTxVector(
+        bestMode,
+        GetDefaultTxPowerLevel(),
+        GetPreambleForTransmission(bestMode.GetModulationClass(), GetShortPreambleEnabled()),
+        ConvertGuardIntervalToNanoSeconds(bestMode,
+                                          GetShortGuardIntervalSupported(station),
+                                          NanoSeconds(guardInterval)),
+        GetNumberOfAntennas(),
+        bestNss,
+        0,
+        GetPhy()->GetTxBandwidth(bestMode, channelWidth),
+        GetAggregation(station));
+}
+
+WifiTxVector
+SnrTableWifiManager::DoGetRtsTxVector(WifiRemoteStation* st)
+{
+    NS_LOG_FUNCTION(this << st);
+    WifiMode mode = GetDefaultMode();
+    return WifiTxVector(
+        mode,
+        GetDefaultTxPowerLevel(),
+        GetPreambleForTransmission(mode.GetModulationClass(), GetShortPreambleEnabled()),
+        ConvertGuardIntervalToNanoSeconds(mode,
+                                          GetShortGuardIntervalSupported(st),
+                                          NanoSeconds(GetGuardInterval(st))),
+        1,
+        1,
+        0,
+        GetPhy()->GetTxBandwidth(mode, GetChannelWidth(st)),
+        GetAggregation(st));
+}
+
+}
@@ -0,0 +1,77 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef SNR_TABLE_WIFI_MANAGER_H
+#define SNR_TABLE_WIFI_MANAGER_H
+
+#include <ns3/wifi-remote-station-manager.h>
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup wifi
+ * \brief Rate control from a table of minimum SNR per HE MCS
+ *
+ * The manager keeps a smoothed estimate of the SNR every peer gets from the device (the data
+ * SNR fed back with the acknowledgments, or the SNR of the frames received from the peer until
+ * the first feedback arrives), scaled from the channel width of every sample to 20 MHz. Every
+ * data frame uses the (MCS, spatial streams) pair with the highest rate whose tabulated SNR,
+ * corrected for the channel width (+3 dB per doubling of 20 MHz) and the number of streams (+3 dB
+ * per doubling), is below the estimate minus Margin.
+ * A failed transmission lowers the estimate by FailurePenalty.
+ */
+class SnrTableWifiManager : public WifiRemoteStationManager
+{
+  public:
+    SnrTableWifiManager();
+    ~SnrTableWifiManager() override;
+    static TypeId GetTypeId();
+
+  private:
+    WifiRemoteStation* DoCreateStation() const override;
+    void DoReportRxOk(WifiRemoteStation* station, double rxSnr, WifiMode txMode) override;
+    void DoReportRtsFailed(WifiRemoteStation* station) override;
+    void DoReportDataFailed(WifiRemoteStation* station) override;
+    void DoReportRtsOk(WifiRemoteStation* station,
+                       double ctsSnr,
+                       WifiMode ctsMode,
+                       double rtsSnr) override;
+    void DoReportDataOk(WifiRemoteStation* station,
+                        double ackSnr,
+                        WifiMode ackMode,
+                        double dataSnr,
+                        uint16_t dataChannelWidth,
+                        uint8_t dataNss) override;
+    void DoReportFinalRtsFailed(WifiRemoteStation* station) override;
+    void DoReportFinalDataFailed(WifiRemoteStation* station) override;
+    WifiTxVector DoGetDataTxVector(WifiRemoteStation* station, uint16_t allowedWidth) override;
+    WifiTxVector DoGetRtsTxVector(WifiRemoteStation* station) override;
+
+    /**
+     * \brief Set the minimum SNR of every HE MCS
+     * \param table comma-separated SNR (dB) of MCS 0, 1... at 20 MHz with one stream
+     */
+    void SetSnrTable(std::string table);
+    std::string GetSnrTable() const;
+
+    /**
+     * \brief Add a new SNR sample of a peer
+     * \param station the peer
+     * \param snr linear SNR
+     * \param channelWidth channel width of the sample (MHz)
+     */
+    void UpdateSnr(WifiRemoteStation* station, double snr, uint16_t channelWidth);
+
+    std::vector<double> m_snrTable; //!< Minimum SNR (dB) per MCS at 20 MHz with one stream
+    double m_margin;
+    double m_alpha;
+    double m_failurePenalty;
+};
+
+};
+#endif
@@ -0,0 +1,76 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "roaming-assoc-manager.h"
+
+#include "roaming-manager.h"
+
+#include <ns3/log.h>
+#include <ns3/pointer.h>
+#include <ns3/sta-wifi-mac.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RoamingAssocManager");
+
+NS_OBJECT_ENSURE_REGISTERED(RoamingAssocManager);
+
+TypeId
+RoamingAssocManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::RoamingAssocManager")
+            .SetParent<WifiDefaultAssocManager>()
+            .SetGroupName("Wifi")
+            .AddConstructor<RoamingAssocManager>()
+            .AddAttribute("RoamingManager",
+                          "Roaming manager steering the STA",
+                          PointerValue(),
+                          MakePointerAccessor(&RoamingAssocManager::m_roamingManager),
+                          MakePointerChecker<RoamingManager>());
+    return tid;
+}
+
+RoamingAssocManager::RoamingAssocManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RoamingAssocManager::~RoamingAssocManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+RoamingAssocManager::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_roamingManager = nullptr;
+    WifiDefaultAssocManager::DoDispose();
+}
+
+bool
+RoamingAssocManager::Compare(const StaWifiMac::ApInfo& lhs, const StaWifiMac::ApInfo& rhs) const
+{
+    if (m_roamingManager)
+    {
+        auto target = m_roamingManager->GetTarget(m_mac->GetAddress());
+        if (target && lhs.m_bssid != rhs.m_bssid)
+        {
+            if (lhs.m_bssid == *target)
+            {
+                return true;
+            }
+            if (rhs.m_bssid == *target)
+            {
+                return false;
+            }
+        }
+    }
+    return lhs.m_snr > rhs.m_snr;
+}
+
+}
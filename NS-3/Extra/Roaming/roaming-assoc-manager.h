@@ -0,0 +1,40 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef ROAMING_ASSOC_MANAGER_H
+#define ROAMING_ASSOC_MANAGER_H
+
+#include <ns3/wifi-default-assoc-manager.h>
+
+namespace ns3
+{
+
+class RoamingManager;
+
+/**
+ * \ingroup wifi
+ * \brief Association manager of a STA steered by a RoamingManager
+ *
+ * The APs found in a scan are ranked as in WifiDefaultAssocManager (highest SNR first), except
+ * that the AP the RoamingManager steers the STA to, if found, goes first.
+ */
+class RoamingAssocManager : public WifiDefaultAssocManager
+{
+  public:
+    static TypeId GetTypeId();
+    RoamingAssocManager();
+    ~RoamingAssocManager() override;
+
+    bool Compare(const StaWifiMac::ApInfo& lhs, const StaWifiMac::ApInfo& rhs) const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Ptr<RoamingManager> m_roamingManager;
+};
+
+};
+#endif
@@ -0,0 +1,556 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "roaming-manager.h"
+
+#include <ns3/abort.h>
+#include <ns3/ampdu-subframe-header.h>
+#include <ns3/arp-header.h>
+#include <ns3/arp-l3-protocol.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/ipv4.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/packet.h>
+#include <ns3/qos-txop.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/wifi-mac-header.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-mpdu.h>
+#include <ns3/wifi-net-device.h>
+#include <ns3/wifi-phy.h>
+
+#include <iostream>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RoamingManager");
+
+NS_OBJECT_ENSURE_REGISTERED(RoamingManager);
+
+RoamingManager::RoamingManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RoamingManager::~RoamingManager()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+RoamingManager::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::RoamingManager")
+            .SetParent<Object>()
+            .AddConstructor<RoamingManager>()
+            .AddAttribute("Interval",
+                          "Time between two handover decisions",
+                          TimeValue(MilliSeconds(500)),
+                          MakeTimeAccessor(&RoamingManager::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("RssiTrigger",
+                          "Steer the STAs that hear their AP below RssiThreshold",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&RoamingManager::m_rssiTrigger),
+                          MakeBooleanChecker())
+            .AddAttribute("LoadTrigger",
+                          "Steer the STAs of the overloaded APs to the least loaded ones",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoamingManager::m_loadTrigger),
+                          MakeBooleanChecker())
+            .AddAttribute("RssiThreshold",
+                          "RSSI of the AP below which a STA looks for a stronger AP (dBm)",
+                          DoubleValue(-75.0),
+                          MakeDoubleAccessor(&RoamingManager::m_rssiThreshold),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Hysteresis",
+                          "RSSI margin of the new AP over the current one (dB)",
+                          DoubleValue(6.0),
+                          MakeDoubleAccessor(&RoamingManager::m_hysteresis),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("LoadMargin",
+                          "Relative load over the mean load per AP that triggers steering",
+                          DoubleValue(0.25),
+                          MakeDoubleAccessor(&RoamingManager::m_loadMargin),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("MinRssi",
+                          "Minimum RSSI of the target AP of a load-triggered handover (dBm)",
+                          DoubleValue(-72.0),
+                          MakeDoubleAccessor(&RoamingManager::m_minRssi),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("HoldTime",
+                          "Minimum time between two steered handovers of a STA",
+                          TimeValue(Seconds(2)),
+                          MakeTimeAccessor(&RoamingManager::m_holdTime),
+                          MakeTimeChecker())
+            .AddAttribute("Alpha",
+                          "Weight of a new RSSI sample in the smoothed RSSI",
+                          DoubleValue(0.3),
+                          MakeDoubleAccessor(&RoamingManager::m_alpha),
+                          MakeDoubleChecker<double>(0.0, 1.0));
+    return tid;
+}
+
+void
+RoamingManager::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_aps.clear();
+    m_stas.clear();
+    m_apIndex.clear();
+    m_staIndex.clear();
+    if (m_csv.is_open())
+    {
+        m_csv.close();
+    }
+    Object::DoDispose();
+}
+
+void
+RoamingManager::AddBss(const std::string& label,
+                       const NetDeviceContainer& apDevices,
+                       const NetDeviceContainer& staDevices)
+{
+    NS_LOG_FUNCTION(this << label);
+    for (uint32_t i = 0; i < apDevices.GetN(); i++)
+    {
+        Ap ap;
+        ap.device = DynamicCast<WifiNetDevice>(apDevices.Get(i));
+        NS_ASSERT(ap.device);
+        ap.bss = label;
+        m_apIndex[ap.device->GetMac()->GetAddress()] = m_aps.size();
+        m_aps.push_back(ap);
+    }
+
+    for (uint32_t i = 0; i < staDevices.GetN(); i++)
+    {
+        Sta sta;
+        sta.device = DynamicCast<WifiNetDevice>(staDevices.Get(i));
+        NS_ASSERT(sta.device);
+        uint32_t index = m_stas.size();
+        m_staIndex[sta.device->GetMac()->GetAddress()] = index;
+        m_stas.push_back(sta);
+
+        Ptr<WifiMac> mac = sta.device->GetMac();
+        mac->TraceConnectWithoutContext(
+            "Assoc",
+            MakeCallback(&RoamingManager::NotifyAssoc, this).Bind(index));
+        mac->TraceConnectWithoutContext(
+            "DeAssoc",
+            MakeCallback(&RoamingManager::NotifyDeAssoc, this).Bind(index));
+        mac->TraceConnectWithoutContext(
+            "MacRx",
+            MakeCallback(&RoamingManager::NotifyMacRx, this).Bind(index));
+        mac->TraceConnectWithoutContext(
+            "AckedMpdu",
+            MakeCallback(&RoamingManager::NotifyAcked, this).Bind(index));
+        mac->TraceConnectWithoutContext(
+            "DroppedMpdu",
+            MakeCallback(&RoamingManager::NotifyDropped, this).Bind(index));
+        sta.device->GetPhy()->TraceConnectWithoutContext(
+            "MonitorSnifferRx",
+            MakeCallback(&RoamingManager::NotifyRx, this).Bind(index));
+    }
+}
+
+void
+RoamingManager::Start(Time measureStart, Time measureEnd)
+{
+    NS_LOG_FUNCTION(this << measureStart << measureEnd);
+    m_measureStart = measureStart;
+    m_measureEnd = measureEnd;
+    m_lastLoadUpdate = measureStart;
+    Simulator::Schedule(measureStart - Simulator::Now(), &RoamingManager::Update, this);
+}
+
+void
+RoamingManager::EnableCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber)
+{
+    m_csv.open(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!m_csv.is_open(), "Can not open " << filename);
+    m_seedNumber = seedNumber;
+    m_runNumber = runNumber;
+}
+
+std::optional<Mac48Address>
+RoamingManager::GetTarget(Mac48Address sta) const
+{
+    auto it = m_staIndex.find(sta);
+    if (it == m_staIndex.end())
+    {
+        return std::nullopt;
+    }
+    return m_stas[it->second].target;
+}
+
+void
+RoamingManager::NotifyRx(uint32_t staIndex,
+                         Ptr<const Packet> packet,
+                         uint16_t channelFreqMhz,
+                         WifiTxVector txVector,
+                         MpduInfo aMpdu,
+                         SignalNoiseDbm signalNoise,
+                         uint16_t staId)
+{
+    // HE data frames are (S-)MPDUs: the sniffer gets every subframe with its delimiter
+    Ptr<const Packet> mpdu = packet;
+    if (aMpdu.type != NORMAL_MPDU)
+    {
+        Ptr<Packet> subframe = packet->Copy();
+        AmpduSubframeHeader delimiter;
+        subframe->RemoveHeader(delimiter);
+        mpdu = subframe;
+    }
+    WifiMacHeader hdr;
+    mpdu->PeekHeader(hdr);
+    if (hdr.IsCtl())
+    {
+        return; // control frames may not carry the transmitter address
+    }
+    auto it = m_apIndex.find(hdr.GetAddr2());
+    if (it == m_apIndex.end())
+    {
+        return;
+    }
+    Sta& sta = m_stas[staIndex];
+    auto [rssi, inserted] = sta.rssi.emplace(it->second, signalNoise.signal);
+    if (!inserted)
+    {
+        rssi->second += m_alpha * (signalNoise.signal - rssi->second);
+    }
+}
+
+void
+RoamingManager::NotifyMacRx(uint32_t staIndex, Ptr<const Packet> packet)
+{
+    Sta& sta = m_stas[staIndex];
+    sta.lastDataRx = Simulator::Now();
+    if (sta.handover && sta.ap)
+    {
+        Time interruption = Simulator::Now() - sta.handover->lastDataRx;
+        m_interruptions++;
+        m_interruptionSum += interruption;
+        NS_LOG_DEBUG("STA " << sta.device->GetNode()->GetId() << " data resumed, interruption "
+                            << interruption.As(Time::MS));
+        LogHandover(sta, interruption);
+        sta.handover.reset();
+    }
+}
+
+void
+RoamingManager::NotifyAcked(uint32_t staIndex, Ptr<const WifiMpdu> mpdu)
+{
+    Sta& sta = m_stas[staIndex];
+    if (sta.leaving && mpdu->GetHeader().IsDisassociation())
+    {
+        Retune(sta);
+    }
+}
+
+void
+RoamingManager::NotifyDropped(uint32_t staIndex,
+                              WifiMacDropReason reason,
+                              Ptr<const WifiMpdu> mpdu)
+{
+    Sta& sta = m_stas[staIndex];
+    if (sta.leaving && mpdu->GetHeader().IsDisassociation())
+    {
+        Retune(sta);
+    }
+}
+
+void
+RoamingManager::NotifyAssoc(uint32_t staIndex, Mac48Address bssid)
+{
+    auto it = m_apIndex.find(bssid);
+    NS_ASSERT(it != m_apIndex.end());
+    AccumulateLoad();
+
+    Sta& sta = m_stas[staIndex];
+    sta.ap = it->second;
+    m_aps[it->second].load++;
+    sta.target.reset();
+
+    if (sta.lastAp && *sta.lastAp != it->second)
+    {
+        if (sta.handover)
+        {
+            // No data was received through the AP of the previous handover
+            LogHandover(sta, std::nullopt);
+        }
+        Handover handover;
+        handover.time = Simulator::Now();
+        handover.from = *sta.lastAp;
+        handover.to = it->second;
+        handover.trigger = sta.trigger;
+        handover.assocGap = Simulator::Now() - sta.deassocTime;
+        handover.lastDataRx = sta.lastDataRx.value_or(sta.deassocTime);
+        sta.handover = handover;
+        m_aps[*sta.lastAp].handoversOut++;
+        m_aps[it->second].handoversIn++;
+        m_handovers++;
+        NS_LOG_DEBUG("STA " << sta.device->GetNode()->GetId() << " " << m_aps[*sta.lastAp].bss
+                            << " -> " << m_aps[it->second].bss << " (" << sta.trigger
+                            << "), association gap " << handover.assocGap.As(Time::MS));
+
+        // The bridges still forward the frames for the STA to the port of its previous AP
+        Simulator::ScheduleNow(&RoamingManager::SendGratuitousArp, this, staIndex);
+    }
+    sta.trigger = "BeaconLoss";
+}
+
+void
+RoamingManager::LogHandover(const Sta& sta, std::optional<Time> interruption)
+{
+    if (!m_csv.is_open())
+    {
+        return;
+    }
+    const Handover& handover = *sta.handover;
+    // seed, run, time (s), STA node, from BSS, to BSS, trigger, association gap (ms),
+    // interruption (ms, empty if no data was received through the new AP)
+    m_csv << m_seedNumber << "," << m_runNumber << "," << handover.time.GetSeconds() << ","
+          << sta.device->GetNode()->GetId() << "," << m_aps[handover.from].bss << ","
+          << m_aps[handover.to].bss << "," << handover.trigger << ","
+          << handover.assocGap.GetSeconds() * 1000 << ",";
+    if (interruption)
+    {
+        m_csv << interruption->GetSeconds() * 1000;
+    }
+    m_csv << "\n";
+}
+
+void
+RoamingManager::SendGratuitousArp(uint32_t staIndex)
+{
+    const Sta& sta = m_stas[staIndex];
+    Ptr<Ipv4> ipv4 = sta.device->GetNode()->GetObject<Ipv4>();
+    int32_t interface = ipv4 ? ipv4->GetInterfaceForDevice(sta.device) : -1;
+    if (interface < 0 || !sta.ap)
+    {
+        return;
+    }
+    Ipv4Address address = ipv4->GetAddress(interface, 0).GetLocal();
+    ArpHeader arp;
+    arp.SetRequest(sta.device->GetAddress(), address, Mac48Address::GetBroadcast(), address);
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(arp);
+    sta.device->Send(packet, Mac48Address::GetBroadcast(), ArpL3Protocol::PROT_NUMBER);
+}
+
+void
+RoamingManager::NotifyDeAssoc(uint32_t staIndex, Mac48Address bssid)
+{
+    AccumulateLoad();
+    Sta& sta = m_stas[staIndex];
+    if (sta.ap)
+    {
+        m_aps[*sta.ap].load--;
+        sta.lastAp = sta.ap;
+        sta.ap.reset();
+    }
+    sta.deassocTime = Simulator::Now();
+}
+
+void
+RoamingManager::AccumulateLoad()
+{
+    Time now = std::min(Simulator::Now(), m_measureEnd);
+    if (m_measureEnd.IsZero() || now <= m_lastLoadUpdate)
+    {
+        return;
+    }
+    for (auto& ap : m_aps)
+    {
+        ap.loadTime += ap.load * (now - m_lastLoadUpdate).GetSeconds();
+    }
+    m_lastLoadUpdate = now;
+}
+
+void
+RoamingManager::Steer(Sta& sta, uint32_t apIndex, const std::string& trigger)
+{
+    NS_LOG_FUNCTION(this << sta.device->GetNode()->GetId() << m_aps[apIndex].bss << trigger);
+    sta.target = m_aps[apIndex].device->GetMac()->GetAddress();
+    sta.trigger = trigger;
+    sta.holdUntil = Simulator::Now() + m_holdTime;
+    sta.leaving = true;
+
+    // Disassociation frame to the current AP, so that it releases the STA; the STA is retuned
+    // once the frame is acknowledged or dropped
+    Ptr<WifiMac> mac = sta.device->GetMac();
+    Mac48Address bssid = m_aps[*sta.ap].device->GetMac()->GetAddress();
+    WifiMacHeader hdr;
+    hdr.SetType(WIFI_MAC_MGT_DISASSOCIATION);
+    hdr.SetAddr1(bssid);
+    hdr.SetAddr2(mac->GetAddress());
+    hdr.SetAddr3(bssid);
+    hdr.SetDsNotFrom();
+    hdr.SetDsNotTo();
+    Ptr<Packet> packet = Create<Packet>(2); // reason code
+    // Management frames of a QoS STA are sent with AC_VO
+    Ptr<Txop> txop = mac->GetQosSupported() ? mac->GetQosTxop(AC_VO) : mac->GetTxop();
+    txop->Queue(Create<WifiMpdu>(packet, hdr));
+}
+
+void
+RoamingManager::Retune(Sta& sta)
+{
+    NS_LOG_FUNCTION(this << sta.device->GetNode()->GetId());
+    sta.leaving = false;
+
+    // Retuning the STA to its own channel disassociates it and starts a new scan
+    Ptr<WifiPhy> phy = sta.device->GetPhy();
+    const WifiPhyOperatingChannel& channel = phy->GetOperatingChannel();
+    std::ostringstream settings;
+    settings << "{" << +channel.GetNumber() << ", " << channel.GetWidth() << ", ";
+    switch (channel.GetPhyBand())
+    {
+    case WIFI_PHY_BAND_2_4GHZ:
+        settings << "BAND_2_4GHZ";
+        break;
+    case WIFI_PHY_BAND_6GHZ:
+        settings << "BAND_6GHZ";
+        break;
+    default:
+        settings << "BAND_5GHZ";
+        break;
+    }
+    settings << ", " << +channel.GetPrimaryChannelIndex(20) << "}";
+    phy->SetAttribute("ChannelSettings", StringValue(settings.str()));
+}
+
+void
+RoamingManager::Update()
+{
+    AccumulateLoad();
+
+    double meanLoad = 0;
+    for (const auto& ap : m_aps)
+    {
+        meanLoad += ap.load;
+    }
+    meanLoad /= m_aps.size();
+
+    // Loads updated with the decisions of this step, so that an AP does not get every STA
+    std::vector<uint32_t> loads;
+    for (const auto& ap : m_aps)
+    {
+        loads.push_back(ap.load);
+    }
+
+    for (auto& sta : m_stas)
+    {
+        if (!sta.ap || Simulator::Now() < sta.holdUntil || !sta.rssi.count(*sta.ap))
+        {
+            continue;
+        }
+        uint32_t current = *sta.ap;
+        double currentRssi = sta.rssi.at(current);
+
+        if (m_rssiTrigger && currentRssi < m_rssiThreshold)
+        {
+            std::optional<uint32_t> best;
+            for (const auto& [ap, rssi] : sta.rssi)
+            {
+                if (ap != current && rssi > currentRssi + m_hysteresis &&
+                    (!best || rssi > sta.rssi.at(*best)))
+                {
+                    best = ap;
+                }
+            }
+            if (best)
+            {
+                loads[current]--;
+                loads[*best]++;
+                Steer(sta, *best, "Rssi");
+                continue;
+            }
+        }
+
+        if (m_loadTrigger && loads[current] > (1 + m_loadMargin) * meanLoad)
+        {
+            std::optional<uint32_t> best;
+            for (const auto& [ap, rssi] : sta.rssi)
+            {
+                if (ap != current && rssi >= m_minRssi && loads[ap] + 1 < loads[current] &&
+                    (!best || loads[ap] < loads[*best] ||
+                     (loads[ap] == loads[*best] && rssi > sta.rssi.at(*best))))
+                {
+                    best = ap;
+                }
+            }
+            if (best)
+            {
+                loads[current]--;
+                loads[*best]++;
+                Steer(sta, *best, "Load");
+            }
+        }
+    }
+
+    if (Simulator::Now() + m_interval <= m_measureEnd)
+    {
+        Simulator::Schedule(m_interval, &RoamingManager::Update, this);
+    }
+}
+
+void
+RoamingManager::WriteLoadCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber)
+{
+    AccumulateLoad();
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    double window = (m_lastLoadUpdate - m_measureStart).GetSeconds();
+    // seed, run, BSS, AP node, mean associated STAs, handovers in, handovers out
+    for (const auto& ap : m_aps)
+    {
+        file << seedNumber << "," << runNumber << "," << ap.bss << ","
+             << ap.device->GetNode()->GetId() << "," << (window > 0 ? ap.loadTime / window : 0)
+             << "," << ap.handoversIn << "," << ap.handoversOut << "\n";
+    }
+}
+
+void
+RoamingManager::Report()
+{
+    AccumulateLoad();
+    double window = (m_lastLoadUpdate - m_measureStart).GetSeconds();
+    double sum = 0;
+    double squares = 0;
+    for (const auto& ap : m_aps)
+    {
+        double load = window > 0 ? ap.loadTime / window : 0;
+        sum += load;
+        squares += load * load;
+    }
+    // Handovers still waiting for data through the new AP
+    for (auto& sta : m_stas)
+    {
+        if (sta.handover)
+        {
+            LogHandover(sta, std::nullopt);
+            sta.handover.reset();
+        }
+    }
+    std::cout << "Roaming: " << m_handovers << " handovers";
+    if (m_interruptions > 0)
+    {
+        std::cout << ", mean data interruption "
+                  << m_interruptionSum.GetSeconds() * 1000 / m_interruptions << " ms (over "
+                  << m_interruptions << " handovers with data after them)";
+    }
+    std::cout << ", AP load balance (Jain) "
+              << (squares > 0 ? sum * sum / (m_aps.size() * squares) : 1.0) << std::endl;
+}
+
+}
@@ -0,0 +1,192 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef ROAMING_MANAGER_H
+#define ROAMING_MANAGER_H
+
+#include <ns3/mac48-address.h>
+#include <ns3/net-device-container.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/wifi-mac.h>
+#include <ns3/wifi-phy-common.h>
+#include <ns3/wifi-tx-vector.h>
+
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class WifiNetDevice;
+
+/**
+ * \ingroup helper
+ * \brief RSSI- and load-triggered handover of the STAs between the APs of an ESS
+ *
+ * Every STA keeps a smoothed RSSI of each AP it hears (beacons and any other frame sent by
+ * the AP). Every Interval, an associated STA out of its hold time is steered:
+ *
+ * - Rssi trigger: when the RSSI of its AP is below RssiThreshold and another AP is heard at
+ *   least Hysteresis dB stronger, to the strongest one;
+ * - Load trigger: when its AP serves more than (1 + LoadMargin) times the mean number of
+ *   associated STAs per AP, to the least loaded AP heard above MinRssi.
+ *
+ * To steer a STA, it sends a Disassociation frame to its AP, so that the AP drops its
+ * association, and once the frame is acknowledged (or dropped) it is retuned to its channel,
+ * which makes it scan again, with the target AP ranked first in its RoamingAssocManager. After
+ * every handover the STA broadcasts a gratuitous ARP through its new AP, so that the bridges of
+ * the backbone learn its new port and the downlink flows follow it.
+ *
+ * Each handover (steered or after a beacon loss) is logged with its association gap (from the
+ * disassociation to the association with the new AP) and its interruption: the gap between
+ * the last data packet received by the STA before the handover and the first one after it.
+ * The number of STAs associated to every AP is integrated over the measurement window to
+ * report the load balance.
+ */
+class RoamingManager : public Object
+{
+  public:
+    RoamingManager();
+    ~RoamingManager() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Manage the APs and STAs of a BSS
+     * \param label label of the BSS
+     * \param apDevices AP devices of the BSS
+     * \param staDevices STA devices of the BSS
+     */
+    void AddBss(const std::string& label,
+                const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& staDevices);
+
+    /**
+     * \brief Start the periodic handover decisions
+     * \param measureStart first decision and start of the load accounting
+     * \param measureEnd last decision and end of the load accounting
+     */
+    void Start(Time measureStart, Time measureEnd);
+
+    /**
+     * \brief Log every handover to a CSV file
+     * \param filename output file (appended)
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void EnableCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber);
+
+    /**
+     * \brief Append the load of every AP to a CSV file
+     * \param filename output file
+     * \param seedNumber seed of the run
+     * \param runNumber run number
+     */
+    void WriteLoadCsv(const std::string& filename, uint32_t seedNumber, uint32_t runNumber);
+
+    /**
+     * \brief Print the handovers, their interruption time and the load balance of the APs
+     */
+    void Report();
+
+    /**
+     * \param sta MAC address of a STA
+     * \return the BSSID the STA is steered to, if any
+     */
+    std::optional<Mac48Address> GetTarget(Mac48Address sta) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Managed AP
+    struct Ap
+    {
+        Ptr<WifiNetDevice> device;
+        std::string bss;
+        uint32_t load{0};     //!< associated STAs
+        double loadTime{0};   //!< associated STAs integrated over the window (STA x s)
+        uint32_t handoversIn{0};
+        uint32_t handoversOut{0};
+    };
+
+    /// Handover waiting for the first data packet received through the new AP
+    struct Handover
+    {
+        Time time;     //!< association with the new AP
+        uint32_t from;
+        uint32_t to;
+        std::string trigger;
+        Time assocGap; //!< from the disassociation to the association
+        Time lastDataRx; //!< last data received before the handover (or disassociation)
+    };
+
+    /// Managed STA
+    struct Sta
+    {
+        Ptr<WifiNetDevice> device;
+        std::map<uint32_t, double> rssi; //!< smoothed RSSI (dBm) per AP index
+        std::optional<uint32_t> ap;      //!< AP the STA is associated to
+        std::optional<uint32_t> lastAp;  //!< AP before the last disassociation
+        std::optional<Mac48Address> target;
+        std::string trigger{"BeaconLoss"}; //!< cause of the next handover
+        Time deassocTime;
+        Time holdUntil;
+        bool leaving{false}; //!< Disassociation frame queued, retune pending
+        std::optional<Time> lastDataRx;
+        std::optional<Handover> handover;
+    };
+
+    void NotifyRx(uint32_t staIndex,
+                  Ptr<const Packet> packet,
+                  uint16_t channelFreqMhz,
+                  WifiTxVector txVector,
+                  MpduInfo aMpdu,
+                  SignalNoiseDbm signalNoise,
+                  uint16_t staId);
+    void NotifyMacRx(uint32_t staIndex, Ptr<const Packet> packet);
+    void NotifyAcked(uint32_t staIndex, Ptr<const WifiMpdu> mpdu);
+    void NotifyDropped(uint32_t staIndex, WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu);
+    void NotifyAssoc(uint32_t staIndex, Mac48Address bssid);
+    void NotifyDeAssoc(uint32_t staIndex, Mac48Address bssid);
+    void AccumulateLoad();
+    void Update();
+    void Steer(Sta& sta, uint32_t apIndex, const std::string& trigger);
+    void Retune(Sta& sta);
+    void SendGratuitousArp(uint32_t staIndex);
+    void LogHandover(const Sta& sta, std::optional<Time> interruption);
+
+    Time m_interval;
+    bool m_rssiTrigger;
+    bool m_loadTrigger;
+    double m_rssiThreshold;
+    double m_hysteresis;
+    double m_loadMargin;
+    double m_minRssi;
+    Time m_holdTime;
+    double m_alpha;
+
+    std::vector<Ap> m_aps;
+    std::vector<Sta> m_stas;
+    std::map<Mac48Address, uint32_t> m_apIndex;
+    std::map<Mac48Address, uint32_t> m_staIndex;
+
+    Time m_measureStart;
+    Time m_measureEnd;
+    Time m_lastLoadUpdate;
+    uint32_t m_handovers{0};
+    uint32_t m_interruptions{0}; //!< handovers followed by data through the new AP
+    Time m_interruptionSum;
+    std::ofstream m_csv;
+    uint32_t m_seedNumber{0};
+    uint32_t m_runNumber{0};
+};
+
+};
+#endif
@@ -0,0 +1,228 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "trajectory-mobility-model.h"
+
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <ns3/log.h>
+#include <ns3/pointer.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TrajectoryMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED(TrajectoryMobilityModel);
+
+TrajectoryMobilityModel::TrajectoryMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TrajectoryMobilityModel::~TrajectoryMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+TrajectoryMobilityModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TrajectoryMobilityModel")
+            .SetParent<MobilityModel>()
+            .SetGroupName("Mobility")
+            .AddConstructor<TrajectoryMobilityModel>()
+            .AddAttribute("Bounds",
+                          "Bounds of the area to cruise.",
+                          RectangleValue(Rectangle(0.0, 100.0, 0.0, 100.0)),
+                          MakeRectangleAccessor(&TrajectoryMobilityModel::m_bounds),
+                          MakeRectangleChecker())
+            .AddAttribute("Time",
+                          "Change current direction and speed after moving for this delay.",
+                          TimeValue(Seconds(1.0)),
+                          MakeTimeAccessor(&TrajectoryMobilityModel::m_modeTime),
+                          MakeTimeChecker())
+            .AddAttribute("Distance",
+                          "Change current direction and speed after moving for this distance.",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&TrajectoryMobilityModel::m_modeDistance),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Mode",
+                          "The mode indicates the condition used to "
+                          "change the current speed and direction",
+                          EnumValue(TrajectoryMobilityModel::MODE_DISTANCE),
+                          MakeEnumAccessor(&TrajectoryMobilityModel::m_mode),
+                          MakeEnumChecker(TrajectoryMobilityModel::MODE_DISTANCE,
+                                          "Distance",
+                                          TrajectoryMobilityModel::MODE_TIME,
+                                          "Time"))
+            .AddAttribute("Direction",
+                          "A random variable used to pick the direction (radians).",
+                          StringValue("ns3::UniformRandomVariable[Min=0.0|Max=6.283184]"),
+                          MakePointerAccessor(&TrajectoryMobilityModel::m_direction),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("Speed",
+                          "A random variable used to pick the speed (m/s).",
+                          StringValue("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
+                          MakePointerAccessor(&TrajectoryMobilityModel::m_speed),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("Duration",
+                          "Duration of the precomputed walk (the node stays still afterwards).",
+                          TimeValue(Seconds(3600)),
+                          MakeTimeAccessor(&TrajectoryMobilityModel::m_duration),
+                          MakeTimeChecker());
+    return tid;
+}
+
+void
+TrajectoryMobilityModel::DoInitialize()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_generated)
+    {
+        GenerateTrack(Simulator::Now().GetSeconds(), m_start);
+    }
+    MobilityModel::DoInitialize();
+}
+
+void
+TrajectoryMobilityModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_track.Clear();
+    MobilityModel::DoDispose();
+}
+
+const TrajectoryTrack&
+TrajectoryMobilityModel::GetTrack() const
+{
+    return m_track;
+}
+
+void
+TrajectoryMobilityModel::GenerateTrack(double startTime, const Vector& start)
+{
+    NS_LOG_FUNCTION(this << startTime << start);
+    // Start positions drawn out of the bounds are moved onto the closest edge
+    Vector position(std::clamp(start.x, m_bounds.xMin, m_bounds.xMax),
+                    std::clamp(start.y, m_bounds.yMin, m_bounds.yMax),
+                    start.z);
+
+    m_track.Clear();
+    m_track.Add(startTime, position);
+    m_hint = 0;
+    m_generated = true;
+
+    const double endTime = startTime + m_duration.GetSeconds();
+    double now = startTime;
+    while (now < endTime)
+    {
+        double speed = m_speed->GetValue();
+        double direction = m_direction->GetValue();
+        Vector velocity(std::cos(direction) * speed, std::sin(direction) * speed, 0.0);
+
+        double legTime = (m_mode == MODE_TIME) ? m_modeTime.GetSeconds()
+                                               : (speed > 0 ? m_modeDistance / speed : endTime);
+        legTime = std::min(legTime, endTime - now);
+        if (speed <= 0)
+        {
+            now += legTime;
+            m_track.Add(now, position);
+            continue;
+        }
+
+        // Move until the end of the leg, rebounding on the bounds
+        while (legTime > 0)
+        {
+            double tx = std::numeric_limits<double>::infinity();
+            double ty = std::numeric_limits<double>::infinity();
+            if (velocity.x > 0)
+            {
+                tx = (m_bounds.xMax - position.x) / velocity.x;
+            }
+            else if (velocity.x < 0)
+            {
+                tx = (m_bounds.xMin - position.x) / velocity.x;
+            }
+            if (velocity.y > 0)
+            {
+                ty = (m_bounds.yMax - position.y) / velocity.y;
+            }
+            else if (velocity.y < 0)
+            {
+                ty = (m_bounds.yMin - position.y) / velocity.y;
+            }
+
+            double step = std::min({legTime, tx, ty});
+            position.x = std::clamp(position.x + velocity.x * step, m_bounds.xMin, m_bounds.xMax);
+            position.y = std::clamp(position.y + velocity.y * step, m_bounds.yMin, m_bounds.yMax);
+            now += step;
+            legTime -= step;
+            m_track.Add(now, position);
+
+            if (step == tx)
+            {
+                velocity.x = -velocity.x;
+            }
+            if (step == ty)
+            {
+                velocity.y = -velocity.y;
+            }
+        }
+    }
+}
+
+Vector
+TrajectoryMobilityModel::DoGetPosition() const
+{
+    if (!m_generated)
+    {
+        return m_start;
+    }
+    return m_track.GetPosition(Simulator::Now().GetSeconds(), m_hint);
+}
+
+void
+TrajectoryMobilityModel::DoSetPosition(const Vector& position)
+{
+    NS_LOG_FUNCTION(this << position);
+    if (!m_generated)
+    {
+        m_start = position;
+    }
+    else
+    {
+        // Restart the walk from the new position
+        GenerateTrack(Simulator::Now().GetSeconds(), position);
+    }
+    NotifyCourseChange();
+}
+
+Vector
+TrajectoryMobilityModel::DoGetVelocity() const
+{
+    if (!m_generated)
+    {
+        return Vector(0, 0, 0);
+    }
+    return m_track.GetVelocity(Simulator::Now().GetSeconds(), m_hint);
+}
+
+int64_t
+TrajectoryMobilityModel::DoAssignStreams(int64_t stream)
+{
+    m_speed->SetStream(stream);
+    m_direction->SetStream(stream + 1);
+    return 2;
+}
+
+}
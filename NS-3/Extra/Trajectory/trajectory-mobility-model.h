@@ -0,0 +1,80 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef TRAJECTORY_MOBILITY_MODEL_H
+#define TRAJECTORY_MOBILITY_MODEL_H
+
+#include "trajectory-track.h"
+
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rectangle.h>
+
+namespace ns3
+{
+/**
+ * \ingroup mobility
+ * \brief 2D random walk precomputed as a waypoint table
+ *
+ * Drop-in replacement of RandomWalk2dMobilityModel (same Mode, Time, Distance, Speed,
+ * Direction and Bounds attributes, rebound on the bounds). The whole walk, up to Duration, is
+ * generated when the node is initialized, so that no event is scheduled per leg; positions
+ * are only computed when requested, by interpolation in the waypoint table.
+ *
+ * No CourseChange is notified at the end of each leg, as the legs are not simulated.
+ */
+class TrajectoryMobilityModel : public MobilityModel
+{
+  public:
+    /// Leg termination mode, as in RandomWalk2dMobilityModel
+    enum Mode
+    {
+        MODE_DISTANCE,
+        MODE_TIME
+    };
+
+    TrajectoryMobilityModel();
+    ~TrajectoryMobilityModel() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \return the waypoint table of the node
+     */
+    const TrajectoryTrack& GetTrack() const;
+
+  protected:
+    void DoInitialize() override;
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Generate the walk from a given time and position up to Duration
+     * \param startTime start time of the walk (seconds)
+     * \param start start position
+     */
+    void GenerateTrack(double startTime, const Vector& start);
+
+    Vector DoGetPosition() const override;
+    void DoSetPosition(const Vector& position) override;
+    Vector DoGetVelocity() const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    Mode m_mode;
+    Time m_modeTime;
+    double m_modeDistance;
+    Ptr<RandomVariableStream> m_speed;
+    Ptr<RandomVariableStream> m_direction;
+    Rectangle m_bounds;
+    Time m_duration;
+
+    TrajectoryTrack m_track;
+    Vector m_start;          //!< position set before the walk is generated
+    bool m_generated{false}; //!< walk already generated
+    mutable uint32_t m_hint{0};
+};
+
+};
+#endif
@@ -0,0 +1,346 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "trajectory-trace.h"
+
+#include <ns3/abort.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TrajectoryTrace");
+
+NS_OBJECT_ENSURE_REGISTERED(TrajectoryTrace);
+NS_OBJECT_ENSURE_REGISTERED(TraceMobilityModel);
+
+namespace
+{
+/// Magic string of the binary format
+const char TRACE_MAGIC[8] = {'N', 'S', '3', 'T', 'R', 'J', '1', '\0'};
+} // namespace
+
+TrajectoryTrace::TrajectoryTrace()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TrajectoryTrace::~TrajectoryTrace()
+{
+    NS_LOG_FUNCTION(this);
+    Unmap();
+}
+
+TypeId
+TrajectoryTrace::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TrajectoryTrace")
+                            .SetParent<Object>()
+                            .AddConstructor<TrajectoryTrace>();
+    return tid;
+}
+
+void
+TrajectoryTrace::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_tracks.clear();
+    Unmap();
+    Object::DoDispose();
+}
+
+void
+TrajectoryTrace::Unmap()
+{
+    if (m_map)
+    {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+}
+
+void
+TrajectoryTrace::Load(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    m_tracks.clear();
+    Unmap();
+    if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0)
+    {
+        LoadCsv(filename);
+    }
+    else
+    {
+        LoadBinary(filename);
+    }
+    NS_LOG_INFO("Trace " << filename << ": " << m_tracks.size() << " tracks");
+}
+
+void
+TrajectoryTrace::LoadCsv(const std::string& filename)
+{
+    std::ifstream file(filename);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open trajectory trace " << filename);
+
+    std::vector<int64_t> nodeIds;
+    std::vector<double> time;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+
+    std::string line;
+    uint64_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        int64_t nodeId;
+        double t;
+        double px;
+        double py;
+        double pz;
+        if (!(iss >> nodeId >> t >> px >> py >> pz))
+        {
+            // Header row
+            NS_ABORT_MSG_IF(lineNumber > 1, "Malformed trace row " << lineNumber);
+            continue;
+        }
+        nodeIds.push_back(nodeId);
+        time.push_back(t);
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+    }
+
+    // Group the rows by node and sort them by time into one compact table
+    std::vector<uint64_t> order(nodeIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+        return nodeIds[a] != nodeIds[b] ? nodeIds[a] < nodeIds[b] : time[a] < time[b];
+    });
+
+    m_time.resize(order.size());
+    m_x.resize(order.size());
+    m_y.resize(order.size());
+    m_z.resize(order.size());
+    for (uint64_t i = 0; i < order.size(); i++)
+    {
+        m_time[i] = time[order[i]];
+        m_x[i] = x[order[i]];
+        m_y[i] = y[order[i]];
+        m_z[i] = z[order[i]];
+    }
+
+    uint64_t begin = 0;
+    for (uint64_t i = 1; i <= order.size(); i++)
+    {
+        if (i == order.size() || nodeIds[order[i]] != nodeIds[order[begin]])
+        {
+            TrajectoryTrack track;
+            track.SetView(&m_time[begin], &m_x[begin], &m_y[begin], &m_z[begin], i - begin);
+            m_tracks.push_back(std::move(track));
+            begin = i;
+        }
+    }
+}
+
+void
+TrajectoryTrace::LoadBinary(const std::string& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    NS_ABORT_MSG_IF(fd < 0, "Can not open trajectory trace " << filename);
+    struct stat fileStat;
+    NS_ABORT_MSG_IF(fstat(fd, &fileStat) != 0, "Can not stat trajectory trace " << filename);
+    m_mapSize = fileStat.st_size;
+
+    const size_t headerSize = sizeof(TRACE_MAGIC) + 2 * sizeof(uint64_t);
+    NS_ABORT_MSG_IF(m_mapSize < headerSize, "Truncated trajectory trace " << filename);
+    m_map = mmap(nullptr, m_mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    NS_ABORT_MSG_IF(m_map == MAP_FAILED, "Can not map trajectory trace " << filename);
+
+    const char* data = static_cast<const char*>(m_map);
+    NS_ABORT_MSG_IF(std::memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0,
+                    "Not a binary trajectory trace: " << filename);
+    uint64_t nTracks;
+    uint64_t nWaypoints;
+    std::memcpy(&nTracks, data + sizeof(TRACE_MAGIC), sizeof(uint64_t));
+    std::memcpy(&nWaypoints, data + sizeof(TRACE_MAGIC) + sizeof(uint64_t), sizeof(uint64_t));
+
+    const size_t expectedSize =
+        headerSize + (nTracks + 1) * sizeof(uint64_t) + 4 * nWaypoints * sizeof(double);
+    NS_ABORT_MSG_IF(m_mapSize < expectedSize, "Truncated trajectory trace " << filename);
+
+    // The header is a multiple of 8 bytes, so the arrays are aligned in the mapping
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data + headerSize);
+    const double* time = reinterpret_cast<const double*>(offsets + nTracks + 1);
+    const double* x = time + nWaypoints;
+    const double* y = x + nWaypoints;
+    const double* z = y + nWaypoints;
+
+    m_tracks.reserve(nTracks);
+    for (uint64_t i = 0; i < nTracks; i++)
+    {
+        NS_ABORT_MSG_IF(offsets[i] > offsets[i + 1] || offsets[i + 1] > nWaypoints,
+                        "Wrong track offsets in " << filename);
+        TrajectoryTrack track;
+        track.SetView(time + offsets[i],
+                      x + offsets[i],
+                      y + offsets[i],
+                      z + offsets[i],
+                      offsets[i + 1] - offsets[i]);
+        m_tracks.push_back(std::move(track));
+    }
+}
+
+void
+TrajectoryTrace::SaveBinary(const std::string& filename) const
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ofstream file(filename, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+
+    uint64_t nTracks = m_tracks.size();
+    std::vector<uint64_t> offsets(nTracks + 1, 0);
+    for (uint64_t i = 0; i < nTracks; i++)
+    {
+        offsets[i + 1] = offsets[i] + m_tracks[i].GetN();
+    }
+    uint64_t nWaypoints = offsets[nTracks];
+
+    file.write(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&nTracks), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&nWaypoints), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    // One array per coordinate, every track in turn
+    for (uint32_t component = 0; component < 4; component++)
+    {
+        for (const auto& track : m_tracks)
+        {
+            for (uint32_t i = 0; i < track.GetN(); i++)
+            {
+                Vector waypoint = track.GetWaypoint(i);
+                double value = component == 0   ? track.GetTime(i)
+                               : component == 1 ? waypoint.x
+                               : component == 2 ? waypoint.y
+                                                : waypoint.z;
+                file.write(reinterpret_cast<const char*>(&value), sizeof(double));
+            }
+        }
+    }
+}
+
+uint32_t
+TrajectoryTrace::GetNTracks() const
+{
+    return m_tracks.size();
+}
+
+const TrajectoryTrack&
+TrajectoryTrace::GetTrack(uint32_t trackIndex) const
+{
+    NS_ABORT_MSG_IF(trackIndex >= m_tracks.size(), "No track " << trackIndex << " in the trace");
+    return m_tracks[trackIndex];
+}
+
+void
+TrajectoryTrace::Install(const NodeContainer& nodes, uint32_t firstTrack)
+{
+    NS_LOG_FUNCTION(this << firstTrack);
+    NS_ABORT_MSG_IF(firstTrack + nodes.GetN() > m_tracks.size(),
+                    "The trace has " << m_tracks.size() << " tracks, " << firstTrack + nodes.GetN()
+                                     << " are needed");
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<TraceMobilityModel> model = CreateObject<TraceMobilityModel>();
+        model->SetTrack(this, firstTrack + i);
+        nodes.Get(i)->AggregateObject(model);
+    }
+}
+
+TraceMobilityModel::TraceMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TraceMobilityModel::~TraceMobilityModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+TraceMobilityModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TraceMobilityModel")
+                            .SetParent<MobilityModel>()
+                            .SetGroupName("Mobility")
+                            .AddConstructor<TraceMobilityModel>();
+    return tid;
+}
+
+void
+TraceMobilityModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_track = nullptr;
+    m_trace = nullptr;
+    MobilityModel::DoDispose();
+}
+
+void
+TraceMobilityModel::SetTrack(Ptr<TrajectoryTrace> trace, uint32_t trackIndex)
+{
+    NS_LOG_FUNCTION(this << trace << trackIndex);
+    m_trace = trace;
+    m_track = &trace->GetTrack(trackIndex);
+    NS_ABORT_MSG_IF(m_track->GetN() == 0, "Empty track " << trackIndex);
+    m_hint = 0;
+    NotifyCourseChange();
+}
+
+Vector
+TraceMobilityModel::DoGetPosition() const
+{
+    NS_ASSERT(m_track);
+    Vector position = m_track->GetPosition(Simulator::Now().GetSeconds(), m_hint);
+    return position + m_offset;
+}
+
+void
+TraceMobilityModel::DoSetPosition(const Vector& position)
+{
+    NS_LOG_FUNCTION(this << position);
+    NS_ASSERT(m_track);
+    m_offset = position - m_track->GetPosition(Simulator::Now().GetSeconds(), m_hint);
+    NotifyCourseChange();
+}
+
+Vector
+TraceMobilityModel::DoGetVelocity() const
+{
+    NS_ASSERT(m_track);
+    return m_track->GetVelocity(Simulator::Now().GetSeconds(), m_hint);
+}
+
+}
@@ -0,0 +1,127 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef TRAJECTORY_TRACE_H
+#define TRAJECTORY_TRACE_H
+
+#include "trajectory-track.h"
+
+#include <ns3/mobility-model.h>
+#include <ns3/node-container.h>
+#include <ns3/object.h>
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup mobility
+ * \brief Recorded node trajectories read from a trace file
+ *
+ * Two formats are supported:
+ * - CSV (".csv" extension): one waypoint per row, "node,time,x,y,z" (time in seconds,
+ *   coordinates in meters, optional header). Rows are grouped by node and sorted by time
+ *   into a single compact table.
+ * - Binary (any other extension), memory-mapped and used in place (no copy):
+ *   \code
+ *   char     magic[8];           // "NS3TRJ1\0"
+ *   uint64_t nTracks;
+ *   uint64_t nWaypoints;         // total
+ *   uint64_t offset[nTracks + 1] // first waypoint of every track, offset[nTracks] = nWaypoints
+ *   double   time[nWaypoints];
+ *   double   x[nWaypoints];
+ *   double   y[nWaypoints];
+ *   double   z[nWaypoints];
+ *   \endcode
+ *   in host byte order. SaveBinary converts a loaded trace into this format.
+ *
+ * Tracks are numbered by ascending node identifier of the trace.
+ */
+class TrajectoryTrace : public Object
+{
+  public:
+    TrajectoryTrace();
+    ~TrajectoryTrace() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Load a trace file (CSV or binary, by extension)
+     * \param filename trace file
+     */
+    void Load(const std::string& filename);
+
+    /**
+     * \brief Write the loaded trace in the binary format
+     * \param filename output file
+     */
+    void SaveBinary(const std::string& filename) const;
+
+    uint32_t GetNTracks() const;
+    const TrajectoryTrack& GetTrack(uint32_t trackIndex) const;
+
+    /**
+     * \brief Make nodes follow consecutive tracks of the trace
+     * \param nodes nodes (e.g. the STAs of a BSS)
+     * \param firstTrack track of the first node (row offset of the BSS in the trace)
+     */
+    void Install(const NodeContainer& nodes, uint32_t firstTrack);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void LoadCsv(const std::string& filename);
+    void LoadBinary(const std::string& filename);
+    void Unmap();
+
+    // Owned storage (CSV traces)
+    std::vector<double> m_time;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+    // Memory-mapped file (binary traces)
+    void* m_map{nullptr};
+    size_t m_mapSize{0};
+
+    std::vector<TrajectoryTrack> m_tracks; //!< views on the storage or on the mapping
+};
+
+/**
+ * \ingroup mobility
+ * \brief Mobility model following one track of a TrajectoryTrace
+ *
+ * SetPosition shifts the whole track so that the node is at the given position now.
+ */
+class TraceMobilityModel : public MobilityModel
+{
+  public:
+    TraceMobilityModel();
+    ~TraceMobilityModel() override;
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Follow a track of a trace
+     * \param trace the trace (kept alive by the model)
+     * \param trackIndex the track
+     */
+    void SetTrack(Ptr<TrajectoryTrace> trace, uint32_t trackIndex);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Vector DoGetPosition() const override;
+    void DoSetPosition(const Vector& position) override;
+    Vector DoGetVelocity() const override;
+
+    Ptr<TrajectoryTrace> m_trace;
+    const TrajectoryTrack* m_track{nullptr};
+    Vector m_offset; //!< shift applied by SetPosition
+    mutable uint32_t m_hint{0};
+};
+
+};
+#endif
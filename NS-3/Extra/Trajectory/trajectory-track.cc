@@ -0,0 +1,184 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "trajectory-track.h"
+
+#include <ns3/abort.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+TrajectoryTrack::TrajectoryTrack()
+{
+}
+
+void
+TrajectoryTrack::UseStorage()
+{
+    m_time = m_timeStorage.data();
+    m_x = m_xStorage.data();
+    m_y = m_yStorage.data();
+    m_z = m_zStorage.data();
+    m_n = m_timeStorage.size();
+}
+
+void
+TrajectoryTrack::Add(double time, const Vector& position)
+{
+    NS_ABORT_MSG_IF(m_isView, "Can not add waypoints to a track view");
+    NS_ABORT_MSG_IF(m_n > 0 && time < m_time[m_n - 1], "Waypoints must be sorted by time");
+    m_timeStorage.push_back(time);
+    m_xStorage.push_back(position.x);
+    m_yStorage.push_back(position.y);
+    m_zStorage.push_back(position.z);
+    UseStorage();
+}
+
+void
+TrajectoryTrack::Clear()
+{
+    NS_ABORT_MSG_IF(m_isView, "Can not clear a track view");
+    m_timeStorage.clear();
+    m_xStorage.clear();
+    m_yStorage.clear();
+    m_zStorage.clear();
+    UseStorage();
+}
+
+void
+TrajectoryTrack::Reserve(uint32_t nWaypoints)
+{
+    NS_ABORT_MSG_IF(m_isView, "Can not reserve storage for a track view");
+    m_timeStorage.reserve(nWaypoints);
+    m_xStorage.reserve(nWaypoints);
+    m_yStorage.reserve(nWaypoints);
+    m_zStorage.reserve(nWaypoints);
+    UseStorage();
+}
+
+void
+TrajectoryTrack::SetView(const double* time,
+                         const double* x,
+                         const double* y,
+                         const double* z,
+                         uint32_t nWaypoints)
+{
+    m_timeStorage.clear();
+    m_xStorage.clear();
+    m_yStorage.clear();
+    m_zStorage.clear();
+    m_time = time;
+    m_x = x;
+    m_y = y;
+    m_z = z;
+    m_n = nWaypoints;
+    m_isView = true;
+}
+
+uint32_t
+TrajectoryTrack::GetN() const
+{
+    return m_n;
+}
+
+double
+TrajectoryTrack::GetTime(uint32_t index) const
+{
+    NS_ABORT_MSG_IF(index >= m_n, "No waypoint " << index);
+    return m_time[index];
+}
+
+Vector
+TrajectoryTrack::GetWaypoint(uint32_t index) const
+{
+    NS_ABORT_MSG_IF(index >= m_n, "No waypoint " << index);
+    return Vector(m_x[index], m_y[index], m_z[index]);
+}
+
+double
+TrajectoryTrack::GetStartTime() const
+{
+    return m_n > 0 ? m_time[0] : 0.0;
+}
+
+double
+TrajectoryTrack::GetEndTime() const
+{
+    return m_n > 0 ? m_time[m_n - 1] : 0.0;
+}
+
+uint32_t
+TrajectoryTrack::FindSegment(double time, uint32_t hint) const
+{
+    // Monotonic queries: the hinted segment or the next one
+    if (hint + 1 < m_n && m_time[hint] <= time)
+    {
+        if (time < m_time[hint + 1])
+        {
+            return hint;
+        }
+        if (hint + 2 < m_n && time < m_time[hint + 2])
+        {
+            return hint + 1;
+        }
+    }
+
+    // Binary search: last waypoint not later than time
+    const double* it = std::upper_bound(m_time, m_time + m_n, time);
+    if (it == m_time)
+    {
+        return 0;
+    }
+    return std::min<uint32_t>((it - m_time) - 1, m_n - 1);
+}
+
+Vector
+TrajectoryTrack::GetPosition(double time, uint32_t& hint) const
+{
+    NS_ABORT_MSG_IF(m_n == 0, "Empty trajectory track");
+    if (time <= m_time[0])
+    {
+        hint = 0;
+        return Vector(m_x[0], m_y[0], m_z[0]);
+    }
+    hint = FindSegment(time, hint);
+    if (hint + 1 >= m_n)
+    {
+        return Vector(m_x[m_n - 1], m_y[m_n - 1], m_z[m_n - 1]);
+    }
+
+    double duration = m_time[hint + 1] - m_time[hint];
+    double alpha = duration > 0 ? (time - m_time[hint]) / duration : 0.0;
+    return Vector(m_x[hint] + alpha * (m_x[hint + 1] - m_x[hint]),
+                  m_y[hint] + alpha * (m_y[hint + 1] - m_y[hint]),
+                  m_z[hint] + alpha * (m_z[hint + 1] - m_z[hint]));
+}
+
+Vector
+TrajectoryTrack::GetVelocity(double time, uint32_t& hint) const
+{
+    if (m_n < 2 || time < m_time[0])
+    {
+        return Vector(0, 0, 0);
+    }
+    hint = FindSegment(time, hint);
+    if (hint + 1 >= m_n)
+    {
+        return Vector(0, 0, 0);
+    }
+
+    double duration = m_time[hint + 1] - m_time[hint];
+    if (duration <= 0)
+    {
+        return Vector(0, 0, 0);
+    }
+    return Vector((m_x[hint + 1] - m_x[hint]) / duration,
+                  (m_y[hint + 1] - m_y[hint]) / duration,
+                  (m_z[hint + 1] - m_z[hint]) / duration);
+}
+
+}
@@ -0,0 +1,116 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef TRAJECTORY_TRACK_H
+#define TRAJECTORY_TRACK_H
+
+#include <ns3/vector.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * \ingroup mobility
+ * \brief Time-indexed waypoint table of a single node
+ *
+ * Waypoints are stored as a structure of arrays (time, x, y, z) sorted by time. The position
+ * between two waypoints is linearly interpolated, before the first and after the last one the
+ * node stays still. The arrays are either owned by the track or an external read-only view
+ * (e.g. a memory-mapped trace file), so that long traces are not copied.
+ */
+class TrajectoryTrack
+{
+  public:
+    TrajectoryTrack();
+    // The read pointers refer to the owned storage, which is only kept valid on move
+    TrajectoryTrack(const TrajectoryTrack&) = delete;
+    TrajectoryTrack& operator=(const TrajectoryTrack&) = delete;
+    TrajectoryTrack(TrajectoryTrack&&) = default;
+    TrajectoryTrack& operator=(TrajectoryTrack&&) = default;
+
+    /**
+     * \brief Append a waypoint (owned storage only)
+     * \param time waypoint time (seconds), not lower than the last one
+     * \param position waypoint position
+     */
+    void Add(double time, const Vector& position);
+
+    /**
+     * \brief Drop every waypoint (owned storage only)
+     */
+    void Clear();
+
+    /**
+     * \brief Reserve storage for a number of waypoints (owned storage only)
+     * \param nWaypoints number of waypoints
+     */
+    void Reserve(uint32_t nWaypoints);
+
+    /**
+     * \brief Use external arrays as waypoints, without copying them
+     * \param time waypoint times (seconds), sorted
+     * \param x x coordinates
+     * \param y y coordinates
+     * \param z z coordinates
+     * \param nWaypoints number of waypoints
+     *
+     * The arrays must outlive the track.
+     */
+    void SetView(const double* time,
+                 const double* x,
+                 const double* y,
+                 const double* z,
+                 uint32_t nWaypoints);
+
+    uint32_t GetN() const;
+    double GetTime(uint32_t index) const;
+    Vector GetWaypoint(uint32_t index) const;
+    double GetStartTime() const;
+    double GetEndTime() const;
+
+    /**
+     * \brief Position at a given time
+     * \param time time (seconds)
+     * \param hint segment of the last lookup, updated (queries are mostly monotonic)
+     * \return the interpolated position
+     */
+    Vector GetPosition(double time, uint32_t& hint) const;
+
+    /**
+     * \brief Velocity at a given time
+     * \param time time (seconds)
+     * \param hint segment of the last lookup, updated
+     * \return the velocity of the current segment
+     */
+    Vector GetVelocity(double time, uint32_t& hint) const;
+
+  private:
+    /**
+     * \brief Segment [i, i + 1] containing a time
+     * \param time time (seconds)
+     * \param hint segment of the last lookup
+     * \return the index of the first waypoint of the segment
+     */
+    uint32_t FindSegment(double time, uint32_t hint) const;
+
+    /// Point the read pointers to the owned storage
+    void UseStorage();
+
+    std::vector<double> m_timeStorage;
+    std::vector<double> m_xStorage;
+    std::vector<double> m_yStorage;
+    std::vector<double> m_zStorage;
+    const double* m_time{nullptr};
+    const double* m_x{nullptr};
+    const double* m_y{nullptr};
+    const double* m_z{nullptr};
+    uint32_t m_n{0};
+    bool m_isView{false};
+};
+
+};
+#endif
@@ -22,6 +22,7 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-module.h"
 #include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/neighbor-cache-helper.h"
 #include "ns3/network-module.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
@@ -36,6 +37,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/wifi-acknowledgment.h"
 #include "ns3/wifi-tx-vector.h"
+#include <ns3/fast-start-helper.h>
 #include <ns3/spectrum-helper.h>
 #include <ns3/three-gpp-ftp-m2-helper.h>
 #include <ns3/traffic-generator-ngmn-gaming.h>
@@ -60,6 +62,19 @@ double g_signalDbmAvgSta[4];
 double g_noiseDbmAvgSta[4];
 uint32_t g_samplesSta[4];
 
+// Measurement window (seconds): samples outside [g_warmUp, g_measureEnd] are discarded
+double g_warmUp = 1.0;
+double g_measureEnd = 0.0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement window
+bool
+InMeasurementWindow()
+{
+    double now = Simulator::Now().GetSeconds();
+    return now >= g_warmUp && now <= g_measureEnd;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Monitor for APs
 void
@@ -72,6 +87,11 @@ MonitorSniffRxCommon(Ptr<const Packet> packet,
                      uint8_t groupIndex,
                      bool isStaVersion)
 {
+    if (!InMeasurementWindow())
+    {
+        return;
+    }
+
     if (isStaVersion)
     {
         g_samplesSta[groupIndex]++;
@@ -595,11 +615,12 @@ VoDServer(ApplicationContainer& vodServerApplications,
 void
 StartStopApplication(ApplicationContainer& clientApplications,
                      ApplicationContainer& serverApplications,
+                     const double appStartTime,
                      const double simulationTime)
 {
-    clientApplications.Start(Seconds(0.0));
+    clientApplications.Start(Seconds(appStartTime));
     clientApplications.Stop(Seconds(simulationTime));
-    serverApplications.Start(Seconds(0.0));
+    serverApplications.Start(Seconds(appStartTime));
     serverApplications.Stop(Seconds(simulationTime));
 }
 
@@ -898,6 +919,8 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Simulation basic parameters
     uint32_t simulationTime = 10; // Simulation duration in seconds
+    double warmUp = 1.0;          // Start of the measurement window (seconds)
+    double measureEnd = 0.0;      // End of the measurement window (seconds, 0: simulationTime)
     uint32_t seedNumber = 1;      // RNG seed
     uint32_t runNumber = 1;       // Run number
 
@@ -969,6 +992,10 @@ main(int argc, char* argv[])
     uint32_t payloadSize =
         1448; // Must fit in the max TX duration when transmitting at MCS 0 over an RU of 26 tones
     uint32_t dataRate = 100000000; // Data Rate (bps)
+    bool staticArp = false;        // Fill ARP caches after addressing (no ARP at start-up)
+    bool preAssociate = false;     // Associate every STA before the applications start
+    double fastStartTime = 0.1;    // Application start time with pre-association (seconds)
+    bool primeBlockAck = false;    // Set up BA agreements before the applications start
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // PARAMETERS FROM COMMAND LINE
@@ -977,6 +1004,13 @@ main(int argc, char* argv[])
 
     // Simulation basic parameters
     cmd.AddValue("simulationTime", "Simulation time (seconds)", simulationTime);
+    cmd.AddValue("warmUp",
+                 "Start of the measurement window (seconds): traffic and samples before it "
+                 "are not accounted",
+                 warmUp);
+    cmd.AddValue("measureEnd",
+                 "End of the measurement window (seconds, 0 for the end of the simulation)",
+                 measureEnd);
     cmd.AddValue("seedNumber", "RNG seed number", seedNumber);
     cmd.AddValue("runNumber", "Simulation run number", runNumber);
 
@@ -1060,9 +1094,35 @@ main(int argc, char* argv[])
                  useExtendedBlockAck);
     cmd.AddValue("payloadSize", "The application payload size in bytes", payloadSize);
     cmd.AddValue("dataRate", "Data rate (bps)", dataRate);
+    cmd.AddValue("staticArp",
+                 "Fast start: pre-populate the ARP caches of every node after address assignment",
+                 staticArp);
+    cmd.AddValue("preAssociate",
+                 "Fast start: immediate active probing association, applications start at "
+                 "fastStartTime",
+                 preAssociate);
+    cmd.AddValue("fastStartTime",
+                 "Application start time (seconds) when preAssociate is enabled",
+                 fastStartTime);
+    cmd.AddValue("primeBlockAck",
+                 "Fast start: establish BA agreements before the applications start "
+                 "(requires preAssociate)",
+                 primeBlockAck);
 
     cmd.Parse(argc, argv);
 
+    // Measurement window: every KPI is computed over [warmUp, measureEnd]
+    if (measureEnd <= 0.0)
+    {
+        measureEnd = simulationTime;
+    }
+    NS_ABORT_MSG_IF(warmUp < 0.0 || warmUp >= measureEnd || measureEnd > simulationTime,
+                    "The measurement window must satisfy 0 <= warmUp < measureEnd <= "
+                    "simulationTime");
+    g_warmUp = warmUp;
+    g_measureEnd = measureEnd;
+    double measureDuration = measureEnd - warmUp;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // ENVIRONMET SETTINGS - FIXING AND ARRANGEMENTS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1072,6 +1132,15 @@ main(int argc, char* argv[])
         Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("0"));
     }
 
+    // Fast start: STAs probe and associate right away instead of waiting for beacons
+    if (preAssociate)
+    {
+        NS_ABORT_MSG_IF(fastStartTime <= 0.0 || fastStartTime >= simulationTime,
+                        "fastStartTime must be within the simulation time");
+        NS_ABORT_MSG_IF(warmUp < fastStartTime, "warmUp must cover the fast start phase");
+        FastStartHelper::ConfigureDefaults();
+    }
+
     // Set + check type of acknowledgment sequence
     if (dlAckSeqType == "ACK-SU-FORMAT")
     {
@@ -1344,6 +1413,16 @@ main(int argc, char* argv[])
                              apDevicesD);
     }
 
+    // Fast start: association tracking
+    Ptr<FastStartHelper> fastStart = CreateObject<FastStartHelper>();
+    if (preAssociate)
+    {
+        fastStart->Install(staDevicesA);
+        fastStart->Install(staDevicesB);
+        fastStart->Install(staDevicesC);
+        fastStart->Install(staDevicesD);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOBILITY
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1532,6 +1611,39 @@ main(int argc, char* argv[])
     staNodeInterfacesD = address.Assign(staDevicesD);
     apNodeInterfacesD = address.Assign(apDevicesD);
 
+    // Fast start: every STA and AP already knows the MAC address of its BSS neighbours,
+    // so applications starting at t=0 do not trigger the ARP resolution storm
+    if (staticArp)
+    {
+        NeighborCacheHelper neighborCache;
+        neighborCache.PopulateNeighborCache(staNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesD);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesD);
+    }
+
+    // Traffic classes: ToS of every class (the wifi UP is the three upper bits of the ToS)
+    uint8_t tosVod = 0xb8;    // UP 5, AC_VI
+    uint8_t tosOthers = 0x00; // UP 0, AC_BE (VoIP, gaming, HTTP and FTP flows)
+
+    // Fast start: one datagram per direction, STA and ToS of the traffic classes sets up the BA
+    // agreements before the applications start (they are otherwise negotiated with measured
+    // traffic)
+    double appStartTime = preAssociate ? fastStartTime : 0.0;
+    if (preAssociate && primeBlockAck)
+    {
+        std::vector<uint8_t> primeTos = {tosVod, tosOthers};
+        Time primeTime = Seconds(0.6 * appStartTime);
+        fastStart->PrimeBlockAck(wifiApNodesA, wifiStaNodesA, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesB, wifiStaNodesB, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesC, wifiStaNodesC, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesD, wifiStaNodesD, primeTos, primeTime);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // APPLICATIONS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1559,7 +1671,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsA, vodClientApplicationsA;
     ApplicationContainer vodServerApplicationsA1, vodClientApplicationsA1;
     uint16_t portUdp = 5050;
-    uint16_t tosValue = 0xb8;
     size_t numStasA = sizeof(selectedStaA) / sizeof(selectedStaA[0]);
 
     VoDServer(vodServerApplicationsA,
@@ -1571,8 +1682,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA, vodServerApplicationsA, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsA,
+                         vodServerApplicationsA,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsA1,
               vodClientApplicationsA1,
@@ -1583,8 +1697,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA1, vodServerApplicationsA1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsA1,
+                         vodServerApplicationsA1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1604,7 +1721,7 @@ main(int argc, char* argv[])
                wifiApNodesA,
                selectedStaA2,
                sizeof(selectedStaA2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsA, httpServerAppsA, simulationTime);
+    StartStopApplication(httpClientAppsA, httpServerAppsA, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1637,7 +1754,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesA,
                                                    &ftpStaInterfacesA);
     ftpHelperA->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1709,8 +1826,8 @@ main(int argc, char* argv[])
              selectedStaA4,
              staSizeA);
 
-    StartStopApplication(gamingClientsStaA, gamingServersApA, simulationTime);
-    StartStopApplication(gamingClientsApA, gamingServersStaA, simulationTime);
+    StartStopApplication(gamingClientsStaA, gamingServersApA, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApA, gamingServersStaA, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -1761,8 +1878,8 @@ main(int argc, char* argv[])
            selectedStaA5,
            sizeof(selectedStaA5) / sizeof(selectedStaA5[0]));
 
-    StartStopApplication(voIPClientsStaA, voIPServersApA, simulationTime);
-    StartStopApplication(voIPClientsApA, voIPServersStaA, simulationTime);
+    StartStopApplication(voIPClientsStaA, voIPServersApA, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApA, voIPServersStaA, appStartTime, simulationTime);
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK B
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1788,7 +1905,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsB, vodClientApplicationsB;
     ApplicationContainer vodServerApplicationsB1, vodClientApplicationsB1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasB = sizeof(selectedStaB) / sizeof(selectedStaB[0]);
 
     VoDServer(vodServerApplicationsB,
@@ -1800,8 +1916,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB, vodServerApplicationsB, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsB,
+                         vodServerApplicationsB,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsB1,
               vodClientApplicationsB1,
@@ -1812,8 +1931,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB1, vodServerApplicationsB1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsB1,
+                         vodServerApplicationsB1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1833,7 +1955,7 @@ main(int argc, char* argv[])
                wifiApNodesB,
                selectedStaB2,
                sizeof(selectedStaB2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsB, httpServerAppsB, simulationTime);
+    StartStopApplication(httpClientAppsB, httpServerAppsB, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1865,7 +1987,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesB,
                                                    &ftpStaInterfacesB);
     ftpHelperB->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1926,8 +2048,8 @@ main(int argc, char* argv[])
              selectedStaB4,
              staSizeB);
 
-    StartStopApplication(gamingClientsStaB, gamingServersApB, simulationTime);
-    StartStopApplication(gamingClientsApB, gamingServersStaB, simulationTime);
+    StartStopApplication(gamingClientsStaB, gamingServersApB, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApB, gamingServersStaB, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -1972,8 +2094,8 @@ main(int argc, char* argv[])
            selectedStaB5,
            sizeof(selectedStaB5) / sizeof(selectedStaB5[0]));
 
-    StartStopApplication(voIPClientsStaB, voIPServersApB, simulationTime);
-    StartStopApplication(voIPClientsApB, voIPServersStaB, simulationTime);
+    StartStopApplication(voIPClientsStaB, voIPServersApB, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApB, voIPServersStaB, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK C
@@ -2000,7 +2122,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsC, vodClientApplicationsC;
     ApplicationContainer vodServerApplicationsC1, vodClientApplicationsC1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasC = sizeof(selectedStaC) / sizeof(selectedStaC[0]);
 
     VoDServer(vodServerApplicationsC,
@@ -2012,8 +2133,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC, vodServerApplicationsC, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsC,
+                         vodServerApplicationsC,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsC1,
               vodClientApplicationsC1,
@@ -2024,8 +2148,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC1, vodServerApplicationsC1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsC1,
+                         vodServerApplicationsC1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2045,7 +2172,7 @@ main(int argc, char* argv[])
                wifiApNodesC,
                selectedStaC2,
                sizeof(selectedStaC2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsC, httpServerAppsC, simulationTime);
+    StartStopApplication(httpClientAppsC, httpServerAppsC, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2077,7 +2204,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesC,
                                                    &ftpStaInterfacesC);
     ftpHelperC->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -2138,8 +2265,8 @@ main(int argc, char* argv[])
              selectedStaC4,
              staSizeC);
 
-    StartStopApplication(gamingClientsStaC, gamingServersApC, simulationTime);
-    StartStopApplication(gamingClientsApC, gamingServersStaC, simulationTime);
+    StartStopApplication(gamingClientsStaC, gamingServersApC, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApC, gamingServersStaC, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2184,8 +2311,8 @@ main(int argc, char* argv[])
            selectedStaC5,
            sizeof(selectedStaC5) / sizeof(selectedStaC5[0]));
 
-    StartStopApplication(voIPClientsStaC, voIPServersApC, simulationTime);
-    StartStopApplication(voIPClientsApC, voIPServersStaC, simulationTime);
+    StartStopApplication(voIPClientsStaC, voIPServersApC, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApC, voIPServersStaC, appStartTime, simulationTime);
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK D
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2211,7 +2338,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsD, vodClientApplicationsD;
     ApplicationContainer vodServerApplicationsD1, vodClientApplicationsD1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasD = sizeof(selectedStaD) / sizeof(selectedStaD[0]);
 
     VoDServer(vodServerApplicationsD,
@@ -2223,8 +2349,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD, vodServerApplicationsD, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsD,
+                         vodServerApplicationsD,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsD1,
               vodClientApplicationsD1,
@@ -2235,8 +2364,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD1, vodServerApplicationsD1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsD1,
+                         vodServerApplicationsD1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2256,7 +2388,7 @@ main(int argc, char* argv[])
                wifiApNodesD,
                selectedStaD2,
                sizeof(selectedStaD2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsD, httpServerAppsD, simulationTime);
+    StartStopApplication(httpClientAppsD, httpServerAppsD, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2288,7 +2420,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesD,
                                                    &ftpStaInterfacesD);
     ftpHelperD->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -2349,8 +2481,8 @@ main(int argc, char* argv[])
              selectedStaD4,
              staSizeD);
 
-    StartStopApplication(gamingClientsStaD, gamingServersApD, simulationTime);
-    StartStopApplication(gamingClientsApD, gamingServersStaD, simulationTime);
+    StartStopApplication(gamingClientsStaD, gamingServersApD, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApD, gamingServersStaD, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2395,8 +2527,8 @@ main(int argc, char* argv[])
            selectedStaD5,
            sizeof(selectedStaD5) / sizeof(selectedStaD5[0]));
 
-    StartStopApplication(voIPClientsStaD, voIPServersApD, simulationTime);
-    StartStopApplication(voIPClientsApD, voIPServersStaD, simulationTime);
+    StartStopApplication(voIPClientsStaD, voIPServersApD, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApD, voIPServersStaD, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MONITORING
@@ -2469,6 +2601,9 @@ main(int argc, char* argv[])
     // FLOW MONITOR
     FlowMonitorHelper flowmonHelper;
     Ptr<FlowMonitor> monitor = flowmonHelper.InstallAll();
+    // Only the packets sent within the measurement window are accounted
+    monitor->Start(Seconds(warmUp));
+    monitor->Stop(Seconds(measureEnd));
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOVEMENT MONITOR
     // Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
@@ -2479,6 +2614,10 @@ main(int argc, char* argv[])
     NS_LOG_INFO("Running simulation...");
     Simulator::Stop(Seconds(simulationTime + 1));
     Simulator::Run();
+    if (preAssociate)
+    {
+        fastStart->Report(Seconds(appStartTime));
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // RESULT CALCULATION
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2558,8 +2697,8 @@ main(int argc, char* argv[])
 
         if (i->second.rxPackets > 0)
         {
-            double rxDuration =
-                i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds();
+            // Same time base for every flow: the measurement window
+            double rxDuration = measureDuration;
 
             delayValues[j] = 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets;
             j++;
@@ -2610,7 +2749,7 @@ main(int argc, char* argv[])
             pos = std::stoi(matchNode[1].str()) + nStaA + nStaB + nStaC + 2 * nAp;
         }
 
-        avgThroughput[pos] += i->second.txBytes * 8.0 / (simulationTime - 1) / 1000.0 / 1000.0;
+        avgThroughput[pos] += i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
         avgDelay[pos] += (i->second.delaySum) / (i->second.rxPackets);
         avgJitter[pos] += (i->second.jitterSum) / (i->second.rxPackets);
         avgtxPackets[pos] += (i->second.txPackets);
@@ -22,6 +22,7 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-module.h"
 #include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/neighbor-cache-helper.h"
 #include "ns3/network-module.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
@@ -36,6 +37,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/wifi-acknowledgment.h"
 #include "ns3/wifi-tx-vector.h"
+#include <ns3/fast-start-helper.h>
 #include <ns3/spectrum-helper.h>
 #include <ns3/three-gpp-ftp-m2-helper.h>
 #include <ns3/traffic-generator-ngmn-gaming.h>
@@ -60,6 +62,19 @@ double g_signalDbmAvgSta[3];
 double g_noiseDbmAvgSta[3];
 uint32_t g_samplesSta[3];
 
+// Measurement window (seconds): samples outside [g_warmUp, g_measureEnd] are discarded
+double g_warmUp = 1.0;
+double g_measureEnd = 0.0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement window
+bool
+InMeasurementWindow()
+{
+    double now = Simulator::Now().GetSeconds();
+    return now >= g_warmUp && now <= g_measureEnd;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Monitor for APs
 void
@@ -72,6 +87,11 @@ MonitorSniffRxCommon(Ptr<const Packet> packet,
                      uint8_t groupIndex,
                      bool isStaVersion)
 {
+    if (!InMeasurementWindow())
+    {
+        return;
+    }
+
     if (isStaVersion)
     {
         g_samplesSta[groupIndex]++;
@@ -566,11 +586,12 @@ VoDServer(ApplicationContainer& vodServerApplications,
 void
 StartStopApplication(ApplicationContainer& clientApplications,
                      ApplicationContainer& serverApplications,
+                     const double appStartTime,
                      const double simulationTime)
 {
-    clientApplications.Start(Seconds(0.0));
+    clientApplications.Start(Seconds(appStartTime));
     clientApplications.Stop(Seconds(simulationTime + 0));
-    serverApplications.Start(Seconds(0.0));
+    serverApplications.Start(Seconds(appStartTime));
     serverApplications.Stop(Seconds(simulationTime + 0));
 }
 
@@ -830,6 +851,8 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Simulation basic parameters
     uint32_t simulationTime = 10; // Simulation duration in seconds
+    double warmUp = 1.0;          // Start of the measurement window (seconds)
+    double measureEnd = 0.0;      // End of the measurement window (seconds, 0: simulationTime)
     uint32_t seedNumber = 1;      // RNG seed
     uint32_t runNumber = 1;       // Run number
 
@@ -897,6 +920,10 @@ main(int argc, char* argv[])
     uint32_t payloadSize =
         1448; // Must fit in the max TX duration when transmitting at MCS 0 over an RU of 26 tones
     uint32_t dataRate = 100000000; // Data Rate (bps)
+    bool staticArp = false;        // Fill ARP caches after addressing (no ARP at start-up)
+    bool preAssociate = false;     // Associate every STA before the applications start
+    double fastStartTime = 0.1;    // Application start time with pre-association (seconds)
+    bool primeBlockAck = false;    // Set up BA agreements before the applications start
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // PARAMETERS FROM COMMAND LINE
@@ -905,6 +932,13 @@ main(int argc, char* argv[])
 
     // Simulation basic parameters
     cmd.AddValue("simulationTime", "Simulation time (seconds)", simulationTime);
+    cmd.AddValue("warmUp",
+                 "Start of the measurement window (seconds): traffic and samples before it "
+                 "are not accounted",
+                 warmUp);
+    cmd.AddValue("measureEnd",
+                 "End of the measurement window (seconds, 0 for the end of the simulation)",
+                 measureEnd);
     cmd.AddValue("seedNumber", "RNG seed number", seedNumber);
     cmd.AddValue("runNumber", "Simulation run number", runNumber);
 
@@ -977,9 +1011,35 @@ main(int argc, char* argv[])
                  useExtendedBlockAck);
     cmd.AddValue("payloadSize", "The application payload size in bytes", payloadSize);
     cmd.AddValue("dataRate", "Data rate (bps)", dataRate);
+    cmd.AddValue("staticArp",
+                 "Fast start: pre-populate the ARP caches of every node after address assignment",
+                 staticArp);
+    cmd.AddValue("preAssociate",
+                 "Fast start: immediate active probing association, applications start at "
+                 "fastStartTime",
+                 preAssociate);
+    cmd.AddValue("fastStartTime",
+                 "Application start time (seconds) when preAssociate is enabled",
+                 fastStartTime);
+    cmd.AddValue("primeBlockAck",
+                 "Fast start: establish BA agreements before the applications start "
+                 "(requires preAssociate)",
+                 primeBlockAck);
 
     cmd.Parse(argc, argv);
 
+    // Measurement window: every KPI is computed over [warmUp, measureEnd]
+    if (measureEnd <= 0.0)
+    {
+        measureEnd = simulationTime;
+    }
+    NS_ABORT_MSG_IF(warmUp < 0.0 || warmUp >= measureEnd || measureEnd > simulationTime,
+                    "The measurement window must satisfy 0 <= warmUp < measureEnd <= "
+                    "simulationTime");
+    g_warmUp = warmUp;
+    g_measureEnd = measureEnd;
+    double measureDuration = measureEnd - warmUp;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // ENVIRONMET SETTINGS - FIXING AND ARRANGEMENTS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -989,6 +1049,15 @@ main(int argc, char* argv[])
         Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("0"));
     }
 
+    // Fast start: STAs probe and associate right away instead of waiting for beacons
+    if (preAssociate)
+    {
+        NS_ABORT_MSG_IF(fastStartTime <= 0.0 || fastStartTime >= simulationTime,
+                        "fastStartTime must be within the simulation time");
+        NS_ABORT_MSG_IF(warmUp < fastStartTime, "warmUp must cover the fast start phase");
+        FastStartHelper::ConfigureDefaults();
+    }
+
     // Set + check type of acknowledgment sequence
     if (dlAckSeqType == "ACK-SU-FORMAT")
     {
@@ -1210,6 +1279,15 @@ main(int argc, char* argv[])
                              apDevicesC);
     }
 
+    // Fast start: association tracking
+    Ptr<FastStartHelper> fastStart = CreateObject<FastStartHelper>();
+    if (preAssociate)
+    {
+        fastStart->Install(staDevicesA);
+        fastStart->Install(staDevicesB);
+        fastStart->Install(staDevicesC);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOBILITY
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1333,6 +1411,36 @@ main(int argc, char* argv[])
     staNodeInterfacesC = address.Assign(staDevicesC);
     apNodeInterfacesC = address.Assign(apDevicesC);
 
+    // Fast start: every STA and AP already knows the MAC address of its BSS neighbours,
+    // so applications starting at t=0 do not trigger the ARP resolution storm
+    if (staticArp)
+    {
+        NeighborCacheHelper neighborCache;
+        neighborCache.PopulateNeighborCache(staNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesC);
+    }
+
+    // Traffic classes: ToS of every class (the wifi UP is the three upper bits of the ToS)
+    uint8_t tosVod = 0xb8;    // UP 5, AC_VI
+    uint8_t tosOthers = 0x00; // UP 0, AC_BE (VoIP, gaming, HTTP and FTP flows)
+
+    // Fast start: one datagram per direction, STA and ToS of the traffic classes sets up the BA
+    // agreements before the applications start (they are otherwise negotiated with measured
+    // traffic)
+    double appStartTime = preAssociate ? fastStartTime : 0.0;
+    if (preAssociate && primeBlockAck)
+    {
+        std::vector<uint8_t> primeTos = {tosVod, tosOthers};
+        Time primeTime = Seconds(0.6 * appStartTime);
+        fastStart->PrimeBlockAck(wifiApNodesA, wifiStaNodesA, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesB, wifiStaNodesB, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesC, wifiStaNodesC, primeTos, primeTime);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // APPLICATIONS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1353,7 +1461,6 @@ main(int argc, char* argv[])
     // 1.2. VoD Flow
     ApplicationContainer vodServerApplicationsA, vodClientApplicationsA;
     uint16_t portUdp = 5050;
-    uint16_t tosValue = 0xb8;
     size_t numStasA = sizeof(selectedStaA) / sizeof(selectedStaA[0]);
 
     VoDServer(vodServerApplicationsA,
@@ -1365,8 +1472,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA, vodServerApplicationsA, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsA,
+                         vodServerApplicationsA,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1386,7 +1496,7 @@ main(int argc, char* argv[])
                wifiApNodesA,
                selectedStaA2,
                sizeof(selectedStaA2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsA, httpServerAppsA, simulationTime);
+    StartStopApplication(httpClientAppsA, httpServerAppsA, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1419,7 +1529,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesA,
                                                    &ftpStaInterfacesA);
     ftpHelperA->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1478,8 +1588,8 @@ main(int argc, char* argv[])
            selectedStaA4,
            sizeof(selectedStaA4) / sizeof(selectedStaA4[0]));
 
-    StartStopApplication(voIPClientsStaA, voIPServersApA, simulationTime);
-    StartStopApplication(voIPClientsApA, voIPServersStaA, simulationTime);
+    StartStopApplication(voIPClientsStaA, voIPServersApA, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApA, voIPServersStaA, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK B
@@ -1499,7 +1609,6 @@ main(int argc, char* argv[])
     // 1.2. VoD Flow
     ApplicationContainer vodServerApplicationsB, vodClientApplicationsB;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasB = sizeof(selectedStaB) / sizeof(selectedStaB[0]);
 
     VoDServer(vodServerApplicationsB,
@@ -1511,8 +1620,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB, vodServerApplicationsB, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsB,
+                         vodServerApplicationsB,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1532,7 +1644,7 @@ main(int argc, char* argv[])
                wifiApNodesB,
                selectedStaB2,
                sizeof(selectedStaB2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsB, httpServerAppsB, simulationTime);
+    StartStopApplication(httpClientAppsB, httpServerAppsB, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1564,7 +1676,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesB,
                                                    &ftpStaInterfacesB);
     ftpHelperB->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1616,8 +1728,8 @@ main(int argc, char* argv[])
            selectedStaB4,
            sizeof(selectedStaB4) / sizeof(selectedStaB4[0]));
 
-    StartStopApplication(voIPClientsStaB, voIPServersApB, simulationTime);
-    StartStopApplication(voIPClientsApB, voIPServersStaB, simulationTime);
+    StartStopApplication(voIPClientsStaB, voIPServersApB, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApB, voIPServersStaB, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK C
@@ -1637,7 +1749,6 @@ main(int argc, char* argv[])
     // 1.2. VoD Flow
     ApplicationContainer vodServerApplicationsC, vodClientApplicationsC;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasC = sizeof(selectedStaC) / sizeof(selectedStaC[0]);
 
     VoDServer(vodServerApplicationsC,
@@ -1649,8 +1760,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC, vodServerApplicationsC, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsC,
+                         vodServerApplicationsC,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1670,7 +1784,7 @@ main(int argc, char* argv[])
                wifiApNodesC,
                selectedStaC2,
                sizeof(selectedStaC2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsC, httpServerAppsC, simulationTime);
+    StartStopApplication(httpClientAppsC, httpServerAppsC, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1702,7 +1816,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesC,
                                                    &ftpStaInterfacesC);
     ftpHelperC->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1753,8 +1867,8 @@ main(int argc, char* argv[])
            selectedStaC4,
            sizeof(selectedStaC4) / sizeof(selectedStaC4[0]));
 
-    StartStopApplication(voIPClientsStaC, voIPServersApC, simulationTime);
-    StartStopApplication(voIPClientsApC, voIPServersStaC, simulationTime);
+    StartStopApplication(voIPClientsStaC, voIPServersApC, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApC, voIPServersStaC, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MONITORING
@@ -1810,6 +1924,9 @@ main(int argc, char* argv[])
     // FLOW MONITOR
     FlowMonitorHelper flowmonHelper;
     Ptr<FlowMonitor> monitor = flowmonHelper.InstallAll();
+    // Only the packets sent within the measurement window are accounted
+    monitor->Start(Seconds(warmUp));
+    monitor->Stop(Seconds(measureEnd));
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOVEMENT MONITOR
     // Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
@@ -1820,6 +1937,10 @@ main(int argc, char* argv[])
     NS_LOG_INFO("Running simulation...");
     Simulator::Stop(Seconds(simulationTime + 1));
     Simulator::Run();
+    if (preAssociate)
+    {
+        fastStart->Report(Seconds(appStartTime));
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // RESULT CALCULATION
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1909,8 +2030,8 @@ main(int argc, char* argv[])
 
         if (i->second.rxPackets > 0)
         {
-            double rxDuration =
-                i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds();
+            // Same time base for every flow: the measurement window
+            double rxDuration = measureDuration;
 
             averageFlowThroughput += i->second.rxBytes * 8.0 / rxDuration / 1000 / 1000;
             averageFlowDelay += 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets;
@@ -1959,7 +2080,7 @@ main(int argc, char* argv[])
             pos = std::stoi(matchNode[1].str()) + nStaA + nStaB + nAp;
         }
 
-        avgThroughput[pos] += i->second.txBytes * 8.0 / (simulationTime - 1) / 1000.0 / 1000.0;
+        avgThroughput[pos] += i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
         avgDelay[pos] += (i->second.delaySum);
         avgJitter[pos] += (i->second.jitterSum);
         avgtxPackets[pos] += (i->second.txPackets);
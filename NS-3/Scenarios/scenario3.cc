@@ -6,6 +6,7 @@
 
 #include "ns3/applications-module.h"
 #include "ns3/boolean.h"
+#include "ns3/bridge-helper.h"
 #include "ns3/command-line.h"
 #include "ns3/config.h"
 #include "ns3/core-module.h"
@@ -22,27 +23,59 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-module.h"
 #include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/neighbor-cache-helper.h"
 #include "ns3/network-module.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/qos-txop.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/simulator.h"
 #include "ns3/spectrum-wifi-helper.h"
 #include "ns3/ssid.h"
 #include "ns3/stats-module.h"
 #include "ns3/string.h"
+#include "ns3/table-based-error-rate-model.h"
 #include "ns3/udp-client-server-helper.h"
 #include "ns3/uinteger.h"
 #include "ns3/wifi-acknowledgment.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-net-device.h"
 #include "ns3/wifi-tx-vector.h"
+#include "ns3/yans-wifi-helper.h"
+#include <ns3/adaptive-obss-pd-algorithm.h>
+#include <ns3/airtime-accountant.h>
+#include <ns3/ampdu-stats.h>
+#include <ns3/channel-planner.h>
+#include <ns3/fast-start-helper.h>
+#include <ns3/mac-queue-stats.h>
+#include <ns3/mcs-histogram.h>
+#include <ns3/mlo-link-stats.h>
+#include <ns3/online-cluster-controller.h>
+#include <ns3/packet-pool.h>
+#include <ns3/pooled-on-off-helper.h>
+#include <ns3/power-control-manager.h>
+#include <ns3/qos-multi-user-scheduler.h>
+#include <ns3/radio-map-propagation-loss-model.h>
+#include <ns3/roaming-manager.h>
+#include <ns3/scenario-checkpoint.h>
+#include <ns3/sinr-per-table-error-rate-model.h>
+#include <ns3/snr-table-wifi-manager.h>
 #include <ns3/spectrum-helper.h>
 #include <ns3/three-gpp-ftp-m2-helper.h>
 #include <ns3/traffic-generator-ngmn-gaming.h>
 #include <ns3/traffic-generator-ngmn-video.h>
 #include <ns3/traffic-generator-ngmn-voip.h>
+#include <ns3/trajectory-mobility-model.h>
+#include <ns3/trajectory-trace.h>
 
+#include <cctype>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <regex>
 
 using namespace ns3;
@@ -60,6 +93,25 @@ double g_signalDbmAvgSta[5];
 double g_noiseDbmAvgSta[5];
 uint32_t g_samplesSta[5];
 
+// Measurement window (seconds): samples outside [g_warmUp, g_measureEnd] are discarded
+double g_warmUp = 1.0;
+double g_measureEnd = 0.0;
+
+// VoD payloads sent by the OnOff sources (one payload allocation each without packet pool)
+uint64_t g_vodTxPackets = 0;
+
+// OBSS PD threshold updates of the adaptive algorithm
+std::ofstream g_obssPdCsv;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement window
+bool
+InMeasurementWindow()
+{
+    double now = Simulator::Now().GetSeconds();
+    return now >= g_warmUp && now <= g_measureEnd;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Monitor for APs
 void
@@ -72,6 +124,11 @@ MonitorSniffRxCommon(Ptr<const Packet> packet,
                      uint8_t groupIndex,
                      bool isStaVersion)
 {
+    if (!InMeasurementWindow())
+    {
+        return;
+    }
+
     if (isStaVersion)
     {
         g_samplesSta[groupIndex]++;
@@ -200,6 +257,292 @@ MonitorSniffRxESta(Ptr<const Packet> packet,
     MonitorSniffRxCommon(packet, channelFreqMhz, txVector, aMpdu, signalNoise, staId, 4, true);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Adaptive OBSS PD threshold trace
+void
+ObssPdThresholdTrace(std::string device, double obssPdLevel, double obssRssi, double per)
+{
+    // seed, run, BSS, node, time, threshold (dBm), OBSS RSSI (dBm), PER
+    g_obssPdCsv << device << "," << Simulator::Now().GetSeconds() << "," << obssPdLevel << ","
+                << obssRssi << "," << per << "\n";
+}
+
+void
+ConnectObssPdTrace(uint32_t seedNumber,
+                   uint32_t runNumber,
+                   std::string bss,
+                   const NetDeviceContainer& devices)
+{
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        Ptr<AdaptiveObssPdAlgorithm> obssPd = devices.Get(i)->GetObject<AdaptiveObssPdAlgorithm>();
+        NS_ASSERT(obssPd);
+        std::ostringstream device;
+        device << seedNumber << "," << runNumber << "," << bss << ","
+               << devices.Get(i)->GetNode()->GetId();
+        obssPd->TraceConnectWithoutContext("Threshold",
+                                           MakeBoundCallback(&ObssPdThresholdTrace, device.str()));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Latency budget of the STAs selected for a delay-sensitive flow (Qos OFDMA scheduler)
+void
+SetStaLatencyBudget(const NetDeviceContainer& apDevices,
+                    const NetDeviceContainer& staDevices,
+                    uint32_t* selectedSta,
+                    size_t staSize,
+                    Time budget)
+{
+    if (apDevices.GetN() == 0)
+    {
+        return;
+    }
+    Ptr<WifiNetDevice> apDevice = DynamicCast<WifiNetDevice>(apDevices.Get(0));
+    Ptr<QosMultiUserScheduler> scheduler = apDevice->GetMac()->GetObject<QosMultiUserScheduler>();
+    NS_ASSERT(scheduler);
+    for (size_t i = 0; i < staSize; ++i)
+    {
+        Ptr<WifiNetDevice> staDevice = DynamicCast<WifiNetDevice>(staDevices.Get(selectedSta[i]));
+        scheduler->SetLatencyBudget(staDevice->GetMac()->GetAddress(), budget);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// EDCA parameters per BSS and AC: entries "BSS:AC:key=value,..." separated by ';', where BSS
+// is A-E or * (every BSS), AC is VO, VI, BE or BK and the keys are cwMin, cwMax, aifsn and txop
+// (TXOP limit in microseconds, multiple of 32)
+void
+ApplyEdcaConfig(std::string edcaConfig, std::string bss, const NetDeviceContainer& devices)
+{
+    const std::map<std::string, AcIndex> acs = {{"VO", AC_VO},
+                                                {"VI", AC_VI},
+                                                {"BE", AC_BE},
+                                                {"BK", AC_BK}};
+    std::istringstream entries(edcaConfig);
+    for (std::string entry; std::getline(entries, entry, ';');)
+    {
+        std::size_t first = entry.find(':');
+        std::size_t second = entry.find(':', first + 1);
+        NS_ABORT_MSG_IF(first == std::string::npos || second == std::string::npos,
+                        "Invalid edcaConfig entry (BSS:AC:key=value,...): " << entry);
+        std::string entryBss = entry.substr(0, first);
+        std::string entryAc = entry.substr(first + 1, second - first - 1);
+        NS_ABORT_MSG_IF(entryBss != "*" && (entryBss.size() != 1 || entryBss < "A" ||
+                                            entryBss > "E"),
+                        "Invalid BSS in edcaConfig (A-E or *): " << entryBss);
+        NS_ABORT_MSG_IF(acs.count(entryAc) == 0,
+                        "Invalid AC in edcaConfig (VO, VI, BE or BK): " << entryAc);
+        if (entryBss != "*" && entryBss != bss)
+        {
+            continue;
+        }
+
+        std::istringstream parameters(entry.substr(second + 1));
+        for (std::string parameter; std::getline(parameters, parameter, ',');)
+        {
+            std::size_t equal = parameter.find('=');
+            NS_ABORT_MSG_IF(equal == std::string::npos,
+                            "Invalid edcaConfig parameter (key=value): " << parameter);
+            std::string key = parameter.substr(0, equal);
+            // Unsigned decimal value: std::stoul would also take signs, spaces and trailing text
+            std::string text = parameter.substr(equal + 1);
+            std::size_t pos = 0;
+            unsigned long number = 0;
+            try
+            {
+                number = std::stoul(text, &pos);
+            }
+            catch (const std::exception&)
+            {
+                pos = 0;
+            }
+            NS_ABORT_MSG_IF(pos == 0 || pos != text.size() ||
+                                !std::isdigit(static_cast<unsigned char>(text.front())) ||
+                                number > std::numeric_limits<uint32_t>::max(),
+                            "Invalid edcaConfig value (unsigned integer): " << parameter);
+            auto value = static_cast<uint32_t>(number);
+            for (uint32_t i = 0; i < devices.GetN(); i++)
+            {
+                Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(devices.Get(i));
+                Ptr<QosTxop> txop = device->GetMac()->GetQosTxop(acs.at(entryAc));
+                if (key == "cwMin")
+                {
+                    txop->SetMinCw(value);
+                }
+                else if (key == "cwMax")
+                {
+                    txop->SetMaxCw(value);
+                }
+                else if (key == "aifsn")
+                {
+                    NS_ABORT_MSG_IF(value < 1 || value > 15, "aifsn must be within 1 and 15");
+                    txop->SetAifsn(value);
+                }
+                else if (key == "txop")
+                {
+                    NS_ABORT_MSG_IF(value % 32 != 0, "txop must be a multiple of 32 us");
+                    txop->SetTxopLimit(MicroSeconds(value));
+                }
+                else
+                {
+                    NS_ABORT_MSG("Invalid edcaConfig key (cwMin, cwMax, aifsn or txop): " << key);
+                }
+            }
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// TID-to-link mapping of the MLDs ("tid,tid link,link; ..." as in the EHT configuration) from
+// the links of the traffic classes, e.g. "VoIP=5,Gaming=5,VoD=6,FTP=5+6", where 5 is the 5 GHz
+// link (0) and 6 the 6 GHz link (1). The TIDs are the UPs of the traffic class ToS values; the
+// classes that are not listed stay on both links
+std::string
+GetTidToLinkMapping(std::string mloLinkMap)
+{
+    const std::map<std::string, uint8_t> classTids = {{"VoIP", 6},
+                                                      {"Gaming", 7},
+                                                      {"VoD", 5},
+                                                      {"HTTP", 3},
+                                                      {"FTP", 1}};
+    const std::map<std::string, std::string> bandLinks = {{"5", "0"}, {"6", "1"}, {"5+6", "0,1"}};
+    std::map<std::string, std::string> linkTids; // Link set -> TIDs
+    std::istringstream entries(mloLinkMap);
+    for (std::string entry; std::getline(entries, entry, ',');)
+    {
+        std::size_t equal = entry.find('=');
+        NS_ABORT_MSG_IF(equal == std::string::npos,
+                        "Invalid mloLinkMap entry (class=band): " << entry);
+        std::string trafficClass = entry.substr(0, equal);
+        std::string bands = entry.substr(equal + 1);
+        NS_ABORT_MSG_IF(classTids.count(trafficClass) == 0,
+                        "Invalid traffic class in mloLinkMap (VoIP, Gaming, VoD, HTTP or FTP): "
+                            << trafficClass);
+        NS_ABORT_MSG_IF(bandLinks.count(bands) == 0,
+                        "Invalid links in mloLinkMap (5, 6 or 5+6): " << bands);
+        std::string& tids = linkTids[bandLinks.at(bands)];
+        tids += (tids.empty() ? "" : ",") + std::to_string(classTids.at(trafficClass));
+    }
+
+    std::string mapping;
+    for (const auto& [links, tids] : linkTids)
+    {
+        mapping += (mapping.empty() ? "" : "; ") + tids + " " + links;
+    }
+    return mapping;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Traffic class of a flow from one of its ports: VoD from 5050 (one port per STA), FTP from
+// 5150, gaming and VoIP from 5250 and 5350 (UL, DL on +50) and HTTP on 80
+std::string
+GetTrafficClass(uint16_t port)
+{
+    if (port == 80)
+    {
+        return "HTTP";
+    }
+    if (port >= 5050 && port < 5150)
+    {
+        return "VoD";
+    }
+    if (port >= 5150 && port < 5250)
+    {
+        return "FTP";
+    }
+    if (port >= 5250 && port < 5350)
+    {
+        return "Gaming";
+    }
+    if (port >= 5350 && port < 5450)
+    {
+        return "VoIP";
+    }
+    return "Other";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Direction of a gaming or VoIP flow from its port: UL on the port of the class, DL on +50
+std::string
+GetTrafficDirection(uint16_t port)
+{
+    if ((port >= 5250 && port < 5300) || (port >= 5350 && port < 5400))
+    {
+        return "UL";
+    }
+    if ((port >= 5300 && port < 5350) || (port >= 5400 && port < 5450))
+    {
+        return "DL";
+    }
+    return "-";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Delay percentiles per traffic class (and direction, for gaming and VoIP), from the delay
+// histograms of the flow monitor
+void
+WriteClassDelayPercentiles(const FlowMonitor::FlowStatsContainer& stats,
+                           Ptr<Ipv4FlowClassifier> classifier,
+                           std::string filename,
+                           uint32_t seedNumber,
+                           uint32_t runNumber,
+                           std::string scheduler)
+{
+    std::map<std::pair<std::string, std::string>, std::map<uint32_t, uint64_t>> classBins;
+    double binWidth = 0;
+    for (const auto& [flowId, flowStats] : stats)
+    {
+        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
+        uint16_t port = t.sourcePort;
+        if (GetTrafficClass(port) == "Other")
+        {
+            port = t.destinationPort;
+        }
+        std::pair<std::string, std::string> key = {GetTrafficClass(port),
+                                                   GetTrafficDirection(port)};
+        const Histogram& histogram = flowStats.delayHistogram;
+        for (uint32_t bin = 0; bin < histogram.GetNBins(); bin++)
+        {
+            if (histogram.GetBinCount(bin) > 0)
+            {
+                classBins[key][bin] += histogram.GetBinCount(bin);
+                binWidth = histogram.GetBinWidth(bin);
+            }
+        }
+    }
+
+    std::ofstream file(filename, std::ios::app);
+    NS_ABORT_MSG_IF(!file.is_open(), "Can not open " << filename);
+    // seed, run, scheduler, class, direction, packets, p50 (ms), p90 (ms), p99 (ms)
+    for (const auto& [key, bins] : classBins)
+    {
+        uint64_t packets = 0;
+        for (const auto& [bin, count] : bins)
+        {
+            packets += count;
+        }
+        file << seedNumber << "," << runNumber << "," << scheduler << "," << key.first << ","
+             << key.second << "," << packets;
+        for (double percentile : {0.5, 0.9, 0.99})
+        {
+            uint64_t accumulated = 0;
+            uint32_t percentileBin = 0;
+            for (const auto& [bin, count] : bins)
+            {
+                accumulated += count;
+                percentileBin = bin;
+                if (accumulated >= percentile * packets)
+                {
+                    break;
+                }
+            }
+            file << "," << 1000 * binWidth * (percentileBin + 1); // upper edge of the bin
+        }
+        file << "\n";
+    }
+}
+
 void
 CreateNodesUniform(NodeContainer& wifiStaNodes,
                    NodeContainer& wifiApNodes,
@@ -223,13 +566,14 @@ CreateNodesNormal(NodeContainer& wifiStaNodes,
                   const uint32_t nAp,
                   const std::string& label,
                   const double mean,
-                  const double variance)
+                  const double variance,
+                  Ptr<ScenarioCheckpoint> checkpoint)
 {
     Ptr<NormalRandomVariable> n = CreateObject<NormalRandomVariable>();
     n->SetAttribute("Mean", DoubleValue(mean));
     n->SetAttribute("Variance", DoubleValue(variance));
 
-    double value = n->GetValue();
+    double value = checkpoint->Replay("nSta" + label, n->GetValue());
     nSta = static_cast<uint32_t>(std::max(1.0, value)); // Ensure at least 1 STA
 
     wifiStaNodes.Create(nSta);
@@ -336,6 +680,75 @@ setChannelInfo(int nNetwork, double frequency, int channelWidth, std::string& ch
     }
 }
 
+Ptr<PropagationLossModel>
+CreateLossModel(double frequency)
+{
+    double lossScenario = 40.05 + 20 * log10(frequency / 2.4);
+    Ptr<ThreeLogDistancePropagationLossModel> lossModel =
+        CreateObject<ThreeLogDistancePropagationLossModel>();
+    lossModel->SetAttribute("ReferenceLoss", DoubleValue(lossScenario));
+    lossModel->SetAttribute("Distance0", DoubleValue(1));
+    lossModel->SetAttribute("Exponent0", DoubleValue(2));
+    lossModel->SetAttribute("Distance1", DoubleValue(10));
+    lossModel->SetAttribute("Exponent1", DoubleValue(3.5));
+    return lossModel;
+}
+
+// Radio map: the loss is looked up in the map instead of computed by the analytic model
+Ptr<SpectrumChannel>
+CreateSpectrumChannel(double frequency, Ptr<PropagationLossModel> radioMap = nullptr)
+{
+    SpectrumChannelHelper channelHelper;
+    channelHelper.SetChannel("ns3::MultiModelSpectrumChannel");
+    channelHelper.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+    channelHelper.AddPropagationLoss(radioMap ? radioMap : CreateLossModel(frequency));
+    return channelHelper.Create();
+}
+
+// Abstract PHY: Yans channel (no power spectral densities), same propagation as the spectrum one
+Ptr<YansWifiChannel>
+CreateAbstractChannel(double frequency, Ptr<PropagationLossModel> radioMap = nullptr)
+{
+    Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel>();
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+    channel->SetPropagationLossModel(radioMap ? radioMap : CreateLossModel(frequency));
+    return channel;
+}
+
+// ESS: every AP bridges its wifi device with its port of the wired backbone
+NetDeviceContainer
+BridgeApDevices(const NetDeviceContainer& apDevices,
+                const NetDeviceContainer& backboneDevices,
+                uint32_t& backboneIndex)
+{
+    BridgeHelper bridge;
+    NetDeviceContainer bridgeDevices;
+    for (uint32_t i = 0; i < apDevices.GetN(); i++)
+    {
+        NetDeviceContainer ports(apDevices.Get(i));
+        ports.Add(backboneDevices.Get(backboneIndex++));
+        bridgeDevices.Add(bridge.Install(apDevices.Get(i)->GetNode(), ports));
+    }
+    return bridgeDevices;
+}
+
+// Addressing of a BSS: subnet 192.168.<index>.0/24, or the same addresses within one /16 subnet
+// for every BSS of an ESS
+void
+SetBssAddressBase(Ipv4AddressHelper& address, uint32_t index, bool ess)
+{
+    std::string network = "192.168." + std::to_string(index) + ".0";
+    std::string base = "0.0." + std::to_string(index) + ".1";
+    if (ess)
+    {
+        address.SetBase("192.168.0.0", "255.255.0.0", Ipv4Address(base.c_str()));
+    }
+    else
+    {
+        address.SetBase(Ipv4Address(network.c_str()), "255.255.255.0");
+    }
+}
+
 void
 ConfigureWifiNetwork(uint32_t seedNumber,
                      uint32_t runNumber,
@@ -343,9 +756,13 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                      WifiHelper wifi,
                      WifiMacHelper mac,
                      double frequency,
+                     bool mlo,
                      int mcs,
+                     std::string rateControl,
                      uint32_t channelWidth,
                      uint32_t gi,
+                     std::string phyModel,
+                     std::string phyTable,
                      uint32_t nAntennasAp,
                      uint32_t nAntennasSta,
                      uint32_t ntxSpatialStreamsAp,
@@ -361,49 +778,91 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                      uint32_t nTxPowerLevelsAp,
                      double ccaEdTrAp,
                      std::string dlAckSeqType,
+                     std::string muScheduler,
                      bool enableUlOfdma,
                      bool useExtendedBlockAck,
+                     uint32_t maxAmpduSize,
+                     bool bssColoring,
                      bool enableBsrp,
                      Time accessReqInterval,
                      Ssid ssid,
-                     uint32_t staGroupIndex,
+                     uint32_t channelIndex,
+                     uint32_t bssIndex,
+                     Ptr<SpectrumChannel> spectrumChannel,
+                     Ptr<SpectrumChannel> mloSpectrumChannel,
+                     Ptr<YansWifiChannel> abstractChannel,
+                     Ptr<PropagationLossModel> radioMap,
                      NodeContainer wifiStaNodes,
                      NodeContainer wifiApNodes,
                      NetDeviceContainer& staDevices,
                      NetDeviceContainer& apDevices)
 {
     // Network configuration: ssid, frequency (band, channel size and number)...
-    SpectrumChannelHelper channelHelper;
     std::string channelStr("");
-    setChannelInfo(staGroupIndex, frequency, channelWidth, channelStr);
+    setChannelInfo(channelIndex, frequency, channelWidth, channelStr);
+    NS_ABORT_MSG_IF(channelStr.empty(), "No channel for the frequency and channel width");
 
     std::cout << "SSID: " << ssid << std::endl;
     std::cout << "Channel Info: " << channelStr << std::endl;
 
-    // Propagation
-    channelHelper.SetChannel("ns3::MultiModelSpectrumChannel");
-    channelHelper.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-    double lossScenario = 40.05 + 20 * log10(frequency / 2.4);
-    channelHelper.AddPropagationLoss("ns3::ThreeLogDistancePropagationLossModel",
-                                     "ReferenceLoss",
-                                     DoubleValue(lossScenario),
-                                     "Distance0",
-                                     DoubleValue(1),
-                                     "Exponent0",
-                                     DoubleValue(2),
-                                     "Distance1",
-                                     DoubleValue(10),
-                                     "Exponent1",
-                                     DoubleValue(3.5));
+    // Propagation: a channel of its own for the BSS, unless the spectrum is shared
+    if (phyModel == "Abstract" && !abstractChannel)
+    {
+        abstractChannel = CreateAbstractChannel(frequency, radioMap);
+    }
+    else if (phyModel != "Abstract" && !spectrumChannel)
+    {
+        spectrumChannel = CreateSpectrumChannel(frequency, radioMap);
+    }
+
+    // Multi-link operation: second affiliated link on 6 GHz, one channel per BSS (the first
+    // link stays co-channel)
+    std::string mloChannelStr("");
+    if (mlo)
+    {
+        setChannelInfo(bssIndex + 1, 6, channelWidth, mloChannelStr);
+        NS_ABORT_MSG_IF(mloChannelStr.empty(), "No 6 GHz channel for the MLO link of the BSS");
+        std::cout << "MLO Channel Info: " << mloChannelStr << std::endl;
+        if (!mloSpectrumChannel)
+        {
+            mloSpectrumChannel = CreateSpectrumChannel(6);
+        }
+    }
 
     // Station state and data/control traffic generation management
-    std::ostringstream oss;
-    oss << "HeMcs" << mcs;
-    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                                 "DataMode",
-                                 StringValue(oss.str()),
-                                 "ControlMode",
-                                 StringValue(oss.str()));
+    std::cout << "Rate Control: " << rateControl << std::endl;
+    if (rateControl == "Constant")
+    {
+        NS_ABORT_MSG_IF(mcs < 0 || mcs > 11, "The Constant rate control needs an MCS (0-11)");
+        std::ostringstream oss;
+        oss << "HeMcs" << mcs;
+        wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                     "DataMode",
+                                     StringValue(oss.str()),
+                                     "ControlMode",
+                                     StringValue(oss.str()));
+    }
+    else if (rateControl == "Ideal")
+    {
+        wifi.SetRemoteStationManager("ns3::IdealWifiManager");
+    }
+    else if (rateControl == "MinstrelHt")
+    {
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+    }
+    else if (rateControl == "ThompsonSampling")
+    {
+        wifi.SetRemoteStationManager("ns3::ThompsonSamplingWifiManager");
+    }
+    else if (rateControl == "SnrTable")
+    {
+        wifi.SetRemoteStationManager("ns3::SnrTableWifiManager");
+    }
+    else
+    {
+        NS_ABORT_MSG("Invalid rate control (must be Constant, Ideal, MinstrelHt, "
+                     "ThompsonSampling or SnrTable)");
+    }
 
     // Set guard interval and MPDU buffer size
     wifi.ConfigHeOptions("GuardInterval",
@@ -411,13 +870,35 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                          "MpduBufferSize",
                          UintegerValue(useExtendedBlockAck ? 256 : 64),
                          "BssColor",
-                         UintegerValue(1));
-
-    // GENERAL - PHY
-    SpectrumWifiPhyHelper phy;
+                         UintegerValue(bssColoring ? bssIndex + 1 : 1));
+
+    // GENERAL - PHY: detailed (spectrum) or abstract (Yans PHY deciding the reception of the HE
+    // data from SINR-PER tables); same MAC and PHY trace sources in both
+    SpectrumWifiPhyHelper spectrumPhy(mlo ? 2 : 1);
+    YansWifiPhyHelper abstractPhy;
+    WifiPhyHelper& phy = phyModel == "Abstract" ? static_cast<WifiPhyHelper&>(abstractPhy)
+                                                : static_cast<WifiPhyHelper&>(spectrumPhy);
     phy.SetPcapDataLinkType(WifiPhyHelper::DLT_IEEE802_11_RADIO);
-    phy.SetChannel(channelHelper.Create());
-    phy.Set("ChannelSettings", StringValue(channelStr));
+    if (phyModel == "Abstract")
+    {
+        abstractPhy.SetChannel(abstractChannel);
+        abstractPhy.Set("ChannelSettings", StringValue(channelStr));
+        abstractPhy.SetErrorRateModel("ns3::SinrPerTableErrorRateModel",
+                                      "TableFile",
+                                      StringValue(phyTable));
+    }
+    else if (mlo)
+    {
+        spectrumPhy.AddChannel(spectrumChannel, WIFI_SPECTRUM_5_GHZ);
+        spectrumPhy.AddChannel(mloSpectrumChannel, WIFI_SPECTRUM_6_GHZ);
+        spectrumPhy.Set(0, "ChannelSettings", StringValue(channelStr));
+        spectrumPhy.Set(1, "ChannelSettings", StringValue(mloChannelStr));
+    }
+    else
+    {
+        spectrumPhy.SetChannel(spectrumChannel);
+        spectrumPhy.Set("ChannelSettings", StringValue(channelStr));
+    }
 
     // STA CONFIGURATION - PHY
     phy.Set("TxPowerStart", DoubleValue(txPowerMinSta));
@@ -434,13 +915,13 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                 "Ssid",
                 SsidValue(ssid),
                 "VO_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "BE_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "BK_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "VI_MaxAmpduSize",
-                UintegerValue(8388607));
+                UintegerValue(maxAmpduSize));
 
     staDevices = wifi.Install(phy, mac, wifiStaNodes);
 
@@ -455,7 +936,15 @@ ConfigureWifiNetwork(uint32_t seedNumber,
     phy.Set("MaxSupportedRxSpatialStreams", UintegerValue(nrxSpatialStreamsAp));
 
     // AP CONFIGURATION - MAC
-    if (dlAckSeqType != "NO-OFDMA")
+    if (dlAckSeqType != "NO-OFDMA" && muScheduler == "Qos")
+    {
+        mac.SetMultiUserScheduler("ns3::QosMultiUserScheduler",
+                                  "EnableUlOfdma",
+                                  BooleanValue(enableUlOfdma),
+                                  "EnableBsrp",
+                                  BooleanValue(enableBsrp));
+    }
+    else if (dlAckSeqType != "NO-OFDMA")
     {
         mac.SetMultiUserScheduler("ns3::RrMultiUserScheduler",
                                   "EnableUlOfdma",
@@ -472,13 +961,13 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                 "EnableBeaconJitter",
                 BooleanValue(false),
                 "VO_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "BE_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "BK_MaxAmpduSize",
-                UintegerValue(8388607),
+                UintegerValue(maxAmpduSize),
                 "VI_MaxAmpduSize",
-                UintegerValue(8388607));
+                UintegerValue(maxAmpduSize));
 
     apDevices = wifi.Install(phy, mac, wifiApNodes);
 
@@ -498,6 +987,84 @@ ConfigureWifiNetwork(uint32_t seedNumber,
     streamNumber += wifi.AssignStreams(staDevices, streamNumber);
 }
 
+void
+InstallStaMobility(MobilityHelper& mobility,
+                   NodeContainer& wifiStaNodes,
+                   const std::string& staMobilityModel,
+                   const Vector& center,
+                   double rho,
+                   const Rectangle& bounds,
+                   Ptr<TrajectoryTrace> trace,
+                   uint32_t& traceOffset)
+{
+    // Trace-driven mobility: consecutive trace rows per BSS
+    if (trace)
+    {
+        trace->Install(wifiStaNodes, traceOffset);
+        traceOffset += wifiStaNodes.GetN();
+        return;
+    }
+
+    // STA - Dynamic configuration: Random Walk from a disc around the AP, within the BSS area
+    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
+                                  "rho",
+                                  DoubleValue(rho),
+                                  "X",
+                                  DoubleValue(center.x),
+                                  "Y",
+                                  DoubleValue(center.y),
+                                  "Z",
+                                  DoubleValue(center.z));
+    if (staMobilityModel == "ns3::ConstantPositionMobilityModel")
+    {
+        mobility.SetMobilityModel(staMobilityModel);
+    }
+    else
+    {
+        mobility.SetMobilityModel(staMobilityModel,
+                                  "Mode",
+                                  StringValue("Time"),
+                                  "Time",
+                                  StringValue("3s"),
+                                  "Speed",
+                                  StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
+                                  "Bounds",
+                                  StringValue(std::to_string(bounds.xMin) + "|" +
+                                              std::to_string(bounds.xMax) + "|" +
+                                              std::to_string(bounds.yMin) + "|" +
+                                              std::to_string(bounds.yMax)));
+    }
+    mobility.Install(wifiStaNodes);
+}
+
+// Area the nodes may cover during the run: the walk bounds, their current position and the
+// waypoints of the traced STAs
+Rectangle
+GetNodeBounds(const NodeContainer& nodes, const Rectangle& walkBounds)
+{
+    Rectangle bounds = walkBounds;
+    auto extend = [&bounds](const Vector& position) {
+        bounds.xMin = std::min(bounds.xMin, position.x);
+        bounds.xMax = std::max(bounds.xMax, position.x);
+        bounds.yMin = std::min(bounds.yMin, position.y);
+        bounds.yMax = std::max(bounds.yMax, position.y);
+    };
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> mobility = nodes.Get(i)->GetObject<MobilityModel>();
+        extend(mobility->GetPosition());
+        if (auto trajectory = DynamicCast<TrajectoryMobilityModel>(mobility))
+        {
+            const TrajectoryTrack& track = trajectory->GetTrack();
+            for (uint32_t w = 0; w < track.GetN(); w++)
+            {
+                extend(track.GetWaypoint(w));
+            }
+        }
+    }
+    return bounds;
+}
+
 double
 getUniformRandomValue(double minVal, double maxVal)
 {
@@ -579,6 +1146,44 @@ printArray(std::string title, uint32_t* array, size_t size)
     std::cout << std::endl;
 }
 
+template <typename T>
+void
+SetVoDAttributes(T& onOffHelper, const uint32_t& dataRate, const uint32_t payloadSize)
+{
+    onOffHelper.SetAttribute("OnTime",
+                             StringValue("ns3::WeibullRandomVariable[Shape=0.8099|Scale=20850]"));
+    onOffHelper.SetAttribute("OffTime",
+                             StringValue("ns3::GammaRandomVariable[Alpha=0.2463|Beta=60.227]"));
+    onOffHelper.SetAttribute("DataRate", DataRateValue(dataRate));
+    onOffHelper.SetAttribute("PacketSize", UintegerValue(payloadSize));
+    onOffHelper.SetAttribute("MaxBytes", UintegerValue(10989173));
+}
+
+ApplicationContainer
+InstallVoDSource(const InetSocketAddress& sinkSocket,
+                 Ptr<Node> node,
+                 const uint32_t& dataRate,
+                 const uint32_t payloadSize,
+                 Ptr<PacketPool> packetPool)
+{
+    // Payloads are recycled from the packet pool when available, plain OnOff otherwise
+    if (packetPool)
+    {
+        PooledOnOffHelper onOffHelper("ns3::UdpSocketFactory", sinkSocket, packetPool);
+        SetVoDAttributes(onOffHelper, dataRate, payloadSize);
+        return onOffHelper.Install(node);
+    }
+    OnOffHelper onOffHelper("ns3::UdpSocketFactory", sinkSocket);
+    SetVoDAttributes(onOffHelper, dataRate, payloadSize);
+    return onOffHelper.Install(node);
+}
+
+void
+VoDTxTrace(Ptr<const Packet> packet)
+{
+    g_vodTxPackets++;
+}
+
 void
 VoDServer(ApplicationContainer& vodServerApplications,
           ApplicationContainer& vodClientApplications,
@@ -589,7 +1194,8 @@ VoDServer(ApplicationContainer& vodServerApplications,
           const uint32_t& dataRate,
           const uint32_t payloadSize,
           uint16_t& portUdp,
-          const uint16_t tosValue)
+          const uint16_t tosValue,
+          Ptr<PacketPool> packetPool)
 {
     for (size_t i = 0; i < numStas; ++i)
     {
@@ -600,16 +1206,8 @@ VoDServer(ApplicationContainer& vodServerApplications,
         InetSocketAddress sinkSocket(address, portUdp + staIndex);
         sinkSocket.SetTos(tosValue);
 
-        OnOffHelper onOffHelper("ns3::UdpSocketFactory", sinkSocket);
-        onOffHelper.SetAttribute(
-            "OnTime",
-            StringValue("ns3::WeibullRandomVariable[Shape=0.8099|Scale=20850]"));
-        onOffHelper.SetAttribute("OffTime",
-                                 StringValue("ns3::GammaRandomVariable[Alpha=0.2463|Beta=60.227]"));
-        onOffHelper.SetAttribute("DataRate", DataRateValue(dataRate));
-        onOffHelper.SetAttribute("PacketSize", UintegerValue(payloadSize));
-        onOffHelper.SetAttribute("MaxBytes", UintegerValue(10989173));
-        vodServerApplications.Add(onOffHelper.Install(wifiApNodes.Get(0)));
+        vodServerApplications.Add(
+            InstallVoDSource(sinkSocket, wifiApNodes.Get(0), dataRate, payloadSize, packetPool));
 
         PacketSinkHelper packetSinkHelper("ns3::UdpSocketFactory", sinkSocket);
         vodClientApplications.Add(packetSinkHelper.Install(wifiStaNodes.Get(staIndex)));
@@ -619,11 +1217,12 @@ VoDServer(ApplicationContainer& vodServerApplications,
 void
 StartStopApplication(ApplicationContainer& clientApplications,
                      ApplicationContainer& serverApplications,
+                     const double appStartTime,
                      const double simulationTime)
 {
-    clientApplications.Start(Seconds(0.0));
+    clientApplications.Start(Seconds(appStartTime));
     clientApplications.Stop(Seconds(simulationTime));
-    serverApplications.Start(Seconds(0.0));
+    serverApplications.Start(Seconds(appStartTime));
     serverApplications.Stop(Seconds(simulationTime));
 }
 
@@ -637,7 +1236,8 @@ VoDClient(ApplicationContainer& vodServerApplications,
           const uint32_t& dataRate,
           const uint32_t payloadSize,
           uint16_t& portUdp,
-          const uint16_t tosValue)
+          const uint16_t tosValue,
+          Ptr<PacketPool> packetPool)
 {
     for (size_t i = 0; i < numStas;
          ++i) // Not using range-based loop since raw pointers don't support it
@@ -650,16 +1250,11 @@ VoDClient(ApplicationContainer& vodServerApplications,
         InetSocketAddress sinkSocket(address, portUdp + staIndex);
         sinkSocket.SetTos(tosValue);
 
-        OnOffHelper onOffHelper("ns3::UdpSocketFactory", sinkSocket);
-        onOffHelper.SetAttribute(
-            "OnTime",
-            StringValue("ns3::WeibullRandomVariable[Shape=0.8099|Scale=20850]"));
-        onOffHelper.SetAttribute("OffTime",
-                                 StringValue("ns3::GammaRandomVariable[Alpha=0.2463|Beta=60.227]"));
-        onOffHelper.SetAttribute("DataRate", DataRateValue(dataRate));
-        onOffHelper.SetAttribute("PacketSize", UintegerValue(payloadSize));
-        onOffHelper.SetAttribute("MaxBytes", UintegerValue(10989173));
-        vodServerApplications.Add(onOffHelper.Install(wifiStaNodes.Get(staIndex)));
+        vodServerApplications.Add(InstallVoDSource(sinkSocket,
+                                                   wifiStaNodes.Get(staIndex),
+                                                   dataRate,
+                                                   payloadSize,
+                                                   packetPool));
 
         PacketSinkHelper packetSinkHelper("ns3::UdpSocketFactory", sinkSocket);
         vodClientApplications.Add(packetSinkHelper.Install(wifiApNodes.Get(0)));
@@ -673,7 +1268,8 @@ HttpServer(uint32_t& httpAppIndex,
            NodeContainer& wifiStaNodes,
            NodeContainer& wifiApNodes,
            uint32_t* selectedStas,
-           size_t numStas)
+           size_t numStas,
+           uint8_t tos)
 {
     for (size_t i = 0; i < numStas; ++i)
     {
@@ -683,6 +1279,7 @@ HttpServer(uint32_t& httpAppIndex,
         const auto serverAddress = ipv4->GetAddress(1, 0).GetLocal();
 
         ThreeGppHttpServerHelper serverHelper(serverAddress);
+        serverHelper.SetAttribute("Tos", UintegerValue(tos));
         httpServerApps.Add(serverHelper.Install(wifiApNodes.Get(0)));
 
         Ptr<ThreeGppHttpServer> httpServer =
@@ -699,6 +1296,7 @@ HttpServer(uint32_t& httpAppIndex,
         httpVariables->SetNumOfEmbeddedObjectsMax(53);
 
         ThreeGppHttpClientHelper clientHelper(serverAddress);
+        clientHelper.SetAttribute("Tos", UintegerValue(tos));
         httpClientApps.Add(clientHelper.Install(wifiStaNodes.Get(staIndex)));
 
         httpAppIndex++;
@@ -724,7 +1322,8 @@ GamingUl(uint16_t portGaming,
          const NodeContainer& wifiApNodes,
          const NodeContainer& wifiStaNodes,
          uint32_t* selectedSta,
-         size_t staSize)
+         size_t staSize,
+         uint8_t tos)
 {
     for (size_t i = 0; i < staSize; ++i)
     {
@@ -733,7 +1332,9 @@ GamingUl(uint16_t portGaming,
         // Source
         auto ipv4Server = wifiApNodes.Get(0)->GetObject<Ipv4>();
         Ipv4Address ipAddressServer = ipv4Server->GetAddress(1, 0).GetLocal();
-        AddressValue serverAddress(InetSocketAddress(ipAddressServer, portGaming));
+        InetSocketAddress remote(ipAddressServer, portGaming);
+        remote.SetTos(tos);
+        AddressValue serverAddress(remote);
 
         TrafficGeneratorHelper gamingHelper("ns3::UdpSocketFactory",
                                             Address(),
@@ -776,7 +1377,8 @@ GamingDl(uint32_t portGaming,
          NodeContainer& wifiApNodes,
          NodeContainer& wifiStaNodes,
          uint32_t* selectedSta,
-         size_t staSize)
+         size_t staSize,
+         uint8_t tos)
 {
     for (size_t i = 0; i < staSize; ++i)
     {
@@ -785,7 +1387,9 @@ GamingDl(uint32_t portGaming,
         // Source
         auto ipv4Server = wifiStaNodes.Get(staIndex)->GetObject<Ipv4>();
         Ipv4Address ipAddressServer = ipv4Server->GetAddress(1, 0).GetLocal();
-        AddressValue serverAddress(InetSocketAddress(ipAddressServer, portGaming + 50));
+        InetSocketAddress remote(ipAddressServer, portGaming + 50);
+        remote.SetTos(tos);
+        AddressValue serverAddress(remote);
 
         TrafficGeneratorHelper gamingHelper("ns3::UdpSocketFactory",
                                             InetSocketAddress(ipAddressServer, portGaming + 50),
@@ -823,7 +1427,8 @@ VoIPUl(uint32_t portVoIP,
        const NodeContainer& wifiApNodes,
        const NodeContainer& wifiStaNodes,
        uint32_t* selectedSta,
-       size_t staSize)
+       size_t staSize,
+       uint8_t tos)
 {
     for (size_t i = 0; i < staSize; ++i)
     {
@@ -832,7 +1437,9 @@ VoIPUl(uint32_t portVoIP,
         // Source
         auto ipv4Server = wifiApNodes.Get(0)->GetObject<Ipv4>();
         Ipv4Address ipAddressServer = ipv4Server->GetAddress(1, 0).GetLocal();
-        AddressValue serverAddress(InetSocketAddress(ipAddressServer, portVoIP));
+        InetSocketAddress remote(ipAddressServer, portVoIP);
+        remote.SetTos(tos);
+        AddressValue serverAddress(remote);
 
         TrafficGeneratorHelper voIPHelper("ns3::UdpSocketFactory",
                                           Address(),
@@ -870,7 +1477,8 @@ VoIPDl(uint32_t portVoIP,
        const NodeContainer& wifiApNodes,
        const NodeContainer& wifiStaNodes,
        uint32_t* selectedSta,
-       size_t staSize)
+       size_t staSize,
+       uint8_t tos)
 {
     for (size_t i = 0; i < staSize; ++i)
     {
@@ -879,7 +1487,9 @@ VoIPDl(uint32_t portVoIP,
         // Source
         auto ipv4Server = wifiStaNodes.Get(staIndex)->GetObject<Ipv4>();
         Ipv4Address ipAddressServer = ipv4Server->GetAddress(1, 0).GetLocal();
-        AddressValue serverAddress(InetSocketAddress(ipAddressServer, portVoIP + 50));
+        InetSocketAddress remote(ipAddressServer, portVoIP + 50);
+        remote.SetTos(tos);
+        AddressValue serverAddress(remote);
 
         TrafficGeneratorHelper voIPHelper("ns3::UdpSocketFactory",
                                           InetSocketAddress(ipAddressServer, portVoIP + 50),
@@ -922,12 +1532,19 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Simulation basic parameters
     uint32_t simulationTime = 10; // Simulation duration in seconds
+    double warmUp = 1.0;          // Start of the measurement window (seconds)
+    double measureEnd = 0.0;      // End of the measurement window (seconds, 0: simulationTime)
     uint32_t seedNumber = 1;      // RNG seed
     uint32_t runNumber = 1;       // Run number
 
     // Logging and tracing
-    bool verbose = false; // Turn on all Wifi logging
-    bool tracing = false; // Turn on PCAP tracing on AP 0
+    bool verbose = false;       // Turn on all Wifi logging
+    bool tracing = false;       // Turn on PCAP tracing on AP 0
+    double airtimeInterval = 0; // Sampling interval of the airtime time series (s, 0: none)
+    bool macStats = false;      // Per-AC MAC queue counters and histograms of every device
+    bool ampduStats = false;    // A-MPDU length, duration and Block Ack histograms of every link
+    bool mcsStats = false;      // MCS histogram of the data frames of every STA
+    bool linkStats = false;     // Throughput, SNR and channel occupancy of every link
 
     // Network Settings
     uint32_t nNetwork = 5; // Number of Networks
@@ -948,6 +1565,8 @@ main(int argc, char* argv[])
     double maxZSize = 1.5;
     double minZSizeAp = 2.0;
     double maxZSizeAp = 3.0;
+    std::string mobilityMode = "RandomWalk"; // STA mobility (RandomWalk / Precomputed / Trace)
+    std::string mobilityTrace = "";          // Trajectory trace file (Trace mobility)
 
     // Transmission Configuration
     double txPowerAp = 21;     // Max TX Power for APs
@@ -955,6 +1574,15 @@ main(int argc, char* argv[])
     double txPowerMinAp = 10;  // Min TX Power reference for APs and STAs
     double txPowerMinSta = 10; // Min TX Power reference for APs and STAs
 
+    // Power control
+    bool powerControl = false;    // RSSI-driven TX power level per device
+    double powerControlStart = 0; // First power adjustment (seconds, 0: middle of the window)
+    double targetRssi = -65;      // RSSI of the weakest peer under power control (dBm)
+
+    // Cluster control
+    std::string clusterControl = ""; // Actions of the online STA clustering (Edca,Ofdma,Power)
+    double clusterControlStart = 0;  // First cluster action (seconds, 0: middle of the window)
+
     uint32_t nTxPowerLevelsAp =
         (uint32_t)(txPowerAp - txPowerMinAp); // Iteration levels for TX power
     uint32_t nTxPowerLevelsSta =
@@ -969,15 +1597,40 @@ main(int argc, char* argv[])
     uint32_t nrxSpatialStreamsSta = 2; // Number of RX Spatial Streams for STAs
 
     // Phy parameters
-    double frequency = 5;             // 2.4 GHz / 5 GHz / 6 GHz
-    int mcs = -1;                     //-1 indicates unset value
-    uint32_t gi = 800;                // Guard interval (ns)
-    uint32_t channelWidth = 80;       // Channel Width (MHz)
-    std::string phyModel{"Spectrum"}; // Phy level model (Yans/Spectrum)
-    bool enableObssPd = true;         // Enable OBSS/PD
-    double obssPdThreshold = -72.0;   // OBSS/PD threshold in dBm
-    double ccaEdTrSta = -62;          // CCA-ED Threshold of STAs in dBm
-    double ccaEdTrAp = -62;           // CCA-ED Threshold of APs in dBm
+    double frequency = 5;                  // 2.4 GHz / 5 GHz / 6 GHz
+    int mcs = -1;                          //-1 indicates unset value
+    uint32_t gi = 800;                     // Guard interval (ns)
+    uint32_t channelWidth = 80;            // Channel Width (MHz)
+    std::string phyModel{"Spectrum"};      // Phy level model (Spectrum / Abstract)
+    std::string phyTable{"PhyTables.csv"}; // SINR-PER tables (Abstract PHY)
+    bool enableObssPd = true;              // Enable OBSS/PD
+    double obssPdThreshold = -72.0;        // OBSS/PD threshold in dBm
+    double ccaEdTrSta = -62;               // CCA-ED Threshold of STAs in dBm
+    double ccaEdTrAp = -62;                // CCA-ED Threshold of APs in dBm
+
+    // Rate control
+    std::string rateControl = "Constant"; // Rate control, one for every BSS or one per BSS (A,B...)
+
+    // Spatial reuse
+    std::string obssPdMode = "Constant"; // OBSS-PD threshold (Constant / Adaptive)
+    bool bssColoring = false;            // BSS color per BSS (1, 2...) instead of 1 for every BSS
+
+    // Multi-link operation
+    bool mlo = false;            // EHT MLDs with a 5 GHz and a 6 GHz link (802.11be)
+    std::string mloLinkMap = ""; // Links of the traffic classes, e.g. "VoIP=5,VoD=6,FTP=5+6"
+
+    // Roaming
+    bool essSsid = false;              // One SSID for every BSS, APs bridged on a wired backbone
+    std::string roaming = "";          // Handover triggers of the STAs in the ESS (Rssi,Load)
+    double roamingRssiThreshold = -75; // AP RSSI below which a STA looks for another AP (dBm)
+
+    // Channel planning
+    std::string channelPlan = "Fixed"; // Channel assignment (Fixed / Auto)
+    bool sharedSpectrum = false;       // Every BSS on one spectrum channel (inter-BSS interference)
+
+    // Radio map
+    std::string radioMapFile = ""; // Radio map of the primary link (generated if missing)
+    double radioMapCellSize = 2;   // Cell size of a generated radio map (m)
 
     // Mac parameters
     std::string dlAckSeqType{"NO-OFDMA"}; // Type of acknowledgment sequence for DL MU PPDUs of DL
@@ -986,12 +1639,32 @@ main(int argc, char* argv[])
     bool enableBsrp = false;              // In case of OFDMA: enable BSRP
     Time accessReqInterval = Seconds(0.1);
 
+    // OFDMA scheduling
+    std::string muScheduler = "RoundRobin"; // DL MU scheduler (RoundRobin / Qos)
+    double voipLatencyBudget = 20;          // Latency budget of the VoIP STAs (ms, Qos scheduler)
+    double gamingLatencyBudget = 40;        // Latency budget of the gaming STAs (ms, Qos scheduler)
+
     // Traffic configuration
     bool useRts = true;               // RTS / CTS
     bool useExtendedBlockAck = false; // Mpdu Buffer Size (256 for extended / 64 for normal size)
+    uint32_t maxAmpduSize = 8388607;  // Max A-MPDU size of every AC (bytes, 0: no aggregation)
     uint32_t payloadSize =
         1448; // Must fit in the max TX duration when transmitting at MCS 0 over an RU of 26 tones
     uint32_t dataRate = 100000000; // Data Rate (bps)
+    bool usePacketPool = false;    // Recycle VoD payloads through a per-simulation packet pool
+    bool staticArp = false;        // Fill ARP caches after addressing (no ARP at start-up)
+    bool preAssociate = false;     // Associate every STA before the applications start
+    double fastStartTime = 0.1;    // Application start time with pre-association (seconds)
+    bool primeBlockAck = false;    // Set up BA agreements before the applications start
+
+    // Traffic classes
+    bool trafficClassAc = false; // ToS per traffic class: VoIP and gaming VO, HTTP BE, FTP BK
+    std::string edcaConfig = ""; // EDCA per BSS and AC, e.g. "A:VO:cwMin=3,aifsn=2;*:BK:txop=0"
+
+    // Checkpoint of the warmed-up state
+    std::string checkpointSave = ""; // Checkpoint file written at checkpointTime
+    double checkpointTime = 1.0;     // Snapshot time of the warmed-up state (seconds)
+    std::string checkpointLoad = ""; // Checkpoint file to fork this run from
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // PARAMETERS FROM COMMAND LINE
@@ -1000,12 +1673,40 @@ main(int argc, char* argv[])
 
     // Simulation basic parameters
     cmd.AddValue("simulationTime", "Simulation time (seconds)", simulationTime);
+    cmd.AddValue("warmUp",
+                 "Start of the measurement window (seconds): traffic and samples before it "
+                 "are not accounted",
+                 warmUp);
+    cmd.AddValue("measureEnd",
+                 "End of the measurement window (seconds, 0 for the end of the simulation)",
+                 measureEnd);
     cmd.AddValue("seedNumber", "RNG seed number", seedNumber);
     cmd.AddValue("runNumber", "Simulation run number", runNumber);
 
     // Logging and tracing
     cmd.AddValue("verbose", "Enable log components", verbose);
     cmd.AddValue("tracing", "Enable pcap tracing", tracing);
+    cmd.AddValue("airtimeInterval",
+                 "Sample the airtime and channel occupancy of every BSS every airtimeInterval "
+                 "seconds to Scenario3-Airtime.csv (0: no time series)",
+                 airtimeInterval);
+    cmd.AddValue("macStats",
+                 "Account queue lengths, sojourn times, retransmissions, drops and Block Ack "
+                 "timeouts per device and AC to Scenario3-MacQueue.csv and "
+                 "Scenario3-MacQueueHistogram.csv",
+                 macStats);
+    cmd.AddValue("ampduStats",
+                 "Account A-MPDU lengths, PPDU durations and Block Ack success ratios per link to "
+                 "Scenario3-Ampdu.csv and Scenario3-AmpduHistogram.csv",
+                 ampduStats);
+    cmd.AddValue("mcsStats",
+                 "Account the MCS selected for the data frames of every STA to "
+                 "Scenario3-McsHistogram.csv",
+                 mcsStats);
+    cmd.AddValue("linkStats",
+                 "Account the throughput, SNR and channel occupancy of every link to "
+                 "Scenario3-Links.csv (enabled by mlo)",
+                 linkStats);
 
     // Network Settings
     cmd.AddValue("nNetwork", "Number of wifi Networks", nNetwork);
@@ -1025,12 +1726,36 @@ main(int argc, char* argv[])
     cmd.AddValue("maxYSize", "Upper bound for Y size of place definition", maxYSize);
     cmd.AddValue("minZSize", "Lower bound for Z size of place definition", minZSize);
     cmd.AddValue("maxZSize", "Upper bound for Z size of place definition", maxZSize);
+    cmd.AddValue("mobilityMode",
+                 "STA mobility: RandomWalk (event-driven legs) or Precomputed (same walk "
+                 "generated up front as a waypoint table) or Trace (recorded trajectories)",
+                 mobilityMode);
+    cmd.AddValue("mobilityTrace",
+                 "Trajectory trace for the Trace mobility: CSV (node,time,x,y,z) or binary "
+                 "(memory-mapped); STAs of A, B... follow consecutive tracks",
+                 mobilityTrace);
 
     // Transmission Configuration
     cmd.AddValue("txPowerAp", "AP transmission power in dBm", txPowerAp);
     cmd.AddValue("txPowerSta", "STA transmission power in dBm", txPowerSta);
     cmd.AddValue("txPowerMinAp", "AP minimum transmission power in dBm", txPowerMinAp);
     cmd.AddValue("txPowerMinSta", "STA minimum transmission power in dBm", txPowerMinSta);
+    cmd.AddValue("powerControl",
+                 "Adapt the TX power level of every AP and STA to the RSSI of its weakest peer",
+                 powerControl);
+    cmd.AddValue("powerControlStart",
+                 "Time of the first power adjustment (seconds, 0 for the middle of the "
+                 "measurement window); throughput is reported before and after it",
+                 powerControlStart);
+    cmd.AddValue("targetRssi", "Target RSSI of the power control (dBm)", targetRssi);
+    cmd.AddValue("clusterControl",
+                 "Cluster the STAs online (throughput, rx packets, SNR, delay, jitter) and apply "
+                 "per-cluster actions: comma-separated Edca, Ofdma (Qos scheduler) and/or Power",
+                 clusterControl);
+    cmd.AddValue("clusterControlStart",
+                 "Time of the first cluster action (seconds, 0 for the middle of the measurement "
+                 "window); throughput and delay are reported before and after it",
+                 clusterControlStart);
     cmd.AddValue("nAntennasAp", "Number of antennas per AP", nAntennasAp);
     cmd.AddValue("nAntennasSta", "Number of antennas per STA", nAntennasSta);
     cmd.AddValue("ntxSpatialStreamsAp", "Number of TX Spatial Streams per AP", ntxSpatialStreamsAp);
@@ -1047,13 +1772,64 @@ main(int argc, char* argv[])
                  "Whether working in the 2.4, 5 or 6 GHz band (other values gets rejected)",
                  frequency);
     cmd.AddValue("mcs", "If set, limit testing to a specific MCS (0-11)", mcs);
+    cmd.AddValue("rateControl",
+                 "Rate control: Constant (mcs), Ideal, MinstrelHt, ThompsonSampling or SnrTable; "
+                 "a comma-separated list sets one per BSS (A,B...)",
+                 rateControl);
     cmd.AddValue("gi", "Guard Interval (3200/1600/800)", gi);
     cmd.AddValue("channelWidth", "Channel Width (20/40/80/160MHz)", channelWidth);
-    cmd.AddValue("phyModel", "PHY Model (Yans / Spectrum)", phyModel);
+    cmd.AddValue("phyModel",
+                 "PHY Model: Spectrum (detailed) or Abstract (Yans PHY with SINR-PER tables per "
+                 "MCS, channel width and spatial streams; faster, no OFDMA nor MLO)",
+                 phyModel);
+    cmd.AddValue("phyTable",
+                 "SINR-PER tables of the Abstract PHY (mcs,width,nss,sinr_db,per); a missing file "
+                 "is generated from the detailed error rate model",
+                 phyTable);
     cmd.AddValue("enableObssPd", "Enable/disable OBSS_PD", enableObssPd);
     cmd.AddValue("obssPdThreshold", "OBSS PD Threshold (dBm)", obssPdThreshold);
+    cmd.AddValue("obssPdMode",
+                 "OBSS PD threshold: Constant (obssPdThreshold) or Adaptive (tuned online from "
+                 "the OBSS RSSI and the PER, starting at obssPdThreshold)",
+                 obssPdMode);
+    cmd.AddValue("bssColoring",
+                 "Give every BSS its own BSS color (forced by the Adaptive OBSS PD)",
+                 bssColoring);
     cmd.AddValue("ccaEdTrSta", "CCA ED Threshold for STAs (dBm)", ccaEdTrSta);
     cmd.AddValue("ccaEdTrAp", "OBSS PD Threshold for APs (dBm)", ccaEdTrAp);
+    cmd.AddValue("mlo",
+                 "IEEE 802.11be multi-link operation: APs and STAs are MLDs with a link on "
+                 "5 GHz (frequency) and another on 6 GHz; per-link KPIs in Scenario3-Links.csv",
+                 mlo);
+    cmd.AddValue("mloLinkMap",
+                 "Links of the traffic classes (TID-to-link mapping, enables trafficClassAc): "
+                 "class=band entries, class VoIP/Gaming/VoD/HTTP/FTP and band 5, 6 or 5+6",
+                 mloLinkMap);
+    cmd.AddValue("essSsid",
+                 "Extended service set: one SSID for every BSS and a wired backbone bridging the "
+                 "APs (shared spectrum, one subnet), so that a STA keeps its flows on a handover",
+                 essSsid);
+    cmd.AddValue("roaming",
+                 "Steer the STAs between the APs of the ESS (enables essSsid): comma-separated "
+                 "Rssi and/or Load triggers; handovers in Scenario3-Handovers.csv",
+                 roaming);
+    cmd.AddValue("roamingRssiThreshold",
+                 "RSSI of its AP below which the Rssi trigger moves a STA to a stronger AP (dBm)",
+                 roamingRssiThreshold);
+    cmd.AddValue("channelPlan",
+                 "Channel assignment: Fixed (channel table) or Auto (interference graph colouring "
+                 "and local search on the predicted throughput; enables sharedSpectrum)",
+                 channelPlan);
+    cmd.AddValue("sharedSpectrum",
+                 "Put every BSS on the same spectrum channel, so that overlapping channels "
+                 "interfere",
+                 sharedSpectrum);
+    cmd.AddValue("radioMap",
+                 "Radio map file of the primary link: the loss is looked up in the map (links out "
+                 "of it or shorter than two cells use the analytic model); a missing file is "
+                 "generated from the analytic model over the area of the nodes",
+                 radioMapFile);
+    cmd.AddValue("radioMapCellSize", "Cell size of a generated radio map (m)", radioMapCellSize);
 
     // Mac parameters
     cmd.AddValue("dlAckType",
@@ -1066,17 +1842,107 @@ main(int argc, char* argv[])
                  "Enable BSRP (useful if DL and UL OFDMA are enabled and TCP is used)",
                  enableBsrp);
     cmd.AddValue("accessReqInterval", "ARI value (miliseconds) for OFDMA", accessReqInterval);
+    cmd.AddValue("muScheduler",
+                 "OFDMA scheduler: RoundRobin or Qos (STAs ranked by head-of-line delay over "
+                 "latency budget in DL and, with enableUlOfdma, by time since their last UL MU "
+                 "transmission over the latency budget of the AC they reported in UL)",
+                 muScheduler);
+    cmd.AddValue("voipLatencyBudget",
+                 "Latency budget of the VoIP STAs for the Qos scheduler (ms)",
+                 voipLatencyBudget);
+    cmd.AddValue("gamingLatencyBudget",
+                 "Latency budget of the gaming STAs for the Qos scheduler (ms)",
+                 gamingLatencyBudget);
 
     // Traffic configuration
     cmd.AddValue("useRts", "Enable RTS/CTS", useRts);
     cmd.AddValue("useExtendedBlockAck",
                  "MPDU Long Buffer Size (256 for extended / 64 for normal size)",
                  useExtendedBlockAck);
+    cmd.AddValue("maxAmpduSize",
+                 "Maximum A-MPDU size of every AC in bytes (0 disables aggregation)",
+                 maxAmpduSize);
     cmd.AddValue("payloadSize", "The application payload size in bytes", payloadSize);
     cmd.AddValue("dataRate", "Data rate (bps)", dataRate);
+    cmd.AddValue("staticArp",
+                 "Fast start: pre-populate the ARP caches of every node after address assignment",
+                 staticArp);
+    cmd.AddValue("preAssociate",
+                 "Fast start: immediate active probing association, applications start at "
+                 "fastStartTime",
+                 preAssociate);
+    cmd.AddValue("fastStartTime",
+                 "Application start time (seconds) when preAssociate is enabled",
+                 fastStartTime);
+    cmd.AddValue("primeBlockAck",
+                 "Fast start: establish BA agreements before the applications start "
+                 "(requires preAssociate)",
+                 primeBlockAck);
+    cmd.AddValue("trafficClassAc",
+                 "Tag every traffic class with its own ToS: VoIP (0xc0) and gaming (0xe0) in "
+                 "AC_VO, VoD (0xb8) in AC_VI, HTTP (0x70) in AC_BE and FTP (0x28) in AC_BK",
+                 trafficClassAc);
+    cmd.AddValue("edcaConfig",
+                 "EDCA parameters per BSS and AC: BSS:AC:key=value,... entries separated by ';' "
+                 "(BSS A-E or *, AC VO/VI/BE/BK, keys cwMin, cwMax, aifsn, txop in us)",
+                 edcaConfig);
+    cmd.AddValue("checkpointSave",
+                 "Save the warmed-up state (topology, positions, associations, BA) to this file",
+                 checkpointSave);
+    cmd.AddValue("checkpointTime", "Simulation time of the checkpoint (seconds)", checkpointTime);
+    cmd.AddValue("checkpointLoad",
+                 "Fork the run from a checkpoint: same seed, topology and positions, fast "
+                 "re-association (a short warmUp is then enough)",
+                 checkpointLoad);
+    cmd.AddValue("usePacketPool",
+                 "Recycle fixed-size VoD payloads through a packet pool",
+                 usePacketPool);
 
     cmd.Parse(argc, argv);
 
+    // Measurement window: every KPI is computed over [warmUp, measureEnd]
+    if (measureEnd <= 0.0)
+    {
+        measureEnd = simulationTime;
+    }
+    NS_ABORT_MSG_IF(warmUp < 0.0 || warmUp >= measureEnd || measureEnd > simulationTime,
+                    "The measurement window must satisfy 0 <= warmUp < measureEnd <= "
+                    "simulationTime");
+    g_warmUp = warmUp;
+    g_measureEnd = measureEnd;
+    double measureDuration = measureEnd - warmUp;
+
+    // Rate control: one manager for every BSS, or a comma-separated one per BSS
+    std::vector<std::string> rateControlBss;
+    std::istringstream rateControlList(rateControl);
+    for (std::string item; std::getline(rateControlList, item, ',');)
+    {
+        rateControlBss.push_back(item);
+    }
+    NS_ABORT_MSG_IF(rateControlBss.size() != 1 && rateControlBss.size() != 5,
+                    "rateControl must give one rate control or one per BSS (A,B,C,D,E)");
+    rateControlBss.resize(5, rateControlBss.front());
+
+    // Checkpoint: a forked run replays the topology of the saved run and rebuilds its
+    // association, ARP and BA state with the fast start mechanisms
+    Ptr<ScenarioCheckpoint> checkpoint = CreateObject<ScenarioCheckpoint>();
+    checkpoint->SetSeedRun(seedNumber, runNumber);
+    if (!checkpointSave.empty())
+    {
+        NS_ABORT_MSG_IF(checkpointTime <= 0.0 || checkpointTime >= simulationTime,
+                        "checkpointTime must be within the simulation time");
+    }
+    if (!checkpointLoad.empty())
+    {
+        NS_ABORT_MSG_IF(!checkpointSave.empty(), "A forked run can not save a checkpoint");
+        checkpoint->Load(checkpointLoad);
+        seedNumber = checkpoint->GetSeed();
+        runNumber = checkpoint->GetRun();
+        preAssociate = true;
+        staticArp = true;
+        primeBlockAck = true;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // ENVIRONMET SETTINGS - FIXING AND ARRANGEMENTS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1086,6 +1952,15 @@ main(int argc, char* argv[])
         Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("0"));
     }
 
+    // Fast start: STAs probe and associate right away instead of waiting for beacons
+    if (preAssociate)
+    {
+        NS_ABORT_MSG_IF(fastStartTime <= 0.0 || fastStartTime >= simulationTime,
+                        "fastStartTime must be within the simulation time");
+        NS_ABORT_MSG_IF(warmUp < fastStartTime, "warmUp must cover the fast start phase");
+        FastStartHelper::ConfigureDefaults();
+    }
+
     // Set + check type of acknowledgment sequence
     if (dlAckSeqType == "ACK-SU-FORMAT")
     {
@@ -1109,9 +1984,24 @@ main(int argc, char* argv[])
     }
 
     // Check Phy level model
-    if (phyModel != "Spectrum")
+    if (phyModel == "Abstract")
+    {
+        NS_ABORT_MSG_IF(dlAckSeqType != "NO-OFDMA", "The Abstract PHY does not handle OFDMA");
+        NS_ABORT_MSG_IF(mlo, "The Abstract PHY handles single-link devices");
+    }
+    else if (phyModel != "Spectrum")
     {
-        NS_ABORT_MSG("Invalid PHY model (must be Spectrum)");
+        NS_ABORT_MSG("Invalid PHY model (must be Spectrum or Abstract)");
+    }
+
+    // Check OFDMA scheduler
+    if (muScheduler == "Qos")
+    {
+        NS_ABORT_MSG_IF(dlAckSeqType == "NO-OFDMA", "The Qos scheduler needs DL OFDMA");
+    }
+    else if (muScheduler != "RoundRobin")
+    {
+        NS_ABORT_MSG("Invalid MU scheduler (must be RoundRobin or Qos)");
     }
 
     // Set compatible Phy in case of OFDMA
@@ -1142,15 +2032,15 @@ main(int argc, char* argv[])
     NodeContainer wifiStaNodesE;
     NodeContainer wifiApNodesE;
 
-    CreateNodesNormal(wifiStaNodesA, wifiApNodesA, nStaA, nAp, "A", nStaA, 15);
+    CreateNodesNormal(wifiStaNodesA, wifiApNodesA, nStaA, nAp, "A", nStaA, 15, checkpoint);
     if (nNetwork >= 2)
-        CreateNodesNormal(wifiStaNodesB, wifiApNodesB, nStaB, nAp, "B", nStaB, 15);
+        CreateNodesNormal(wifiStaNodesB, wifiApNodesB, nStaB, nAp, "B", nStaB, 15, checkpoint);
     if (nNetwork >= 3)
-        CreateNodesNormal(wifiStaNodesC, wifiApNodesC, nStaC, nAp, "C", nStaC, 15);
+        CreateNodesNormal(wifiStaNodesC, wifiApNodesC, nStaC, nAp, "C", nStaC, 15, checkpoint);
     if (nNetwork >= 4)
-        CreateNodesNormal(wifiStaNodesD, wifiApNodesD, nStaD, nAp, "D", nStaD, 15);
+        CreateNodesNormal(wifiStaNodesD, wifiApNodesD, nStaD, nAp, "D", nStaD, 15, checkpoint);
     if (nNetwork >= 5)
-        CreateNodesNormal(wifiStaNodesE, wifiApNodesE, nStaE, nAp, "D", nStaE, 15);
+        CreateNodesNormal(wifiStaNodesE, wifiApNodesE, nStaE, nAp, "E", nStaE, 15, checkpoint);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NetDevice Creation
@@ -1175,34 +2065,146 @@ main(int argc, char* argv[])
     }
 
     // Wifi Standard
-    wifi.SetStandard(WIFI_STANDARD_80211ax);
+    wifi.SetStandard(mlo ? WIFI_STANDARD_80211be : WIFI_STANDARD_80211ax);
 
-    if (enableObssPd)
+    // Multi-link operation: EHT MLDs with a 5 GHz and a 6 GHz link, with the traffic classes
+    // mapped to links through their TIDs
+    if (mlo)
+    {
+        NS_ABORT_MSG_IF(frequency != 5,
+                        "Multi-link operation needs frequency 5 (links on 5 GHz and 6 GHz)");
+        linkStats = true;
+        NS_ABORT_MSG_IF(channelPlan != "Fixed", "The channel planning only handles single links");
+        if (!mloLinkMap.empty())
+        {
+            // The traffic classes are told apart by their TIDs
+            trafficClassAc = true;
+            std::string mapping = GetTidToLinkMapping(mloLinkMap);
+            std::cout << "TID-to-link mapping: " << mapping << std::endl;
+            wifi.ConfigEhtOptions("TidToLinkMappingDl",
+                                  StringValue(mapping),
+                                  "TidToLinkMappingUl",
+                                  StringValue(mapping));
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(!mloLinkMap.empty(), "mloLinkMap needs multi-link operation (mlo)");
+    }
+
+    if (enableObssPd && obssPdMode == "Constant")
     {
         wifi.SetObssPdAlgorithm("ns3::ConstantObssPdAlgorithm",
                                 "ObssPdLevel",
                                 DoubleValue(obssPdThreshold));
     }
+    else if (enableObssPd && obssPdMode == "Adaptive")
+    {
+        // OBSS frames can only be told apart with a BSS color per BSS
+        bssColoring = true;
+        wifi.SetObssPdAlgorithm("ns3::AdaptiveObssPdAlgorithm",
+                                "ObssPdLevel",
+                                DoubleValue(obssPdThreshold));
+    }
+    else if (enableObssPd)
+    {
+        NS_ABORT_MSG("Invalid OBSS PD mode (must be Constant or Adaptive)");
+    }
 
     // Mac Helper
     WifiMacHelper mac;
 
+    // Roaming: the STAs move between the APs of an ESS, which they must hear on one channel
+    Ptr<RoamingManager> roamingManager = CreateObject<RoamingManager>();
+    if (!roaming.empty())
+    {
+        essSsid = true;
+        roamingManager->SetAttribute("RssiTrigger", BooleanValue(false));
+        std::istringstream triggerList(roaming);
+        for (std::string trigger; std::getline(triggerList, trigger, ',');)
+        {
+            NS_ABORT_MSG_IF(trigger != "Rssi" && trigger != "Load",
+                            "Invalid roaming trigger (must be Rssi or Load)");
+            roamingManager->SetAttribute(trigger + "Trigger", BooleanValue(true));
+        }
+        roamingManager->SetAttribute("RssiThreshold", DoubleValue(roamingRssiThreshold));
+        mac.SetAssocManager("ns3::RoamingAssocManager",
+                            "RoamingManager",
+                            PointerValue(roamingManager));
+    }
+    if (essSsid)
+    {
+        NS_ABORT_MSG_IF(mlo, "The ESS handles single-link devices");
+        NS_ABORT_MSG_IF(channelPlan != "Fixed", "The APs of the ESS share one channel");
+        sharedSpectrum = true;
+    }
+
+    // Channel planning: the BSSs only interfere, and the planned channels only matter, on one
+    // shared spectrum channel
+    if (channelPlan == "Auto")
+    {
+        sharedSpectrum = true;
+    }
+
+    // Radio map of the primary link, loaded once the nodes are placed
+    Ptr<RadioMapPropagationLossModel> radioMap = nullptr;
+    if (!radioMapFile.empty())
+    {
+        radioMap = CreateObject<RadioMapPropagationLossModel>();
+        radioMap->SetAttribute("Fallback", PointerValue(CreateLossModel(frequency)));
+    }
+
+    // Spectrum shared by every BSS (otherwise each BSS gets a channel of its own); the Abstract
+    // PHY only models co-channel interference
+    Ptr<SpectrumChannel> sharedChannel = nullptr;
+    Ptr<SpectrumChannel> mloSharedChannel = nullptr;
+    Ptr<YansWifiChannel> abstractSharedChannel = nullptr;
+    if (sharedSpectrum && phyModel == "Abstract")
+    {
+        abstractSharedChannel = CreateAbstractChannel(frequency, radioMap);
+    }
+    else if (sharedSpectrum)
+    {
+        sharedChannel = CreateSpectrumChannel(frequency, radioMap);
+        mloSharedChannel = mlo ? CreateSpectrumChannel(6) : nullptr;
+    }
+
+    // SINR-PER tables of the Abstract PHY, generated from the detailed error rate model on the
+    // first run (HE MCS 0-11, 20-160 MHz, 1-4 spatial streams, 1500 byte frames)
+    if (phyModel == "Abstract" && !std::ifstream(phyTable).good())
+    {
+        std::cout << "Generating SINR-PER tables " << phyTable << std::endl;
+        SinrPerTableErrorRateModel::Generate(CreateObject<TableBasedErrorRateModel>(),
+                                             1500,
+                                             -5,
+                                             45,
+                                             0.25,
+                                             phyTable);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK CONFIGURATION: PHY + MAC
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Every BSS on the first channel of the band and width (co-channel deployment); the channel
+    // planning may move them afterwards
+    const uint32_t channelIndex = 1;
 
     if (nNetwork >= 1)
     {
-        ssid = Ssid("ns3-802.11ax-A");
+        ssid = Ssid(essSsid ? "ns3-802.11ax-ESS" : "ns3-802.11ax-A");
         ConfigureWifiNetwork(seedNumber,
                              runNumber,
                              tracing,
                              wifi,
                              mac,
                              frequency,
+                             mlo,
                              mcs,
+                             rateControlBss[0],
                              channelWidth,
                              gi,
+                             phyModel,
+                             phyTable,
                              nAntennasAp,
                              nAntennasSta,
                              ntxSpatialStreamsAp,
@@ -1218,12 +2220,20 @@ main(int argc, char* argv[])
                              nTxPowerLevelsAp,
                              ccaEdTrAp,
                              dlAckSeqType,
+                             muScheduler,
                              enableUlOfdma,
                              useExtendedBlockAck,
+                             maxAmpduSize,
+                             bssColoring,
                              enableBsrp,
                              accessReqInterval,
                              ssid,
+                             channelIndex,
                              0,
+                             sharedChannel,
+                             mloSharedChannel,
+                             abstractSharedChannel,
+                             radioMap,
                              wifiStaNodesA,
                              wifiApNodesA,
                              staDevicesA,
@@ -1232,16 +2242,20 @@ main(int argc, char* argv[])
 
     if (nNetwork >= 2)
     {
-        ssid = Ssid("ns3-802.11ax-B");
+        ssid = Ssid(essSsid ? "ns3-802.11ax-ESS" : "ns3-802.11ax-B");
         ConfigureWifiNetwork(seedNumber,
                              runNumber,
                              tracing,
                              wifi,
                              mac,
                              frequency,
+                             mlo,
                              mcs,
+                             rateControlBss[1],
                              channelWidth,
                              gi,
+                             phyModel,
+                             phyTable,
                              nAntennasAp,
                              nAntennasSta,
                              ntxSpatialStreamsAp,
@@ -1257,12 +2271,20 @@ main(int argc, char* argv[])
                              nTxPowerLevelsAp,
                              ccaEdTrAp,
                              dlAckSeqType,
+                             muScheduler,
                              enableUlOfdma,
                              useExtendedBlockAck,
+                             maxAmpduSize,
+                             bssColoring,
                              enableBsrp,
                              accessReqInterval,
                              ssid,
-                             0,
+                             channelIndex,
+                             1,
+                             sharedChannel,
+                             mloSharedChannel,
+                             abstractSharedChannel,
+                             radioMap,
                              wifiStaNodesB,
                              wifiApNodesB,
                              staDevicesB,
@@ -1271,16 +2293,20 @@ main(int argc, char* argv[])
 
     if (nNetwork >= 3)
     {
-        ssid = Ssid("ns3-802.11ax-C");
+        ssid = Ssid(essSsid ? "ns3-802.11ax-ESS" : "ns3-802.11ax-C");
         ConfigureWifiNetwork(seedNumber,
                              runNumber,
                              tracing,
                              wifi,
                              mac,
                              frequency,
+                             mlo,
                              mcs,
+                             rateControlBss[2],
                              channelWidth,
                              gi,
+                             phyModel,
+                             phyTable,
                              nAntennasAp,
                              nAntennasSta,
                              ntxSpatialStreamsAp,
@@ -1296,12 +2322,20 @@ main(int argc, char* argv[])
                              nTxPowerLevelsAp,
                              ccaEdTrAp,
                              dlAckSeqType,
+                             muScheduler,
                              enableUlOfdma,
                              useExtendedBlockAck,
+                             maxAmpduSize,
+                             bssColoring,
                              enableBsrp,
                              accessReqInterval,
                              ssid,
-                             0,
+                             channelIndex,
+                             2,
+                             sharedChannel,
+                             mloSharedChannel,
+                             abstractSharedChannel,
+                             radioMap,
                              wifiStaNodesC,
                              wifiApNodesC,
                              staDevicesC,
@@ -1310,16 +2344,20 @@ main(int argc, char* argv[])
 
     if (nNetwork >= 4)
     {
-        ssid = Ssid("ns3-802.11ax-D");
+        ssid = Ssid(essSsid ? "ns3-802.11ax-ESS" : "ns3-802.11ax-D");
         ConfigureWifiNetwork(seedNumber,
                              runNumber,
                              tracing,
                              wifi,
                              mac,
                              frequency,
+                             mlo,
                              mcs,
+                             rateControlBss[3],
                              channelWidth,
                              gi,
+                             phyModel,
+                             phyTable,
                              nAntennasAp,
                              nAntennasSta,
                              ntxSpatialStreamsAp,
@@ -1335,12 +2373,20 @@ main(int argc, char* argv[])
                              nTxPowerLevelsAp,
                              ccaEdTrAp,
                              dlAckSeqType,
+                             muScheduler,
                              enableUlOfdma,
                              useExtendedBlockAck,
+                             maxAmpduSize,
+                             bssColoring,
                              enableBsrp,
                              accessReqInterval,
                              ssid,
-                             0,
+                             channelIndex,
+                             3,
+                             sharedChannel,
+                             mloSharedChannel,
+                             abstractSharedChannel,
+                             radioMap,
                              wifiStaNodesD,
                              wifiApNodesD,
                              staDevicesD,
@@ -1349,16 +2395,20 @@ main(int argc, char* argv[])
 
     if (nNetwork >= 5)
     {
-        ssid = Ssid("ns3-802.11ax-E");
+        ssid = Ssid(essSsid ? "ns3-802.11ax-ESS" : "ns3-802.11ax-E");
         ConfigureWifiNetwork(seedNumber,
                              runNumber,
                              tracing,
                              wifi,
                              mac,
                              frequency,
+                             mlo,
                              mcs,
+                             rateControlBss[4],
                              channelWidth,
                              gi,
+                             phyModel,
+                             phyTable,
                              nAntennasAp,
                              nAntennasSta,
                              ntxSpatialStreamsAp,
@@ -1374,163 +2424,149 @@ main(int argc, char* argv[])
                              nTxPowerLevelsAp,
                              ccaEdTrAp,
                              dlAckSeqType,
+                             muScheduler,
                              enableUlOfdma,
                              useExtendedBlockAck,
+                             maxAmpduSize,
+                             bssColoring,
                              enableBsrp,
                              accessReqInterval,
                              ssid,
-                             0,
+                             channelIndex,
+                             4,
+                             sharedChannel,
+                             mloSharedChannel,
+                             abstractSharedChannel,
+                             radioMap,
                              wifiStaNodesE,
                              wifiApNodesE,
                              staDevicesE,
                              apDevicesE);
     }
 
+    // EDCA parameters per BSS and AC (the APs advertise them again at association)
+    if (!edcaConfig.empty())
+    {
+        ApplyEdcaConfig(edcaConfig, "A", NetDeviceContainer(apDevicesA, staDevicesA));
+        ApplyEdcaConfig(edcaConfig, "B", NetDeviceContainer(apDevicesB, staDevicesB));
+        ApplyEdcaConfig(edcaConfig, "C", NetDeviceContainer(apDevicesC, staDevicesC));
+        ApplyEdcaConfig(edcaConfig, "D", NetDeviceContainer(apDevicesD, staDevicesD));
+        ApplyEdcaConfig(edcaConfig, "E", NetDeviceContainer(apDevicesE, staDevicesE));
+    }
+
+    // Traffic classes: ToS of every class (the wifi UP is the three upper bits of the ToS)
+    uint8_t tosVoip = trafficClassAc ? 0xc0 : 0x00;   // UP 6, AC_VO
+    uint8_t tosGaming = trafficClassAc ? 0xe0 : 0x00; // UP 7, AC_VO
+    uint8_t tosVod = 0xb8;                            // UP 5, AC_VI
+    uint8_t tosHttp = trafficClassAc ? 0x70 : 0x00;   // UP 3, AC_BE
+    uint8_t tosFtp = trafficClassAc ? 0x28 : 0x00;    // UP 1, AC_BK
+
+    // Fast start: association tracking
+    Ptr<FastStartHelper> fastStart = CreateObject<FastStartHelper>();
+    if (preAssociate)
+    {
+        fastStart->Install(staDevicesA);
+        fastStart->Install(staDevicesB);
+        fastStart->Install(staDevicesC);
+        fastStart->Install(staDevicesD);
+        fastStart->Install(staDevicesE);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOBILITY
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Mobility Helper
     MobilityHelper mobility;
 
-    double xSize = getUniformRandomValue(minXsize, maxXSize);
+    // STA walks: simulated leg by leg, precomputed for the whole simulation or recorded
+    std::string staMobilityModel = "ns3::RandomWalk2dMobilityModel";
+    if (mobilityMode == "Precomputed")
+    {
+        staMobilityModel = "ns3::TrajectoryMobilityModel";
+        Config::SetDefault("ns3::TrajectoryMobilityModel::Duration",
+                           TimeValue(Seconds(simulationTime + 1)));
+    }
+    Ptr<TrajectoryTrace> trajectoryTrace = nullptr;
+    uint32_t traceOffset = 0;
+    if (mobilityMode == "Trace")
+    {
+        NS_ABORT_MSG_IF(mobilityTrace.empty(), "Trace mobility requires a mobilityTrace file");
+        trajectoryTrace = CreateObject<TrajectoryTrace>();
+        trajectoryTrace->Load(mobilityTrace);
+    }
+    else if (mobilityMode != "RandomWalk" && mobilityMode != "Precomputed")
+    {
+        NS_ABORT_MSG("Invalid mobility mode (must be RandomWalk, Precomputed or Trace)");
+    }
+
+    double xSize = checkpoint->Replay("xSize", getUniformRandomValue(minXsize, maxXSize));
     double xSize2 = 2 * xSize;
     double xSize3 = 3 * xSize;
     double xSize4 = 4 * xSize;
 
-    double ySize = getUniformRandomValue(minYsize, maxYSize);
+    double ySize = checkpoint->Replay("ySize", getUniformRandomValue(minYsize, maxYSize));
     double ySize2 = 2 * ySize;
     double ySize3 = 3 * ySize;
     double ySize4 = 4 * ySize;
 
-    double zSize = getUniformRandomValue(minZSize, maxZSize);
-    double zSizeAp = getUniformRandomValue(minZSizeAp, maxZSizeAp);
-
-    // STA - Dynamic configuration: Random Walk
-    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
-                                  "rho",
-                                  DoubleValue((sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2),
-                                  "X",
-                                  DoubleValue(xSize),
-                                  "Y",
-                                  DoubleValue(ySize),
-                                  "Z",
-                                  DoubleValue(zSize));
-    mobility.SetMobilityModel(
-        "ns3::RandomWalk2dMobilityModel",
-        "Mode",
-        StringValue("Time"),
-        "Time",
-        StringValue("3s"),
-        "Speed",
-        StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
-        "Bounds",
-        StringValue("0|" + std::to_string(xSize2) + "|0|" + std::to_string(ySize2)));
-    mobility.Install(wifiStaNodesA);
+    double zSize = checkpoint->Replay("zSize", getUniformRandomValue(minZSize, maxZSize));
+    double zSizeAp = checkpoint->Replay("zSizeAp", getUniformRandomValue(minZSizeAp, maxZSizeAp));
+
+    // STAs of every BSS: around its AP, within its quarter of the area (the STAs of B keep
+    // their initial position)
+    double staRho = (sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2;
+    InstallStaMobility(mobility,
+                       wifiStaNodesA,
+                       staMobilityModel,
+                       Vector(xSize, ySize, zSize),
+                       staRho,
+                       Rectangle(0, xSize2, 0, ySize2),
+                       trajectoryTrace,
+                       traceOffset);
 
     std::cout << "Pasa STAs A" << std::endl;
 
-    // STA - Dynamic configuration: Random Walk
-    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
-                                  "rho",
-                                  DoubleValue((sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2),
-                                  "X",
-                                  DoubleValue(xSize3),
-                                  "Y",
-                                  DoubleValue(ySize),
-                                  "Z",
-                                  DoubleValue(zSize));
-    mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                              "Mode",
-                              StringValue("Time"),
-                              "Time",
-                              StringValue("3s"),
-                              "Speed",
-                              StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
-                              "Bounds",
-                              StringValue(std::to_string(xSize2) + "|" + std::to_string(xSize4) +
-                                          "|0|" + std::to_string(ySize2)));
-    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
-    mobility.Install(wifiStaNodesB);
+    InstallStaMobility(mobility,
+                       wifiStaNodesB,
+                       "ns3::ConstantPositionMobilityModel",
+                       Vector(xSize3, ySize, zSize),
+                       staRho,
+                       Rectangle(xSize2, xSize4, 0, ySize2),
+                       trajectoryTrace,
+                       traceOffset);
 
     std::cout << "Pasa STAs B" << std::endl;
 
-    // STA - Dynamic configuration: Random Walk
-    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
-                                  "rho",
-                                  DoubleValue((sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2),
-                                  "X",
-                                  DoubleValue(xSize),
-                                  "Y",
-                                  DoubleValue(ySize3),
-                                  "Z",
-                                  DoubleValue(zSize));
-
-    std::cout << "Pasa STAs C1" << std::endl;
-    std::cout << "0|" + std::to_string(xSize2) + "|" + std::to_string(ySize2) + "|" +
-                     std::to_string(ySize4)
-              << std::endl;
-
-    mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                              "Mode",
-                              StringValue("Time"),
-                              "Time",
-                              StringValue("3s"),
-                              "Speed",
-                              StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
-                              "Bounds",
-                              StringValue("0|" + std::to_string(xSize2) + "|" +
-                                          std::to_string(ySize2) + "|" + std::to_string(ySize4)));
-    mobility.Install(wifiStaNodesC);
+    InstallStaMobility(mobility,
+                       wifiStaNodesC,
+                       staMobilityModel,
+                       Vector(xSize, ySize3, zSize),
+                       staRho,
+                       Rectangle(0, xSize2, ySize2, ySize4),
+                       trajectoryTrace,
+                       traceOffset);
 
     std::cout << "Pasa STAs C" << std::endl;
 
-    // STA - Dynamic configuration: Random Walk
-    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
-                                  "rho",
-                                  DoubleValue((sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2),
-                                  "X",
-                                  DoubleValue(xSize3),
-                                  "Y",
-                                  DoubleValue(ySize3),
-                                  "Z",
-                                  DoubleValue(zSize));
-    mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                              "Mode",
-                              StringValue("Time"),
-                              "Time",
-                              StringValue("3s"),
-                              "Speed",
-                              StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
-                              "Bounds",
-                              StringValue(std::to_string(xSize2) + "|" + std::to_string(xSize4) +
-                                          "|" + std::to_string(ySize2) + "|" +
-                                          std::to_string(ySize4)));
-    mobility.Install(wifiStaNodesD);
+    InstallStaMobility(mobility,
+                       wifiStaNodesD,
+                       staMobilityModel,
+                       Vector(xSize3, ySize3, zSize),
+                       staRho,
+                       Rectangle(xSize2, xSize4, ySize2, ySize4),
+                       trajectoryTrace,
+                       traceOffset);
 
     std::cout << "Pasa STAs D" << std::endl;
 
-    // STA - Dynamic configuration: Random Walk
-    mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
-                                  "rho",
-                                  DoubleValue((sqrt(pow(xSize, 2) + pow(ySize, 2))) / 2),
-                                  "X",
-                                  DoubleValue(xSize2),
-                                  "Y",
-                                  DoubleValue(ySize2),
-                                  "Z",
-                                  DoubleValue(zSize));
-    mobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
-                              "Mode",
-                              StringValue("Time"),
-                              "Time",
-                              StringValue("3s"),
-                              "Speed",
-                              StringValue("ns3::ConstantRandomVariable[Constant=1.0]"),
-                              "Bounds",
-                              StringValue(std::to_string(xSize) + "|" + std::to_string(xSize3) +
-                                          "|" + std::to_string(ySize) + "|" +
-                                          std::to_string(ySize3)));
-    mobility.Install(wifiStaNodesE);
+    InstallStaMobility(mobility,
+                       wifiStaNodesE,
+                       staMobilityModel,
+                       Vector(xSize2, ySize2, zSize),
+                       staRho,
+                       Rectangle(xSize, xSize3, ySize, ySize3),
+                       trajectoryTrace,
+                       traceOffset);
 
     std::cout << "Pasa STAs E" << std::endl;
 
@@ -1579,6 +2615,119 @@ main(int argc, char* argv[])
 
     std::cout << "Pasa AP E" << std::endl;
 
+    // Checkpoint: save or restore the warmed-up state of every BSS
+    checkpoint->AddNetwork("A", wifiApNodesA, wifiStaNodesA);
+    checkpoint->AddNetwork("B", wifiApNodesB, wifiStaNodesB);
+    checkpoint->AddNetwork("C", wifiApNodesC, wifiStaNodesC);
+    checkpoint->AddNetwork("D", wifiApNodesD, wifiStaNodesD);
+    checkpoint->AddNetwork("E", wifiApNodesE, wifiStaNodesE);
+    if (checkpoint->IsLoaded())
+    {
+        checkpoint->RestorePositions();
+        checkpoint->ScheduleCheck(Seconds(fastStartTime));
+    }
+    else if (!checkpointSave.empty())
+    {
+        checkpoint->ScheduleSave(Seconds(checkpointTime), checkpointSave);
+    }
+
+    // Radio map: generated from the analytic model on the first run (a cell-pair map over the
+    // area of the nodes, one cell of margin); a map that does not cover every node is rejected
+    if (radioMap)
+    {
+        NodeContainer wifiNodes(wifiApNodesA,
+                                wifiApNodesB,
+                                wifiApNodesC,
+                                wifiApNodesD,
+                                wifiApNodesE);
+        for (const NodeContainer& staNodes :
+             {wifiStaNodesA, wifiStaNodesB, wifiStaNodesC, wifiStaNodesD, wifiStaNodesE})
+        {
+            wifiNodes.Add(staNodes);
+        }
+        Rectangle nodeBounds = GetNodeBounds(wifiNodes, Rectangle(0, xSize4, 0, ySize4));
+        if (!std::ifstream(radioMapFile).good())
+        {
+            std::cout << "Generating radio map " << radioMapFile << std::endl;
+            RadioMapPropagationLossModel::Generate(
+                CreateLossModel(frequency),
+                Rectangle(nodeBounds.xMin - radioMapCellSize,
+                          nodeBounds.xMax + radioMapCellSize,
+                          nodeBounds.yMin - radioMapCellSize,
+                          nodeBounds.yMax + radioMapCellSize),
+                radioMapCellSize,
+                zSizeAp,
+                zSize,
+                {},
+                radioMapFile);
+        }
+        radioMap->Load(radioMapFile);
+        Rectangle mapArea = radioMap->GetArea();
+        NS_ABORT_MSG_IF(!mapArea.IsInside(Vector(nodeBounds.xMin, nodeBounds.yMin, 0)) ||
+                            !mapArea.IsInside(Vector(nodeBounds.xMax, nodeBounds.yMax, 0)),
+                        "Radio map " << radioMapFile << " (" << mapArea
+                                     << ") does not cover the nodes (" << nodeBounds << ")");
+    }
+
+    // Channel planning: primary channel and width of every BSS from the AP positions
+    if (channelPlan == "Auto")
+    {
+        Ptr<ChannelPlanner> planner = CreateObject<ChannelPlanner>();
+        planner->SetAttribute("LossModel", PointerValue(CreateLossModel(frequency)));
+        planner->SetAttribute("TxPower", DoubleValue(txPowerAp));
+        int32_t channelNumber = getChannelNumber(channelWidth, frequency, channelIndex);
+        NS_ABORT_MSG_IF(channelNumber < 0, "No channel for the frequency and channel width");
+        ChannelPlanner::Channel fixedChannel = {static_cast<uint16_t>(channelNumber),
+                                                static_cast<uint16_t>(channelWidth)};
+
+        planner->AddBss("A", wifiApNodesA.Get(0), fixedChannel);
+        if (nNetwork >= 2)
+            planner->AddBss("B", wifiApNodesB.Get(0), fixedChannel);
+        if (nNetwork >= 3)
+            planner->AddBss("C", wifiApNodesC.Get(0), fixedChannel);
+        if (nNetwork >= 4)
+            planner->AddBss("D", wifiApNodesD.Get(0), fixedChannel);
+        if (nNetwork >= 5)
+            planner->AddBss("E", wifiApNodesE.Get(0), fixedChannel);
+
+        planner->Plan(frequency, channelWidth);
+
+        planner->Apply(0, NetDeviceContainer(apDevicesA, staDevicesA));
+        if (nNetwork >= 2)
+            planner->Apply(1, NetDeviceContainer(apDevicesB, staDevicesB));
+        if (nNetwork >= 3)
+            planner->Apply(2, NetDeviceContainer(apDevicesC, staDevicesC));
+        if (nNetwork >= 4)
+            planner->Apply(3, NetDeviceContainer(apDevicesD, staDevicesD));
+        if (nNetwork >= 5)
+            planner->Apply(4, NetDeviceContainer(apDevicesE, staDevicesE));
+
+        planner->WriteCsv("Scenario3-ChannelPlan.csv", seedNumber, runNumber);
+    }
+    else if (channelPlan != "Fixed")
+    {
+        NS_ABORT_MSG("Invalid channel plan (must be Fixed or Auto)");
+    }
+
+    // ESS: the APs share a wired backbone, bridged with their wifi device, so that a STA keeps
+    // its address and flows after a handover
+    NetDeviceContainer bridgeDevicesA, bridgeDevicesB, bridgeDevicesC, bridgeDevicesD,
+        bridgeDevicesE;
+    if (essSsid)
+    {
+        CsmaHelper backbone;
+        backbone.SetChannelAttribute("DataRate", StringValue("10Gbps"));
+        backbone.SetChannelAttribute("Delay", TimeValue(MicroSeconds(5)));
+        NetDeviceContainer backboneDevices = backbone.Install(
+            NodeContainer(wifiApNodesA, wifiApNodesB, wifiApNodesC, wifiApNodesD, wifiApNodesE));
+        uint32_t backboneIndex = 0;
+        bridgeDevicesA = BridgeApDevices(apDevicesA, backboneDevices, backboneIndex);
+        bridgeDevicesB = BridgeApDevices(apDevicesB, backboneDevices, backboneIndex);
+        bridgeDevicesC = BridgeApDevices(apDevicesC, backboneDevices, backboneIndex);
+        bridgeDevicesD = BridgeApDevices(apDevicesD, backboneDevices, backboneIndex);
+        bridgeDevicesE = BridgeApDevices(apDevicesE, backboneDevices, backboneIndex);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // INTERNET PROTOCOL STACK
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1604,39 +2753,230 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     Ipv4AddressHelper address;
 
-    address.SetBase("192.168.1.0", "255.255.255.0");
+    SetBssAddressBase(address, 1, essSsid);
     Ipv4InterfaceContainer staNodeInterfacesA;
     Ipv4InterfaceContainer apNodeInterfacesA;
     staNodeInterfacesA = address.Assign(staDevicesA);
-    apNodeInterfacesA = address.Assign(apDevicesA);
+    apNodeInterfacesA = address.Assign(essSsid ? bridgeDevicesA : apDevicesA);
 
-    address.SetBase("192.168.2.0", "255.255.255.0");
+    SetBssAddressBase(address, 2, essSsid);
     Ipv4InterfaceContainer staNodeInterfacesB;
     Ipv4InterfaceContainer apNodeInterfacesB;
     staNodeInterfacesB = address.Assign(staDevicesB);
-    apNodeInterfacesB = address.Assign(apDevicesB);
+    apNodeInterfacesB = address.Assign(essSsid ? bridgeDevicesB : apDevicesB);
 
-    address.SetBase("192.168.3.0", "255.255.255.0");
+    SetBssAddressBase(address, 3, essSsid);
     Ipv4InterfaceContainer staNodeInterfacesC;
     Ipv4InterfaceContainer apNodeInterfacesC;
     staNodeInterfacesC = address.Assign(staDevicesC);
-    apNodeInterfacesC = address.Assign(apDevicesC);
+    apNodeInterfacesC = address.Assign(essSsid ? bridgeDevicesC : apDevicesC);
 
-    address.SetBase("192.168.4.0", "255.255.255.0");
+    SetBssAddressBase(address, 4, essSsid);
     Ipv4InterfaceContainer staNodeInterfacesD;
     Ipv4InterfaceContainer apNodeInterfacesD;
     staNodeInterfacesD = address.Assign(staDevicesD);
-    apNodeInterfacesD = address.Assign(apDevicesD);
+    apNodeInterfacesD = address.Assign(essSsid ? bridgeDevicesD : apDevicesD);
 
-    address.SetBase("192.168.5.0", "255.255.255.0");
+    SetBssAddressBase(address, 5, essSsid);
     Ipv4InterfaceContainer staNodeInterfacesE;
     Ipv4InterfaceContainer apNodeInterfacesE;
     staNodeInterfacesE = address.Assign(staDevicesE);
-    apNodeInterfacesE = address.Assign(apDevicesE);
+    apNodeInterfacesE = address.Assign(essSsid ? bridgeDevicesE : apDevicesE);
+
+    // Fast start: every STA and AP already knows the MAC address of its BSS neighbours,
+    // so applications starting at t=0 do not trigger the ARP resolution storm
+    if (staticArp)
+    {
+        NeighborCacheHelper neighborCache;
+        neighborCache.PopulateNeighborCache(staNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesD);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesD);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesE);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesE);
+    }
+
+    // Fast start: one datagram per direction, STA and ToS of the traffic classes sets up the BA
+    // agreements before the applications start (they are otherwise negotiated with measured
+    // traffic)
+    double appStartTime = preAssociate ? fastStartTime : 0.0;
+    if (preAssociate && primeBlockAck)
+    {
+        std::vector<uint8_t> primeTos;
+        for (uint8_t tos : {tosVoip, tosGaming, tosVod, tosHttp, tosFtp})
+        {
+            if (std::find(primeTos.begin(), primeTos.end(), tos) == primeTos.end())
+            {
+                primeTos.push_back(tos);
+            }
+        }
+        Time primeTime = Seconds(0.6 * appStartTime);
+        fastStart->PrimeBlockAck(wifiApNodesA, wifiStaNodesA, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesB, wifiStaNodesB, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesC, wifiStaNodesC, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesD, wifiStaNodesD, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesE, wifiStaNodesE, primeTos, primeTime);
+    }
+
+    // Power control: per-device TX power level from the RSSI measured on the BSS links
+    Ptr<PowerControlManager> powerControlManager = CreateObject<PowerControlManager>();
+    if (powerControl)
+    {
+        if (powerControlStart <= 0)
+        {
+            powerControlStart = (warmUp + measureEnd) / 2;
+        }
+        powerControlManager->SetAttribute("TargetRssi", DoubleValue(targetRssi));
+        powerControlManager->AddBss(apDevicesA, staDevicesA);
+        powerControlManager->AddBss(apDevicesB, staDevicesB);
+        powerControlManager->AddBss(apDevicesC, staDevicesC);
+        powerControlManager->AddBss(apDevicesD, staDevicesD);
+        powerControlManager->AddBss(apDevicesE, staDevicesE);
+        powerControlManager->EnableCsv("Scenario3-PowerControl.csv", seedNumber, runNumber);
+        powerControlManager->Start(Seconds(warmUp),
+                                   Seconds(powerControlStart),
+                                   Seconds(measureEnd));
+    }
+
+    // Spatial reuse: per-device trace of the adaptive OBSS PD threshold
+    if (enableObssPd && obssPdMode == "Adaptive")
+    {
+        g_obssPdCsv.open("Scenario3-ObssPd.csv", std::ios::app);
+        NS_ABORT_MSG_IF(!g_obssPdCsv.is_open(), "Can not open Scenario3-ObssPd.csv");
+        ConnectObssPdTrace(seedNumber, runNumber, "A", NetDeviceContainer(apDevicesA, staDevicesA));
+        ConnectObssPdTrace(seedNumber, runNumber, "B", NetDeviceContainer(apDevicesB, staDevicesB));
+        ConnectObssPdTrace(seedNumber, runNumber, "C", NetDeviceContainer(apDevicesC, staDevicesC));
+        ConnectObssPdTrace(seedNumber, runNumber, "D", NetDeviceContainer(apDevicesD, staDevicesD));
+        ConnectObssPdTrace(seedNumber, runNumber, "E", NetDeviceContainer(apDevicesE, staDevicesE));
+    }
+
+    // Rate control: MCS selected for the data frames of every STA within the window
+    Ptr<McsHistogram> mcsHistogram = nullptr;
+    if (mcsStats)
+    {
+        mcsHistogram = CreateObject<McsHistogram>();
+        mcsHistogram->AddBss("A", apDevicesA, staDevicesA);
+        mcsHistogram->AddBss("B", apDevicesB, staDevicesB);
+        mcsHistogram->AddBss("C", apDevicesC, staDevicesC);
+        mcsHistogram->AddBss("D", apDevicesD, staDevicesD);
+        mcsHistogram->AddBss("E", apDevicesE, staDevicesE);
+        mcsHistogram->SetWindow(Seconds(warmUp), Seconds(measureEnd));
+    }
+
+    // Multi-link operation: throughput, SNR and channel occupancy of every link
+    Ptr<MloLinkStats> mloLinkStats = nullptr;
+    if (linkStats)
+    {
+        mloLinkStats = CreateObject<MloLinkStats>();
+        mloLinkStats->AddBss("A", apDevicesA, staDevicesA);
+        mloLinkStats->AddBss("B", apDevicesB, staDevicesB);
+        mloLinkStats->AddBss("C", apDevicesC, staDevicesC);
+        mloLinkStats->AddBss("D", apDevicesD, staDevicesD);
+        mloLinkStats->AddBss("E", apDevicesE, staDevicesE);
+        mloLinkStats->SetWindow(Seconds(warmUp), Seconds(measureEnd));
+    }
+
+    // Airtime: PHY state occupancy of every device and BSS (DeviceStats columns, time series)
+    Ptr<AirtimeAccountant> airtime = CreateObject<AirtimeAccountant>();
+    airtime->AddBss("A", apDevicesA, staDevicesA);
+    airtime->AddBss("B", apDevicesB, staDevicesB);
+    airtime->AddBss("C", apDevicesC, staDevicesC);
+    airtime->AddBss("D", apDevicesD, staDevicesD);
+    airtime->AddBss("E", apDevicesE, staDevicesE);
+    airtime->SetWindow(Seconds(warmUp), Seconds(measureEnd));
+    if (airtimeInterval > 0)
+    {
+        airtime->SetAttribute("Interval", TimeValue(Seconds(airtimeInterval)));
+        airtime->EnableTimeSeries("Scenario3-Airtime.csv", seedNumber, runNumber);
+    }
+
+    // MAC queues: per-AC counters and histograms of every device
+    Ptr<MacQueueStats> macQueueStats = nullptr;
+    if (macStats)
+    {
+        macQueueStats = CreateObject<MacQueueStats>();
+        macQueueStats->AddBss("A", apDevicesA, staDevicesA);
+        macQueueStats->AddBss("B", apDevicesB, staDevicesB);
+        macQueueStats->AddBss("C", apDevicesC, staDevicesC);
+        macQueueStats->AddBss("D", apDevicesD, staDevicesD);
+        macQueueStats->AddBss("E", apDevicesE, staDevicesE);
+        macQueueStats->Start(Seconds(warmUp), Seconds(measureEnd));
+    }
+
+    // Aggregation: A-MPDU length, PPDU duration and Block Ack success ratio of every link
+    Ptr<AmpduStats> aggregationStats = nullptr;
+    if (ampduStats)
+    {
+        aggregationStats = CreateObject<AmpduStats>();
+        aggregationStats->AddBss("A", apDevicesA, staDevicesA);
+        aggregationStats->AddBss("B", apDevicesB, staDevicesB);
+        aggregationStats->AddBss("C", apDevicesC, staDevicesC);
+        aggregationStats->AddBss("D", apDevicesD, staDevicesD);
+        aggregationStats->AddBss("E", apDevicesE, staDevicesE);
+        aggregationStats->SetWindow(Seconds(warmUp), Seconds(measureEnd));
+    }
+
+    // Cluster control: sequential k-means on the STA features with a QoS action per cluster
+    Ptr<OnlineClusterController> clusterController = CreateObject<OnlineClusterController>();
+    if (!clusterControl.empty())
+    {
+        std::map<std::string, std::string> actions = {{"Edca", "EdcaAction"},
+                                                      {"Ofdma", "OfdmaAction"},
+                                                      {"Power", "PowerAction"}};
+        clusterController->SetAttribute("EdcaAction", BooleanValue(false));
+        std::istringstream actionList(clusterControl);
+        for (std::string action; std::getline(actionList, action, ',');)
+        {
+            NS_ABORT_MSG_IF(!actions.count(action),
+                            "Invalid cluster action (must be Edca, Ofdma or Power)");
+            clusterController->SetAttribute(actions[action], BooleanValue(true));
+        }
+        NS_ABORT_MSG_IF(clusterControl.find("Power") != std::string::npos && powerControl,
+                        "The Power cluster action and the power control are exclusive");
+        NS_ABORT_MSG_IF(clusterControl.find("Ofdma") != std::string::npos && muScheduler != "Qos",
+                        "The Ofdma cluster action needs the Qos MU scheduler");
+        if (clusterControlStart <= 0)
+        {
+            clusterControlStart = (warmUp + measureEnd) / 2;
+        }
+        clusterController->AddBss("A", apDevicesA, staDevicesA);
+        clusterController->AddBss("B", apDevicesB, staDevicesB);
+        clusterController->AddBss("C", apDevicesC, staDevicesC);
+        clusterController->AddBss("D", apDevicesD, staDevicesD);
+        clusterController->AddBss("E", apDevicesE, staDevicesE);
+        clusterController->EnableCsv("Scenario3-Clusters.csv", seedNumber, runNumber);
+        clusterController->Start(Seconds(warmUp),
+                                 Seconds(clusterControlStart),
+                                 Seconds(measureEnd));
+    }
+
+    // Roaming: RSSI and load triggered handovers of the STAs between the APs of the ESS
+    if (!roaming.empty())
+    {
+        roamingManager->AddBss("A", apDevicesA, staDevicesA);
+        roamingManager->AddBss("B", apDevicesB, staDevicesB);
+        roamingManager->AddBss("C", apDevicesC, staDevicesC);
+        roamingManager->AddBss("D", apDevicesD, staDevicesD);
+        roamingManager->AddBss("E", apDevicesE, staDevicesE);
+        roamingManager->EnableCsv("Scenario3-Handovers.csv", seedNumber, runNumber);
+        roamingManager->Start(Seconds(warmUp), Seconds(measureEnd));
+    }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // APPLICATIONS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Packet pool shared by every VoD source of the simulation
+    Ptr<PacketPool> packetPool = nullptr;
+    if (usePacketPool)
+    {
+        packetPool = CreateObject<PacketPool>();
+        packetPool->SetAttribute("PacketSize", UintegerValue(payloadSize));
+    }
+
     // NETWORK A
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // 1. Traffic type: VoD
@@ -1661,7 +3001,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsA, vodClientApplicationsA;
     ApplicationContainer vodServerApplicationsA1, vodClientApplicationsA1;
     uint16_t portUdp = 5050;
-    uint16_t tosValue = 0xb8;
     size_t numStasA = sizeof(selectedStaA) / sizeof(selectedStaA[0]);
 
     VoDServer(vodServerApplicationsA,
@@ -1673,8 +3012,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA, vodServerApplicationsA, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsA,
+                         vodServerApplicationsA,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsA1,
               vodClientApplicationsA1,
@@ -1685,8 +3028,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA1, vodServerApplicationsA1, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsA1,
+                         vodServerApplicationsA1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1705,8 +3052,9 @@ main(int argc, char* argv[])
                wifiStaNodesA,
                wifiApNodesA,
                selectedStaA2,
-               sizeof(selectedStaA2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsA, httpServerAppsA, simulationTime);
+               sizeof(selectedStaA2) / sizeof(uint32_t),
+               tosHttp);
+    StartStopApplication(httpClientAppsA, httpServerAppsA, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1739,7 +3087,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesA,
                                                    &ftpStaInterfacesA);
     ftpHelperA->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1747,6 +3095,7 @@ main(int argc, char* argv[])
                           sigmaFtp,
                           dataRate);
 
+    ftpHelperA->SetTos(tosFtp);
     ftpHelperA->Start();
     // 4. Traffic type: Gaming
     // 4.1. Random Node Selection
@@ -1789,7 +3138,8 @@ main(int argc, char* argv[])
              wifiApNodesA,
              wifiStaNodesA,
              selectedStaA4,
-             staSizeA);
+             staSizeA,
+             tosGaming);
     GamingUl(portGaming,
              aPacketSizeDl,
              aPacketSizeUl,
@@ -1808,10 +3158,11 @@ main(int argc, char* argv[])
              wifiApNodesA,
              wifiStaNodesA,
              selectedStaA4,
-             staSizeA);
+             staSizeA,
+             tosGaming);
 
-    StartStopApplication(gamingClientsStaA, gamingServersApA, simulationTime);
-    StartStopApplication(gamingClientsApA, gamingServersStaA, simulationTime);
+    StartStopApplication(gamingClientsStaA, gamingServersApA, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApA, gamingServersStaA, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -1845,7 +3196,8 @@ main(int argc, char* argv[])
            wifiApNodesA,
            wifiStaNodesA,
            selectedStaA5,
-           sizeof(selectedStaA5) / sizeof(selectedStaA5[0]));
+           sizeof(selectedStaA5) / sizeof(selectedStaA5[0]),
+           tosVoip);
     VoIPUl(portVoIP,
            encoderFrameLength,
            meanTalkSpurtDuration,
@@ -1860,10 +3212,11 @@ main(int argc, char* argv[])
            wifiApNodesA,
            wifiStaNodesA,
            selectedStaA5,
-           sizeof(selectedStaA5) / sizeof(selectedStaA5[0]));
+           sizeof(selectedStaA5) / sizeof(selectedStaA5[0]),
+           tosVoip);
 
-    StartStopApplication(voIPClientsStaA, voIPServersApA, simulationTime);
-    StartStopApplication(voIPClientsApA, voIPServersStaA, simulationTime);
+    StartStopApplication(voIPClientsStaA, voIPServersApA, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApA, voIPServersStaA, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK B
@@ -1890,7 +3243,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsB, vodClientApplicationsB;
     ApplicationContainer vodServerApplicationsB1, vodClientApplicationsB1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasB = sizeof(selectedStaB) / sizeof(selectedStaB[0]);
 
     VoDServer(vodServerApplicationsB,
@@ -1902,8 +3254,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB, vodServerApplicationsB, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsB,
+                         vodServerApplicationsB,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsB1,
               vodClientApplicationsB1,
@@ -1914,8 +3270,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB1, vodServerApplicationsB1, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsB1,
+                         vodServerApplicationsB1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1934,8 +3294,9 @@ main(int argc, char* argv[])
                wifiStaNodesB,
                wifiApNodesB,
                selectedStaB2,
-               sizeof(selectedStaB2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsB, httpServerAppsB, simulationTime);
+               sizeof(selectedStaB2) / sizeof(uint32_t),
+               tosHttp);
+    StartStopApplication(httpClientAppsB, httpServerAppsB, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1967,13 +3328,14 @@ main(int argc, char* argv[])
                                                    &wifiApNodesB,
                                                    &ftpStaInterfacesB);
     ftpHelperB->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
                           muFtp,
                           sigmaFtp,
                           dataRate);
+    ftpHelperB->SetTos(tosFtp);
     ftpHelperB->Start();
 
     // 4. Traffic type: Gaming
@@ -2007,7 +3369,8 @@ main(int argc, char* argv[])
              wifiApNodesB,
              wifiStaNodesB,
              selectedStaB4,
-             staSizeB);
+             staSizeB,
+             tosGaming);
     GamingUl(portGaming,
              aPacketSizeDl,
              aPacketSizeUl,
@@ -2026,10 +3389,11 @@ main(int argc, char* argv[])
              wifiApNodesB,
              wifiStaNodesB,
              selectedStaB4,
-             staSizeB);
+             staSizeB,
+             tosGaming);
 
-    StartStopApplication(gamingClientsStaB, gamingServersApB, simulationTime);
-    StartStopApplication(gamingClientsApB, gamingServersStaB, simulationTime);
+    StartStopApplication(gamingClientsStaB, gamingServersApB, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApB, gamingServersStaB, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2057,7 +3421,8 @@ main(int argc, char* argv[])
            wifiApNodesB,
            wifiStaNodesB,
            selectedStaB5,
-           sizeof(selectedStaB5) / sizeof(selectedStaB5[0]));
+           sizeof(selectedStaB5) / sizeof(selectedStaB5[0]),
+           tosVoip);
     VoIPUl(portVoIP,
            encoderFrameLength,
            meanTalkSpurtDuration,
@@ -2072,10 +3437,11 @@ main(int argc, char* argv[])
            wifiApNodesB,
            wifiStaNodesB,
            selectedStaB5,
-           sizeof(selectedStaB5) / sizeof(selectedStaB5[0]));
+           sizeof(selectedStaB5) / sizeof(selectedStaB5[0]),
+           tosVoip);
 
-    StartStopApplication(voIPClientsStaB, voIPServersApB, simulationTime);
-    StartStopApplication(voIPClientsApB, voIPServersStaB, simulationTime);
+    StartStopApplication(voIPClientsStaB, voIPServersApB, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApB, voIPServersStaB, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK C
@@ -2102,7 +3468,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsC, vodClientApplicationsC;
     ApplicationContainer vodServerApplicationsC1, vodClientApplicationsC1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasC = sizeof(selectedStaC) / sizeof(selectedStaC[0]);
 
     VoDServer(vodServerApplicationsC,
@@ -2114,8 +3479,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC, vodServerApplicationsC, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsC,
+                         vodServerApplicationsC,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsC1,
               vodClientApplicationsC1,
@@ -2126,8 +3495,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC1, vodServerApplicationsC1, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsC1,
+                         vodServerApplicationsC1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2146,8 +3519,9 @@ main(int argc, char* argv[])
                wifiStaNodesC,
                wifiApNodesC,
                selectedStaC2,
-               sizeof(selectedStaC2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsC, httpServerAppsC, simulationTime);
+               sizeof(selectedStaC2) / sizeof(uint32_t),
+               tosHttp);
+    StartStopApplication(httpClientAppsC, httpServerAppsC, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2179,13 +3553,14 @@ main(int argc, char* argv[])
                                                    &wifiApNodesC,
                                                    &ftpStaInterfacesC);
     ftpHelperC->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
                           muFtp,
                           sigmaFtp,
                           dataRate);
+    ftpHelperC->SetTos(tosFtp);
     ftpHelperC->Start();
 
     // 4. Traffic type: Gaming
@@ -2219,7 +3594,8 @@ main(int argc, char* argv[])
              wifiApNodesC,
              wifiStaNodesC,
              selectedStaC4,
-             staSizeC);
+             staSizeC,
+             tosGaming);
     GamingUl(portGaming,
              aPacketSizeDl,
              aPacketSizeUl,
@@ -2238,10 +3614,11 @@ main(int argc, char* argv[])
              wifiApNodesC,
              wifiStaNodesC,
              selectedStaC4,
-             staSizeC);
+             staSizeC,
+             tosGaming);
 
-    StartStopApplication(gamingClientsStaC, gamingServersApC, simulationTime);
-    StartStopApplication(gamingClientsApC, gamingServersStaC, simulationTime);
+    StartStopApplication(gamingClientsStaC, gamingServersApC, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApC, gamingServersStaC, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2269,7 +3646,8 @@ main(int argc, char* argv[])
            wifiApNodesC,
            wifiStaNodesC,
            selectedStaC5,
-           sizeof(selectedStaC5) / sizeof(selectedStaC5[0]));
+           sizeof(selectedStaC5) / sizeof(selectedStaC5[0]),
+           tosVoip);
     VoIPUl(portVoIP,
            encoderFrameLength,
            meanTalkSpurtDuration,
@@ -2284,10 +3662,11 @@ main(int argc, char* argv[])
            wifiApNodesC,
            wifiStaNodesC,
            selectedStaC5,
-           sizeof(selectedStaC5) / sizeof(selectedStaC5[0]));
+           sizeof(selectedStaC5) / sizeof(selectedStaC5[0]),
+           tosVoip);
 
-    StartStopApplication(voIPClientsStaC, voIPServersApC, simulationTime);
-    StartStopApplication(voIPClientsApC, voIPServersStaC, simulationTime);
+    StartStopApplication(voIPClientsStaC, voIPServersApC, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApC, voIPServersStaC, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK D
@@ -2314,7 +3693,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsD, vodClientApplicationsD;
     ApplicationContainer vodServerApplicationsD1, vodClientApplicationsD1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasD = sizeof(selectedStaD) / sizeof(selectedStaD[0]);
 
     VoDServer(vodServerApplicationsD,
@@ -2326,8 +3704,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD, vodServerApplicationsD, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsD,
+                         vodServerApplicationsD,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsD1,
               vodClientApplicationsD1,
@@ -2338,8 +3720,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD1, vodServerApplicationsD1, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsD1,
+                         vodServerApplicationsD1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2358,8 +3744,9 @@ main(int argc, char* argv[])
                wifiStaNodesD,
                wifiApNodesD,
                selectedStaD2,
-               sizeof(selectedStaD2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsD, httpServerAppsD, simulationTime);
+               sizeof(selectedStaD2) / sizeof(uint32_t),
+               tosHttp);
+    StartStopApplication(httpClientAppsD, httpServerAppsD, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2391,13 +3778,14 @@ main(int argc, char* argv[])
                                                    &wifiApNodesD,
                                                    &ftpStaInterfacesD);
     ftpHelperD->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
                           muFtp,
                           sigmaFtp,
                           dataRate);
+    ftpHelperD->SetTos(tosFtp);
     ftpHelperD->Start();
 
     // 4. Traffic type: Gaming
@@ -2431,7 +3819,8 @@ main(int argc, char* argv[])
              wifiApNodesD,
              wifiStaNodesD,
              selectedStaD4,
-             staSizeD);
+             staSizeD,
+             tosGaming);
     GamingUl(portGaming,
              aPacketSizeDl,
              aPacketSizeUl,
@@ -2450,10 +3839,11 @@ main(int argc, char* argv[])
              wifiApNodesD,
              wifiStaNodesD,
              selectedStaD4,
-             staSizeD);
+             staSizeD,
+             tosGaming);
 
-    StartStopApplication(gamingClientsStaD, gamingServersApD, simulationTime);
-    StartStopApplication(gamingClientsApD, gamingServersStaD, simulationTime);
+    StartStopApplication(gamingClientsStaD, gamingServersApD, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApD, gamingServersStaD, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2481,7 +3871,8 @@ main(int argc, char* argv[])
            wifiApNodesD,
            wifiStaNodesD,
            selectedStaD5,
-           sizeof(selectedStaD5) / sizeof(selectedStaD5[0]));
+           sizeof(selectedStaD5) / sizeof(selectedStaD5[0]),
+           tosVoip);
     VoIPUl(portVoIP,
            encoderFrameLength,
            meanTalkSpurtDuration,
@@ -2496,10 +3887,11 @@ main(int argc, char* argv[])
            wifiApNodesD,
            wifiStaNodesD,
            selectedStaD5,
-           sizeof(selectedStaD5) / sizeof(selectedStaD5[0]));
+           sizeof(selectedStaD5) / sizeof(selectedStaD5[0]),
+           tosVoip);
 
-    StartStopApplication(voIPClientsStaD, voIPServersApD, simulationTime);
-    StartStopApplication(voIPClientsApD, voIPServersStaD, simulationTime);
+    StartStopApplication(voIPClientsStaD, voIPServersApD, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApD, voIPServersStaD, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK E
@@ -2526,7 +3918,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsE, vodClientApplicationsE;
     ApplicationContainer vodServerApplicationsE1, vodClientApplicationsE1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasE = sizeof(selectedStaE) / sizeof(selectedStaE[0]);
 
     VoDServer(vodServerApplicationsE,
@@ -2538,8 +3929,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsE, vodServerApplicationsE, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsE,
+                         vodServerApplicationsE,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsE1,
               vodClientApplicationsE1,
@@ -2550,8 +3945,12 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsE1, vodServerApplicationsE1, simulationTime);
+              tosVod,
+              packetPool);
+    StartStopApplication(vodClientApplicationsE1,
+                         vodServerApplicationsE1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2570,8 +3969,9 @@ main(int argc, char* argv[])
                wifiStaNodesE,
                wifiApNodesE,
                selectedStaE2,
-               sizeof(selectedStaE2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsE, httpServerAppsE, simulationTime);
+               sizeof(selectedStaE2) / sizeof(uint32_t),
+               tosHttp);
+    StartStopApplication(httpClientAppsE, httpServerAppsE, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2603,13 +4003,14 @@ main(int argc, char* argv[])
                                                    &wifiApNodesE,
                                                    &ftpStaInterfacesE);
     ftpHelperE->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
                           muFtp,
                           sigmaFtpE,
                           dataRate);
+    ftpHelperE->SetTos(tosFtp);
     ftpHelperE->Start();
 
     // 4. Traffic type: Gaming
@@ -2643,7 +4044,8 @@ main(int argc, char* argv[])
              wifiApNodesE,
              wifiStaNodesE,
              selectedStaE4,
-             staSizeE);
+             staSizeE,
+             tosGaming);
     GamingUl(portGaming,
              aPacketSizeDl,
              aPacketSizeUl,
@@ -2662,10 +4064,11 @@ main(int argc, char* argv[])
              wifiApNodesE,
              wifiStaNodesE,
              selectedStaE4,
-             staSizeE);
+             staSizeE,
+             tosGaming);
 
-    StartStopApplication(gamingClientsStaE, gamingServersApE, simulationTime);
-    StartStopApplication(gamingClientsApE, gamingServersStaE, simulationTime);
+    StartStopApplication(gamingClientsStaE, gamingServersApE, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApE, gamingServersStaE, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2693,7 +4096,8 @@ main(int argc, char* argv[])
            wifiApNodesE,
            wifiStaNodesE,
            selectedStaE5,
-           sizeof(selectedStaE5) / sizeof(selectedStaE5[0]));
+           sizeof(selectedStaE5) / sizeof(selectedStaE5[0]),
+           tosVoip);
     VoIPUl(portVoIP,
            encoderFrameLength,
            meanTalkSpurtDuration,
@@ -2708,10 +4112,11 @@ main(int argc, char* argv[])
            wifiApNodesE,
            wifiStaNodesE,
            selectedStaE5,
-           sizeof(selectedStaE5) / sizeof(selectedStaE5[0]));
+           sizeof(selectedStaE5) / sizeof(selectedStaE5[0]),
+           tosVoip);
 
-    StartStopApplication(voIPClientsStaE, voIPServersApE, simulationTime);
-    StartStopApplication(voIPClientsApE, voIPServersStaE, simulationTime);
+    StartStopApplication(voIPClientsStaE, voIPServersApE, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApE, voIPServersStaE, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MONITORING
@@ -2800,10 +4205,78 @@ main(int argc, char* argv[])
         g_samplesSta[4] = 0;
     }
 
+    // VoD payload generation rate (PooledOnOffApplication is an OnOffApplication)
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::OnOffApplication/Tx",
+                                  MakeCallback(&VoDTxTrace));
+
+    // OFDMA scheduling: tighter latency budget for the STAs with VoIP and gaming flows
+    if (muScheduler == "Qos")
+    {
+        // Devices of a BSS and its STAs selected for gaming (4) and VoIP (5) flows
+        struct LatencySensitiveStas
+        {
+            NetDeviceContainer apDevices;
+            NetDeviceContainer staDevices;
+            uint32_t* gamingStas;
+            size_t nGamingStas;
+            uint32_t* voipStas;
+            size_t nVoipStas;
+        };
+
+        std::vector<LatencySensitiveStas> latencySensitiveStas = {
+            {apDevicesA,
+             staDevicesA,
+             selectedStaA4,
+             sizeof(selectedStaA4) / sizeof(selectedStaA4[0]),
+             selectedStaA5,
+             sizeof(selectedStaA5) / sizeof(selectedStaA5[0])},
+            {apDevicesB,
+             staDevicesB,
+             selectedStaB4,
+             sizeof(selectedStaB4) / sizeof(selectedStaB4[0]),
+             selectedStaB5,
+             sizeof(selectedStaB5) / sizeof(selectedStaB5[0])},
+            {apDevicesC,
+             staDevicesC,
+             selectedStaC4,
+             sizeof(selectedStaC4) / sizeof(selectedStaC4[0]),
+             selectedStaC5,
+             sizeof(selectedStaC5) / sizeof(selectedStaC5[0])},
+            {apDevicesD,
+             staDevicesD,
+             selectedStaD4,
+             sizeof(selectedStaD4) / sizeof(selectedStaD4[0]),
+             selectedStaD5,
+             sizeof(selectedStaD5) / sizeof(selectedStaD5[0])},
+            {apDevicesE,
+             staDevicesE,
+             selectedStaE4,
+             sizeof(selectedStaE4) / sizeof(selectedStaE4[0]),
+             selectedStaE5,
+             sizeof(selectedStaE5) / sizeof(selectedStaE5[0])}};
+
+        for (const auto& bss : latencySensitiveStas)
+        {
+            SetStaLatencyBudget(bss.apDevices,
+                                bss.staDevices,
+                                bss.gamingStas,
+                                bss.nGamingStas,
+                                MilliSeconds(gamingLatencyBudget));
+            SetStaLatencyBudget(bss.apDevices,
+                                bss.staDevices,
+                                bss.voipStas,
+                                bss.nVoipStas,
+                                MilliSeconds(voipLatencyBudget));
+        }
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // FLOW MONITOR
     FlowMonitorHelper flowmonHelper;
     Ptr<FlowMonitor> monitor = flowmonHelper.InstallAll();
+    // Only the packets sent within the measurement window are accounted
+    monitor->Start(Seconds(warmUp));
+    monitor->Stop(Seconds(measureEnd));
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOVEMENT MONITOR
     // Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
@@ -2813,7 +4286,53 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     NS_LOG_INFO("Running simulation...");
     Simulator::Stop(Seconds(simulationTime + 1));
+    auto wallClockStart = std::chrono::steady_clock::now();
     Simulator::Run();
+    std::chrono::duration<double> wallClockRun = std::chrono::steady_clock::now() - wallClockStart;
+    if (preAssociate)
+    {
+        fastStart->Report(Seconds(appStartTime));
+    }
+    if (powerControl)
+    {
+        powerControlManager->Report();
+    }
+    if (!clusterControl.empty())
+    {
+        clusterController->Report();
+    }
+    if (!roaming.empty())
+    {
+        roamingManager->Report();
+        roamingManager->WriteLoadCsv("Scenario3-ApLoad.csv", seedNumber, runNumber);
+    }
+    if (mcsHistogram)
+    {
+        mcsHistogram->WriteCsv("Scenario3-McsHistogram.csv", seedNumber, runNumber);
+    }
+    if (mloLinkStats)
+    {
+        if (mlo)
+        {
+            mloLinkStats->Report();
+        }
+        mloLinkStats->WriteCsv("Scenario3-Links.csv", seedNumber, runNumber);
+    }
+    if (macQueueStats)
+    {
+        macQueueStats->WriteCsv("Scenario3-MacQueue.csv", seedNumber, runNumber);
+        macQueueStats->WriteHistogramCsv("Scenario3-MacQueueHistogram.csv", seedNumber, runNumber);
+    }
+    if (aggregationStats)
+    {
+        aggregationStats->WriteCsv("Scenario3-Ampdu.csv", seedNumber, runNumber);
+        aggregationStats->WriteHistogramCsv("Scenario3-AmpduHistogram.csv", seedNumber, runNumber);
+    }
+    if (radioMap)
+    {
+        std::cout << "Radio map: " << radioMap->GetNLookups() << " lookups, "
+                  << radioMap->GetNFallbacks() << " out of the map" << std::endl;
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // RESULT CALCULATION
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2825,6 +4344,12 @@ main(int argc, char* argv[])
     Ptr<Ipv4FlowClassifier> classifier =
         DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
     FlowMonitor::FlowStatsContainer stats = monitor->GetFlowStats();
+    WriteClassDelayPercentiles(stats,
+                               classifier,
+                               "Scenario3-ClassDelay.csv",
+                               seedNumber,
+                               runNumber,
+                               dlAckSeqType == "NO-OFDMA" ? "SU" : muScheduler);
 
     double averageFlowThroughput = 0.0;
     double averageFlowDelay = 0.0;
@@ -2891,13 +4416,12 @@ main(int argc, char* argv[])
 
         flowTxPackets[flowIndex] = i->second.txPackets;
         flowTxBytes[flowIndex] = i->second.txBytes;
-        flowTxOffered[flowIndex] =
-            i->second.txBytes * 8.0 / (simulationTime - 1.0) / 1000.0 / 1000.0;
+        flowTxOffered[flowIndex] = i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
 
         if (i->second.rxPackets > 0)
         {
-            double rxDuration =
-                i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds();
+            // Same time base for every flow: the measurement window
+            double rxDuration = measureDuration;
 
             averageFlowThroughput += i->second.rxBytes * 8.0 / rxDuration / 1000 / 1000;
             averageFlowDelay += 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets;
@@ -2954,7 +4478,7 @@ main(int argc, char* argv[])
             pos = std::stoi(matchNode[1].str()) + nStaA + nStaB + nStaC + nStaD + 3 * nAp;
         }
 
-        avgThroughput[pos] += i->second.txBytes * 8.0 / (simulationTime - 1) / 1000.0 / 1000.0;
+        avgThroughput[pos] += i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
         avgDelay[pos] += (i->second.delaySum);
         avgJitter[pos] += (i->second.jitterSum);
         avgtxPackets[pos] += (i->second.txPackets);
@@ -2983,7 +4507,9 @@ main(int argc, char* argv[])
     // Address" << "," << "MCS value" << "," << "Channel width (MHz)" << "," << "GI (ns)" << "," <<
     // "Avg Throughput (Mbit/s)" << "," << "Avg Tx Bytes" << "," << "Avg Tx Packets" << "," << "Avg
     // Rx Bytes" << "," << "Avg Rx Packets" << "," << "Avg Total Delay"<< "," << "Avg Total Jitter"
-    // << "," << "Signal (dBm)" << "," << "Noise (dBm)" << "," << "SNR (dB)" << '\n';
+    // << "," << "Signal (dBm)" << "," << "Noise (dBm)" << "," << "SNR (dB)" << "," << "Tx
+    // Airtime" << "," << "Rx Airtime" << "," << "CCA Busy" << "," << "Idle" << "," << "BSS
+    // Airtime" << "," << "BSS Channel Busy" << '\n';
 
     NodeContainer nodes;
     nodes.Add(wifiStaNodesA);
@@ -3053,54 +4579,62 @@ main(int argc, char* argv[])
         if (i < nStaA)
         {
             std::cout << g_signalDbmAvgSta[0] << "," << g_noiseDbmAvgSta[0] << ","
-                      << (g_signalDbmAvgSta[0] - g_noiseDbmAvgSta[0]) << std::endl;
+                      << (g_signalDbmAvgSta[0] - g_noiseDbmAvgSta[0]) << ",";
         }
         else if (i == nStaA)
         {
             std::cout << g_signalDbmAvg[0] << "," << g_noiseDbmAvg[0] << ","
-                      << (g_signalDbmAvg[0] - g_noiseDbmAvg[0]) << std::endl;
+                      << (g_signalDbmAvg[0] - g_noiseDbmAvg[0]) << ",";
         }
         else if (i > nStaA && i < nStaA + nStaB + nAp)
         {
             std::cout << g_signalDbmAvgSta[1] << "," << g_noiseDbmAvgSta[1] << ","
-                      << (g_signalDbmAvgSta[1] - g_noiseDbmAvgSta[1]) << std::endl;
+                      << (g_signalDbmAvgSta[1] - g_noiseDbmAvgSta[1]) << ",";
         }
         else if (i == nStaA + nStaB + nAp)
         {
             std::cout << g_signalDbmAvg[1] << "," << g_noiseDbmAvg[1] << ","
-                      << (g_signalDbmAvg[1] - g_noiseDbmAvg[1]) << std::endl;
+                      << (g_signalDbmAvg[1] - g_noiseDbmAvg[1]) << ",";
         }
         else if (i > nStaA + nStaB + nAp && i < nStaA + nStaB + nStaC + 2 * nAp)
         {
             std::cout << g_signalDbmAvgSta[2] << "," << g_noiseDbmAvgSta[2] << ","
-                      << (g_signalDbmAvgSta[2] - g_noiseDbmAvgSta[2]) << std::endl;
+                      << (g_signalDbmAvgSta[2] - g_noiseDbmAvgSta[2]) << ",";
         }
         else if (i == nStaA + nStaB + nStaC + 2 * nAp)
         {
             std::cout << g_signalDbmAvg[2] << "," << g_noiseDbmAvg[2] << ","
-                      << (g_signalDbmAvg[2] - g_noiseDbmAvg[2]) << std::endl;
+                      << (g_signalDbmAvg[2] - g_noiseDbmAvg[2]) << ",";
         }
         else if (i > nStaA + nStaB + nStaC + 2 * nAp && i < nStaA + nStaB + nStaC + nStaD + 3 * nAp)
         {
             std::cout << g_signalDbmAvgSta[3] << "," << g_noiseDbmAvgSta[3] << ","
-                      << (g_signalDbmAvgSta[3] - g_noiseDbmAvgSta[3]) << std::endl;
+                      << (g_signalDbmAvgSta[3] - g_noiseDbmAvgSta[3]) << ",";
         }
         else if (i == nStaA + nStaB + nStaC + nStaD + 3 * nAp)
         {
             std::cout << g_signalDbmAvg[3] << "," << g_noiseDbmAvg[3] << ","
-                      << (g_signalDbmAvg[3] - g_noiseDbmAvg[3]) << std::endl;
+                      << (g_signalDbmAvg[3] - g_noiseDbmAvg[3]) << ",";
         }
         else if (i > nStaA + nStaB + nStaC + nStaD + 3 * nAp &&
                  i < nStaA + nStaB + nStaC + nStaD + nStaE + 4 * nAp)
         {
             std::cout << g_signalDbmAvgSta[4] << "," << g_noiseDbmAvgSta[4] << ","
-                      << (g_signalDbmAvgSta[4] - g_noiseDbmAvgSta[4]) << std::endl;
+                      << (g_signalDbmAvgSta[4] - g_noiseDbmAvgSta[4]) << ",";
         }
         else
         {
             std::cout << g_signalDbmAvg[4] << "," << g_noiseDbmAvg[4] << ","
-                      << (g_signalDbmAvg[4] - g_noiseDbmAvg[4]) << std::endl;
+                      << (g_signalDbmAvg[4] - g_noiseDbmAvg[4]) << ",";
         }
+
+        // Airtime of the device and of its BSS (fractions of the measurement window)
+        AirtimeAccountant::Occupancy deviceAirtime =
+            airtime->GetDeviceOccupancy(nodes.Get(i)->GetId());
+        AirtimeAccountant::Occupancy bssAirtime = airtime->GetBssOccupancy(nodes.Get(i)->GetId());
+        std::cout << deviceAirtime.tx << "," << deviceAirtime.rx << "," << deviceAirtime.ccaBusy
+                  << "," << deviceAirtime.idle << "," << bssAirtime.tx << "," << bssAirtime.busy
+                  << std::endl;
     }
     fclose(stdout);
 
@@ -3214,5 +4748,20 @@ main(int argc, char* argv[])
                   << flowMeanDelay[flowIndex] << "," << flowLastDelay[flowIndex] << ","
                   << flowMeanJitter[flowIndex] << "\n";
     }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Benchmark File
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Seed, Run, Packet pool, Wall-clock run time (s), VoD packets, Payload allocations,
+    // Recycled payloads, Allocation rate (allocations per simulated second), PHY model, MAC stats
+    uint64_t payloadAllocations = packetPool ? packetPool->GetNAllocated() : g_vodTxPackets;
+    std::ofstream benchmarkFile("Scenario3-Benchmark.csv", std::ios::app);
+    benchmarkFile << seedNumber << "," << runNumber << "," << usePacketPool << ","
+                  << wallClockRun.count() << "," << g_vodTxPackets << "," << payloadAllocations
+                  << "," << (packetPool ? packetPool->GetNRecycled() : 0) << ","
+                  << payloadAllocations / static_cast<double>(simulationTime + 1) << ","
+                  << phyModel << "," << macStats << "\n";
+    benchmarkFile.close();
+
     return 0;
 }
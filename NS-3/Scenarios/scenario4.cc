@@ -22,6 +22,7 @@
 #include "ns3/mobility-helper.h"
 #include "ns3/mobility-module.h"
 #include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/neighbor-cache-helper.h"
 #include "ns3/network-module.h"
 #include "ns3/on-off-helper.h"
 #include "ns3/packet-sink-helper.h"
@@ -36,6 +37,8 @@
 #include "ns3/uinteger.h"
 #include "ns3/wifi-acknowledgment.h"
 #include "ns3/wifi-tx-vector.h"
+#include <ns3/fast-start-helper.h>
+#include <ns3/multi-wall-propagation-loss-model.h>
 #include <ns3/spectrum-helper.h>
 #include <ns3/three-gpp-ftp-m2-helper.h>
 #include <ns3/traffic-generator-ngmn-gaming.h>
@@ -61,6 +64,19 @@ double g_signalDbmAvgSta[5];
 double g_noiseDbmAvgSta[5];
 uint32_t g_samplesSta[5];
 
+// Measurement window (seconds): samples outside [g_warmUp, g_measureEnd] are discarded
+double g_warmUp = 1.0;
+double g_measureEnd = 0.0;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Measurement window
+bool
+InMeasurementWindow()
+{
+    double now = Simulator::Now().GetSeconds();
+    return now >= g_warmUp && now <= g_measureEnd;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 // Monitor for APs
 void
@@ -73,6 +89,11 @@ MonitorSniffRxCommon(Ptr<const Packet> packet,
                      uint8_t groupIndex,
                      bool isStaVersion)
 {
+    if (!InMeasurementWindow())
+    {
+        return;
+    }
+
     if (isStaVersion)
     {
         g_samplesSta[groupIndex]++;
@@ -368,6 +389,7 @@ ConfigureWifiNetwork(uint32_t seedNumber,
                      Time accessReqInterval,
                      Ssid ssid,
                      uint32_t staGroupIndex,
+                     Ptr<PropagationLossModel> buildingLossModel,
                      NodeContainer wifiStaNodes,
                      NodeContainer wifiApNodes,
                      NetDeviceContainer& staDevices,
@@ -381,9 +403,14 @@ ConfigureWifiNetwork(uint32_t seedNumber,
     std::cout << "SSID: " << ssid << std::endl;
     std::cout << "Channel Info: " << channelStr << std::endl;
 
-    // Propagation
+    // Propagation: the helper chains each loss model before the previous ones, so the building
+    // penetration loss ends the chain after the distance loss and one instance serves every BSS
     channelHelper.SetChannel("ns3::MultiModelSpectrumChannel");
     channelHelper.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+    if (buildingLossModel)
+    {
+        channelHelper.AddPropagationLoss(buildingLossModel);
+    }
     channelHelper.AddPropagationLoss("ns3::LogDistancePropagationLossModel");
 
     // Station state and data/control traffic generation management
@@ -488,6 +515,34 @@ ConfigureWifiNetwork(uint32_t seedNumber,
     streamNumber += wifi.AssignStreams(staDevices, streamNumber);
 }
 
+// Regular building over the place: interior walls alternately across x and y, evenly spaced
+// (the first two split the four outer BSSs), and one floor slab between consecutive storeys
+void
+AddRegularBuilding(Ptr<MultiWallPropagationLossModel> buildingLossModel,
+                   uint32_t nWalls,
+                   uint32_t nFloors,
+                   double floorHeight,
+                   double xLength,
+                   double yLength)
+{
+    uint32_t nWallsX = (nWalls + 1) / 2;
+    uint32_t nWallsY = nWalls / 2;
+    for (uint32_t i = 1; i <= nWallsX; i++)
+    {
+        double x = i * xLength / (nWallsX + 1);
+        buildingLossModel->AddWall(Vector(x, 0, 0), Vector(x, yLength, 0));
+    }
+    for (uint32_t i = 1; i <= nWallsY; i++)
+    {
+        double y = i * yLength / (nWallsY + 1);
+        buildingLossModel->AddWall(Vector(0, y, 0), Vector(xLength, y, 0));
+    }
+    for (uint32_t i = 1; i < nFloors; i++)
+    {
+        buildingLossModel->AddFloor(i * floorHeight);
+    }
+}
+
 double
 getUniformRandomValue(double minVal, double maxVal)
 {
@@ -609,11 +664,12 @@ VoDServer(ApplicationContainer& vodServerApplications,
 void
 StartStopApplication(ApplicationContainer& clientApplications,
                      ApplicationContainer& serverApplications,
+                     const double appStartTime,
                      const double simulationTime)
 {
-    clientApplications.Start(Seconds(0.0));
+    clientApplications.Start(Seconds(appStartTime));
     clientApplications.Stop(Seconds(simulationTime));
-    serverApplications.Start(Seconds(0.0));
+    serverApplications.Start(Seconds(appStartTime));
     serverApplications.Stop(Seconds(simulationTime));
 }
 
@@ -912,6 +968,8 @@ main(int argc, char* argv[])
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Simulation basic parameters
     uint32_t simulationTime = 10; // Simulation duration in seconds
+    double warmUp = 1.0;          // Start of the measurement window (seconds)
+    double measureEnd = 0.0;      // End of the measurement window (seconds, 0: simulationTime)
     uint32_t seedNumber = 1;      // RNG seed
     uint32_t runNumber = 1;       // Run number
 
@@ -929,9 +987,9 @@ main(int argc, char* argv[])
     uint32_t nAp = 1;      // Number of APs
 
     // Physical aspects of the environment
-    double distance = 1; // Meters
-    double nFloors = 1;  // Propagation loss object
-    double nWalls = 2;   // Propagation loss object
+    double distance = 1;  // Meters
+    uint32_t nFloors = 1; // Storeys of the building (building propagation)
+    uint32_t nWalls = 2;  // Interior walls of the building (building propagation)
     double minXsize = 7.0;
     double maxXSize = 14.0;
     double minYsize = 7.0;
@@ -941,6 +999,13 @@ main(int argc, char* argv[])
     double minZSizeAp = 2.0;
     double maxZSizeAp = 10.0;
 
+    // Building propagation
+    bool building = false;         // Wall and floor penetration loss on top of the distance loss
+    std::string buildingFile = ""; // Building description; empty: nWalls walls and nFloors storeys
+    double wallLoss = 5;           // Penetration loss of a wall (dB)
+    double floorLoss = 18.3;       // Penetration loss of a floor (dB)
+    double floorHeight = 3;        // Storey height (m)
+
     // Transmission Configuration
     double txPowerAp = 30;     // Max TX Power for APs
     double txPowerSta = 15;    // Max TX Power for STAs
@@ -984,6 +1049,10 @@ main(int argc, char* argv[])
     uint32_t payloadSize =
         1448; // Must fit in the max TX duration when transmitting at MCS 0 over an RU of 26 tones
     uint32_t dataRate = 100000000; // Data Rate (bps)
+    bool staticArp = false;        // Fill ARP caches after addressing (no ARP at start-up)
+    bool preAssociate = false;     // Associate every STA before the applications start
+    double fastStartTime = 0.1;    // Application start time with pre-association (seconds)
+    bool primeBlockAck = false;    // Set up BA agreements before the applications start
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // PARAMETERS FROM COMMAND LINE
@@ -992,6 +1061,13 @@ main(int argc, char* argv[])
 
     // Simulation basic parameters
     cmd.AddValue("simulationTime", "Simulation time (seconds)", simulationTime);
+    cmd.AddValue("warmUp",
+                 "Start of the measurement window (seconds): traffic and samples before it "
+                 "are not accounted",
+                 warmUp);
+    cmd.AddValue("measureEnd",
+                 "End of the measurement window (seconds, 0 for the end of the simulation)",
+                 measureEnd);
     cmd.AddValue("seedNumber", "RNG seed number", seedNumber);
     cmd.AddValue("runNumber", "Simulation run number", runNumber);
 
@@ -1017,6 +1093,24 @@ main(int argc, char* argv[])
     cmd.AddValue("maxYSize", "Upper bound for Y size of place definition", maxYSize);
     cmd.AddValue("minZSize", "Lower bound for Z size of place definition", minZSize);
     cmd.AddValue("maxZSize", "Upper bound for Z size of place definition", maxZSize);
+    cmd.AddValue("nFloors", "Storeys of the building (building propagation)", nFloors);
+    cmd.AddValue("nWalls",
+                 "Interior walls of the building, alternately across x and y (building "
+                 "propagation)",
+                 nWalls);
+
+    // Building propagation
+    cmd.AddValue("building",
+                 "Add the COST 231 multi-wall/multi-floor penetration loss of the building to the "
+                 "distance loss",
+                 building);
+    cmd.AddValue("buildingFile",
+                 "Building description, one element per line: wall,x1,y1,x2,y2[,loss] or "
+                 "floor,z[,loss] (empty: regular building of nWalls and nFloors)",
+                 buildingFile);
+    cmd.AddValue("wallLoss", "Penetration loss of a wall (dB)", wallLoss);
+    cmd.AddValue("floorLoss", "Penetration loss of a floor (dB)", floorLoss);
+    cmd.AddValue("floorHeight", "Storey height of the regular building (m)", floorHeight);
 
     // Transmission Configuration
     cmd.AddValue("txPowerAp", "AP transmission power in dBm", txPowerAp);
@@ -1066,9 +1160,35 @@ main(int argc, char* argv[])
                  useExtendedBlockAck);
     cmd.AddValue("payloadSize", "The application payload size in bytes", payloadSize);
     cmd.AddValue("dataRate", "Data rate (bps)", dataRate);
+    cmd.AddValue("staticArp",
+                 "Fast start: pre-populate the ARP caches of every node after address assignment",
+                 staticArp);
+    cmd.AddValue("preAssociate",
+                 "Fast start: immediate active probing association, applications start at "
+                 "fastStartTime",
+                 preAssociate);
+    cmd.AddValue("fastStartTime",
+                 "Application start time (seconds) when preAssociate is enabled",
+                 fastStartTime);
+    cmd.AddValue("primeBlockAck",
+                 "Fast start: establish BA agreements before the applications start "
+                 "(requires preAssociate)",
+                 primeBlockAck);
 
     cmd.Parse(argc, argv);
 
+    // Measurement window: every KPI is computed over [warmUp, measureEnd]
+    if (measureEnd <= 0.0)
+    {
+        measureEnd = simulationTime;
+    }
+    NS_ABORT_MSG_IF(warmUp < 0.0 || warmUp >= measureEnd || measureEnd > simulationTime,
+                    "The measurement window must satisfy 0 <= warmUp < measureEnd <= "
+                    "simulationTime");
+    g_warmUp = warmUp;
+    g_measureEnd = measureEnd;
+    double measureDuration = measureEnd - warmUp;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // ENVIRONMET SETTINGS - FIXING AND ARRANGEMENTS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1078,6 +1198,15 @@ main(int argc, char* argv[])
         Config::SetDefault("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue("0"));
     }
 
+    // Fast start: STAs probe and associate right away instead of waiting for beacons
+    if (preAssociate)
+    {
+        NS_ABORT_MSG_IF(fastStartTime <= 0.0 || fastStartTime >= simulationTime,
+                        "fastStartTime must be within the simulation time");
+        NS_ABORT_MSG_IF(warmUp < fastStartTime, "warmUp must cover the fast start phase");
+        FastStartHelper::ConfigureDefaults();
+    }
+
     // Set + check type of acknowledgment sequence
     if (dlAckSeqType == "ACK-SU-FORMAT")
     {
@@ -1179,6 +1308,15 @@ main(int argc, char* argv[])
     // Mac Helper
     WifiMacHelper mac;
 
+    // Building propagation: the walls and floors are added once the place is sized
+    Ptr<MultiWallPropagationLossModel> buildingLoss = nullptr;
+    if (building)
+    {
+        buildingLoss = CreateObject<MultiWallPropagationLossModel>();
+        buildingLoss->SetAttribute("WallLoss", DoubleValue(wallLoss));
+        buildingLoss->SetAttribute("FloorLoss", DoubleValue(floorLoss));
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK CONFIGURATION: PHY + MAC
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1215,6 +1353,7 @@ main(int argc, char* argv[])
                              accessReqInterval,
                              ssid,
                              0,
+                             buildingLoss,
                              wifiStaNodesA,
                              wifiApNodesA,
                              staDevicesA,
@@ -1254,6 +1393,7 @@ main(int argc, char* argv[])
                              accessReqInterval,
                              ssid,
                              0,
+                             buildingLoss,
                              wifiStaNodesB,
                              wifiApNodesB,
                              staDevicesB,
@@ -1293,6 +1433,7 @@ main(int argc, char* argv[])
                              accessReqInterval,
                              ssid,
                              0,
+                             buildingLoss,
                              wifiStaNodesC,
                              wifiApNodesC,
                              staDevicesC,
@@ -1332,6 +1473,7 @@ main(int argc, char* argv[])
                              accessReqInterval,
                              ssid,
                              0,
+                             buildingLoss,
                              wifiStaNodesD,
                              wifiApNodesD,
                              staDevicesD,
@@ -1371,12 +1513,24 @@ main(int argc, char* argv[])
                              accessReqInterval,
                              ssid,
                              0,
+                             buildingLoss,
                              wifiStaNodesE,
                              wifiApNodesE,
                              staDevicesE,
                              apDevicesE);
     }
 
+    // Fast start: association tracking
+    Ptr<FastStartHelper> fastStart = CreateObject<FastStartHelper>();
+    if (preAssociate)
+    {
+        fastStart->Install(staDevicesA);
+        fastStart->Install(staDevicesB);
+        fastStart->Install(staDevicesC);
+        fastStart->Install(staDevicesD);
+        fastStart->Install(staDevicesE);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOBILITY
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1396,6 +1550,20 @@ main(int argc, char* argv[])
     double zSize = getUniformRandomValue(minZSize, maxZSize);
     double zSizeAp = getUniformRandomValue(minZSizeAp, maxZSizeAp);
 
+    if (building)
+    {
+        if (buildingFile.empty())
+        {
+            AddRegularBuilding(buildingLoss, nWalls, nFloors, floorHeight, xSize4, ySize4);
+        }
+        else
+        {
+            buildingLoss->LoadBuilding(buildingFile);
+        }
+        std::cout << "Building: " << buildingLoss->GetNWalls() << " walls, "
+                  << buildingLoss->GetNFloors() << " floors" << std::endl;
+    }
+
     // STA - Dynamic configuration: Random Walk
     mobility.SetPositionAllocator("ns3::UniformDiscPositionAllocator",
                                   "rho",
@@ -1599,6 +1767,42 @@ main(int argc, char* argv[])
     staNodeInterfacesE = address.Assign(staDevicesE);
     apNodeInterfacesE = address.Assign(apDevicesE);
 
+    // Fast start: every STA and AP already knows the MAC address of its BSS neighbours,
+    // so applications starting at t=0 do not trigger the ARP resolution storm
+    if (staticArp)
+    {
+        NeighborCacheHelper neighborCache;
+        neighborCache.PopulateNeighborCache(staNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesA);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesB);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesC);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesD);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesD);
+        neighborCache.PopulateNeighborCache(staNodeInterfacesE);
+        neighborCache.PopulateNeighborCache(apNodeInterfacesE);
+    }
+
+    // Traffic classes: ToS of every class (the wifi UP is the three upper bits of the ToS)
+    uint8_t tosVod = 0xb8;    // UP 5, AC_VI
+    uint8_t tosOthers = 0x00; // UP 0, AC_BE (VoIP, gaming, HTTP and FTP flows)
+
+    // Fast start: one datagram per direction, STA and ToS of the traffic classes sets up the BA
+    // agreements before the applications start (they are otherwise negotiated with measured
+    // traffic)
+    double appStartTime = preAssociate ? fastStartTime : 0.0;
+    if (preAssociate && primeBlockAck)
+    {
+        std::vector<uint8_t> primeTos = {tosVod, tosOthers};
+        Time primeTime = Seconds(0.6 * appStartTime);
+        fastStart->PrimeBlockAck(wifiApNodesA, wifiStaNodesA, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesB, wifiStaNodesB, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesC, wifiStaNodesC, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesD, wifiStaNodesD, primeTos, primeTime);
+        fastStart->PrimeBlockAck(wifiApNodesE, wifiStaNodesE, primeTos, primeTime);
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // APPLICATIONS
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1626,7 +1830,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsA, vodClientApplicationsA;
     ApplicationContainer vodServerApplicationsA1, vodClientApplicationsA1;
     uint16_t portUdp = 5050;
-    uint16_t tosValue = 0xb8;
     size_t numStasA = sizeof(selectedStaA) / sizeof(selectedStaA[0]);
 
     VoDServer(vodServerApplicationsA,
@@ -1638,8 +1841,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA, vodServerApplicationsA, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsA,
+                         vodServerApplicationsA,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsA1,
               vodClientApplicationsA1,
@@ -1650,8 +1856,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsA1, vodServerApplicationsA1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsA1,
+                         vodServerApplicationsA1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1671,7 +1880,7 @@ main(int argc, char* argv[])
                wifiApNodesA,
                selectedStaA2,
                sizeof(selectedStaA2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsA, httpServerAppsA, simulationTime);
+    StartStopApplication(httpClientAppsA, httpServerAppsA, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1704,7 +1913,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesA,
                                                    &ftpStaInterfacesA);
     ftpHelperA->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1776,8 +1985,8 @@ main(int argc, char* argv[])
              selectedStaA4,
              staSizeA);
 
-    StartStopApplication(gamingClientsStaA, gamingServersApA, simulationTime);
-    StartStopApplication(gamingClientsApA, gamingServersStaA, simulationTime);
+    StartStopApplication(gamingClientsStaA, gamingServersApA, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApA, gamingServersStaA, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -1828,8 +2037,8 @@ main(int argc, char* argv[])
            selectedStaA5,
            sizeof(selectedStaA5) / sizeof(selectedStaA5[0]));
 
-    StartStopApplication(voIPClientsStaA, voIPServersApA, simulationTime);
-    StartStopApplication(voIPClientsApA, voIPServersStaA, simulationTime);
+    StartStopApplication(voIPClientsStaA, voIPServersApA, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApA, voIPServersStaA, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK B
@@ -1856,7 +2065,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsB, vodClientApplicationsB;
     ApplicationContainer vodServerApplicationsB1, vodClientApplicationsB1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasB = sizeof(selectedStaB) / sizeof(selectedStaB[0]);
 
     VoDServer(vodServerApplicationsB,
@@ -1868,8 +2076,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB, vodServerApplicationsB, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsB,
+                         vodServerApplicationsB,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsB1,
               vodClientApplicationsB1,
@@ -1880,8 +2091,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsB1, vodServerApplicationsB1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsB1,
+                         vodServerApplicationsB1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -1901,7 +2115,7 @@ main(int argc, char* argv[])
                wifiApNodesB,
                selectedStaB2,
                sizeof(selectedStaB2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsB, httpServerAppsB, simulationTime);
+    StartStopApplication(httpClientAppsB, httpServerAppsB, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -1933,7 +2147,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesB,
                                                    &ftpStaInterfacesB);
     ftpHelperB->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -1994,8 +2208,8 @@ main(int argc, char* argv[])
              selectedStaB4,
              staSizeB);
 
-    StartStopApplication(gamingClientsStaB, gamingServersApB, simulationTime);
-    StartStopApplication(gamingClientsApB, gamingServersStaB, simulationTime);
+    StartStopApplication(gamingClientsStaB, gamingServersApB, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApB, gamingServersStaB, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2040,8 +2254,8 @@ main(int argc, char* argv[])
            selectedStaB5,
            sizeof(selectedStaB5) / sizeof(selectedStaB5[0]));
 
-    StartStopApplication(voIPClientsStaB, voIPServersApB, simulationTime);
-    StartStopApplication(voIPClientsApB, voIPServersStaB, simulationTime);
+    StartStopApplication(voIPClientsStaB, voIPServersApB, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApB, voIPServersStaB, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK C
@@ -2068,7 +2282,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsC, vodClientApplicationsC;
     ApplicationContainer vodServerApplicationsC1, vodClientApplicationsC1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasC = sizeof(selectedStaC) / sizeof(selectedStaC[0]);
 
     VoDServer(vodServerApplicationsC,
@@ -2080,8 +2293,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC, vodServerApplicationsC, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsC,
+                         vodServerApplicationsC,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsC1,
               vodClientApplicationsC1,
@@ -2092,8 +2308,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsC1, vodServerApplicationsC1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsC1,
+                         vodServerApplicationsC1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2113,7 +2332,7 @@ main(int argc, char* argv[])
                wifiApNodesC,
                selectedStaC2,
                sizeof(selectedStaC2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsC, httpServerAppsC, simulationTime);
+    StartStopApplication(httpClientAppsC, httpServerAppsC, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2145,7 +2364,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesC,
                                                    &ftpStaInterfacesC);
     ftpHelperC->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -2206,8 +2425,8 @@ main(int argc, char* argv[])
              selectedStaC4,
              staSizeC);
 
-    StartStopApplication(gamingClientsStaC, gamingServersApC, simulationTime);
-    StartStopApplication(gamingClientsApC, gamingServersStaC, simulationTime);
+    StartStopApplication(gamingClientsStaC, gamingServersApC, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApC, gamingServersStaC, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2252,8 +2471,8 @@ main(int argc, char* argv[])
            selectedStaC5,
            sizeof(selectedStaC5) / sizeof(selectedStaC5[0]));
 
-    StartStopApplication(voIPClientsStaC, voIPServersApC, simulationTime);
-    StartStopApplication(voIPClientsApC, voIPServersStaC, simulationTime);
+    StartStopApplication(voIPClientsStaC, voIPServersApC, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApC, voIPServersStaC, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK D
@@ -2280,7 +2499,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsD, vodClientApplicationsD;
     ApplicationContainer vodServerApplicationsD1, vodClientApplicationsD1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasD = sizeof(selectedStaD) / sizeof(selectedStaD[0]);
 
     VoDServer(vodServerApplicationsD,
@@ -2292,8 +2510,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD, vodServerApplicationsD, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsD,
+                         vodServerApplicationsD,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsD1,
               vodClientApplicationsD1,
@@ -2304,8 +2525,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsD1, vodServerApplicationsD1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsD1,
+                         vodServerApplicationsD1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2325,7 +2549,7 @@ main(int argc, char* argv[])
                wifiApNodesD,
                selectedStaD2,
                sizeof(selectedStaD2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsD, httpServerAppsD, simulationTime);
+    StartStopApplication(httpClientAppsD, httpServerAppsD, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2357,7 +2581,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesD,
                                                    &ftpStaInterfacesD);
     ftpHelperD->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -2418,8 +2642,8 @@ main(int argc, char* argv[])
              selectedStaD4,
              staSizeD);
 
-    StartStopApplication(gamingClientsStaD, gamingServersApD, simulationTime);
-    StartStopApplication(gamingClientsApD, gamingServersStaD, simulationTime);
+    StartStopApplication(gamingClientsStaD, gamingServersApD, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApD, gamingServersStaD, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2464,8 +2688,8 @@ main(int argc, char* argv[])
            selectedStaD5,
            sizeof(selectedStaD5) / sizeof(selectedStaD5[0]));
 
-    StartStopApplication(voIPClientsStaD, voIPServersApD, simulationTime);
-    StartStopApplication(voIPClientsApD, voIPServersStaD, simulationTime);
+    StartStopApplication(voIPClientsStaD, voIPServersApD, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApD, voIPServersStaD, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NETWORK E
@@ -2492,7 +2716,6 @@ main(int argc, char* argv[])
     ApplicationContainer vodServerApplicationsE, vodClientApplicationsE;
     ApplicationContainer vodServerApplicationsE1, vodClientApplicationsE1;
     portUdp = 5050;
-    tosValue = 0xb8;
     size_t numStasE = sizeof(selectedStaE) / sizeof(selectedStaE[0]);
 
     VoDServer(vodServerApplicationsE,
@@ -2504,8 +2727,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsE, vodServerApplicationsE, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsE,
+                         vodServerApplicationsE,
+                         appStartTime,
+                         simulationTime);
 
     VoDClient(vodServerApplicationsE1,
               vodClientApplicationsE1,
@@ -2516,8 +2742,11 @@ main(int argc, char* argv[])
               dataRate,
               payloadSize,
               portUdp,
-              tosValue);
-    StartStopApplication(vodClientApplicationsE1, vodServerApplicationsE1, simulationTime);
+              tosVod);
+    StartStopApplication(vodClientApplicationsE1,
+                         vodServerApplicationsE1,
+                         appStartTime,
+                         simulationTime);
 
     // 2. Traffic type: HTTP
     // 2.1. Random Node Selection
@@ -2537,7 +2766,7 @@ main(int argc, char* argv[])
                wifiApNodesE,
                selectedStaE2,
                sizeof(selectedStaE2) / sizeof(uint32_t));
-    StartStopApplication(httpClientAppsE, httpServerAppsE, simulationTime);
+    StartStopApplication(httpClientAppsE, httpServerAppsE, appStartTime, simulationTime);
 
     // 3. Traffic type: FTP
     // 3.1. Random Node Selection
@@ -2569,7 +2798,7 @@ main(int argc, char* argv[])
                                                    &wifiApNodesE,
                                                    &ftpStaInterfacesE);
     ftpHelperE->Configure(portFtp,
-                          Seconds(0.0),
+                          Seconds(appStartTime),
                           Seconds(1.0),
                           Seconds(simulationTime),
                           lambdaFtp,
@@ -2630,8 +2859,8 @@ main(int argc, char* argv[])
              selectedStaE4,
              staSizeE);
 
-    StartStopApplication(gamingClientsStaE, gamingServersApE, simulationTime);
-    StartStopApplication(gamingClientsApE, gamingServersStaE, simulationTime);
+    StartStopApplication(gamingClientsStaE, gamingServersApE, appStartTime, simulationTime);
+    StartStopApplication(gamingClientsApE, gamingServersStaE, appStartTime, simulationTime);
 
     // 5. Traffic type: VoIP
     // 5.1. Random Node Selection
@@ -2676,8 +2905,8 @@ main(int argc, char* argv[])
            selectedStaE5,
            sizeof(selectedStaE5) / sizeof(selectedStaE5[0]));
 
-    StartStopApplication(voIPClientsStaE, voIPServersApE, simulationTime);
-    StartStopApplication(voIPClientsApE, voIPServersStaE, simulationTime);
+    StartStopApplication(voIPClientsStaE, voIPServersApE, appStartTime, simulationTime);
+    StartStopApplication(voIPClientsApE, voIPServersStaE, appStartTime, simulationTime);
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MONITORING
@@ -2770,6 +2999,9 @@ main(int argc, char* argv[])
     // FLOW MONITOR
     FlowMonitorHelper flowmonHelper;
     Ptr<FlowMonitor> monitor = flowmonHelper.InstallAll();
+    // Only the packets sent within the measurement window are accounted
+    monitor->Start(Seconds(warmUp));
+    monitor->Stop(Seconds(measureEnd));
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // MOVEMENT MONITOR
     // Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
@@ -2780,6 +3012,16 @@ main(int argc, char* argv[])
     NS_LOG_INFO("Running simulation...");
     Simulator::Stop(Seconds(simulationTime + 1));
     Simulator::Run();
+    if (preAssociate)
+    {
+        fastStart->Report(Seconds(appStartTime));
+    }
+    if (building)
+    {
+        std::cout << "Building propagation: " << buildingLoss->GetCacheMisses()
+                  << " link losses computed, " << buildingLoss->GetCacheHits() << " cached"
+                  << std::endl;
+    }
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // RESULT CALCULATION
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2857,13 +3099,12 @@ main(int argc, char* argv[])
 
         flowTxPackets[flowIndex] = i->second.txPackets;
         flowTxBytes[flowIndex] = i->second.txBytes;
-        flowTxOffered[flowIndex] =
-            i->second.txBytes * 8.0 / (simulationTime - 1.0) / 1000.0 / 1000.0;
+        flowTxOffered[flowIndex] = i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
 
         if (i->second.rxPackets > 0)
         {
-            double rxDuration =
-                i->second.timeLastRxPacket.GetSeconds() - i->second.timeFirstTxPacket.GetSeconds();
+            // Same time base for every flow: the measurement window
+            double rxDuration = measureDuration;
 
             averageFlowThroughput += i->second.rxBytes * 8.0 / rxDuration / 1000 / 1000;
             averageFlowDelay += 1000 * i->second.delaySum.GetSeconds() / i->second.rxPackets;
@@ -2920,7 +3161,7 @@ main(int argc, char* argv[])
             pos = std::stoi(matchNode[1].str()) + nStaA + nStaB + nStaC + nStaD + 3 * nAp;
         }
 
-        avgThroughput[pos] += i->second.txBytes * 8.0 / (simulationTime - 1) / 1000.0 / 1000.0;
+        avgThroughput[pos] += i->second.txBytes * 8.0 / measureDuration / 1000.0 / 1000.0;
         avgDelay[pos] += (i->second.delaySum);
         avgJitter[pos] += (i->second.jitterSum);
         avgtxPackets[pos] += (i->second.txPackets);
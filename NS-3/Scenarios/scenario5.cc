@@ -0,0 +1,602 @@
+/* Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; */
+// Copyright (c) 2020 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+// Copyright (c) 2023 Universidad del País Vasco / Euskal Herriko Unibertsitatea (UPV/EHU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/applications-module.h"
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/core-module.h"
+#include "ns3/double.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/log.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-module.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/network-module.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-wifi-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/wifi-net-device.h"
+#include <ns3/channel-planner.h>
+#include <ns3/layout-generator.h>
+#include <ns3/spectrum-helper.h>
+#include <ns3/trajectory-mobility-model.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace ns3;
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// LOG COMPONENT DEFINITION
+NS_LOG_COMPONENT_DEFINE("Wifi-Scenario5"); // Logging Keyword definition
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Non-overlapping channels of a band and width, in the order they are reused
+std::vector<uint16_t>
+GetChannelNumbers(double frequency, uint32_t channelWidth)
+{
+    if (frequency == 5)
+    {
+        switch (channelWidth)
+        {
+        case 20:
+            return {36,  40,  44,  48,  52,  56,  60,  64,  100, 104, 108, 112, 116,
+                    120, 124, 128, 132, 136, 140, 144, 149, 153, 157, 161, 165};
+        case 40:
+            return {38, 46, 54, 62, 102, 110, 118, 126, 134, 142, 151, 159};
+        case 80:
+            return {42, 58, 106, 122, 138, 155};
+        case 160:
+            return {50, 114};
+        }
+    }
+    else if (frequency == 6)
+    {
+        // 1 + 4k (20 MHz), 3 + 8k (40 MHz), 7 + 16k (80 MHz), 15 + 32k (160 MHz) up to 233
+        std::vector<uint16_t> numbers;
+        if (channelWidth == 20 || channelWidth == 40 || channelWidth == 80 || channelWidth == 160)
+        {
+            uint16_t step = channelWidth / 5;
+            for (uint16_t number = step / 2 - 1; number <= 233; number += step)
+            {
+                numbers.push_back(number);
+            }
+        }
+        return numbers;
+    }
+    else if (frequency == 2.4 && channelWidth == 20)
+    {
+        return {1, 6, 11};
+    }
+    return {};
+}
+
+std::string
+GetChannelSettings(uint16_t channelNumber, uint32_t channelWidth, double frequency)
+{
+    std::ostringstream oss;
+    oss << "{" << channelNumber << ", " << channelWidth;
+    if (frequency == 6)
+    {
+        oss << ", BAND_6GHZ, 0}";
+    }
+    else if (frequency == 5)
+    {
+        oss << ", BAND_5GHZ, 0}";
+    }
+    else
+    {
+        oss << ", BAND_2_4GHZ, 0}";
+    }
+    return oss.str();
+}
+
+Ptr<PropagationLossModel>
+CreateLossModel(double frequency)
+{
+    double lossScenario = 40.05 + 20 * log10(frequency / 2.4);
+    Ptr<ThreeLogDistancePropagationLossModel> lossModel =
+        CreateObject<ThreeLogDistancePropagationLossModel>();
+    lossModel->SetAttribute("ReferenceLoss", DoubleValue(lossScenario));
+    lossModel->SetAttribute("Distance0", DoubleValue(1));
+    lossModel->SetAttribute("Exponent0", DoubleValue(2));
+    lossModel->SetAttribute("Distance1", DoubleValue(10));
+    lossModel->SetAttribute("Exponent1", DoubleValue(3.5));
+    return lossModel;
+}
+
+Ptr<SpectrumChannel>
+CreateSpectrumChannel(double frequency)
+{
+    SpectrumChannelHelper channelHelper;
+    channelHelper.SetChannel("ns3::MultiModelSpectrumChannel");
+    channelHelper.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+    channelHelper.AddPropagationLoss(CreateLossModel(frequency));
+    return channelHelper.Create();
+}
+
+// Addressing of a BSS: subnet 10.<index / 256>.<index % 256>.0/24
+void
+SetBssAddressBase(Ipv4AddressHelper& address, uint32_t index)
+{
+    std::string network =
+        "10." + std::to_string(index / 256) + "." + std::to_string(index % 256) + ".0";
+    address.SetBase(Ipv4Address(network.c_str()), "255.255.255.0");
+}
+
+// BSS of an address given by SetBssAddressBase
+uint32_t
+GetBssIndex(Ipv4Address address)
+{
+    return (address.Get() >> 8) & 0xffff;
+}
+
+void
+ConfigureWifiNetwork(WifiHelper& wifi,
+                     SpectrumWifiPhyHelper& phy,
+                     WifiMacHelper& mac,
+                     const std::string& channelSettings,
+                     double txPowerMinSta,
+                     double txPowerSta,
+                     double txPowerMinAp,
+                     double txPowerAp,
+                     double ccaEdTr,
+                     Ssid ssid,
+                     NodeContainer wifiStaNodes,
+                     NodeContainer wifiApNodes,
+                     NetDeviceContainer& staDevices,
+                     NetDeviceContainer& apDevices)
+{
+    phy.Set("ChannelSettings", StringValue(channelSettings));
+
+    // STA CONFIGURATION - PHY
+    phy.Set("TxPowerStart", DoubleValue(txPowerMinSta));
+    phy.Set("TxPowerEnd", DoubleValue(txPowerSta));
+    phy.Set("TxPowerLevels", UintegerValue((uint32_t)(txPowerSta - txPowerMinSta)));
+    phy.Set("CcaEdThreshold", DoubleValue(ccaEdTr));
+    phy.Set("RxSensitivity", DoubleValue(-92.0));
+
+    mac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+    staDevices = wifi.Install(phy, mac, wifiStaNodes);
+
+    // AP CONFIGURATION - PHY
+    phy.Set("TxPowerStart", DoubleValue(txPowerMinAp));
+    phy.Set("TxPowerEnd", DoubleValue(txPowerAp));
+    phy.Set("TxPowerLevels", UintegerValue((uint32_t)(txPowerAp - txPowerMinAp)));
+
+    // Beacon jitter kept: hundreds of APs starting together would beacon in lockstep
+    mac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+    apDevices = wifi.Install(phy, mac, wifiApNodes);
+}
+
+// Wall-clock seconds since a phase started; the next phase starts now
+double
+EndSetupPhase(std::chrono::steady_clock::time_point& phaseStart)
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - phaseStart;
+    phaseStart = now;
+    return elapsed.count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // ENVIRONMENT SETTINGS - DEFAULT PARAMETERS
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Simulation basic parameters
+    uint32_t simulationTime = 5; // Simulation duration in seconds
+    double warmUp = 1.0;         // Start of the measurement window (seconds)
+    uint32_t seedNumber = 1;     // RNG seed
+    uint32_t runNumber = 1;      // Run number
+    bool setupOnly = false;      // Build the deployment and stop (setup time benchmark)
+
+    // Logging
+    bool verbose = false; // Turn on all Wifi logging
+
+    // Layout
+    std::string layout = "Grid"; // AP placement (Grid / Hex / FloorPlan)
+    uint32_t nAps = 100;         // Number of APs (FloorPlan: 0 for every AP of the file)
+    double apSpacing = 20;       // Distance between neighbouring APs (m)
+    uint32_t columns = 0;        // APs per row (0: square layout)
+    std::string floorPlan = "";  // AP coordinates of the FloorPlan layout (CSV x,y[,z])
+    double apHeight = 2.5;       // AP height (m)
+    double minZSize = 1.0;       // Lower bound of the STA height (m)
+    double maxZSize = 1.5;       // Upper bound of the STA height (m)
+    double nStaMean = 10;        // Mean number of STAs per cell
+    double nStaVariance = 4;     // Variance of the number of STAs per cell
+
+    std::string mobilityMode = "RandomWalk"; // STA mobility (RandomWalk / Precomputed)
+
+    // Transmission Configuration
+    double txPowerAp = 21;     // Max TX Power for APs
+    double txPowerSta = 15;    // Max TX Power for STAs
+    double txPowerMinAp = 10;  // Min TX Power reference for APs
+    double txPowerMinSta = 10; // Min TX Power reference for STAs
+    double ccaEdTr = -62;      // CCA-ED Threshold in dBm
+
+    // Phy parameters
+    double frequency = 5;              // 2.4 GHz / 5 GHz / 6 GHz
+    int mcs = -1;                      // Constant rate MCS (-1: Ideal rate control)
+    uint32_t gi = 800;                 // Guard interval (ns)
+    uint32_t channelWidth = 20;        // Channel Width (MHz)
+    uint32_t nChannels = 4;            // Channels reused over the layout (0: every channel)
+    std::string channelPlan = "Fixed"; // Channel assignment (Fixed reuse / Auto)
+    bool bssColoring = true;           // BSS color per BSS (1-63, reused)
+
+    // Traffic configuration
+    uint32_t payloadSize = 1448; // UDP payload (bytes)
+    uint32_t dataRate = 1000000; // DL data rate per STA (bps)
+    uint8_t tos = 0xb8;          // ToS of the DL flows (AC_VI, as the VoD flows)
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // PARAMETERS FROM COMMAND LINE
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    CommandLine cmd(__FILE__);
+
+    // Simulation basic parameters
+    cmd.AddValue("simulationTime", "Simulation time (seconds)", simulationTime);
+    cmd.AddValue("warmUp", "Start of the measurement window (seconds)", warmUp);
+    cmd.AddValue("seedNumber", "RNG seed number", seedNumber);
+    cmd.AddValue("runNumber", "Simulation run number", runNumber);
+    cmd.AddValue("setupOnly",
+                 "Build the deployment, write the setup times and stop before running",
+                 setupOnly);
+
+    // Logging
+    cmd.AddValue("verbose", "Enable log components", verbose);
+
+    // Layout
+    cmd.AddValue("layout", "AP placement: Grid, Hex (hexagonal cells) or FloorPlan", layout);
+    cmd.AddValue("nAps", "Number of APs (FloorPlan: 0 for every AP of the file)", nAps);
+    cmd.AddValue("apSpacing", "Distance between neighbouring APs of Grid and Hex (m)", apSpacing);
+    cmd.AddValue("columns", "APs per row of Grid and Hex (0: square layout)", columns);
+    cmd.AddValue("floorPlan", "CSV file of AP coordinates (x,y[,z]) for FloorPlan", floorPlan);
+    cmd.AddValue("apHeight", "AP height (m)", apHeight);
+    cmd.AddValue("minZSize", "Lower bound of the STA height (m)", minZSize);
+    cmd.AddValue("maxZSize", "Upper bound of the STA height (m)", maxZSize);
+    cmd.AddValue("nStaMean", "Mean number of STAs per cell", nStaMean);
+    cmd.AddValue("nStaVariance", "Variance of the number of STAs per cell", nStaVariance);
+    cmd.AddValue("mobilityMode",
+                 "STA mobility: RandomWalk (event-driven legs) or Precomputed (same walk "
+                 "generated up front as a waypoint table), bounded by the cell",
+                 mobilityMode);
+
+    // Transmission Configuration
+    cmd.AddValue("txPowerAp", "Max TX Power for APs (dBm)", txPowerAp);
+    cmd.AddValue("txPowerSta", "Max TX Power for STAs (dBm)", txPowerSta);
+    cmd.AddValue("ccaEdTr", "CCA-ED Threshold (dBm)", ccaEdTr);
+
+    // Phy parameters
+    cmd.AddValue("frequency", "Whether working in the 2.4, 5 or 6 GHz band", frequency);
+    cmd.AddValue("mcs", "Constant rate MCS (-1 for the Ideal rate control)", mcs);
+    cmd.AddValue("gi", "Guard interval (ns)", gi);
+    cmd.AddValue("channelWidth", "Channel width (MHz)", channelWidth);
+    cmd.AddValue("nChannels", "Channels reused over the layout (0 for every channel)", nChannels);
+    cmd.AddValue("channelPlan",
+                 "Channel assignment: Fixed (reuse of nChannels, farthest cells first) or Auto "
+                 "(ChannelPlanner); plan in Scenario5-ChannelPlan.csv",
+                 channelPlan);
+    cmd.AddValue("bssColoring", "BSS color per BSS (1-63, reused)", bssColoring);
+
+    // Traffic configuration
+    cmd.AddValue("payloadSize", "UDP payload size (bytes)", payloadSize);
+    cmd.AddValue("dataRate", "DL data rate per STA (bps)", dataRate);
+
+    cmd.Parse(argc, argv);
+
+    if (verbose)
+    {
+        LogComponentEnable("LayoutGenerator", LOG_LEVEL_ALL);
+        LogComponentEnable("Wifi-Scenario5", LOG_LEVEL_ALL);
+    }
+
+    NS_ABORT_MSG_IF(channelPlan != "Fixed" && channelPlan != "Auto",
+                    "Invalid channel plan (must be Fixed or Auto)");
+    NS_ABORT_MSG_IF(mobilityMode != "RandomWalk" && mobilityMode != "Precomputed",
+                    "Invalid mobility mode (must be RandomWalk or Precomputed)");
+    std::vector<uint16_t> channelNumbers = GetChannelNumbers(frequency, channelWidth);
+    NS_ABORT_MSG_IF(channelNumbers.empty(), "Wrong frequency value or channel width!");
+    if (nChannels == 0 || nChannels > channelNumbers.size())
+    {
+        nChannels = channelNumbers.size();
+    }
+
+    // RNG: For independent replications, the most rigorous set up is to define both seed
+    // (fixed) and run number (incremental)
+    RngSeedManager::SetSeed(seedNumber); // set randomness seed
+    RngSeedManager::SetRun(runNumber);   // set run number
+
+    // Wall-clock time of every setup phase (seconds)
+    auto setupStart = std::chrono::steady_clock::now();
+    auto phaseStart = setupStart;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // LAYOUT AND NODES
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    Ptr<LayoutGenerator> layoutGenerator = CreateObject<LayoutGenerator>();
+    layoutGenerator->SetAttribute("Layout", StringValue(layout));
+    layoutGenerator->SetAttribute("NAps", UintegerValue(nAps));
+    layoutGenerator->SetAttribute("Spacing", DoubleValue(apSpacing));
+    layoutGenerator->SetAttribute("Columns", UintegerValue(columns));
+    layoutGenerator->SetAttribute("FloorPlan", StringValue(floorPlan));
+    layoutGenerator->SetAttribute("ApHeight", DoubleValue(apHeight));
+    layoutGenerator->Generate();
+    uint32_t nBss = layoutGenerator->GetN();
+
+    Ptr<NormalRandomVariable> nStaRv = CreateObject<NormalRandomVariable>();
+    nStaRv->SetAttribute("Mean", DoubleValue(nStaMean));
+    nStaRv->SetAttribute("Variance", DoubleValue(nStaVariance));
+
+    NodeContainer wifiApNodes;
+    wifiApNodes.Create(nBss);
+    std::vector<NodeContainer> wifiStaNodes(nBss);
+    uint32_t nStaTotal = 0;
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        wifiStaNodes[i].Create(static_cast<uint32_t>(std::max(1.0, nStaRv->GetValue())));
+        nStaTotal += wifiStaNodes[i].GetN();
+    }
+    std::cout << "Layout: " << layout << ", " << nBss << " APs, " << nStaTotal << " STAs"
+              << std::endl;
+    double nodesTime = EndSetupPhase(phaseStart);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // MOBILITY
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    layoutGenerator->InstallAps(wifiApNodes);
+
+    std::string staMobilityModel = "ns3::RandomWalk2dMobilityModel";
+    if (mobilityMode == "Precomputed")
+    {
+        staMobilityModel = "ns3::TrajectoryMobilityModel";
+        Config::SetDefault("ns3::TrajectoryMobilityModel::Duration",
+                           TimeValue(Seconds(simulationTime + 1)));
+    }
+    Ptr<UniformRandomVariable> zRv = CreateObject<UniformRandomVariable>();
+    zRv->SetAttribute("Min", DoubleValue(minZSize));
+    zRv->SetAttribute("Max", DoubleValue(maxZSize));
+    double zSize = zRv->GetValue();
+
+    // STAs dropped in the region of their cell and walking within it
+    MobilityHelper mobility;
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        layoutGenerator->ConfigureStaMobility(mobility, i, staMobilityModel, zSize);
+        mobility.Install(wifiStaNodes[i]);
+    }
+    layoutGenerator->WriteCsv("Scenario5-Layout.csv", seedNumber, runNumber);
+    double mobilityTime = EndSetupPhase(phaseStart);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // WIFI
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211ax);
+    if (mcs >= 0)
+    {
+        NS_ABORT_MSG_IF(mcs > 11, "The Constant rate control needs an MCS (0-11)");
+        std::string mode = "HeMcs" + std::to_string(mcs);
+        wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                     "DataMode",
+                                     StringValue(mode),
+                                     "ControlMode",
+                                     StringValue(mode));
+    }
+    else
+    {
+        wifi.SetRemoteStationManager("ns3::IdealWifiManager");
+    }
+
+    // Every BSS on one spectrum channel: co-channel cells interfere as in a real deployment
+    Ptr<SpectrumChannel> spectrumChannel = CreateSpectrumChannel(frequency);
+    SpectrumWifiPhyHelper phy;
+    phy.SetChannel(spectrumChannel);
+
+    WifiMacHelper mac;
+    std::vector<uint32_t> channelGroups = layoutGenerator->AssignChannelGroups(nChannels);
+    std::vector<NetDeviceContainer> staDevices(nBss);
+    std::vector<NetDeviceContainer> apDevices(nBss);
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        wifi.ConfigHeOptions("GuardInterval",
+                             TimeValue(NanoSeconds(gi)),
+                             "BssColor",
+                             UintegerValue(bssColoring ? i % 63 + 1 : 1));
+        ConfigureWifiNetwork(
+            wifi,
+            phy,
+            mac,
+            GetChannelSettings(channelNumbers[channelGroups[i]], channelWidth, frequency),
+            txPowerMinSta,
+            txPowerSta,
+            txPowerMinAp,
+            txPowerAp,
+            ccaEdTr,
+            Ssid("ns3-802.11ax-" + std::to_string(i)),
+            wifiStaNodes[i],
+            wifiApNodes.Get(i),
+            staDevices[i],
+            apDevices[i]);
+    }
+
+    int64_t streamNumber = 100;
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        streamNumber += wifi.AssignStreams(apDevices[i], streamNumber);
+        streamNumber += wifi.AssignStreams(staDevices[i], streamNumber);
+    }
+    double wifiTime = EndSetupPhase(phaseStart);
+
+    // Channel planning over the whole deployment
+    std::vector<uint16_t> bssChannels; // channel of every BSS after the planning
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        bssChannels.push_back(channelNumbers[channelGroups[i]]);
+    }
+    if (channelPlan == "Auto")
+    {
+        Ptr<ChannelPlanner> planner = CreateObject<ChannelPlanner>();
+        planner->SetAttribute("LossModel", PointerValue(CreateLossModel(frequency)));
+        planner->SetAttribute("TxPower", DoubleValue(txPowerAp));
+        planner->SetAttribute("CellRadius", DoubleValue(apSpacing / 2));
+        for (uint32_t i = 0; i < nBss; i++)
+        {
+            ChannelPlanner::Channel fixedChannel;
+            fixedChannel.number = channelNumbers[channelGroups[i]];
+            fixedChannel.width = channelWidth;
+            planner->AddBss(std::to_string(i), wifiApNodes.Get(i), fixedChannel);
+        }
+        planner->Plan(frequency, channelWidth);
+        for (uint32_t i = 0; i < nBss; i++)
+        {
+            planner->Apply(i, NetDeviceContainer(apDevices[i], staDevices[i]));
+            bssChannels[i] = planner->GetChannel(i).number;
+        }
+        planner->WriteCsv("Scenario5-ChannelPlan.csv", seedNumber, runNumber);
+        std::cout << "Channel plan: predicted throughput "
+                  << planner->GetInitialPredictedThroughput() << " -> "
+                  << planner->GetPredictedThroughput() << " Mbps" << std::endl;
+    }
+    double channelPlanTime = EndSetupPhase(phaseStart);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // INTERNET PROTOCOL STACK AND ADDRESSING
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    InternetStackHelper stack;
+    stack.Install(wifiApNodes);
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        stack.Install(wifiStaNodes[i]);
+    }
+
+    Ipv4AddressHelper address;
+    std::vector<Ipv4InterfaceContainer> staNodeInterfaces(nBss);
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        SetBssAddressBase(address, i);
+        staNodeInterfaces[i] = address.Assign(staDevices[i]);
+        address.Assign(apDevices[i]);
+    }
+    double internetTime = EndSetupPhase(phaseStart);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // APPLICATIONS
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // One constant-rate DL UDP flow per STA, from its AP
+    ApplicationContainer serverApplications;
+    ApplicationContainer clientApplications;
+    uint16_t portUdp = 5050;
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        for (uint32_t j = 0; j < wifiStaNodes[i].GetN(); j++)
+        {
+            InetSocketAddress sinkSocket(staNodeInterfaces[i].GetAddress(j), portUdp + j);
+            sinkSocket.SetTos(tos);
+
+            OnOffHelper onOffHelper("ns3::UdpSocketFactory", sinkSocket);
+            onOffHelper.SetConstantRate(DataRate(dataRate), payloadSize);
+            serverApplications.Add(onOffHelper.Install(wifiApNodes.Get(i)));
+
+            PacketSinkHelper packetSinkHelper("ns3::UdpSocketFactory", sinkSocket);
+            clientApplications.Add(packetSinkHelper.Install(wifiStaNodes[i].Get(j)));
+        }
+    }
+    serverApplications.Start(Seconds(warmUp));
+    serverApplications.Stop(Seconds(simulationTime));
+    clientApplications.Start(Seconds(warmUp));
+    clientApplications.Stop(Seconds(simulationTime));
+
+    FlowMonitorHelper flowmonHelper;
+    Ptr<FlowMonitor> monitor = flowmonHelper.InstallAll();
+    double applicationsTime = EndSetupPhase(phaseStart);
+    std::chrono::duration<double> setupTime = phaseStart - setupStart;
+    std::cout << "Setup: " << setupTime.count() << " s (nodes " << nodesTime << " s, mobility "
+              << mobilityTime << " s, wifi " << wifiTime << " s, channel plan "
+              << channelPlanTime << " s, internet " << internetTime << " s, applications "
+              << applicationsTime << " s)" << std::endl;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // RUNNING
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    std::chrono::duration<double> wallClockRun(0);
+    if (!setupOnly)
+    {
+        NS_LOG_INFO("Running simulation...");
+        Simulator::Stop(Seconds(simulationTime + 1));
+        auto wallClockStart = std::chrono::steady_clock::now();
+        Simulator::Run();
+        wallClockRun = std::chrono::steady_clock::now() - wallClockStart;
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // BSS statistics
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        monitor->CheckForLostPackets();
+        Ptr<Ipv4FlowClassifier> classifier =
+            DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
+        std::vector<uint64_t> rxBytes(nBss, 0);
+        std::vector<uint64_t> rxPackets(nBss, 0);
+        std::vector<uint64_t> lostPackets(nBss, 0);
+        std::vector<double> delaySum(nBss, 0);
+        for (const auto& [flowId, flowStats] : monitor->GetFlowStats())
+        {
+            uint32_t bss = GetBssIndex(classifier->FindFlow(flowId).destinationAddress);
+            if (bss >= nBss)
+            {
+                continue;
+            }
+            rxBytes[bss] += flowStats.rxBytes;
+            rxPackets[bss] += flowStats.rxPackets;
+            lostPackets[bss] += flowStats.lostPackets;
+            delaySum[bss] += flowStats.delaySum.GetSeconds();
+        }
+
+        std::ofstream bssFile("Scenario5-BssStats.csv", std::ios::app);
+        NS_ABORT_MSG_IF(!bssFile.is_open(), "Can not open Scenario5-BssStats.csv");
+        // seed, run, BSS, channel, STAs, DL throughput (Mbps), mean delay (ms), lost packets
+        double window = simulationTime - warmUp;
+        double totalThroughput = 0;
+        for (uint32_t i = 0; i < nBss; i++)
+        {
+            double throughput = rxBytes[i] * 8.0 / window / 1e6;
+            totalThroughput += throughput;
+            bssFile << seedNumber << "," << runNumber << "," << i << ","
+                    << bssChannels[i] << "," << wifiStaNodes[i].GetN() << ","
+                    << throughput << ","
+                    << (rxPackets[i] > 0 ? 1000 * delaySum[i] / rxPackets[i] : 0) << ","
+                    << lostPackets[i] << "\n";
+        }
+        std::cout << "Aggregate DL throughput: " << totalThroughput << " Mbps" << std::endl;
+    }
+    Simulator::Destroy();
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Setup File
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Seed, Run, Layout, APs, STAs, Nodes (s), Mobility (s), Wifi (s), Channel plan (s),
+    // Internet (s), Applications (s), Total setup (s), Wall-clock run time (s)
+    std::ofstream setupFile("Scenario5-Setup.csv", std::ios::app);
+    setupFile << seedNumber << "," << runNumber << "," << layout << "," << nBss << ","
+              << nStaTotal << "," << nodesTime << "," << mobilityTime << "," << wifiTime << ","
+              << channelPlanTime << "," << internetTime << "," << applicationsTime << ","
+              << setupTime.count() << "," << wallClockRun.count() << "\n";
+    setupFile.close();
+
+    return 0;
+}